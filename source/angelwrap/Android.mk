@@ -10,6 +10,7 @@ LOCAL_STATIC_LIBRARIES := angelscript
 LOCAL_SRC_FILES := \
   ../gameshared/q_math.c \
   ../gameshared/q_shared.c \
+  ../qalgo/md5.c \
   $(addprefix addon/,$(notdir $(wildcard $(LOCAL_PATH)/addon/*.cpp))) \
   $(notdir $(wildcard $(LOCAL_PATH)/*.c)) \
   $(notdir $(wildcard $(LOCAL_PATH)/*.cpp))
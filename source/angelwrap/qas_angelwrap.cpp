@@ -28,8 +28,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "addon/addon_vec3.h"
 #include "addon/addon_cvar.h"
 #include "addon/addon_stringutils.h"
+#include "../qalgo/md5.h"
 
 #include <list>
+#include <vector>
 
 static void *qasAlloc( size_t size ) {
 	return QAS_Malloc( size );
@@ -137,6 +139,8 @@ void qasReleaseEngine( asIScriptEngine *engine ) {
 		return;
 	}
 
+	qasProfilerReleaseEngine( engine );
+
 	// release all contexts linked to this engine
 	qasContextList &ctxList = contexts[engine];
 	for( qasContextList::iterator it = ctxList.begin(); it != ctxList.end(); it++ ) {
@@ -194,6 +198,8 @@ void qasReleaseContext( asIScriptContext *ctx ) {
 	qasContextList &ctxList = contexts[engine];
 	ctxList.remove( ctx );
 
+	qasProfilerReleaseContext( ctx );
+
 	ctx->Release();
 }
 
@@ -207,12 +213,17 @@ asIScriptContext *qasAcquireContext( asIScriptEngine *engine ) {
 	for( qasContextList::iterator it = ctxList.begin(); it != ctxList.end(); it++ ) {
 		asIScriptContext *ctx = *it;
 		if( ctx->GetState() == asEXECUTION_FINISHED ) {
+			qasProfilerAcquireContext( ctx, true );
 			return ctx;
 		}
 	}
 
 	// if no context was available, create a new one
-	return qasCreateContext( engine );
+	asIScriptContext *ctx = qasCreateContext( engine );
+	if( ctx ) {
+		qasProfilerAcquireContext( ctx, false );
+	}
+	return ctx;
 }
 
 asIScriptContext *qasGetActiveContext( void ) {
@@ -265,6 +276,268 @@ static char *qasLoadScriptSection( const char *rootDir, const char *dir, const c
 	return (char *)data;
 }
 
+/*************************************
+* Bytecode cache
+**************************************/
+
+#define QAS_BYTECODE_CACHE_MAGIC        "QASB"
+#define QAS_BYTECODE_CACHE_VERSION      1
+#define QAS_BYTECODE_CACHE_EXTENSION    ".asbc"
+
+typedef struct {
+	char magic[4];
+	int version;
+	md5_byte_t digest[16];
+	int length;
+} qasbytecodeheader_t;
+
+class qasBytecodeWriteStream : public asIBinaryStream {
+public:
+	std::vector<uint8_t> data;
+
+	void Read( void *ptr, asUINT size ) {
+	}
+	void Write( const void *ptr, asUINT size ) {
+		const uint8_t *bytes = ( const uint8_t * )ptr;
+		data.insert( data.end(), bytes, bytes + size );
+	}
+};
+
+class qasBytecodeReadStream : public asIBinaryStream {
+	const uint8_t *data;
+	size_t length;
+	size_t offset;
+public:
+	bool overrun;
+
+	qasBytecodeReadStream( const uint8_t *data_, size_t length_ )
+		: data( data_ ), length( length_ ), offset( 0 ), overrun( false ) {}
+
+	void Read( void *ptr, asUINT size ) {
+		// never let a damaged file read past the buffer, fail the load instead
+		if( size > length - offset ) {
+			memset( ptr, 0, size );
+			offset = length;
+			overrun = true;
+			return;
+		}
+		memcpy( ptr, data + offset, size );
+		offset += size;
+	}
+	void Write( const void *ptr, asUINT size ) {
+	}
+};
+
+/*
+* qasHashString
+*/
+static void qasHashString( md5_state_t *md5, const char *string ) {
+	if( !string ) {
+		string = "";
+	}
+	// include the terminator so adjacent strings can't be confused
+	md5_append( md5, ( const md5_byte_t * )string, strlen( string ) + 1 );
+}
+
+/*
+* qasHashInt
+*/
+static void qasHashInt( md5_state_t *md5, int value ) {
+	md5_append( md5, ( const md5_byte_t * )&value, sizeof( value ) );
+}
+
+/*
+* qasHashEngineInterface
+*
+* Hashes everything the application has registered to the engine, so that
+* cached bytecode is rejected as soon as the script API changes in any way.
+*/
+static void qasHashEngineInterface( md5_state_t *md5, asIScriptEngine *asEngine ) {
+	asUINT i, j;
+
+	qasHashString( md5, ANGELSCRIPT_VERSION_STRING );
+	qasHashInt( md5, ANGELWRAP_API_VERSION );
+	qasHashInt( md5, (int)sizeof( void * ) );
+
+	qasHashInt( md5, asEngine->GetEnumCount() );
+	for( i = 0; i < asEngine->GetEnumCount(); i++ ) {
+		int typeId;
+		const char *nameSpace = NULL;
+		const char *name = asEngine->GetEnumByIndex( i, &typeId, &nameSpace );
+
+		qasHashString( md5, nameSpace );
+		qasHashString( md5, name );
+		for( j = 0; j < (asUINT)asEngine->GetEnumValueCount( typeId ); j++ ) {
+			int value;
+			qasHashString( md5, asEngine->GetEnumValueByIndex( typeId, j, &value ) );
+			qasHashInt( md5, value );
+		}
+	}
+
+	qasHashInt( md5, asEngine->GetFuncdefCount() );
+	for( i = 0; i < asEngine->GetFuncdefCount(); i++ ) {
+		qasHashString( md5, asEngine->GetFuncdefByIndex( i )->GetDeclaration( true, true ) );
+	}
+
+	qasHashInt( md5, asEngine->GetObjectTypeCount() );
+	for( i = 0; i < asEngine->GetObjectTypeCount(); i++ ) {
+		asIObjectType *objectType = asEngine->GetObjectTypeByIndex( i );
+
+		qasHashString( md5, objectType->GetNamespace() );
+		qasHashString( md5, objectType->GetName() );
+		qasHashInt( md5, (int)objectType->GetFlags() );
+		qasHashInt( md5, objectType->GetSize() );
+
+		for( j = 0; j < objectType->GetBehaviourCount(); j++ ) {
+			asEBehaviours behaviour;
+			asIScriptFunction *func = objectType->GetBehaviourByIndex( j, &behaviour );
+			qasHashInt( md5, (int)behaviour );
+			qasHashString( md5, func->GetDeclaration( true, true ) );
+		}
+		for( j = 0; j < objectType->GetFactoryCount(); j++ ) {
+			qasHashString( md5, objectType->GetFactoryByIndex( j )->GetDeclaration( true, true ) );
+		}
+		for( j = 0; j < objectType->GetMethodCount(); j++ ) {
+			qasHashString( md5, objectType->GetMethodByIndex( j )->GetDeclaration( true, true ) );
+		}
+		for( j = 0; j < objectType->GetPropertyCount(); j++ ) {
+			qasHashString( md5, objectType->GetPropertyDeclaration( j, true ) );
+		}
+	}
+
+	qasHashInt( md5, asEngine->GetGlobalPropertyCount() );
+	for( i = 0; i < asEngine->GetGlobalPropertyCount(); i++ ) {
+		int typeId;
+		bool isConst;
+		const char *name = NULL, *nameSpace = NULL;
+
+		asEngine->GetGlobalPropertyByIndex( i, &name, &nameSpace, &typeId, &isConst );
+		qasHashString( md5, nameSpace );
+		qasHashString( md5, name );
+		qasHashString( md5, asEngine->GetTypeDeclaration( typeId, true ) );
+		qasHashInt( md5, isConst ? 1 : 0 );
+	}
+
+	qasHashInt( md5, asEngine->GetGlobalFunctionCount() );
+	for( i = 0; i < asEngine->GetGlobalFunctionCount(); i++ ) {
+		qasHashString( md5, asEngine->GetGlobalFunctionByIndex( i )->GetDeclaration( true, true ) );
+	}
+}
+
+/*
+* qasBytecodeCachePath
+*/
+static void qasBytecodeCachePath( const char *scriptName, char *path, size_t pathSize ) {
+	Q_snprintfz( path, pathSize, "cache/%s", scriptName );
+	COM_ReplaceExtension( path, QAS_BYTECODE_CACHE_EXTENSION, pathSize );
+}
+
+/*
+* qasLoadCachedBytecode
+*
+* Returns false if there's no valid cache file for the digest or it failed to load.
+* In the latter case the module is left in an undefined state and must be recreated.
+*/
+static bool qasLoadCachedBytecode( asIScriptModule *asModule, const char *scriptName, const md5_byte_t *digest, bool *moduleDirty ) {
+	int length, filenum;
+	char path[MAX_QPATH];
+	qasbytecodeheader_t header;
+	uint8_t *data;
+	int error;
+
+	*moduleDirty = false;
+
+	qasBytecodeCachePath( scriptName, path, sizeof( path ) );
+
+	length = trap_FS_FOpenFile( path, &filenum, FS_READ | FS_CACHE );
+	if( length == -1 ) {
+		return false;
+	}
+
+	if( length < (int)sizeof( header )
+		|| trap_FS_Read( &header, sizeof( header ), filenum ) != (int)sizeof( header )
+		|| memcmp( header.magic, QAS_BYTECODE_CACHE_MAGIC, sizeof( header.magic ) )
+		|| LittleLong( header.version ) != QAS_BYTECODE_CACHE_VERSION
+		|| memcmp( header.digest, digest, sizeof( header.digest ) )
+		|| LittleLong( header.length ) != length - (int)sizeof( header ) ) {
+		trap_FS_FCloseFile( filenum );
+		return false;
+	}
+
+	length -= sizeof( header );
+	data = ( uint8_t * )qasAlloc( length + 1 );
+	if( trap_FS_Read( data, length, filenum ) != length ) {
+		trap_FS_FCloseFile( filenum );
+		qasFree( data );
+		return false;
+	}
+	trap_FS_FCloseFile( filenum );
+
+	qasBytecodeReadStream stream( data, length );
+
+	*moduleDirty = true;
+	error = asModule->LoadByteCode( &stream );
+	qasFree( data );
+
+	if( error < 0 || stream.overrun ) {
+		QAS_Printf( S_COLOR_YELLOW "* Failed to load bytecode cache '%s', recompiling\n", path );
+		return false;
+	}
+
+	QAS_Printf( "* Loaded script bytecode from '%s'\n", path );
+	return true;
+}
+
+/*
+* qasSaveCachedBytecode
+*/
+static void qasSaveCachedBytecode( asIScriptModule *asModule, const char *scriptName, const md5_byte_t *digest ) {
+	int filenum;
+	char path[MAX_QPATH];
+	qasbytecodeheader_t header;
+	qasBytecodeWriteStream stream;
+
+	// debug info is kept so that script errors still report sections and lines
+	if( asModule->SaveByteCode( &stream, false ) < 0 || stream.data.empty() ) {
+		return;
+	}
+
+	qasBytecodeCachePath( scriptName, path, sizeof( path ) );
+
+	if( trap_FS_FOpenFile( path, &filenum, FS_WRITE | FS_CACHE ) == -1 ) {
+		QAS_Printf( S_COLOR_YELLOW "* Couldn't write bytecode cache '%s'\n", path );
+		return;
+	}
+
+	memcpy( header.magic, QAS_BYTECODE_CACHE_MAGIC, sizeof( header.magic ) );
+	header.version = LittleLong( QAS_BYTECODE_CACHE_VERSION );
+	memcpy( header.digest, digest, sizeof( header.digest ) );
+	header.length = LittleLong( (int)stream.data.size() );
+
+	if( trap_FS_Write( &header, sizeof( header ), filenum ) != (int)sizeof( header )
+		|| trap_FS_Write( &stream.data[0], stream.data.size(), filenum ) != (int)stream.data.size() ) {
+		trap_FS_FCloseFile( filenum );
+		trap_FS_RemoveFile( path );
+		return;
+	}
+
+	trap_FS_FCloseFile( filenum );
+}
+
+/*
+* qasFreeScriptSections
+*/
+static void qasFreeScriptSections( char **sections, int numSections ) {
+	int i;
+
+	for( i = 0; i < numSections; i++ ) {
+		if( sections[i] ) {
+			qasFree( sections[i] );
+		}
+	}
+	qasFree( sections );
+}
+
 /*
 * qasBuildScriptProject
 */
@@ -272,6 +545,9 @@ static asIScriptModule *qasBuildScriptProject( asIScriptEngine *asEngine, const
 	int error;
 	int numSections, sectionNum;
 	char *section;
+	char **sections;
+	bool useCache;
+	md5_byte_t digest[16];
 	asIScriptModule *asModule;
 
 	if( asEngine == NULL ) {
@@ -291,30 +567,70 @@ static asIScriptModule *qasBuildScriptProject( asIScriptEngine *asEngine, const
 
 	// load up the script sections
 
+	sections = ( char ** )qasAlloc( numSections * sizeof( *sections ) );
+	for( sectionNum = 0; sectionNum < numSections; sectionNum++ ) {
+		sections[sectionNum] = qasLoadScriptSection( rootDir, dir, script, sectionNum );
+		if( !sections[sectionNum] ) {
+			break;
+		}
+	}
+
+	if( sectionNum != numSections ) {
+		QAS_Printf( S_COLOR_RED "* Error: couldn't load all script sections.\n" );
+		qasFreeScriptSections( sections, sectionNum );
+		return NULL;
+	}
+
 	asModule = asEngine->GetModule( moduleName, asGM_CREATE_IF_NOT_EXISTS );
 	if( asModule == NULL ) {
 		QAS_Printf( S_COLOR_RED "qasBuildGameScript: GetModule '%s' failed\n", moduleName );
+		qasFreeScriptSections( sections, numSections );
 		return NULL;
 	}
 
-	for( sectionNum = 0; ( section = qasLoadScriptSection( rootDir, dir, script, sectionNum ) ) != NULL; sectionNum++ ) {
-		const char *sectionName = COM_ListNameForPosition( script, sectionNum, QAS_SECTIONS_SEPARATOR );
-		error = asModule->AddScriptSection( sectionName, section, strlen( section ) );
+	// the bytecode cache is keyed by the registered engine interface and all sources
+	useCache = trap_Cvar_Get( "as_bytecodeCache", "1", CVAR_ARCHIVE )->integer != 0;
+	if( useCache ) {
+		md5_state_t md5;
+		bool moduleDirty;
+
+		md5_init( &md5 );
+		qasHashEngineInterface( &md5, asEngine );
+		qasHashInt( &md5, numSections );
+		for( sectionNum = 0; sectionNum < numSections; sectionNum++ ) {
+			qasHashString( &md5, COM_ListNameForPosition( script, sectionNum, QAS_SECTIONS_SEPARATOR ) );
+			qasHashString( &md5, sections[sectionNum] );
+		}
+		md5_finish( &md5, digest );
+
+		if( qasLoadCachedBytecode( asModule, scriptName, digest, &moduleDirty ) ) {
+			qasFreeScriptSections( sections, numSections );
+			return asModule;
+		}
 
-		qasFree( section );
+		if( moduleDirty ) {
+			asModule = asEngine->GetModule( moduleName, asGM_ALWAYS_CREATE );
+			if( asModule == NULL ) {
+				QAS_Printf( S_COLOR_RED "qasBuildGameScript: GetModule '%s' failed\n", moduleName );
+				qasFreeScriptSections( sections, numSections );
+				return NULL;
+			}
+		}
+	}
+
+	for( sectionNum = 0; sectionNum < numSections; sectionNum++ ) {
+		const char *sectionName = COM_ListNameForPosition( script, sectionNum, QAS_SECTIONS_SEPARATOR );
+		error = asModule->AddScriptSection( sectionName, sections[sectionNum], strlen( sections[sectionNum] ) );
 
 		if( error ) {
 			QAS_Printf( S_COLOR_RED "* Failed to add the script section %s with error %i\n", sectionName, error );
+			qasFreeScriptSections( sections, numSections );
 			asEngine->DiscardModule( moduleName );
 			return NULL;
 		}
 	}
 
-	if( sectionNum != numSections ) {
-		QAS_Printf( S_COLOR_RED "* Error: couldn't load all script sections.\n" );
-		asEngine->DiscardModule( moduleName );
-		return NULL;
-	}
+	qasFreeScriptSections( sections, numSections );
 
 	error = asModule->Build();
 	if( error ) {
@@ -323,6 +639,10 @@ static asIScriptModule *qasBuildScriptProject( asIScriptEngine *asEngine, const
 		return NULL;
 	}
 
+	if( useCache ) {
+		qasSaveCachedBytecode( asModule, scriptName, digest );
+	}
+
 	return asModule;
 }
 
@@ -86,6 +86,13 @@ void qasReleaseContext( asIScriptContext *ctx );
 void qasReleaseEngine( asIScriptEngine *engine );
 asIScriptContext *qasGetActiveContext( void );
 
+// profiler
+void qasProfilerInit( void );
+void qasProfilerShutdown( void );
+void qasProfilerAcquireContext( asIScriptContext *ctx, bool reused );
+void qasProfilerReleaseContext( asIScriptContext *ctx );
+void qasProfilerReleaseEngine( asIScriptEngine *engine );
+
 // array tools
 CScriptArrayInterface *qasCreateArrayCpp( unsigned int length, void *ot );
 void qasReleaseArrayCpp( CScriptArrayInterface *arr );
@@ -67,10 +67,14 @@ int QAS_Init( void ) {
 	srand( time( NULL ) );
 
 	QAS_InitAngelExport();
+
+	qasProfilerInit();
 	return 1;
 }
 
 void QAS_ShutDown( void ) {
+	qasProfilerShutdown();
+
 	QAS_MemFreePool( &angelwrappool );
 }
 
@@ -0,0 +1,341 @@
+/*
+Copyright (C) 2017 Warsow development team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "qas_precompiled.h"
+
+#include <map>
+#include <vector>
+#include <algorithm>
+
+// The profiler hooks the line callback of contexts while as_profile is set.
+// Every statement boundary charges the time elapsed since the previous one to
+// the call stack that was active then: exclusively to the topmost function and
+// inclusively to every distinct function below it. Call stacks are additionally
+// sampled every as_profile_sampleInterval microseconds and kept as folded stacks
+// that can be fed to flamegraph.pl and compatible tools.
+//
+// When the profiler is disabled the only cost is a cvar check per acquired context.
+
+typedef struct {
+	std::string name;
+	asIScriptEngine *engine;
+	uint64_t calls;
+	uint64_t inclusive;
+	uint64_t exclusive;
+} qasprofilefunc_t;
+
+typedef std::vector<asIScriptFunction *> qasProfileStack;
+
+typedef struct {
+	uint64_t lastTime;
+	qasProfileStack stack;
+} qasprofilecontext_t;
+
+typedef std::map<asIScriptFunction *, qasprofilefunc_t> qasProfileFuncMap;
+typedef std::map<asIScriptContext *, qasprofilecontext_t> qasProfileContextMap;
+typedef std::map<std::string, uint64_t> qasProfileSampleMap;
+
+static cvar_t *as_profile;
+static cvar_t *as_profile_sampleInterval;
+
+static qasProfileFuncMap profileFuncs;
+static qasProfileContextMap profileContexts;
+static qasProfileSampleMap profileSamples;
+
+static uint64_t profileNextSampleTime;
+static uint64_t profileNumAcquires, profileNumReuses;
+
+/*
+* qasProfilerFindFunc
+*/
+static qasprofilefunc_t *qasProfilerFindFunc( asIScriptFunction *func ) {
+	qasProfileFuncMap::iterator it = profileFuncs.find( func );
+	if( it != profileFuncs.end() ) {
+		return &it->second;
+	}
+
+	// keep the function alive so the pointer can't be recycled by a newly built module
+	func->AddRef();
+
+	qasprofilefunc_t &pf = profileFuncs[func];
+	const char *moduleName = func->GetModuleName();
+	if( moduleName ) {
+		pf.name = moduleName;
+		pf.name += "::";
+	}
+	pf.name += func->GetDeclaration( true, true );
+	pf.engine = func->GetEngine();
+	pf.calls = pf.inclusive = pf.exclusive = 0;
+	return &pf;
+}
+
+/*
+* qasProfilerCharge
+*/
+static void qasProfilerCharge( const qasProfileStack &stack, uint64_t time ) {
+	size_t i, j;
+
+	if( stack.empty() ) {
+		return;
+	}
+
+	qasProfilerFindFunc( stack.back() )->exclusive += time;
+
+	for( i = 0; i < stack.size(); i++ ) {
+		// recursive calls must not count the same time twice
+		for( j = 0; j < i; j++ ) {
+			if( stack[j] == stack[i] ) {
+				break;
+			}
+		}
+		if( j == i ) {
+			qasProfilerFindFunc( stack[i] )->inclusive += time;
+		}
+	}
+}
+
+/*
+* qasProfilerSample
+*/
+static void qasProfilerSample( const qasProfileStack &stack ) {
+	std::string folded;
+
+	for( size_t i = 0; i < stack.size(); i++ ) {
+		if( i ) {
+			folded += ';';
+		}
+		folded += qasProfilerFindFunc( stack[i] )->name;
+	}
+
+	profileSamples[folded]++;
+}
+
+/*
+* qasProfilerLineCallback
+*/
+static void qasProfilerLineCallback( asIScriptContext *ctx, void *param ) {
+	qasprofilecontext_t *pc = ( qasprofilecontext_t * )param;
+	qasProfileStack &stack = pc->stack;
+	asUINT i, size, common;
+	uint64_t now;
+
+	if( !as_profile->integer ) {
+		return;
+	}
+
+	now = trap_Microseconds();
+	if( pc->lastTime ) {
+		qasProfilerCharge( stack, now - pc->lastTime );
+	}
+	pc->lastTime = now;
+
+	// compare the new call stack to the previous one, frames above the common base are new calls
+	size = ctx->GetCallstackSize();
+	for( common = 0; common < size && common < stack.size(); common++ ) {
+		if( ctx->GetFunction( size - 1 - common ) != stack[common] ) {
+			break;
+		}
+	}
+
+	// a function returning and being called again between two statements at the same depth
+	// is indistinguishable from staying inside it, so call counts are a lower bound
+	stack.resize( size );
+	for( i = common; i < size; i++ ) {
+		stack[i] = ctx->GetFunction( size - 1 - i );
+		qasProfilerFindFunc( stack[i] )->calls++;
+	}
+
+	if( now >= profileNextSampleTime ) {
+		qasProfilerSample( stack );
+		profileNextSampleTime = now + (uint64_t)std::max( as_profile_sampleInterval->integer, 1 );
+	}
+}
+
+/*
+* qasProfilerAcquireContext
+*/
+void qasProfilerAcquireContext( asIScriptContext *ctx, bool reused ) {
+	if( !as_profile->integer ) {
+		// unhook contexts left from a previous profiling session
+		if( !profileContexts.empty() ) {
+			qasProfileContextMap::iterator it = profileContexts.find( ctx );
+			if( it != profileContexts.end() ) {
+				ctx->ClearLineCallback();
+				profileContexts.erase( it );
+			}
+		}
+		return;
+	}
+
+	profileNumAcquires++;
+	if( reused ) {
+		profileNumReuses++;
+	}
+
+	qasProfileContextMap::iterator it = profileContexts.find( ctx );
+	if( it == profileContexts.end() ) {
+		qasprofilecontext_t &pc = profileContexts[ctx];
+		pc.lastTime = 0;
+		ctx->SetLineCallback( asFUNCTION( qasProfilerLineCallback ), &pc, asCALL_CDECL );
+		return;
+	}
+
+	// a new execution starts, time passed since the previous one does not belong to any function
+	it->second.lastTime = 0;
+	it->second.stack.clear();
+}
+
+/*
+* qasProfilerReleaseContext
+*/
+void qasProfilerReleaseContext( asIScriptContext *ctx ) {
+	profileContexts.erase( ctx );
+}
+
+/*
+* qasProfilerReleaseEngine
+*/
+void qasProfilerReleaseEngine( asIScriptEngine *engine ) {
+	for( qasProfileFuncMap::iterator it = profileFuncs.begin(); it != profileFuncs.end(); ) {
+		if( it->second.engine == engine ) {
+			it->first->Release();
+			profileFuncs.erase( it++ );
+		} else {
+			++it;
+		}
+	}
+
+	for( qasProfileContextMap::iterator it = profileContexts.begin(); it != profileContexts.end(); ) {
+		if( it->first->GetEngine() == engine ) {
+			profileContexts.erase( it++ );
+		} else {
+			++it;
+		}
+	}
+}
+
+/*
+* qasProfilerReset
+*/
+static void qasProfilerReset( void ) {
+	for( qasProfileFuncMap::iterator it = profileFuncs.begin(); it != profileFuncs.end(); ++it ) {
+		it->first->Release();
+	}
+	profileFuncs.clear();
+	profileSamples.clear();
+
+	// functions on the call stacks of running contexts are looked up again on the next statement
+	for( qasProfileContextMap::iterator it = profileContexts.begin(); it != profileContexts.end(); ++it ) {
+		it->second.lastTime = 0;
+		it->second.stack.clear();
+	}
+
+	profileNumAcquires = profileNumReuses = 0;
+	profileNextSampleTime = 0;
+}
+
+static bool qasProfilerCompareFuncs( const qasprofilefunc_t *f1, const qasprofilefunc_t *f2 ) {
+	return f1->inclusive > f2->inclusive;
+}
+
+/*
+* qasProfilerWriteFoldedStacks
+*/
+static void qasProfilerWriteFoldedStacks( const char *filename ) {
+	int filenum;
+	char count[32];
+
+	if( trap_FS_FOpenFile( filename, &filenum, FS_WRITE ) == -1 ) {
+		QAS_Printf( S_COLOR_RED "Couldn't open %s for writing\n", filename );
+		return;
+	}
+
+	for( qasProfileSampleMap::iterator it = profileSamples.begin(); it != profileSamples.end(); ++it ) {
+		Q_snprintfz( count, sizeof( count ), " %" PRIu64 "\n", it->second );
+		trap_FS_Write( it->first.c_str(), it->first.size(), filenum );
+		trap_FS_Write( count, strlen( count ), filenum );
+	}
+
+	trap_FS_FCloseFile( filenum );
+
+	QAS_Printf( "Wrote %i sampled stacks to %s\n", (int)profileSamples.size(), filename );
+}
+
+/*
+* qasProfilerDump_f
+*/
+static void qasProfilerDump_f( void ) {
+	std::vector<const qasprofilefunc_t *> funcs;
+
+	for( qasProfileFuncMap::iterator it = profileFuncs.begin(); it != profileFuncs.end(); ++it ) {
+		funcs.push_back( &it->second );
+	}
+	std::sort( funcs.begin(), funcs.end(), qasProfilerCompareFuncs );
+
+	QAS_Printf( "%10s %10s %10s %10s  %s\n", "calls", "incl ms", "excl ms", "us/call", "function" );
+	for( size_t i = 0; i < funcs.size(); i++ ) {
+		const qasprofilefunc_t *pf = funcs[i];
+		QAS_Printf( "%10" PRIu64 " %10.2f %10.2f %10.2f  %s\n", pf->calls,
+					pf->inclusive * 0.001, pf->exclusive * 0.001,
+					pf->calls ? (double)pf->inclusive / pf->calls : 0.0, pf->name.c_str() );
+	}
+
+	QAS_Printf( "%" PRIu64 " contexts acquired, %.1f%% reused\n", profileNumAcquires,
+				profileNumAcquires ? 100.0 * profileNumReuses / profileNumAcquires : 0.0 );
+
+	if( trap_Cmd_Argc() > 1 ) {
+		char filename[MAX_QPATH];
+
+		Q_strncpyz( filename, trap_Cmd_Argv( 1 ), sizeof( filename ) );
+		COM_DefaultExtension( filename, ".folded", sizeof( filename ) );
+		qasProfilerWriteFoldedStacks( filename );
+	}
+}
+
+/*
+* qasProfilerReset_f
+*/
+static void qasProfilerReset_f( void ) {
+	qasProfilerReset();
+}
+
+/*
+* qasProfilerInit
+*/
+void qasProfilerInit( void ) {
+	as_profile = trap_Cvar_Get( "as_profile", "0", 0 );
+	as_profile_sampleInterval = trap_Cvar_Get( "as_profile_sampleInterval", "100", CVAR_ARCHIVE );
+
+	trap_Cmd_AddCommand( "as_profile_dump", qasProfilerDump_f );
+	trap_Cmd_AddCommand( "as_profile_reset", qasProfilerReset_f );
+}
+
+/*
+* qasProfilerShutdown
+*/
+void qasProfilerShutdown( void ) {
+	trap_Cmd_RemoveCommand( "as_profile_dump" );
+	trap_Cmd_RemoveCommand( "as_profile_reset" );
+
+	// engines are expected to be released by now, so don't touch the remaining functions
+	profileFuncs.clear();
+	profileContexts.clear();
+	profileSamples.clear();
+}
@@ -21,7 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef __QAS_PUBLIC_H__
 #define __QAS_PUBLIC_H__
 
-#define ANGELWRAP_API_VERSION   15
+#define ANGELWRAP_API_VERSION   16
 
 typedef struct {
 	void ( *Print )( const char *msg );
@@ -33,6 +33,7 @@ typedef struct {
 #endif
 
 	int64_t ( *Milliseconds )( void );
+	uint64_t ( *Microseconds )( void );
 
 	// console variable interaction
 	cvar_t *( *Cvar_Get )( const char *name, const char *value, int flags );
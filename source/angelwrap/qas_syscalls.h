@@ -45,6 +45,10 @@ static inline int64_t trap_Milliseconds( void ) {
 	return ANGELWRAP_IMPORT.Milliseconds();
 }
 
+static inline uint64_t trap_Microseconds( void ) {
+	return ANGELWRAP_IMPORT.Microseconds();
+}
+
 static inline cvar_t *trap_Cvar_Get( const char *name, const char *value, int flags ) {
 	return ANGELWRAP_IMPORT.Cvar_Get( name, value, flags );
 }
@@ -81,11 +85,11 @@ static inline char *trap_Cmd_Args( void ) {
 	return ANGELWRAP_IMPORT.Cmd_Args();
 }
 
-static inline void trap_Cmd_AddCommand( char *name, void ( *cmd )( void ) ) {
+static inline void trap_Cmd_AddCommand( const char *name, void ( *cmd )( void ) ) {
 	ANGELWRAP_IMPORT.Cmd_AddCommand( name, cmd );
 }
 
-static inline void trap_Cmd_RemoveCommand( char *cmd_name ) {
+static inline void trap_Cmd_RemoveCommand( const char *cmd_name ) {
 	ANGELWRAP_IMPORT.Cmd_RemoveCommand( cmd_name );
 }
 
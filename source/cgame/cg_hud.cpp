@@ -1639,8 +1639,9 @@ static opFunc_t CG_OperatorFuncForArgument( const char *token ) {
 
 //=============================================================================
 
-static const char *CG_GetStringArg( struct cg_layoutnode_s **argumentsnode );
-static float CG_GetNumericArg( struct cg_layoutnode_s **argumentsnode );
+static const char *CG_GetStringArg( struct cg_layoutarg_s **argumentsnode );
+static float CG_GetNumericArg( struct cg_layoutarg_s **argumentsnode );
+static struct shader_s *CG_GetShaderArg( struct cg_layoutarg_s **argumentsnode );
 
 //=============================================================================
 
@@ -1673,7 +1674,7 @@ enum
 //=============================================================================
 // Commands' Functions
 //=============================================================================
-static bool CG_LFuncDrawTimer( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawTimer( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	char time[64];
 	int min, sec, milli;
 
@@ -1694,7 +1695,7 @@ static bool CG_LFuncDrawTimer( struct cg_layoutnode_s *commandnode, struct cg_la
 	return true;
 }
 
-static bool CG_LFuncDrawPicVar( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawPicVar( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int min, max, val, firstimg, lastimg, imgcount;
 	static char filefmt[MAX_QPATH], filenm[MAX_QPATH], *ptr;
 	int x, y, filenr;
@@ -1771,7 +1772,7 @@ static bool CG_LFuncDrawPicVar( struct cg_layoutnode_s *commandnode, struct cg_l
 	return true;
 }
 
-static bool CG_LFuncDrawPicByIndex( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawPicByIndex( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int value = (int)CG_GetNumericArg( &argumentnode );
 	int x, y;
 
@@ -1787,7 +1788,7 @@ static bool CG_LFuncDrawPicByIndex( struct cg_layoutnode_s *commandnode, struct
 	return false;
 }
 
-static bool CG_LFuncDrawPicByItemIndex( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawPicByItemIndex( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int itemindex = (int)CG_GetNumericArg( &argumentnode );
 	int x, y;
 	gsitem_t    *item;
@@ -1802,16 +1803,16 @@ static bool CG_LFuncDrawPicByItemIndex( struct cg_layoutnode_s *commandnode, str
 	return true;
 }
 
-static bool CG_LFuncDrawPicByName( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawPicByName( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int x, y;
 
 	x = CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width );
 	y = CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height );
-	trap_R_DrawStretchPic( x, y, layout_cursor_width, layout_cursor_height, 0, 0, 1, 1, layout_cursor_color, trap_R_RegisterPic( CG_GetStringArg( &argumentnode ) ) );
+	trap_R_DrawStretchPic( x, y, layout_cursor_width, layout_cursor_height, 0, 0, 1, 1, layout_cursor_color, CG_GetShaderArg( &argumentnode ) );
 	return true;
 }
 
-static bool CG_LFuncDrawSubPicByName( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawSubPicByName( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int x, y;
 	struct shader_s *shader;
 	float s1, t1, s2, t2;
@@ -1819,7 +1820,7 @@ static bool CG_LFuncDrawSubPicByName( struct cg_layoutnode_s *commandnode, struc
 	x = CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width );
 	y = CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height );
 
-	shader = trap_R_RegisterPic( CG_GetStringArg( &argumentnode ) );
+	shader = CG_GetShaderArg( &argumentnode );
 
 	s1 = CG_GetNumericArg( &argumentnode );
 	t1 = CG_GetNumericArg( &argumentnode );
@@ -1830,7 +1831,7 @@ static bool CG_LFuncDrawSubPicByName( struct cg_layoutnode_s *commandnode, struc
 	return true;
 }
 
-static bool CG_LFuncDrawRotatedPicByName( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawRotatedPicByName( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int x, y;
 	struct shader_s *shader;
 	float angle;
@@ -1838,7 +1839,7 @@ static bool CG_LFuncDrawRotatedPicByName( struct cg_layoutnode_s *commandnode, s
 	x = CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width );
 	y = CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height );
 
-	shader = trap_R_RegisterPic( CG_GetStringArg( &argumentnode ) );
+	shader = CG_GetShaderArg( &argumentnode );
 
 	angle = CG_GetNumericArg( &argumentnode );
 
@@ -1846,7 +1847,7 @@ static bool CG_LFuncDrawRotatedPicByName( struct cg_layoutnode_s *commandnode, s
 	return true;
 }
 
-static bool CG_LFuncDrawModelByIndex( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawModelByIndex( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	struct model_s *model;
 	int value = (int)CG_GetNumericArg( &argumentnode );
 
@@ -1859,7 +1860,7 @@ static bool CG_LFuncDrawModelByIndex( struct cg_layoutnode_s *commandnode, struc
 	return false;
 }
 
-static bool CG_LFuncDrawModelByName( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawModelByName( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	struct model_s *model;
 	struct shader_s *shader;
 	const char *shadername;
@@ -1871,7 +1872,7 @@ static bool CG_LFuncDrawModelByName( struct cg_layoutnode_s *commandnode, struct
 	return true;
 }
 
-static bool CG_LFuncDrawModelByItemIndex( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawModelByItemIndex( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int i;
 	gsitem_t    *item;
 	struct model_s *model;
@@ -1890,7 +1891,7 @@ static bool CG_LFuncDrawModelByItemIndex( struct cg_layoutnode_s *commandnode, s
 	return true;
 }
 
-static bool CG_LFuncScale( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncScale( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	layout_cursor_scale = (int)CG_GetNumericArg( &argumentnode );
 	return true;
 }
@@ -1898,7 +1899,7 @@ static bool CG_LFuncScale( struct cg_layoutnode_s *commandnode, struct cg_layout
 #define SCALE_X( n ) ( ( layout_cursor_scale == NOSCALE ) ? ( n ) : ( ( layout_cursor_scale == SCALEBYHEIGHT ) ? ( n ) * cgs.vidHeight / 600.0f : ( n ) * cgs.vidWidth / 800.0f ) )
 #define SCALE_Y( n ) ( ( layout_cursor_scale == NOSCALE ) ? ( n ) : ( ( layout_cursor_scale == SCALEBYWIDTH ) ? ( n ) * cgs.vidWidth / 800.0f : ( n ) * cgs.vidHeight / 600.0f ) )
 
-static bool CG_LFuncCursor( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncCursor( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	float x, y;
 
 	x = CG_GetNumericArg( &argumentnode );
@@ -1911,7 +1912,7 @@ static bool CG_LFuncCursor( struct cg_layoutnode_s *commandnode, struct cg_layou
 	return true;
 }
 
-static bool CG_LFuncCursorX( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncCursorX( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	float x;
 
 	x = CG_GetNumericArg( &argumentnode );
@@ -1921,7 +1922,7 @@ static bool CG_LFuncCursorX( struct cg_layoutnode_s *commandnode, struct cg_layo
 	return true;
 }
 
-static bool CG_LFuncCursorY( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncCursorY( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	float y;
 
 	y = CG_GetNumericArg( &argumentnode );
@@ -1931,7 +1932,7 @@ static bool CG_LFuncCursorY( struct cg_layoutnode_s *commandnode, struct cg_layo
 	return true;
 }
 
-static bool CG_LFuncMoveCursor( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncMoveCursor( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	float x, y;
 
 	x = CG_GetNumericArg( &argumentnode );
@@ -1944,7 +1945,7 @@ static bool CG_LFuncMoveCursor( struct cg_layoutnode_s *commandnode, struct cg_l
 	return true;
 }
 
-static bool CG_LFuncSize( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncSize( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	float x, y;
 
 	x = CG_GetNumericArg( &argumentnode );
@@ -1957,7 +1958,7 @@ static bool CG_LFuncSize( struct cg_layoutnode_s *commandnode, struct cg_layoutn
 	return true;
 }
 
-static bool CG_LFuncSizeWidth( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncSizeWidth( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	float x;
 
 	x = CG_GetNumericArg( &argumentnode );
@@ -1967,7 +1968,7 @@ static bool CG_LFuncSizeWidth( struct cg_layoutnode_s *commandnode, struct cg_la
 	return true;
 }
 
-static bool CG_LFuncSizeHeight( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncSizeHeight( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	float y;
 
 	y = CG_GetNumericArg( &argumentnode );
@@ -1977,7 +1978,7 @@ static bool CG_LFuncSizeHeight( struct cg_layoutnode_s *commandnode, struct cg_l
 	return true;
 }
 
-static bool CG_LFuncColor( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncColor( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int i;
 	for( i = 0; i < 4; i++ ) {
 		layout_cursor_color[i] = CG_GetNumericArg( &argumentnode );
@@ -1986,17 +1987,17 @@ static bool CG_LFuncColor( struct cg_layoutnode_s *commandnode, struct cg_layout
 	return true;
 }
 
-static bool CG_LFuncColorToTeamColor( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncColorToTeamColor( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	CG_TeamColor( CG_GetNumericArg( &argumentnode ), layout_cursor_color );
 	return true;
 }
 
-static bool CG_LFuncColorAlpha( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncColorAlpha( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	layout_cursor_color[3] = CG_GetNumericArg( &argumentnode );
 	return true;
 }
 
-static bool CG_LFuncRotationSpeed( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncRotationSpeed( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int i;
 	for( i = 0; i < 3; i++ ) {
 		layout_cursor_rotation[i] = CG_GetNumericArg( &argumentnode );
@@ -2005,7 +2006,7 @@ static bool CG_LFuncRotationSpeed( struct cg_layoutnode_s *commandnode, struct c
 	return true;
 }
 
-static bool CG_LFuncAlign( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncAlign( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int v, h;
 
 	h = (int)CG_GetNumericArg( &argumentnode );
@@ -2020,8 +2021,26 @@ static bool CG_LFuncAlign( struct cg_layoutnode_s *commandnode, struct cg_layout
 	return true;
 }
 
+// HUD scripts switch between a handful of fonts many times per frame, so remember
+// the faces instead of looking them up by name on every switch
+#define MAX_LAYOUT_FONTS 16
+
+typedef struct
+{
+	struct qfontface_s *( *regfunc )( const char *, int, unsigned int );
+	char name[MAX_QPATH];
+	int style;
+	int size;
+	struct qfontface_s *font;
+} cg_layoutfont_t;
+
+static cg_layoutfont_t layout_fonts[MAX_LAYOUT_FONTS];
+static int layout_num_fonts;
+
 static struct qfontface_s *CG_GetLayoutCursorFont( void ) {
+	int i;
 	struct qfontface_s *font;
+	cg_layoutfont_t *cached;
 
 	if( !layout_cursor_font_dirty ) {
 		return layout_cursor_font;
@@ -2030,9 +2049,26 @@ static struct qfontface_s *CG_GetLayoutCursorFont( void ) {
 		layout_cursor_font_regfunc = trap_SCR_RegisterFont;
 	}
 
+	for( i = 0; i < layout_num_fonts; i++ ) {
+		cached = &layout_fonts[i];
+		if( cached->regfunc == layout_cursor_font_regfunc && cached->style == layout_cursor_font_style
+			&& cached->size == layout_cursor_font_size && !strcmp( cached->name, layout_cursor_font_name ) ) {
+			layout_cursor_font = cached->font;
+			layout_cursor_font_dirty = false;
+			return layout_cursor_font;
+		}
+	}
+
 	font = layout_cursor_font_regfunc( layout_cursor_font_name, layout_cursor_font_style, layout_cursor_font_size );
 	if( font ) {
 		layout_cursor_font = font;
+
+		cached = &layout_fonts[layout_num_fonts < MAX_LAYOUT_FONTS ? layout_num_fonts++ : MAX_LAYOUT_FONTS - 1];
+		cached->regfunc = layout_cursor_font_regfunc;
+		Q_strncpyz( cached->name, layout_cursor_font_name, sizeof( cached->name ) );
+		cached->style = layout_cursor_font_style;
+		cached->size = layout_cursor_font_size;
+		cached->font = font;
 	} else {
 		layout_cursor_font = cgs.fontSystemSmall;
 	}
@@ -2041,7 +2077,7 @@ static struct qfontface_s *CG_GetLayoutCursorFont( void ) {
 	return layout_cursor_font;
 }
 
-static bool CG_LFuncFontFamily( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncFontFamily( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	const char *fontname = CG_GetStringArg( &argumentnode );
 
 	if( !Q_stricmp( fontname, "con_fontSystem" ) ) {
@@ -2057,7 +2093,7 @@ static bool CG_LFuncFontFamily( struct cg_layoutnode_s *commandnode, struct cg_l
 	return true;
 }
 
-static bool CG_LFuncSpecialFontFamily( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncSpecialFontFamily( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	const char *fontname = CG_GetStringArg( &argumentnode );
 
 	Q_strncpyz( layout_cursor_font_name, fontname, sizeof( layout_cursor_font_name ) );
@@ -2067,8 +2103,8 @@ static bool CG_LFuncSpecialFontFamily( struct cg_layoutnode_s *commandnode, stru
 	return true;
 }
 
-static bool CG_LFuncFontSize( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
-	struct cg_layoutnode_s *charnode = argumentnode;
+static bool CG_LFuncFontSize( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
+	struct cg_layoutarg_s *charnode = argumentnode;
 	const char *fontsize = CG_GetStringArg( &charnode );
 
 	if( !Q_stricmp( fontsize, "con_fontsystemsmall" ) ) {
@@ -2088,7 +2124,7 @@ static bool CG_LFuncFontSize( struct cg_layoutnode_s *commandnode, struct cg_lay
 	return true;
 }
 
-static bool CG_LFuncFontStyle( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncFontStyle( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	const char *fontstyle = CG_GetStringArg( &argumentnode );
 
 	if( !Q_stricmp( fontstyle, "normal" ) ) {
@@ -2109,7 +2145,7 @@ static bool CG_LFuncFontStyle( struct cg_layoutnode_s *commandnode, struct cg_la
 	return true;
 }
 
-static bool CG_LFuncDrawObituaries( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawObituaries( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int internal_align = (int)CG_GetNumericArg( &argumentnode );
 	int icon_size = (int)CG_GetNumericArg( &argumentnode );
 
@@ -2118,12 +2154,12 @@ static bool CG_LFuncDrawObituaries( struct cg_layoutnode_s *commandnode, struct
 	return true;
 }
 
-static bool CG_LFuncDrawAwards( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawAwards( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	CG_DrawAwards( layout_cursor_x, layout_cursor_y, layout_cursor_align, CG_GetLayoutCursorFont(), layout_cursor_color );
 	return true;
 }
 
-static bool CG_LFuncDrawClock( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawClock( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	CG_DrawClock( layout_cursor_x, layout_cursor_y, layout_cursor_align, CG_GetLayoutCursorFont(), layout_cursor_color );
 	return true;
 }
@@ -2132,7 +2168,7 @@ static bool CG_LFuncDrawClock( struct cg_layoutnode_s *commandnode, struct cg_la
 #define HELPMESSAGE_OVERSHOOT_FREQUENCY 6.0f
 #define HELPMESSAGE_OVERSHOOT_DECAY 10.0f
 
-static bool CG_LFuncDrawHelpMessage( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawHelpMessage( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	// hide this one when scoreboard is up
 	if( !CG_IsScoreboardShown() ) {
 		if( !cgs.demoPlaying ) {
@@ -2193,17 +2229,17 @@ static bool CG_LFuncDrawHelpMessage( struct cg_layoutnode_s *commandnode, struct
 	return true;
 }
 
-static bool CG_LFuncDrawTeamMates( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawTeamMates( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	CG_DrawTeamMates();
 	return true;
 }
 
-static bool CG_LFuncDrawPointed( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawPointed( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	CG_DrawPlayerNames( CG_GetLayoutCursorFont(), layout_cursor_color );
 	return true;
 }
 
-static bool CG_LFuncDrawString( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawString( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	const char *string = CG_GetStringArg( &argumentnode );
 
 	if( !string || !string[0] ) {
@@ -2244,13 +2280,13 @@ static bool CG_LFuncDrawStringRepeat_x( const char *string, int num_draws ) {
 	return true;
 }
 
-static bool CG_LFuncDrawStringRepeat( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawStringRepeat( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	const char *string = CG_GetStringArg( &argumentnode );
 	int num_draws = CG_GetNumericArg( &argumentnode );
 	return CG_LFuncDrawStringRepeat_x( string, num_draws );
 }
 
-static bool CG_LFuncDrawStringRepeatConfigString( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawStringRepeatConfigString( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	const char *string = CG_GetStringArg( &argumentnode );
 	int index = (int)CG_GetNumericArg( &argumentnode );
 
@@ -2263,7 +2299,7 @@ static bool CG_LFuncDrawStringRepeatConfigString( struct cg_layoutnode_s *comman
 	return CG_LFuncDrawStringRepeat_x( string, num_draws );
 }
 
-static bool CG_LFuncDrawItemNameFromIndex( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawItemNameFromIndex( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	gsitem_t    *item;
 	int itemindex = CG_GetNumericArg( &argumentnode );
 
@@ -2276,7 +2312,7 @@ static bool CG_LFuncDrawItemNameFromIndex( struct cg_layoutnode_s *commandnode,
 	return true;
 }
 
-static bool CG_LFuncDrawConfigstring( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawConfigstring( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int index = (int)CG_GetNumericArg( &argumentnode );
 
 	if( index < 0 || index >= MAX_CONFIGSTRINGS ) {
@@ -2288,7 +2324,7 @@ static bool CG_LFuncDrawConfigstring( struct cg_layoutnode_s *commandnode, struc
 	return true;
 }
 
-static bool CG_LFuncDrawCleanConfigstring( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawCleanConfigstring( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int index = (int)CG_GetNumericArg( &argumentnode );
 
 	if( index < 0 || index >= MAX_CONFIGSTRINGS ) {
@@ -2300,7 +2336,7 @@ static bool CG_LFuncDrawCleanConfigstring( struct cg_layoutnode_s *commandnode,
 	return true;
 }
 
-static bool CG_LFuncDrawPlayerName( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawPlayerName( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int index = (int)CG_GetNumericArg( &argumentnode ) - 1;
 
 	if( cgs.demoTutorial ) {
@@ -2318,7 +2354,7 @@ static bool CG_LFuncDrawPlayerName( struct cg_layoutnode_s *commandnode, struct
 	return false;
 }
 
-static bool CG_LFuncDrawCleanPlayerName( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawCleanPlayerName( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int index = (int)CG_GetNumericArg( &argumentnode ) - 1;
 
 	if( cgs.demoTutorial ) {
@@ -2333,13 +2369,13 @@ static bool CG_LFuncDrawCleanPlayerName( struct cg_layoutnode_s *commandnode, st
 	return false;
 }
 
-static bool CG_LFuncDrawNumeric( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawNumeric( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int value = (int)CG_GetNumericArg( &argumentnode );
 	CG_DrawHUDNumeric( layout_cursor_x, layout_cursor_y, layout_cursor_align, layout_cursor_color, layout_cursor_width, layout_cursor_height, value );
 	return true;
 }
 
-static bool CG_LFuncDrawStretchNum( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawStretchNum( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	static char num[16];
 	int len;
 	int value = (int)CG_GetNumericArg( &argumentnode );
@@ -2354,14 +2390,14 @@ static bool CG_LFuncDrawStretchNum( struct cg_layoutnode_s *commandnode, struct
 	return true;
 }
 
-static bool CG_LFuncDrawNumeric2( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawNumeric2( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int value = (int)CG_GetNumericArg( &argumentnode );
 
 	trap_SCR_DrawString( layout_cursor_x, layout_cursor_y, layout_cursor_align, va( "%i", value ), CG_GetLayoutCursorFont(), layout_cursor_color );
 	return true;
 }
 
-static bool CG_LFuncDrawBar( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawBar( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int value = (int)CG_GetNumericArg( &argumentnode );
 	int maxvalue = (int)CG_GetNumericArg( &argumentnode );
 	CG_DrawHUDRect( layout_cursor_x, layout_cursor_y, layout_cursor_align,
@@ -2370,17 +2406,17 @@ static bool CG_LFuncDrawBar( struct cg_layoutnode_s *commandnode, struct cg_layo
 	return true;
 }
 
-static bool CG_LFuncDrawPicBar( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawPicBar( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int value = (int)CG_GetNumericArg( &argumentnode );
 	int maxvalue = (int)CG_GetNumericArg( &argumentnode );
 
 	CG_DrawHUDRect( layout_cursor_x, layout_cursor_y, layout_cursor_align,
 					layout_cursor_width, layout_cursor_height, value, maxvalue,
-					layout_cursor_color, trap_R_RegisterPic( CG_GetStringArg( &argumentnode ) ) );
+					layout_cursor_color, CG_GetShaderArg( &argumentnode ) );
 	return true;
 }
 
-static bool CG_LFuncDrawWeaponIcon( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawWeaponIcon( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int weapon = cg.predictedPlayerState.stats[STAT_WEAPON];
 	int x, y;
 
@@ -2394,7 +2430,7 @@ static bool CG_LFuncDrawWeaponIcon( struct cg_layoutnode_s *commandnode, struct
 	return true;
 }
 
-static bool CG_LFuncCustomWeaponIcons( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncCustomWeaponIcons( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int weapon = (int)CG_GetNumericArg( &argumentnode );
 	int hasgun = (int)CG_GetNumericArg( &argumentnode );
 
@@ -2411,7 +2447,7 @@ static bool CG_LFuncCustomWeaponIcons( struct cg_layoutnode_s *commandnode, stru
 	return true;
 }
 
-static bool CG_LFuncResetCustomWeaponIcons( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncResetCustomWeaponIcons( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int weapon;
 	for( weapon = 0; weapon < WEAP_TOTAL - 1; weapon++ ) {
 		customWeaponPics[weapon] = NULL;
@@ -2421,12 +2457,12 @@ static bool CG_LFuncResetCustomWeaponIcons( struct cg_layoutnode_s *commandnode,
 	return true;
 }
 
-static bool CG_LFuncCustomWeaponSelect( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncCustomWeaponSelect( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	customWeaponSelectPic = CG_GetStringArg( &argumentnode );
 	return true;
 }
 
-static void CG_LFuncsWeaponIcons( struct cg_layoutnode_s *argumentnode, bool touch ) {
+static void CG_LFuncsWeaponIcons( struct cg_layoutarg_s *argumentnode, bool touch ) {
 	int offx, offy, w, h;
 
 	offx = (int)( CG_GetNumericArg( &argumentnode ) * cgs.vidWidth / 800 );
@@ -2437,17 +2473,17 @@ static void CG_LFuncsWeaponIcons( struct cg_layoutnode_s *argumentnode, bool tou
 	CG_DrawWeaponIcons( layout_cursor_x, layout_cursor_y, offx, offy, w, h, layout_cursor_align, touch );
 }
 
-static bool CG_LFuncDrawWeaponIcons( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawWeaponIcons( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	CG_LFuncsWeaponIcons( argumentnode, false );
 	return true;
 }
 
-static bool CG_LFuncTouchWeaponIcons( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncTouchWeaponIcons( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	CG_LFuncsWeaponIcons( argumentnode, true );
 	return true;
 }
 
-static bool CG_LFuncSetTouchWeaponDropOffset( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncSetTouchWeaponDropOffset( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	float x, y;
 
 	x = CG_GetNumericArg( &argumentnode );
@@ -2460,7 +2496,7 @@ static bool CG_LFuncSetTouchWeaponDropOffset( struct cg_layoutnode_s *commandnod
 	return true;
 }
 
-static bool CG_LFuncDrawWeaponCross( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawWeaponCross( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int ammoofs = (int)( CG_GetNumericArg( &argumentnode ) * cgs.vidHeight / 600 );
 	int ammosize = (int)( CG_GetNumericArg( &argumentnode ) * cgs.vidHeight / 600 );
 	int ammopass;
@@ -2479,12 +2515,12 @@ static bool CG_LFuncDrawWeaponCross( struct cg_layoutnode_s *commandnode, struct
 	return true;
 }
 
-static bool CG_LFuncDrawCaptureAreas( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawCaptureAreas( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	// FIXME: DELETE ME
 	return true;
 }
 
-static bool CG_LFuncDrawMiniMap( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawMiniMap( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	bool draw_playernames, draw_itemnames;
 
 	draw_playernames = (int)( CG_GetNumericArg( &argumentnode ) ) == 0 ? false : true;
@@ -2495,7 +2531,7 @@ static bool CG_LFuncDrawMiniMap( struct cg_layoutnode_s *commandnode, struct cg_
 	return true;
 }
 
-static bool CG_LFuncDrawLocationName( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawLocationName( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int loc_tag = CG_GetNumericArg( &argumentnode );
 	char string[MAX_CONFIGSTRING_CHARS];
 
@@ -2509,7 +2545,7 @@ static bool CG_LFuncDrawLocationName( struct cg_layoutnode_s *commandnode, struc
 	return true;
 }
 
-static bool CG_LFuncDrawWeaponWeakAmmo( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawWeaponWeakAmmo( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int offx, offy, fontsize;
 
 	offx = (int)( CG_GetNumericArg( &argumentnode ) * cgs.vidWidth / 800 );
@@ -2521,7 +2557,7 @@ static bool CG_LFuncDrawWeaponWeakAmmo( struct cg_layoutnode_s *commandnode, str
 	return true;
 }
 
-static bool CG_LFuncDrawWeaponStrongAmmo( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawWeaponStrongAmmo( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int offx, offy, fontsize;
 
 	offx = (int)( CG_GetNumericArg( &argumentnode ) * cgs.vidWidth / 800 );
@@ -2533,35 +2569,35 @@ static bool CG_LFuncDrawWeaponStrongAmmo( struct cg_layoutnode_s *commandnode, s
 	return true;
 }
 
-static bool CG_LFuncDrawTeamInfo( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawTeamInfo( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	CG_DrawTeamInfo( layout_cursor_x, layout_cursor_y, layout_cursor_align, CG_GetLayoutCursorFont(), layout_cursor_color );
 	return true;
 }
 
-static bool CG_LFuncDrawCrossHair( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawCrossHair( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	CG_DrawCrosshair( layout_cursor_x, layout_cursor_y, layout_cursor_align );
 	return true;
 }
 
-static bool CG_LFuncDrawKeyState( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawKeyState( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	const char *key = CG_GetStringArg( &argumentnode );
 
 	CG_DrawKeyState( layout_cursor_x, layout_cursor_y, layout_cursor_width, layout_cursor_height, layout_cursor_align, key );
 	return true;
 }
 
-static bool CG_LFuncDrawNet( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawNet( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	CG_DrawNet( layout_cursor_x, layout_cursor_y, layout_cursor_width, layout_cursor_height, layout_cursor_align, layout_cursor_color );
 	return true;
 }
 
-static bool CG_LFuncDrawChat( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncDrawChat( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int padding_x, padding_y;
 	struct shader_s *shader;
 
 	padding_x = (int)( CG_GetNumericArg( &argumentnode ) ) * cgs.vidWidth / 800;
 	padding_y = (int)( CG_GetNumericArg( &argumentnode ) ) * cgs.vidHeight / 600;
-	shader = trap_R_RegisterPic( CG_GetStringArg( &argumentnode ) );
+	shader = CG_GetShaderArg( &argumentnode );
 
 	CG_DrawChat( &cg.chat, layout_cursor_x, layout_cursor_y, layout_cursor_font_name, CG_GetLayoutCursorFont(), layout_cursor_font_size,
 				 layout_cursor_width, layout_cursor_height, padding_x, padding_y, layout_cursor_color, shader );
@@ -2572,7 +2608,7 @@ static void CG_MoveUpFunc( int id, int64_t time ) {
 	CG_SetTouchpad( TOUCHPAD_MOVE, -1 );
 }
 
-static bool CG_LFuncTouchMove( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncTouchMove( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int touch = CG_TouchArea( TOUCHAREA_HUD_MOVE,
 							  CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width ),
 							  CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height ),
@@ -2608,7 +2644,7 @@ static void CG_ViewUpFunc( int id, int64_t time ) {
 	}
 }
 
-static bool CG_LFuncTouchView( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncTouchView( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int touchID = CG_TouchArea( TOUCHAREA_HUD_VIEW,
 								CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width ),
 								CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height ),
@@ -2640,7 +2676,7 @@ static void CG_UpmoveUpFunc( int id, int64_t time ) {
 	cg_hud_touch_upmove = 0;
 }
 
-static bool CG_LFuncTouchJump( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncTouchJump( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	if( CG_TouchArea( TOUCHAREA_HUD_JUMP,
 					  CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width ),
 					  CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height ),
@@ -2650,7 +2686,7 @@ static bool CG_LFuncTouchJump( struct cg_layoutnode_s *commandnode, struct cg_la
 	return true;
 }
 
-static bool CG_LFuncTouchCrouch( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncTouchCrouch( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	if( CG_TouchArea( TOUCHAREA_HUD_CROUCH,
 					  CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width ),
 					  CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height ),
@@ -2664,7 +2700,7 @@ static void CG_AttackUpFunc( int id, int64_t time ) {
 	cg_hud_touch_buttons &= ~BUTTON_ATTACK;
 }
 
-static bool CG_LFuncTouchAttack( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncTouchAttack( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	if( CG_TouchArea( TOUCHAREA_HUD_ATTACK,
 					  CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width ),
 					  CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height ),
@@ -2678,7 +2714,7 @@ static void CG_SpecialUpFunc( int id, int64_t time ) {
 	cg_hud_touch_buttons &= ~BUTTON_SPECIAL;
 }
 
-static bool CG_LFuncTouchSpecial( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncTouchSpecial( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	if( CG_TouchArea( TOUCHAREA_HUD_SPECIAL,
 					  CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width ),
 					  CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height ),
@@ -2688,7 +2724,7 @@ static bool CG_LFuncTouchSpecial( struct cg_layoutnode_s *commandnode, struct cg
 	return true;
 }
 
-static bool CG_LFuncTouchClassAction( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncTouchClassAction( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	if( CG_TouchArea( TOUCHAREA_HUD_CLASSACTION,
 					  CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width ),
 					  CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height ),
@@ -2698,7 +2734,7 @@ static bool CG_LFuncTouchClassAction( struct cg_layoutnode_s *commandnode, struc
 	return true;
 }
 
-static bool CG_LFuncTouchDropItem( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncTouchDropItem( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	if( CG_TouchArea( TOUCHAREA_HUD_DROPITEM,
 					  CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width ),
 					  CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height ),
@@ -2712,7 +2748,7 @@ static void CG_ScoresUpFunc( int id, int64_t time ) {
 	CG_ScoresOff_f();
 }
 
-static bool CG_LFuncTouchScores( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncTouchScores( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	if( CG_TouchArea( TOUCHAREA_HUD_SCORES,
 					  CG_HorizontalAlignForWidth( layout_cursor_x, layout_cursor_align, layout_cursor_width ),
 					  CG_VerticalAlignForHeight( layout_cursor_y, layout_cursor_align, layout_cursor_height ),
@@ -2728,7 +2764,7 @@ static void CG_QuickMenuUpFunc( int id, int64_t time ) {
 	}
 }
 
-static bool CG_LFuncTouchQuickMenu( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncTouchQuickMenu( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	int side = ( int )CG_GetNumericArg( &argumentnode );
 
 	if( GS_MatchState() < MATCH_STATE_POSTMATCH ) {
@@ -2743,11 +2779,11 @@ static bool CG_LFuncTouchQuickMenu( struct cg_layoutnode_s *commandnode, struct
 }
 
 
-static bool CG_LFuncIf( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncIf( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	return (int)CG_GetNumericArg( &argumentnode ) != 0;
 }
 
-static bool CG_LFuncIfNot( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments ) {
+static bool CG_LFuncIfNot( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments ) {
 	return (int)CG_GetNumericArg( &argumentnode ) == 0;
 }
 
@@ -2755,8 +2791,8 @@ static bool CG_LFuncIfNot( struct cg_layoutnode_s *commandnode, struct cg_layout
 typedef struct cg_layoutcommand_s
 {
 	const char *name;
-	bool ( *func )( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments );
-	bool ( *touchfunc )( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments );
+	bool ( *func )( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments );
+	bool ( *touchfunc )( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments );
 	int numparms;
 	const char *help;
 	bool precache;
@@ -3505,10 +3541,12 @@ void Cmd_CG_PrintHudHelp_f( void ) {
 //=============================================================================
 
 
+typedef bool ( *layoutFunc_t )( struct cg_layoutop_s *commandnode, struct cg_layoutarg_s *argumentnode, int numArguments );
+
 typedef struct cg_layoutnode_s
 {
-	bool ( *func )( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments );
-	bool ( *touchfunc )( struct cg_layoutnode_s *commandnode, struct cg_layoutnode_s *argumentnode, int numArguments );
+	layoutFunc_t func;
+	layoutFunc_t touchfunc;
 	int type;
 	char *string;
 	int integer;
@@ -3520,30 +3558,81 @@ typedef struct cg_layoutnode_s
 	bool precache;
 } cg_layoutnode_t;
 
+// The parsed tree is compiled into a flat program: a linear array of commands, each one
+// pointing to its arguments in a shared array. Every argument list is terminated by a
+// LNODE_COMMAND sentinel so reading too many arguments is still caught. Commands which
+// own an "if" thread store the index of the first command past the thread in skip.
+
+typedef struct cg_layoutarg_s
+{
+	int type;
+	float value;
+	opFunc_t opFunc;
+	const char *string;
+	const reference_numeric_t *reference;
+	struct shader_s *shader;
+} cg_layoutarg_t;
+
+typedef struct cg_layoutop_s
+{
+	layoutFunc_t func;
+	layoutFunc_t touchfunc;
+	const char *name;
+	cg_layoutarg_t *args;
+	int numArgs;
+	int skip;
+} cg_layoutop_t;
+
+typedef struct cg_layoutprogram_s
+{
+	cg_layoutop_t *ops;
+	int numOps;
+	cg_layoutarg_t *args;
+	int numArgs;
+} cg_layoutprogram_t;
+
 /*
 * CG_GetStringArg
 */
-static const char *CG_GetStringArg( struct cg_layoutnode_s **argumentsnode ) {
-	struct cg_layoutnode_s *anode = *argumentsnode;
+static const char *CG_GetStringArg( struct cg_layoutarg_s **argumentsnode ) {
+	struct cg_layoutarg_s *anode = *argumentsnode;
 
-	if( !anode || anode->type == LNODE_COMMAND ) {
+	if( anode->type == LNODE_COMMAND ) {
 		CG_Error( "'CG_LayoutGetIntegerArg': bad arg count" );
 	}
 
 	// we can return anything as string
-	*argumentsnode = anode->next;
+	*argumentsnode = anode + 1;
 	return anode->string;
 }
 
+/*
+* CG_GetShaderArg
+* the shader is registered on first use and kept with the argument
+*/
+static struct shader_s *CG_GetShaderArg( struct cg_layoutarg_s **argumentsnode ) {
+	struct cg_layoutarg_s *anode = *argumentsnode;
+
+	if( anode->type == LNODE_COMMAND ) {
+		CG_Error( "'CG_LayoutGetIntegerArg': bad arg count" );
+	}
+
+	*argumentsnode = anode + 1;
+	if( !anode->shader ) {
+		anode->shader = trap_R_RegisterPic( anode->string );
+	}
+	return anode->shader;
+}
+
 /*
 * CG_GetNumericArg
 * can use recursion for mathematical operations
 */
-static float CG_GetNumericArg( struct cg_layoutnode_s **argumentsnode ) {
-	struct cg_layoutnode_s *anode = *argumentsnode;
+static float CG_GetNumericArg( struct cg_layoutarg_s **argumentsnode ) {
+	struct cg_layoutarg_s *anode = *argumentsnode;
 	float value;
 
-	if( !anode || anode->type == LNODE_COMMAND ) {
+	if( anode->type == LNODE_COMMAND ) {
 		CG_Error( "'CG_LayoutGetIntegerArg': bad arg count" );
 	}
 
@@ -3551,9 +3640,9 @@ static float CG_GetNumericArg( struct cg_layoutnode_s **argumentsnode ) {
 		CG_Printf( "WARNING: 'CG_LayoutGetIntegerArg': arg %s is not numeric", anode->string );
 	}
 
-	*argumentsnode = anode->next;
-	if( anode->type == LNODE_REFERENCE_NUMERIC ) {
-		value = cg_numeric_references[anode->integer].func( cg_numeric_references[anode->integer].parameter );
+	*argumentsnode = anode + 1;
+	if( anode->reference ) {
+		value = anode->reference->func( anode->reference->parameter );
 	} else {
 		value = anode->value;
 	}
@@ -3822,7 +3911,6 @@ static bool CG_LayoutFixCommasInToken( char **ptr, char **backptr ) {
 */
 static cg_layoutnode_t *CG_RecurseParseLayoutScript( char **ptr, int level ) {
 	cg_layoutnode_t *command = NULL;
-	cg_layoutnode_t *argumentnode = NULL;
 	cg_layoutnode_t *node = NULL;
 	cg_layoutnode_t *rootnode = NULL;
 	int expecArgs = 0, numArgs = 0;
@@ -3950,7 +4038,6 @@ static cg_layoutnode_t *CG_RecurseParseLayoutScript( char **ptr, int level ) {
 
 				// move on into the new command
 				command = node;
-				argumentnode = NULL;
 				numArgs = 0;
 				expecArgs = command->integer;
 				add = true;
@@ -3961,27 +4048,11 @@ static cg_layoutnode_t *CG_RecurseParseLayoutScript( char **ptr, int level ) {
 		}
 
 		if( add == true ) {
-			if( command && command == rootnode ) {
-				if( !argumentnode ) {
-					argumentnode = node;
-				}
-			}
-
 			if( rootnode ) {
 				rootnode->next = node;
 			}
 			node->parent = rootnode;
 			rootnode = node;
-
-			// precache arguments by calling the function at load time
-			if( command && expecArgs == numArgs && command->func && command->precache ) {
-				Vector4Set( layout_cursor_color, 0, 0, 0, 0 );
-				layout_cursor_x = -layout_cursor_width - 1;
-				layout_cursor_y = -layout_cursor_height - 1;
-				layout_cursor_width = 0;
-				layout_cursor_height = 0;
-				command->func( command, argumentnode, numArgs );
-			}
 		}
 	}
 
@@ -4016,105 +4087,261 @@ static void CG_RecursePrintLayoutThread( cg_layoutnode_t *rootnode, int level )
 #endif
 
 /*
-* CG_ParseLayoutScript
+* CG_CountLayoutThread
 */
-static void CG_ParseLayoutScript( char *string, cg_layoutnode_t *rootnode ) {
+static void CG_CountLayoutThread( cg_layoutnode_t *rootnode, int *numOps, int *numArgs ) {
+	cg_layoutnode_t *node;
 
-	CG_RecurseFreeLayoutThread( cg.statusBar );
-	cg.statusBar = CG_RecurseParseLayoutScript( &string, 0 );
+	if( !rootnode ) {
+		return;
+	}
 
-#if 0
-	CG_RecursePrintLayoutThread( cg_layoutRootNode, 0 );
-#endif
+	node = rootnode;
+	while( node->parent ) {
+		node = node->parent;
+	}
+
+	for( ; node; node = node->next ) {
+		if( node->type == LNODE_COMMAND ) {
+			// one extra argument for the terminating sentinel
+			( *numOps )++;
+			( *numArgs )++;
+			CG_CountLayoutThread( node->ifthread, numOps, numArgs );
+		} else {
+			( *numArgs )++;
+		}
+	}
 }
 
-//=============================================================================
+/*
+* CG_FoldLayoutArguments
+* operators are evaluated right to left, so a constant tail of an expression
+* can be replaced by its value at load time
+*/
+static int CG_FoldLayoutArguments( cg_layoutarg_t *args, int numArgs ) {
+	int i, j;
 
-//=============================================================================
+	for( i = numArgs - 2; i >= 0; i-- ) {
+		cg_layoutarg_t *a = &args[i], *b = &args[i + 1];
+
+		if( !a->opFunc || b->opFunc ) {
+			continue;
+		}
+		if( a->type != LNODE_NUMERIC || a->reference || b->type != LNODE_NUMERIC || b->reference ) {
+			continue;
+		}
+
+		a->value = a->opFunc( a->value, b->value );
+		a->opFunc = NULL;
+
+		CG_Free( ( void * )b->string );
+		for( j = i + 1; j < numArgs - 1; j++ ) {
+			args[j] = args[j + 1];
+		}
+		numArgs--;
+	}
+
+	return numArgs;
+}
 
 /*
-* CG_RecurseExecuteLayoutThread
-* Execution works like this: First node (on backwards) is expected to be the command, followed by arguments nodes.
-* we keep a pointer to the command and run the tree counting arguments until we reach the next command,
-* then we call the command function sending the pointer to first argument and the pointer to the command.
-* At return we advance one node (we stopped at last argument node) so it starts again from the next command (if any).
-*
-* When finding an "if" command with a subtree, we execute the "if" command. In the case it
-* returns any value, we recurse execute the subtree
+* CG_CompileLayoutThread
+* appends the thread to the program, the string arguments are moved from the nodes to the program
 */
-static void CG_RecurseExecuteLayoutThread( cg_layoutnode_t *rootnode, bool touch ) {
-	cg_layoutnode_t *argumentnode = NULL;
-	cg_layoutnode_t *commandnode = NULL;
+static void CG_CompileLayoutThread( cg_layoutprogram_t *program, cg_layoutnode_t *rootnode ) {
+	cg_layoutnode_t *commandnode, *node;
+	cg_layoutop_t *op;
+	cg_layoutarg_t *arg;
 	int numArguments;
 
 	if( !rootnode ) {
 		return;
 	}
 
-	// run until the real root
 	commandnode = rootnode;
 	while( commandnode->parent ) {
 		commandnode = commandnode->parent;
 	}
 
-	// now run backwards up to the next command node
 	while( commandnode ) {
-		argumentnode = commandnode->next;
-
-		// we could trust the parser, but I prefer counting the arguments here
 		numArguments = 0;
-		while( argumentnode ) {
-			if( argumentnode->type == LNODE_COMMAND ) {
-				break;
-			}
-
-			argumentnode = argumentnode->next;
+		for( node = commandnode->next; node && node->type != LNODE_COMMAND; node = node->next ) {
 			numArguments++;
 		}
 
-		// reset
-		argumentnode = commandnode->next;
-
-		// Execute the command node
-		if( commandnode->integer != numArguments ) {
+		// nothing past a broken command was ever executed, so don't compile it either
+		if( commandnode->type != LNODE_COMMAND || commandnode->integer != numArguments ) {
 			CG_Printf( "ERROR: Layout command %s: invalid argument count (expecting %i, found %i)\n", commandnode->string, commandnode->integer, numArguments );
 			return;
 		}
-		if( !touch && commandnode->func ) {
-			//special case for if commands
-			if( commandnode->func( commandnode, argumentnode, numArguments ) ) {
-				// execute the "if" thread when command returns a value
-				if( commandnode->ifthread ) {
-					CG_RecurseExecuteLayoutThread( commandnode->ifthread, touch );
-				}
-			}
-		} else if( touch && commandnode->touchfunc ) {
-			//special case for if commands
-			if( commandnode->touchfunc( commandnode, argumentnode, numArguments ) ) {
-				// execute the "if" thread when command returns a value
-				if( commandnode->ifthread ) {
-					CG_RecurseExecuteLayoutThread( commandnode->ifthread, touch );
-				}
+
+		op = &program->ops[program->numOps++];
+		op->func = commandnode->func;
+		op->touchfunc = commandnode->touchfunc;
+		op->name = commandnode->string;
+		commandnode->string = NULL;
+		op->args = &program->args[program->numArgs];
+
+		for( node = commandnode->next; node && node->type != LNODE_COMMAND; node = node->next ) {
+			arg = &op->args[op->numArgs++];
+			arg->type = node->type;
+			arg->value = node->value;
+			arg->opFunc = node->opFunc;
+			arg->string = node->string;
+			node->string = NULL;
+			if( node->type == LNODE_REFERENCE_NUMERIC ) {
+				arg->reference = &cg_numeric_references[node->integer];
 			}
 		}
 
-		//move up to next command node
-		commandnode = argumentnode;
-		if( commandnode == rootnode ) {
-			return;
+		op->numArgs = CG_FoldLayoutArguments( op->args, op->numArgs );
+		op->args[op->numArgs].type = LNODE_COMMAND;
+		program->numArgs += op->numArgs + 1;
+
+		// precache arguments by calling the function at load time
+		if( op->func && commandnode->precache ) {
+			Vector4Set( layout_cursor_color, 0, 0, 0, 0 );
+			layout_cursor_x = -layout_cursor_width - 1;
+			layout_cursor_y = -layout_cursor_height - 1;
+			layout_cursor_width = 0;
+			layout_cursor_height = 0;
+			op->func( op, op->args, op->numArgs );
 		}
 
-		while( commandnode && commandnode->type != LNODE_COMMAND ) {
-			commandnode = commandnode->next;
+		CG_CompileLayoutThread( program, commandnode->ifthread );
+		op->skip = program->numOps;
+
+		commandnode = node;
+	}
+}
+
+/*
+* CG_FreeLayoutProgram
+*/
+static void CG_FreeLayoutProgram( cg_layoutprogram_t *program ) {
+	int i, j;
+
+	if( !program ) {
+		return;
+	}
+
+	for( i = 0; i < program->numOps; i++ ) {
+		cg_layoutop_t *op = &program->ops[i];
+
+		if( op->name ) {
+			CG_Free( ( void * )op->name );
 		}
+		for( j = 0; j < op->numArgs; j++ ) {
+			if( op->args[j].string ) {
+				CG_Free( ( void * )op->args[j].string );
+			}
+		}
+	}
+
+	CG_Free( program );
+}
+
+/*
+* CG_ParseLayoutScript
+*/
+static void CG_ParseLayoutScript( char *string ) {
+	cg_layoutnode_t *rootnode;
+	cg_layoutprogram_t *program;
+	int numOps = 0, numArgs = 0;
+
+	CG_FreeLayoutProgram( cg.statusBar );
+	cg.statusBar = NULL;
+
+	rootnode = CG_RecurseParseLayoutScript( &string, 0 );
+	if( !rootnode ) {
+		return;
 	}
+
+#if 0
+	CG_RecursePrintLayoutThread( rootnode, 0 );
+#endif
+
+	CG_CountLayoutThread( rootnode, &numOps, &numArgs );
+
+	// a single block holding the header, the commands and the arguments
+	program = ( cg_layoutprogram_t * )CG_Malloc( sizeof( cg_layoutprogram_t ) +
+												 numOps * sizeof( cg_layoutop_t ) + numArgs * sizeof( cg_layoutarg_t ) );
+	program->ops = ( cg_layoutop_t * )( program + 1 );
+	program->args = ( cg_layoutarg_t * )( program->ops + numOps );
+
+	CG_CompileLayoutThread( program, rootnode );
+
+	CG_RecurseFreeLayoutThread( rootnode );
+
+	cg.statusBar = program;
+}
+
+//=============================================================================
+
+//=============================================================================
+
+/*
+* CG_ReportHudTime
+* Accumulates the time of drawing passes and prints their average once a second
+*/
+static void CG_ReportHudTime( uint64_t micros ) {
+	static uint64_t totalMicros, maxMicros;
+	static int numFrames;
+	static int64_t reportedAt;
+	int64_t now;
+
+	totalMicros += micros;
+	maxMicros = max( maxMicros, micros );
+	numFrames++;
+
+	now = trap_Milliseconds();
+	if( now - reportedAt < 1000 ) {
+		return;
+	}
+
+	CG_Printf( "hud: %i frames, %.1f usec average, %u usec max\n",
+			   numFrames, (double)totalMicros / numFrames, (unsigned)maxMicros );
+
+	totalMicros = maxMicros = 0;
+	numFrames = 0;
+	reportedAt = now;
 }
 
 /*
 * CG_ExecuteLayoutProgram
+* Runs the commands in order. When a command fails or has no function for the current pass,
+* execution continues past its "if" thread, which is empty for anything but if/ifnot commands.
 */
-void CG_ExecuteLayoutProgram( struct cg_layoutnode_s *rootnode, bool touch ) {
-	CG_RecurseExecuteLayoutThread( rootnode, touch );
+void CG_ExecuteLayoutProgram( struct cg_layoutprogram_s *program, bool touch ) {
+	cg_layoutop_t *ops, *op;
+	layoutFunc_t func;
+	int numOps, i;
+	uint64_t start = 0;
+
+	if( !program ) {
+		return;
+	}
+
+	if( cg_showHudTime->integer && !touch ) {
+		start = trap_Microseconds();
+	}
+
+	ops = program->ops;
+	numOps = program->numOps;
+
+	for( i = 0; i < numOps; ) {
+		op = &ops[i];
+		func = touch ? op->touchfunc : op->func;
+		if( func && func( op, op->args, op->numArgs ) ) {
+			i++;
+		} else {
+			i = op->skip;
+		}
+	}
+
+	if( cg_showHudTime->integer && !touch ) {
+		CG_ReportHudTime( trap_Microseconds() - start );
+	}
 }
 
 //=============================================================================
@@ -4488,12 +4715,13 @@ static void CG_LoadStatusBarFile( char *path ) {
 	CG_ClearHUDInputState();
 
 	// load the new status bar program
-	CG_ParseLayoutScript( opt, cg.statusBar );
+	CG_ParseLayoutScript( opt );
 
 	// Free the opt buffer!
 	CG_Free( opt );
 
 	// set up layout font as default system font
+	layout_num_fonts = 0;
 	Q_strncpyz( layout_cursor_font_name, DEFAULT_SYSTEM_FONT_FAMILY, sizeof( layout_cursor_font_name ) );
 	layout_cursor_font_style = QFONT_STYLE_NONE;
 	layout_cursor_font_size = DEFAULT_SYSTEM_FONT_SMALL_SIZE;
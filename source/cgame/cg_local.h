@@ -614,7 +614,7 @@ typedef struct {
 	int award_head;
 
 	// statusbar program
-	struct cg_layoutnode_s *statusBar;
+	struct cg_layoutprogram_s *statusBar;
 
 	cg_viewweapon_t weapon;
 	cg_viewdef_t view;
@@ -704,6 +704,8 @@ struct sfx_s *CG_RegisterSexedSound( int entnum, const char *name );
 extern cvar_t *cg_predict;
 extern cvar_t *cg_predict_optimize;
 extern cvar_t *cg_showMiss;
+extern cvar_t *cg_showPredictCost;
+extern cvar_t *cg_showHudTime;
 
 void CG_PredictedEvent( int entNum, int ev, int parm );
 void CG_Predict_ChangeWeapon( int new_weapon );
@@ -831,7 +833,7 @@ extern cvar_t *cg_touch_zoomTime;
 void CG_SC_ResetObituaries( void );
 void CG_SC_Obituary( void );
 void Cmd_CG_PrintHudHelp_f( void );
-void CG_ExecuteLayoutProgram( struct cg_layoutnode_s *rootnode, bool touch );
+void CG_ExecuteLayoutProgram( struct cg_layoutprogram_s *program, bool touch );
 void CG_GetHUDTouchButtons( int *buttons, int *upmove );
 void CG_UpdateHUDPostDraw( void );
 void CG_UpdateHUDPostTouch( void );
@@ -27,6 +27,8 @@ centity_t cg_entities[MAX_EDICTS];
 cvar_t *cg_predict;
 cvar_t *cg_predict_optimize;
 cvar_t *cg_showMiss;
+cvar_t *cg_showPredictCost;
+cvar_t *cg_showHudTime;
 
 cvar_t *cg_model;
 cvar_t *cg_skin;
@@ -717,6 +719,8 @@ static void CG_RegisterVariables( void ) {
 	cg_predict =        trap_Cvar_Get( "cg_predict", "1", 0 );
 	cg_predict_optimize = trap_Cvar_Get( "cg_predict_optimize", "1", 0 );
 	cg_showMiss =       trap_Cvar_Get( "cg_showMiss", "0", 0 );
+	cg_showPredictCost = trap_Cvar_Get( "cg_showPredictCost", "0", 0 );
+	cg_showHudTime = trap_Cvar_Get( "cg_showHudTime", "0", 0 );
 
 	cg_debugPlayerModels =  trap_Cvar_Get( "cg_debugPlayerModels", "0", CVAR_CHEAT | CVAR_ARCHIVE );
 	cg_debugWeaponModels =  trap_Cvar_Get( "cg_debugWeaponModels", "0", CVAR_CHEAT | CVAR_ARCHIVE );
@@ -23,6 +23,22 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 int cg_numSolids;
 static entity_state_t *cg_solidList[MAX_PARSE_ENTITIES];
 
+// solids sorted by the minimal X of their bounds in the current snapshot, traces
+// only test the ones overlapping the box swept by the trace
+typedef struct {
+	vec3_t absmins, absmaxs;
+	int solid;                  // index in cg_solidList
+} cg_solidbounds_t;
+
+static int cg_numSortedSolids;
+static cg_solidbounds_t cg_sortedSolids[MAX_PARSE_ENTITIES];
+static float cg_sortedSolidsMaxSize;    // the largest X size of solids bounds
+
+// the prediction overwrites the state of the POV entity, so its bounds can't be cached
+static int cg_povSolid;
+
+static int cg_predictTraces, cg_predictTests;
+
 int cg_numTriggers;
 static entity_state_t *cg_triggersList[MAX_PARSE_ENTITIES];
 static bool cg_triggersListTriggered[MAX_PARSE_ENTITIES];
@@ -106,6 +122,155 @@ void CG_CheckPredictionError( void ) {
 	}
 }
 
+/*
+* CG_CompareSolidBounds
+*/
+static int CG_CompareSolidBounds( const void *p1, const void *p2 ) {
+	const cg_solidbounds_t *b1 = ( const cg_solidbounds_t * )p1, *b2 = ( const cg_solidbounds_t * )p2;
+
+	if( b1->absmins[0] != b2->absmins[0] ) {
+		return b1->absmins[0] < b2->absmins[0] ? -1 : 1;
+	}
+	return b1->solid - b2->solid;
+}
+
+/*
+* CG_SolidBounds
+*
+* Returns false if the entity can't be collided with
+*/
+static bool CG_SolidBounds( const entity_state_t *ent, vec3_t absmins, vec3_t absmaxs ) {
+	int i, x, zd, zu;
+	float radius;
+	vec3_t origin, mins, maxs;
+	struct cmodel_s *cmodel;
+
+	if( ent->solid == SOLID_BMODEL ) {
+		cmodel = trap_CM_InlineModel( ent->modelindex );
+		if( !cmodel ) {
+			return false;
+		}
+
+		trap_CM_InlineModelBounds( cmodel, mins, maxs );
+
+		if( ent->linearMovement ) {
+			GS_LinearMovement( ent, cg.frame.serverTime, origin );
+		} else {
+			VectorCopy( ent->origin, origin );
+		}
+
+		if( ent->angles[0] || ent->angles[1] || ent->angles[2] ) {
+			radius = RadiusFromBounds( mins, maxs );
+			for( i = 0; i < 3; i++ ) {
+				mins[i] = -radius;
+				maxs[i] = radius;
+			}
+		}
+	} else {
+		x = 8 * ( ent->solid & 31 );
+		zd = 8 * ( ( ent->solid >> 5 ) & 31 );
+		zu = 8 * ( ( ent->solid >> 10 ) & 63 ) - 32;
+
+		mins[0] = mins[1] = -x;
+		maxs[0] = maxs[1] = x;
+		mins[2] = -zd;
+		maxs[2] = zu;
+
+		VectorCopy( ent->origin, origin );
+	}
+
+	// expand a bit so traces stopping right at the surface are still tested
+	for( i = 0; i < 3; i++ ) {
+		absmins[i] = origin[i] + mins[i] - 1;
+		absmaxs[i] = origin[i] + maxs[i] + 1;
+	}
+	return true;
+}
+
+/*
+* CG_BuildSolidBroadphase
+*/
+static void CG_BuildSolidBroadphase( void ) {
+	int i;
+	cg_solidbounds_t *bounds;
+
+	cg_numSortedSolids = 0;
+	cg_sortedSolidsMaxSize = 0;
+	cg_povSolid = -1;
+
+	for( i = 0; i < cg_numSolids; i++ ) {
+		if( cg_solidList[i]->number == (int)cg.frame.playerState.POVnum ) {
+			cg_povSolid = i;
+			continue;
+		}
+
+		bounds = &cg_sortedSolids[cg_numSortedSolids];
+		if( !CG_SolidBounds( cg_solidList[i], bounds->absmins, bounds->absmaxs ) ) {
+			continue;
+		}
+
+		bounds->solid = i;
+		cg_sortedSolidsMaxSize = max( cg_sortedSolidsMaxSize, bounds->absmaxs[0] - bounds->absmins[0] );
+		cg_numSortedSolids++;
+	}
+
+	qsort( cg_sortedSolids, cg_numSortedSolids, sizeof( *cg_sortedSolids ), CG_CompareSolidBounds );
+}
+
+/*
+* CG_SolidsInBox
+*
+* Returns indices of the solids which might be touched by a move within the box, in cg_solidList order
+*/
+static int CG_SolidsInBox( const vec3_t absmins, const vec3_t absmaxs, int *list ) {
+	int i, j, lo, hi, mid, num, solid;
+	const cg_solidbounds_t *bounds;
+
+	// skip the solids that end before the box for sure
+	lo = 0;
+	hi = cg_numSortedSolids;
+	while( lo < hi ) {
+		mid = ( lo + hi ) / 2;
+		if( cg_sortedSolids[mid].absmins[0] < absmins[0] - cg_sortedSolidsMaxSize ) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	num = 0;
+	for( i = lo, bounds = cg_sortedSolids + lo; i < cg_numSortedSolids; i++, bounds++ ) {
+		if( bounds->absmins[0] > absmaxs[0] ) {
+			break;
+		}
+		if( bounds->absmaxs[0] < absmins[0] ) {
+			continue;
+		}
+		if( bounds->absmins[1] > absmaxs[1] || bounds->absmaxs[1] < absmins[1] ) {
+			continue;
+		}
+		if( bounds->absmins[2] > absmaxs[2] || bounds->absmaxs[2] < absmins[2] ) {
+			continue;
+		}
+		list[num++] = bounds->solid;
+	}
+
+	if( cg_povSolid >= 0 ) {
+		list[num++] = cg_povSolid;
+	}
+
+	// restore the original order, so ties are resolved the same way as without the broadphase
+	for( i = 1; i < num; i++ ) {
+		solid = list[i];
+		for( j = i; j > 0 && list[j - 1] > solid; j-- ) {
+			list[j] = list[j - 1];
+		}
+		list[j] = solid;
+	}
+
+	return num;
+}
+
 /*
 * CG_BuildSolidList
 */
@@ -149,6 +314,8 @@ void CG_BuildSolidList( void ) {
 			}
 		}
 	}
+
+	CG_BuildSolidBroadphase();
 }
 
 /*
@@ -233,10 +400,29 @@ static void CG_ClipMoveToEntities( const vec3_t start, const vec3_t mins, const
 	entity_state_t *ent;
 	struct cmodel_s *cmodel;
 	vec3_t bmins, bmaxs;
+	vec3_t absmins, absmaxs;
 	int64_t serverTime = cg.frame.serverTime;
+	int numTouch, touch[MAX_PARSE_ENTITIES];
 
-	for( i = 0; i < cg_numSolids; i++ ) {
-		ent = cg_solidList[i];
+	if( !mins ) {
+		mins = vec3_origin;
+	}
+	if( !maxs ) {
+		maxs = vec3_origin;
+	}
+
+	// the box swept by the move
+	for( i = 0; i < 3; i++ ) {
+		absmins[i] = min( start[i], end[i] ) + mins[i];
+		absmaxs[i] = max( start[i], end[i] ) + maxs[i];
+	}
+
+	numTouch = CG_SolidsInBox( absmins, absmaxs, touch );
+
+	cg_predictTraces++;
+
+	for( i = 0; i < numTouch; i++ ) {
+		ent = cg_solidList[touch[i]];
 
 		if( ent->number == ignore ) {
 			continue;
@@ -278,6 +464,8 @@ static void CG_ClipMoveToEntities( const vec3_t start, const vec3_t mins, const
 			}
 		}
 
+		cg_predictTests++;
+
 		trap_CM_TransformedBoxTrace( &trace, (vec_t *)start, (vec_t *)end, (vec_t *)mins, (vec_t *)maxs, cmodel, contentmask, origin, angles );
 		if( trace.allsolid || trace.fraction < tr->fraction ) {
 			trace.ent = ent->number;
@@ -404,10 +592,14 @@ void CG_PredictMovement( void ) {
 	int64_t ucmdExecuted, ucmdHead;
 	int64_t frame;
 	pmove_t pm;
+	int numCmds;
 
 	trap_NET_GetCurrentState( NULL, &ucmdHead, NULL );
 	ucmdExecuted = cg.frame.ucmdExecuted;
 
+	cg_predictTraces = cg_predictTests = 0;
+	numCmds = 0;
+
 	if( !cg_predict_optimize->integer || ( ucmdHead - cg.predictFrom >= CMD_BACKUP ) ) {
 		cg.predictFrom = 0;
 	}
@@ -450,6 +642,7 @@ void CG_PredictMovement( void ) {
 		}
 
 		Pmove( &pm );
+		numCmds++;
 
 		// copy for stair smoothing
 		predictedSteps[frame] = pm.step;
@@ -494,4 +687,9 @@ void CG_PredictMovement( void ) {
 	}
 
 	CG_PredictSmoothSteps();
+
+	if( cg_showPredictCost->integer ) {
+		CG_Printf( "predict: %i cmds, %i traces, %i entity tests, %i without broadphase\n",
+				   numCmds, cg_predictTraces, cg_predictTests, cg_predictTraces * cg_numSolids );
+	}
 }
@@ -43,7 +43,7 @@ typedef void ( *cg_fdrawchar_t )( int x, int y, int w, int h, float s1, float t1
 
 // cg_public.h -- client game dll information visible to engine
 
-#define CGAME_API_VERSION   101
+#define CGAME_API_VERSION   102
 
 //
 // structs and variables shared with the main engine
@@ -138,6 +138,7 @@ typedef struct {
 
 	void ( *GetConfigString )( int i, char *str, int size );
 	int64_t ( *Milliseconds )( void );
+	uint64_t ( *Microseconds )( void );
 	bool ( *DownloadRequest )( const char *filename, bool requestpak );
 
 	unsigned int ( * Hash_BlockChecksum )( const uint8_t * data, size_t len );
@@ -171,6 +171,10 @@ static inline int64_t trap_Milliseconds( void ) {
 	return CGAME_IMPORT.Milliseconds();
 }
 
+static inline uint64_t trap_Microseconds( void ) {
+	return CGAME_IMPORT.Microseconds();
+}
+
 static inline bool trap_DownloadRequest( const char *filename, bool requestpak ) {
 	return CGAME_IMPORT.DownloadRequest( filename, requestpak == true ? true : false ) == true;
 }
@@ -223,8 +223,9 @@ static void CL_SendConnectPacket( void ) {
 
 	Uuid_ToString( uuid_buffer, cls.mm_ticket );
 	Com_DPrintf( "CL_MM_Initialized: %d, cls.mm_ticket: %s\n", CL_MM_Initialized(), uuid_buffer );
-	Netchan_OutOfBandPrint( cls.socket, &cls.serveraddress, "connect %i %i %i \"%s\" %i %s\n",
-							APP_PROTOCOL_VERSION, Netchan_GamePort(), cls.challenge, Cvar_Userinfo(), 0, uuid_buffer );
+	Netchan_OutOfBandPrint( cls.socket, &cls.serveraddress, "connect %i %i %i \"%s\" %i %s %u %u\n",
+							APP_PROTOCOL_VERSION, Netchan_GamePort(), cls.challenge, Cvar_Userinfo(), 0, uuid_buffer,
+							Netchan_CodecMask(), Netchan_DictionaryChecksum() );
 }
 
 /*
@@ -870,6 +871,8 @@ void CL_Disconnect( const char *message ) {
 		CL_Disconnect_SendCommand(); // send a disconnect message to the server
 
 	}
+	Netchan_Release( &cls.netchan );
+
 	FS_RemovePurePaks();
 
 	Com_FreePureList( &cls.purelist );
@@ -1119,6 +1122,8 @@ static void CL_ConnectionlessPacket( const socket_t *socket, const netadr_t *add
 		Q_strncpyz( cls.session, MSG_ReadStringLine( msg ), sizeof( cls.session ) );
 
 		Netchan_Setup( &cls.netchan, socket, address, Netchan_GamePort() );
+		// servers not supporting codec negotiation don't send it, meaning the legacy codec
+		Netchan_SetCodec( &cls.netchan, ( netchan_codec_t )atoi( MSG_ReadStringLine( msg ) ) );
 		memset( cl.configstrings, 0, sizeof( cl.configstrings ) );
 		CL_SetClientState( CA_HANDSHAKE );
 		CL_AddReliableCommand( "new" );
@@ -1255,17 +1260,13 @@ static bool CL_ProcessPacket( netchan_t *netchan, msg_t *msg ) {
 		return false; // wasn't accepted for some reason
 
 	}
-	// now if compressed, expand it
-	MSG_BeginReading( msg );
-	MSG_ReadInt32( msg ); // sequence
-	MSG_ReadInt32( msg ); // sequence_ack
-	if( msg->compressed ) {
-		zerror = Netchan_DecompressMessage( msg );
-		if( zerror < 0 ) {
-			// compression error. Drop the packet
-			Com_Printf( "CL_ProcessPacket: Compression error %i. Dropping packet\n", zerror );
-			return false;
-		}
+	// now if compressed, expand it, the header has already been read by Netchan_Process.
+	// Uncompressed messages go through it too, the stream codecs keep them for reference
+	zerror = Netchan_DecompressMessage( netchan, msg );
+	if( zerror < 0 ) {
+		// compression error. Drop the packet
+		Com_Printf( "CL_ProcessPacket: Compression error %i. Dropping packet\n", zerror );
+		return false;
 	}
 
 	return true;
@@ -2267,7 +2268,7 @@ void CL_Netchan_Transmit( msg_t *msg ) {
 	Netchan_PushAllFragments( &cls.netchan );
 
 	if( msg->cursize > 60 ) {
-		int zerror = Netchan_CompressMessage( msg );
+		int zerror = Netchan_CompressMessage( &cls.netchan, msg );
 		if( zerror < 0 ) { // it's compression error, just send uncompressed
 			Com_DPrintf( "CL_Netchan_Transmit (ignoring compression): Compression error %i\n", zerror );
 		}
@@ -343,6 +343,14 @@ void CL_SoundModule_Init( bool verbose ) {
 	import.BufPipe_ReadCmds = QBufPipe_ReadCmds;
 	import.BufPipe_Wait = QBufPipe_Wait;
 
+	import.Jobs_NumWorkers = QJobs_NumWorkers;
+	import.JobCounter_Create = QJobCounter_Create;
+	import.JobCounter_Destroy = QJobCounter_Destroy;
+	import.JobCounter_IsDone = QJobCounter_IsDone;
+	import.Jobs_Schedule = QJobs_Schedule;
+	import.Jobs_ParallelFor = QJobs_ParallelFor;
+	import.Jobs_Wait = QJobs_Wait;
+
 	sm = bound( 1, s_module->integer, num_sound_modules );
 	smfb = bound( 0, s_module_fallback->integer, num_sound_modules );
 
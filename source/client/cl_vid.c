@@ -373,6 +373,8 @@ static bool VID_LoadRefresh( const char *name ) {
 	import.FS_MoveFile = &FS_MoveFile;
 	import.FS_IsUrl = &FS_IsUrl;
 	import.FS_FileMTime = &FS_FileMTime;
+	import.FS_PakNameForFile = &FS_PakNameForFile;
+	import.FS_ChecksumBaseFile = &FS_ChecksumBaseFile;
 	import.FS_RemoveDirectory = &FS_RemoveDirectory;
 	import.FS_GameDirectory = &FS_GameDirectory;
 	import.FS_WriteDirectory = &FS_WriteDirectory;
@@ -397,10 +399,15 @@ static bool VID_LoadRefresh( const char *name ) {
 	import.Thread_Create = QThread_Create;
 	import.Thread_Join = QThread_Join;
 	import.Thread_Yield = QThread_Yield;
+	import.Thread_GetNumCPUs = QThread_GetNumCPUs;
 	import.Mutex_Create = QMutex_Create;
 	import.Mutex_Destroy = QMutex_Destroy;
 	import.Mutex_Lock = QMutex_Lock;
 	import.Mutex_Unlock = QMutex_Unlock;
+	import.CondVar_Create = QCondVar_Create;
+	import.CondVar_Destroy = QCondVar_Destroy;
+	import.CondVar_Wait = QCondVar_Wait;
+	import.CondVar_Wake = QCondVar_Wake;
 
 	import.BufPipe_Create = QBufPipe_Create;
 	import.BufPipe_Destroy = QBufPipe_Destroy;
@@ -409,6 +416,14 @@ static bool VID_LoadRefresh( const char *name ) {
 	import.BufPipe_ReadCmds = QBufPipe_ReadCmds;
 	import.BufPipe_Wait = QBufPipe_Wait;
 
+	import.Jobs_NumWorkers = QJobs_NumWorkers;
+	import.JobCounter_Create = QJobCounter_Create;
+	import.JobCounter_Destroy = QJobCounter_Destroy;
+	import.JobCounter_IsDone = QJobCounter_IsDone;
+	import.Jobs_Schedule = QJobs_Schedule;
+	import.Jobs_ParallelFor = QJobs_ParallelFor;
+	import.Jobs_Wait = QJobs_Wait;
+
 	file_size = strlen( LIB_DIRECTORY "/" LIB_PREFIX ) + strlen( name ) + 1 + strlen( ARCH ) + strlen( LIB_SUFFIX ) + 1;
 	file = Mem_TempMalloc( file_size );
 	Q_snprintfz( file, file_size, LIB_DIRECTORY "/" LIB_PREFIX "%s_" ARCH LIB_SUFFIX, name );
@@ -1,9 +1,12 @@
 #include "bot.h"
 #include "ai_shutdown_hooks_holder.h"
 #include "ai_manager.h"
+#include "ai_trace_cache.h"
+#include "movement/MovementRolloutCache.h"
 #include "navigation/NavMeshManager.h"
 #include "teamplay/ObjectiveBasedTeam.h"
 #include "combat/TacticalSpotsRegistry.h"
+#include "awareness/PerceptionSnapshot.h"
 
 const cvar_t *ai_evolution;
 const cvar_t *ai_debug_output;
@@ -199,6 +202,7 @@ void AI_InitLevel( void ) {
 	AiManager::Init( g_gametype->string, level.mapname );
 
 	NavEntitiesRegistry::Instance()->Init();
+	PerceptionSnapshot::Init();
 }
 
 void AI_Shutdown( void ) {
@@ -231,14 +235,96 @@ void AI_JoinedTeam( edict_t *ent, int team ) {
 	AiManager::Instance()->OnBotJoinedTeam( ent, team );
 }
 
+// Accumulated microseconds spent in AI code, reported to the server benchmark
+static uint64_t aiFrameTime = 0;
+
+uint64_t AI_GetFrameTime() {
+	uint64_t result = aiFrameTime;
+	aiFrameTime = 0;
+	return result;
+}
+
+void AI_TraceCacheStats_f( void ) {
+	if( trap_Cmd_Argc() > 1 && !Q_stricmp( trap_Cmd_Argv( 1 ), "reset" ) ) {
+		AiTraceCache::Instance()->ResetStats();
+		return;
+	}
+	AiTraceCache::Instance()->PrintStats();
+}
+
+void AI_MovementRolloutCacheStats_f( void ) {
+	if( trap_Cmd_Argc() > 1 && !Q_stricmp( trap_Cmd_Argv( 1 ), "reset" ) ) {
+		MovementRolloutCache::Instance()->ResetStats();
+		return;
+	}
+	MovementRolloutCache::Instance()->PrintStats();
+}
+
+static void AI_PrintRouteCacheStats( const char *owner, const AiAasRouteCache *routeCache, int64_t levelTime ) {
+	const AiAasRouteCache::Stats &stats = routeCache->GetStats();
+	const float seconds = std::max( 0.001f, 0.001f * ( levelTime - stats.resetAt ) );
+	const uint64_t fills = stats.areaCacheFills + stats.portalCacheFills;
+	G_Printf( "%-24s %10" PRIu64 " %12" PRIu64 " %9.1f %8" PRIu64 " %9.1f %10.1f %9.1f\n", owner,
+			  stats.areaCacheFills, stats.portalCacheFills, fills / seconds, stats.oneToManyQueries,
+			  stats.oneToManyQueries ? stats.oneToManyGoals / (float)stats.oneToManyQueries : 0.0f,
+			  stats.oneToManyQueries ? stats.oneToManyScannedAreas / (float)stats.oneToManyQueries : 0.0f,
+			  stats.oneToManyQueries ? stats.oneToManyMicros / (float)stats.oneToManyQueries : 0.0f );
+}
+
+void AI_RouteCacheStats_f( void ) {
+	const bool reset = trap_Cmd_Argc() > 1 && !Q_stricmp( trap_Cmd_Argv( 1 ), "reset" );
+	if( !reset ) {
+		G_Printf( "%-24s %10s %12s %9s %8s %9s %10s %9s\n", "owner", "area fills", "portal fills", "fills/s",
+				  "1:N reqs", "goals/req", "areas/req", "usec/req" );
+	}
+
+	float totalFillsPerSecond = 0.0f;
+	int numBots = 0;
+	for( int i = 1; i <= gs.maxclients; ++i ) {
+		const edict_t *ent = game.edicts + i;
+		if( !ent->r.inuse || !ent->ai || !ent->ai->botRef ) {
+			continue;
+		}
+		const AiAasRouteCache *routeCache = ent->ai->botRef->RouteCache();
+		if( reset ) {
+			routeCache->ResetStats();
+			continue;
+		}
+		const AiAasRouteCache::Stats &stats = routeCache->GetStats();
+		const float seconds = std::max( 0.001f, 0.001f * ( level.time - stats.resetAt ) );
+		totalFillsPerSecond += ( stats.areaCacheFills + stats.portalCacheFills ) / seconds;
+		numBots++;
+		AI_PrintRouteCacheStats( ent->r.client->netname, routeCache, level.time );
+	}
+
+	// The shared instance is used by team-wide logic
+	if( const AiAasRouteCache *sharedRouteCache = AiAasRouteCache::Shared() ) {
+		if( reset ) {
+			sharedRouteCache->ResetStats();
+			return;
+		}
+		AI_PrintRouteCacheStats( "(shared)", sharedRouteCache, level.time );
+	}
+
+	if( numBots ) {
+		G_Printf( "Routing cache fills per bot per second: %.1f\n", totalFillsPerSecond / numBots );
+	}
+}
+
 void AI_CommonFrame() {
+	const uint64_t startedAt = trap_Microseconds();
+
 	AiAasWorld::Instance()->Frame();
 
+	AiNavMeshManager::Frame();
+
 	EntitiesPvsCache::Instance()->Update();
 
 	NavEntitiesRegistry::Instance()->Update();
 
 	AiManager::Instance()->Update();
+
+	aiFrameTime += trap_Microseconds() - startedAt;
 }
 
 static inline void ExtendDimension( float *mins, float *maxs, int dimension ) {
@@ -442,7 +528,9 @@ void AI_Think( edict_t *self ) {
 		return;
 	}
 
+	const uint64_t startedAt = trap_Microseconds();
 	self->ai->aiRef->Update();
+	aiFrameTime += trap_Microseconds() - startedAt;
 }
 
 void AI_RegisterEvent( edict_t *ent, int event, int parm ) {
@@ -113,4 +113,15 @@ void        AI_Respawn( edict_t *ent );
 
 void        AI_Cheat_NoTarget( edict_t *ent );
 
+uint64_t    AI_GetFrameTime();
+
+// Prints hit rates of the shared trace cache, "reset" as an argument clears them
+void        AI_TraceCacheStats_f( void );
+// Prints hit and replay rates of the shared movement rollout cache, "reset" as an argument clears them
+void        AI_MovementRolloutCacheStats_f( void );
+// Prints routing cache fill rates of bots, "reset" as an argument clears them
+void        AI_RouteCacheStats_f( void );
+// Compares allocation rates of single-threaded and concurrent pools, an optional argument is a number of operations
+void        AI_PoolsBenchmark_f( void );
+
 #endif
\ No newline at end of file
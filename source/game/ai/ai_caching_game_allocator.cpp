@@ -1,6 +1,7 @@
 #include "ai_caching_game_allocator.h"
 #include "ai_local.h"
 #include "ai_shutdown_hooks_holder.h"
+#include "ai_concurrent_free_list.h"
 
 UntypedCachingGameAllocator::UntypedCachingGameAllocator( size_t elemSize,
 														  const char *tag,
@@ -76,4 +77,89 @@ void UntypedCachingGameAllocator::Free( void *ptr ) {
 	}
 	cache[cachedChunksCount++] = ptr;
 	usedChunksCount--;
-}
\ No newline at end of file
+}
+ConcurrentCachingGameAllocator::ConcurrentCachingGameAllocator( size_t chunkSize_, const char *tag_,
+																size_t limit_, unsigned initialCacheSize_ )
+	: chunkSize( chunkSize_ ), limit( limit_ ), tag( tag_ ? tag_ : "unknown tag" ),
+	initialCacheSize( (unsigned)std::min( (size_t)initialCacheSize_, limit_ ) ),
+	chunks( nullptr ), numCreatedChunks( 0 ), freeList( nullptr ), initState( NOT_INITIALIZED ) {}
+
+ConcurrentCachingGameAllocator::~ConcurrentCachingGameAllocator() {
+	if( initState.load( std::memory_order_relaxed ) == NOT_INITIALIZED ) {
+		return;
+	}
+	AI_FailWith( "ConcurrentCachingGameAllocator::~ConcurrentCachingGameAllocator()", "%s: Has not been cleared\n", tag );
+}
+
+void ConcurrentCachingGameAllocator::Init() {
+	if( initState.load( std::memory_order_acquire ) == INITIALIZED ) {
+		return;
+	}
+
+	int expectedState = NOT_INITIALIZED;
+	if( !initState.compare_exchange_strong( expectedState, INITIALIZING, std::memory_order_acquire ) ) {
+		// Wait for another thread that initializes the allocator
+		while( initState.load( std::memory_order_acquire ) != INITIALIZED ) {}
+		return;
+	}
+
+	chunks = (void **)G_Malloc( sizeof( void * ) * limit );
+	freeList = new( G_Malloc( sizeof( ConcurrentFreeList ) ) )ConcurrentFreeList( (unsigned)limit );
+	for( unsigned i = 0; i < initialCacheSize; ++i ) {
+		CreateChunk( i );
+	}
+	numCreatedChunks.store( initialCacheSize, std::memory_order_relaxed );
+	// Only the created chunks are free at start, other ones are created on demand
+	freeList->Reset( initialCacheSize );
+
+	AiShutdownHooksHolder::Instance()->RegisterHook( [&] { this->Clear(); } );
+
+	initState.store( INITIALIZED, std::memory_order_release );
+}
+
+void ConcurrentCachingGameAllocator::Clear() {
+	const unsigned numChunks = numCreatedChunks.load( std::memory_order_relaxed );
+	for( unsigned i = 0; i < numChunks; ++i ) {
+		G_Free( chunks[i] );
+	}
+	G_Free( chunks );
+	chunks = nullptr;
+	freeList->~ConcurrentFreeList();
+	G_Free( freeList );
+	freeList = nullptr;
+	numCreatedChunks.store( 0, std::memory_order_relaxed );
+	// Allow reinitialization on next Alloc() call
+	initState.store( NOT_INITIALIZED, std::memory_order_release );
+}
+
+void *ConcurrentCachingGameAllocator::CreateChunk( unsigned index ) {
+	auto *header = (uint8_t *)G_Malloc( HEADER_SIZE + chunkSize );
+	*( (uint32_t *)header ) = index;
+	chunks[index] = header;
+	return header + HEADER_SIZE;
+}
+
+void *ConcurrentCachingGameAllocator::Alloc() {
+	Init();
+
+	int index = freeList->Pop();
+	if( index >= 0 ) {
+		return (uint8_t *)chunks[index] + HEADER_SIZE;
+	}
+
+	// All created chunks are in use, create a new one
+	const unsigned newIndex = numCreatedChunks.fetch_add( 1, std::memory_order_relaxed );
+	if( newIndex >= limit ) {
+		AI_FailWith( "ConcurrentCachingGameAllocator::Alloc()", "%s: Can't allocate more than %d chunks\n", tag, (int)limit );
+	}
+	return CreateChunk( newIndex );
+}
+
+void ConcurrentCachingGameAllocator::Free( void *ptr ) {
+	uint8_t *header = (uint8_t *)ptr - HEADER_SIZE;
+	const uint32_t index = *( (uint32_t *)header );
+	if( index >= numCreatedChunks.load( std::memory_order_relaxed ) || chunks[index] != header ) {
+		AI_FailWith( "ConcurrentCachingGameAllocator::Free()", "%s: Attempt to free chunk %p that has not been registered\n", tag, ptr );
+	}
+	freeList->Push( (int32_t)index );
+}
@@ -1,6 +1,10 @@
 #ifndef CACHING_GAME_ALLOCATOR_H
 #define CACHING_GAME_ALLOCATOR_H
 
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
 #include <unordered_set>
 
 class UntypedCachingGameAllocator
@@ -30,22 +34,58 @@ public:
 	void Free( void *ptr );
 };
 
-template<typename T, unsigned N>
-class CachingGameBufferAllocator : UntypedCachingGameAllocator
+// A thread-safe counterpart of UntypedCachingGameAllocator.
+// Chunks are created on demand up to the limit and are reused via a ConcurrentFreeList of chunk indices.
+// The first Alloc() call should be performed by the main thread as it registers a shutdown hook.
+class ConcurrentCachingGameAllocator
 {
+	// Chunks are prepended by a header that holds a chunk index (its size keeps the chunk data aligned)
+	static constexpr size_t HEADER_SIZE = 16;
+
+	enum { NOT_INITIALIZED, INITIALIZING, INITIALIZED };
+
+	const size_t chunkSize;
+	const size_t limit;
+	const char *tag;
+	const unsigned initialCacheSize;
+	// Addresses of chunk headers
+	void **chunks;
+	std::atomic<unsigned> numCreatedChunks;
+	class ConcurrentFreeList *freeList;
+	std::atomic<int> initState;
+
+	void Init();
+	void Clear();
+
+	void *CreateChunk( unsigned index );
+
+public:
+	ConcurrentCachingGameAllocator( size_t chunkSize, const char *tag = nullptr, size_t limit = 32, unsigned initialCacheSize = 8 );
+	~ConcurrentCachingGameAllocator();
+
+	void *Alloc();
+	void Free( void *ptr );
+};
+
+// Set IsConcurrent if buffers are allocated and freed by multiple threads
+template<typename T, unsigned N, bool IsConcurrent = false>
+class CachingGameBufferAllocator : std::conditional<IsConcurrent, ConcurrentCachingGameAllocator, UntypedCachingGameAllocator>::type
+{
+	typedef typename std::conditional<IsConcurrent, ConcurrentCachingGameAllocator, UntypedCachingGameAllocator>::type Base;
+
 	static constexpr unsigned alignedElemSize() {
 		return ( sizeof( T ) % alignof( T ) ) ? sizeof( T ) + alignof( T ) - ( sizeof( T ) % alignof( T ) ) : sizeof( T );
 	}
 
 public:
 	CachingGameBufferAllocator( const char *tag, size_t limit = 32, unsigned initialCacheSize = 8 )
-		: UntypedCachingGameAllocator( alignedElemSize() * N, tag, limit, initialCacheSize ) {}
+		: Base( alignedElemSize() * N, tag, limit, initialCacheSize ) {}
 
 	inline T *Alloc() {
-		return (T*)UntypedCachingGameAllocator::Alloc();
+		return (T*)Base::Alloc();
 	}
 	inline void Free( T *ptr ) {
-		UntypedCachingGameAllocator::Free( ptr );
+		Base::Free( ptr );
 	}
 };
 
@@ -0,0 +1,162 @@
+#include "ai_concurrent_free_list.h"
+#include "ai_local.h"
+
+#include <new>
+
+// A number of threads that have got a magazine slot
+static std::atomic<int> numThreadSlots( 0 );
+
+int ConcurrentFreeList::ThreadSlot() {
+	// Slots are never released, the set of threads that execute AI code is fixed (the main thread and job workers)
+	static thread_local int slot = -2;
+	if( slot == -2 ) {
+		const int newSlot = numThreadSlots.fetch_add( 1, std::memory_order_relaxed );
+		slot = newSlot < (int)MAX_THREAD_SLOTS ? newSlot : -1;
+	}
+	return slot;
+}
+
+ConcurrentFreeList::ConcurrentFreeList( unsigned capacity_ )
+	: head( 0 ), magazines( nullptr ), magazinesMem( nullptr ), capacity( capacity_ ) {
+	nextIndices = (std::atomic<int32_t> *)G_Malloc( sizeof( std::atomic<int32_t> ) * capacity );
+	for( unsigned i = 0; i < capacity; ++i ) {
+		new( nextIndices + i )std::atomic<int32_t>( -1 );
+	}
+
+	// Make sure all magazines together may hold not more than a half of indices, so stealing is rare
+	magazineSize = std::min( MAGAZINE_SIZE, capacity / ( 2 * MAX_THREAD_SLOTS ) );
+	if( magazineSize ) {
+		// Allocate an extra magazine to be able to align the magazines array
+		magazinesMem = G_Malloc( sizeof( Magazine ) * ( MAX_THREAD_SLOTS + 1 ) );
+		uintptr_t alignedAddress = (uintptr_t)magazinesMem + alignof( Magazine ) - 1;
+		alignedAddress -= alignedAddress % alignof( Magazine );
+		magazines = (Magazine *)alignedAddress;
+		for( unsigned i = 0; i < MAX_THREAD_SLOTS; ++i ) {
+			new( &magazines[i].lock )std::atomic_flag();
+			magazines[i].lock.clear( std::memory_order_relaxed );
+			magazines[i].count = 0;
+		}
+	}
+
+	Reset( capacity );
+}
+
+ConcurrentFreeList::~ConcurrentFreeList() {
+	G_Free( nextIndices );
+	if( magazinesMem ) {
+		G_Free( magazinesMem );
+	}
+}
+
+void ConcurrentFreeList::Reset( unsigned numIndices ) {
+	for( unsigned i = 0; i < numIndices; ++i ) {
+		nextIndices[i].store( i + 1 < numIndices ? (int32_t)( i + 1 ) : -1, std::memory_order_relaxed );
+	}
+	// The tag is dropped as well since there must be no concurrent operations
+	head.store( numIndices ? 1 : 0, std::memory_order_release );
+
+	if( magazines ) {
+		for( unsigned i = 0; i < MAX_THREAD_SLOTS; ++i ) {
+			magazines[i].count = 0;
+		}
+	}
+}
+
+int ConcurrentFreeList::PopGlobal() {
+	uint64_t oldHead = head.load( std::memory_order_acquire );
+	for(;; ) {
+		const uint32_t topIndexPlusOne = (uint32_t)oldHead;
+		if( !topIndexPlusOne ) {
+			return -1;
+		}
+		const int32_t index = (int32_t)topIndexPlusOne - 1;
+		// The index might be popped and pushed back by another thread at this moment,
+		// but the tag is modified in this case and the CAS below fails
+		const int32_t nextIndex = nextIndices[index].load( std::memory_order_relaxed );
+		const uint64_t newHead = ( ( ( oldHead >> 32 ) + 1 ) << 32 ) | (uint32_t)( nextIndex + 1 );
+		if( head.compare_exchange_weak( oldHead, newHead, std::memory_order_acquire, std::memory_order_acquire ) ) {
+			return index;
+		}
+	}
+}
+
+void ConcurrentFreeList::PushGlobal( int32_t index ) {
+	uint64_t oldHead = head.load( std::memory_order_relaxed );
+	for(;; ) {
+		nextIndices[index].store( (int32_t)(uint32_t)oldHead - 1, std::memory_order_relaxed );
+		const uint64_t newHead = ( ( ( oldHead >> 32 ) + 1 ) << 32 ) | (uint32_t)( index + 1 );
+		if( head.compare_exchange_weak( oldHead, newHead, std::memory_order_release, std::memory_order_relaxed ) ) {
+			return;
+		}
+	}
+}
+
+int ConcurrentFreeList::StealFromMagazines( int ownSlot ) {
+	for( int i = 0; i < (int)MAX_THREAD_SLOTS; ++i ) {
+		if( i == ownSlot ) {
+			continue;
+		}
+		Magazine &magazine = magazines[i];
+		magazine.Lock();
+		const int index = magazine.count ? magazine.indices[--magazine.count] : -1;
+		magazine.Unlock();
+		if( index >= 0 ) {
+			return index;
+		}
+	}
+	return -1;
+}
+
+int ConcurrentFreeList::Pop() {
+	if( !magazineSize ) {
+		return PopGlobal();
+	}
+
+	const int slot = ThreadSlot();
+	if( slot < 0 ) {
+		const int index = PopGlobal();
+		return index >= 0 ? index : StealFromMagazines( slot );
+	}
+
+	Magazine &magazine = magazines[slot];
+	magazine.Lock();
+	if( !magazine.count ) {
+		// Refill a half of the magazine, so few next Push() calls do not spill it
+		while( magazine.count < std::max( 1u, magazineSize / 2 ) ) {
+			const int index = PopGlobal();
+			if( index < 0 ) {
+				break;
+			}
+			magazine.indices[magazine.count++] = index;
+		}
+		if( !magazine.count ) {
+			// Release the own magazine first, so threads that steal from each other do not deadlock
+			magazine.Unlock();
+			return StealFromMagazines( slot );
+		}
+	}
+	const int index = magazine.indices[--magazine.count];
+	magazine.Unlock();
+	return index;
+}
+
+void ConcurrentFreeList::Push( int32_t index ) {
+	if( magazineSize ) {
+		const int slot = ThreadSlot();
+		if( slot >= 0 ) {
+			Magazine &magazine = magazines[slot];
+			magazine.Lock();
+			if( magazine.count == magazineSize ) {
+				// Spill a half of the magazine, so few next Pop() calls do not refill it
+				while( magazine.count > magazineSize / 2 ) {
+					PushGlobal( magazine.indices[--magazine.count] );
+				}
+			}
+			magazine.indices[magazine.count++] = index;
+			magazine.Unlock();
+			return;
+		}
+	}
+
+	PushGlobal( index );
+}
@@ -0,0 +1,69 @@
+#ifndef QFUSION_AI_CONCURRENT_FREE_LIST_H
+#define QFUSION_AI_CONCURRENT_FREE_LIST_H
+
+#include <atomic>
+#include <stdint.h>
+
+// A free list of indices in [0, capacity) range that may be used by multiple threads.
+// Every thread gets a small private magazine of indices, so most Pop()/Push() calls do not touch shared memory.
+// Magazines are refilled from and spilled to a lock-free global stack.
+// If the global stack is empty, indices are stolen from magazines of other threads,
+// so Pop() fails only if all indices are really taken (a pool would look exhausted too early otherwise).
+class ConcurrentFreeList
+{
+public:
+	static constexpr unsigned MAX_THREAD_SLOTS = 16;
+	static constexpr unsigned MAGAZINE_SIZE = 16;
+
+private:
+	// Put every magazine on its own cache line to prevent false sharing
+	struct alignas( 64 )Magazine {
+		// Is taken by the owner thread on every access and by other threads that steal indices.
+		// The owner never waits for it while holding another magazine lock, so there are no deadlocks.
+		std::atomic_flag lock;
+		int32_t indices[MAGAZINE_SIZE];
+		unsigned count;
+
+		void Lock() {
+			while( lock.test_and_set( std::memory_order_acquire ) ) {}
+		}
+		void Unlock() {
+			lock.clear( std::memory_order_release );
+		}
+	};
+
+	// Low 32 bits is an index of the top + 1 (zero if the stack is empty), high 32 bits is a modification tag
+	std::atomic<uint64_t> head;
+	std::atomic<int32_t> *nextIndices;
+	Magazine *magazines;
+	// Magazine blocks are allocated with a padding, the actual address is kept for G_Free()
+	void *magazinesMem;
+	unsigned capacity;
+	unsigned magazineSize;
+
+	// Returns an index of a magazine of the current thread or -1 if all magazines have been taken
+	static int ThreadSlot();
+
+	int PopGlobal();
+	void PushGlobal( int32_t index );
+	// Takes an index from a magazine of any other thread, returns -1 if all magazines are empty
+	int StealFromMagazines( int ownSlot );
+public:
+	ConcurrentFreeList( unsigned capacity_ );
+	~ConcurrentFreeList();
+
+	ConcurrentFreeList( const ConcurrentFreeList &that ) = delete;
+	ConcurrentFreeList &operator=( const ConcurrentFreeList &that ) = delete;
+
+	// Returns -1 if there are no free indices
+	int Pop();
+	void Push( int32_t index );
+
+	// Makes [0, numIndices) indices free and empties magazines.
+	// Not thread-safe, should be called when no other thread uses the list.
+	void Reset( unsigned numIndices );
+
+	unsigned Capacity() const { return capacity; }
+};
+
+#endif
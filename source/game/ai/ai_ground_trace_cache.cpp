@@ -1,5 +1,6 @@
 #include "ai_shutdown_hooks_holder.h"
 #include "ai_ground_trace_cache.h"
+#include "ai_trace_cache.h"
 #include "static_vector.h"
 #include "ai_local.h"
 
@@ -56,7 +57,8 @@ void AiGroundTraceCache::GetGroundTrace( const edict_s *ent, float depth, trace_
 	}
 
 	vec3_t end = { ent->s.origin[0], ent->s.origin[1], ent->s.origin[2] - depth };
-	G_Trace( &cachedTrace->trace, entRef->s.origin, nullptr, nullptr, end, entRef, MASK_AISOLID );
+	AiTraceCache::Instance()->Trace( &cachedTrace->trace, entRef->s.origin, nullptr, nullptr, end, entRef,
+									 MASK_AISOLID, AiTraceCache::GROUND );
 	// Copy trace data
 	*trace = cachedTrace->trace;
 	cachedTrace->depth = depth;
@@ -88,7 +90,8 @@ bool AiGroundTraceCache::TryDropToFloor( const struct edict_s *ent, float depth,
 	}
 
 	vec3_t end = { ent->s.origin[0], ent->s.origin[1], ent->s.origin[2] - depth };
-	G_Trace( &cachedTrace->trace, entRef->s.origin, nullptr, nullptr, end, entRef, MASK_AISOLID );
+	AiTraceCache::Instance()->Trace( &cachedTrace->trace, entRef->s.origin, nullptr, nullptr, end, entRef,
+									 MASK_AISOLID, AiTraceCache::GROUND );
 	cachedTrace->depth = depth;
 	cachedTrace->computedAt = level.time;
 	if( cachedTrace->trace.fraction == 1.0f ) {
@@ -251,6 +251,21 @@ inline void StaticWorldTrace( trace_t *trace, const vec3_t from, const vec3_t to
 	trap_CM_TransformedBoxTrace( trace, from_, to_, mins_, maxs_, nullptr, contentsMask, nullptr, nullptr );
 }
 
+// Traces many rays of the same box size against the world model sharing the BSP traversal.
+// Results are exactly the same as ones of StaticWorldTrace() called for every ray.
+inline void StaticWorldTraceBatch( trace_t *traces, const vec3_t *from, const vec3_t *to, int numTraces,
+								   int contentsMask, const vec3_t mins = vec3_origin, const vec3_t maxs = vec3_origin ) {
+	assert( from );
+	vec3_t *from_ = const_cast<vec3_t *>( from );
+	assert( to );
+	vec3_t *to_ = const_cast<vec3_t *>( to );
+	assert( mins );
+	float *mins_ = const_cast<float *>( mins );
+	assert( maxs );
+	float *maxs_ = const_cast<float *>( maxs );
+	trap_CM_TraceBatch( traces, from_, to_, numTraces, mins_, maxs_, contentsMask );
+}
+
 // This shorthand is for backward compatibility and some degree of convenience
 inline void SolidWorldTrace( trace_t *trace, const vec3_t from, const vec3_t to,
 							 const vec3_t mins = vec3_origin, const vec3_t maxs = vec3_origin ) {
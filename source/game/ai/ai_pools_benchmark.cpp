@@ -0,0 +1,196 @@
+#include "ai_local.h"
+#include "ai_caching_game_allocator.h"
+#include "planning/BasePlanner.h"
+
+// Allocation stress tests of AI pools and caching allocators ("aipoolbench [numOps]" command).
+// Single-threaded variants are compared on the main thread,
+// and concurrent ones are compared with a mutex-guarded single-threaded pool on job workers.
+
+struct BenchmarkItem : public PoolItem {
+	char payload[64];
+
+	BenchmarkItem( PoolBase *pool_ ) : PoolItem( pool_ ) {
+		payload[0] = 0;
+	}
+};
+
+struct BenchmarkChunk {
+	char data[256];
+};
+
+static constexpr unsigned BENCHMARK_POOL_SIZE = 1024;
+// A maximal number of items held by a benchmark thread at once
+static constexpr unsigned MAX_HELD_ITEMS = 32;
+
+typedef Pool<BenchmarkItem, BENCHMARK_POOL_SIZE> PlainBenchmarkPool;
+typedef Pool<BenchmarkItem, BENCHMARK_POOL_SIZE, true> ConcurrentBenchmarkPool;
+
+// Caching allocators must have a static storage duration as they are cleared by a shutdown hook
+static CachingGameBufferAllocator<BenchmarkChunk, 1> plainChunksAllocator( "plain benchmark chunks", 1024 );
+static CachingGameBufferAllocator<BenchmarkChunk, 1, true> concurrentChunksAllocator( "concurrent benchmark chunks", 1024 );
+
+// Allocates and releases items in a random order keeping up to MAX_HELD_ITEMS at once.
+// Returns a number of failed allocations.
+template <typename AllocFn, typename FreeFn>
+static unsigned RunAllocationStress( unsigned numOps, uint32_t seed, AllocFn allocFn, FreeFn freeFn ) {
+	void *heldItems[MAX_HELD_ITEMS];
+	unsigned numHeldItems = 0;
+	unsigned numFailedAllocs = 0;
+	uint32_t random = seed;
+
+	for( unsigned i = 0; i < numOps; ++i ) {
+		random = random * 1664525u + 1013904223u;
+		// Prefer allocations if there are few held items and releases otherwise
+		if( numHeldItems < MAX_HELD_ITEMS && ( !numHeldItems || ( random >> 16 ) % MAX_HELD_ITEMS >= numHeldItems ) ) {
+			if( void *item = allocFn() ) {
+				heldItems[numHeldItems++] = item;
+			} else {
+				numFailedAllocs++;
+			}
+		} else {
+			const unsigned index = ( random >> 8 ) % numHeldItems;
+			freeFn( heldItems[index] );
+			heldItems[index] = heldItems[--numHeldItems];
+		}
+	}
+
+	while( numHeldItems ) {
+		freeFn( heldItems[--numHeldItems] );
+	}
+
+	return numFailedAllocs;
+}
+
+template <typename BenchmarkPool>
+static unsigned StressPool( BenchmarkPool *pool, unsigned numOps, uint32_t seed ) {
+	return RunAllocationStress( numOps, seed,
+								[=]() -> void * { return pool->New(); },
+								[]( void *item ) { ( (BenchmarkItem *)item )->DeleteSelf(); } );
+}
+
+template <typename Allocator>
+static unsigned StressAllocator( Allocator *allocator, unsigned numOps, uint32_t seed ) {
+	return RunAllocationStress( numOps, seed,
+								[=]() -> void * { return allocator->Alloc(); },
+								[=]( void *chunk ) { allocator->Free( (BenchmarkChunk *)chunk ); } );
+}
+
+static void PrintBenchmarkResult( const char *name, uint64_t micros, unsigned numOps, unsigned numFailedAllocs ) {
+	G_Printf( "%-48s %8.2f ns/op %8u failed allocs\n", name, 1000.0 * micros / std::max( 1u, numOps ), numFailedAllocs );
+}
+
+struct PoolsBenchmarkJobs {
+	enum Mode {
+		LOCKED_POOL,
+		CONCURRENT_POOL,
+		CONCURRENT_ALLOCATOR
+	};
+
+	Mode mode;
+	unsigned opsPerJob;
+	PlainBenchmarkPool *plainPool;
+	ConcurrentBenchmarkPool *concurrentPool;
+	struct qmutex_s *plainPoolLock;
+	std::atomic<unsigned> numFailedAllocs;
+
+	static void Run( unsigned first, unsigned items, void *arg );
+	void RunLockedPool( uint32_t seed );
+};
+
+void PoolsBenchmarkJobs::RunLockedPool( uint32_t seed ) {
+	struct qmutex_s *lock = plainPoolLock;
+	PlainBenchmarkPool *pool = plainPool;
+	numFailedAllocs += RunAllocationStress( opsPerJob, seed,
+											[=]() -> void * {
+		trap_Mutex_Lock( lock );
+		void *item = pool->New();
+		trap_Mutex_Unlock( lock );
+		return item;
+	},
+											[=]( void *item ) {
+		trap_Mutex_Lock( lock );
+		( (BenchmarkItem *)item )->DeleteSelf();
+		trap_Mutex_Unlock( lock );
+	} );
+}
+
+void PoolsBenchmarkJobs::Run( unsigned first, unsigned items, void *arg ) {
+	auto *jobs = (PoolsBenchmarkJobs *)arg;
+	for( unsigned i = first; i < first + items; ++i ) {
+		const uint32_t seed = i + 1;
+		switch( jobs->mode ) {
+			case LOCKED_POOL:
+				jobs->RunLockedPool( seed );
+				break;
+			case CONCURRENT_POOL:
+				jobs->numFailedAllocs += StressPool( jobs->concurrentPool, jobs->opsPerJob, seed );
+				break;
+			case CONCURRENT_ALLOCATOR:
+				jobs->numFailedAllocs += StressAllocator( &concurrentChunksAllocator, jobs->opsPerJob, seed );
+				break;
+		}
+	}
+}
+
+static void RunPoolsBenchmarkJobs( const char *name, PoolsBenchmarkJobs *jobs, PoolsBenchmarkJobs::Mode mode, unsigned numJobs ) {
+	jobs->mode = mode;
+	jobs->numFailedAllocs = 0;
+
+	struct qjobcounter_s *counter = trap_JobCounter_Create();
+	const uint64_t startedAt = trap_Microseconds();
+	trap_Jobs_ParallelFor( PoolsBenchmarkJobs::Run, jobs, numJobs, 1, counter, nullptr );
+	trap_Jobs_Wait( counter );
+	const uint64_t micros = trap_Microseconds() - startedAt;
+	trap_JobCounter_Destroy( &counter );
+
+	PrintBenchmarkResult( name, micros, jobs->opsPerJob * numJobs, jobs->numFailedAllocs );
+}
+
+void AI_PoolsBenchmark_f( void ) {
+	unsigned numOps = 1000 * 1000;
+	if( trap_Cmd_Argc() > 1 ) {
+		numOps = (unsigned)std::max( 1000, atoi( trap_Cmd_Argv( 1 ) ) );
+	}
+
+	// Pools are too large to be put on stack
+	auto *plainPool = new( G_Malloc( sizeof( PlainBenchmarkPool ) ) )PlainBenchmarkPool( "plain benchmark pool" );
+	auto *concurrentPool = new( G_Malloc( sizeof( ConcurrentBenchmarkPool ) ) )ConcurrentBenchmarkPool( "concurrent benchmark pool" );
+
+	G_Printf( "Main thread, %u operations:\n", numOps );
+
+	uint64_t startedAt = trap_Microseconds();
+	unsigned numFailedAllocs = StressPool( plainPool, numOps, 1 );
+	PrintBenchmarkResult( "Pool", trap_Microseconds() - startedAt, numOps, numFailedAllocs );
+
+	startedAt = trap_Microseconds();
+	numFailedAllocs = StressPool( concurrentPool, numOps, 1 );
+	PrintBenchmarkResult( "Pool (concurrent)", trap_Microseconds() - startedAt, numOps, numFailedAllocs );
+
+	startedAt = trap_Microseconds();
+	numFailedAllocs = StressAllocator( &plainChunksAllocator, numOps, 1 );
+	PrintBenchmarkResult( "CachingGameBufferAllocator", trap_Microseconds() - startedAt, numOps, numFailedAllocs );
+
+	startedAt = trap_Microseconds();
+	numFailedAllocs = StressAllocator( &concurrentChunksAllocator, numOps, 1 );
+	PrintBenchmarkResult( "CachingGameBufferAllocator (concurrent)", trap_Microseconds() - startedAt, numOps, numFailedAllocs );
+
+	// There is a job per worker (jobs are executed synchronously if there are no workers)
+	const unsigned numJobs = (unsigned)std::max( 1, trap_Jobs_NumWorkers() );
+	PoolsBenchmarkJobs jobs;
+	jobs.opsPerJob = std::max( 1u, numOps / numJobs );
+	jobs.plainPool = plainPool;
+	jobs.concurrentPool = concurrentPool;
+	jobs.plainPoolLock = trap_Mutex_Create();
+
+	G_Printf( "%u jobs, %u operations per job:\n", numJobs, jobs.opsPerJob );
+	RunPoolsBenchmarkJobs( "Pool (guarded by a mutex)", &jobs, PoolsBenchmarkJobs::LOCKED_POOL, numJobs );
+	RunPoolsBenchmarkJobs( "Pool (concurrent)", &jobs, PoolsBenchmarkJobs::CONCURRENT_POOL, numJobs );
+	RunPoolsBenchmarkJobs( "CachingGameBufferAllocator (concurrent)", &jobs, PoolsBenchmarkJobs::CONCURRENT_ALLOCATOR, numJobs );
+
+	trap_Mutex_Destroy( &jobs.plainPoolLock );
+
+	plainPool->~PlainBenchmarkPool();
+	G_Free( plainPool );
+	concurrentPool->~ConcurrentBenchmarkPool();
+	G_Free( concurrentPool );
+}
@@ -0,0 +1,194 @@
+#include "ai_shutdown_hooks_holder.h"
+#include "ai_trace_cache.h"
+#include "static_vector.h"
+
+static const char *categoryNames[AiTraceCache::NUM_CATEGORIES] = {
+	"ground", "environment", "next reach", "fire target", "other"
+};
+
+AiTraceCache::AiTraceCache() {
+	entries = (Entry *)G_Malloc( NUM_ENTRIES * sizeof( Entry ) );
+	// Make all entries stale
+	for( unsigned i = 0; i < NUM_ENTRIES; ++i ) {
+		entries[i].frameNum = -1;
+	}
+	memset( stats, 0, sizeof( stats ) );
+}
+
+AiTraceCache::~AiTraceCache() {
+	if( entries ) {
+		G_Free( entries );
+	}
+}
+
+static StaticVector<AiTraceCache, 1> instanceHolder;
+
+AiTraceCache *AiTraceCache::Instance() {
+	if( instanceHolder.empty() ) {
+		instanceHolder.emplace_back( AiTraceCache() );
+		AiShutdownHooksHolder::Instance()->RegisterHook([&] { instanceHolder.clear(); } );
+	}
+	return &instanceHolder.front();
+}
+
+void AiTraceCache::MakeKey( Key *key, const vec3_t start, const vec3_t mins, const vec3_t maxs,
+							const vec3_t end, int contentMask, int ignore ) {
+	// Make sure there is no garbage in padding as keys are compared bytewise
+	memset( key, 0, sizeof( Key ) );
+
+	for( int i = 0; i < 3; ++i ) {
+		key->start[i] = (int32_t)floorf( start[i] * KEY_STEPS_PER_UNIT + 0.5f );
+		key->end[i] = (int32_t)floorf( end[i] * KEY_STEPS_PER_UNIT + 0.5f );
+		key->mins[i] = (int32_t)floorf( mins[i] * KEY_STEPS_PER_UNIT + 0.5f );
+		key->maxs[i] = (int32_t)floorf( maxs[i] * KEY_STEPS_PER_UNIT + 0.5f );
+	}
+
+	key->contentMask = contentMask;
+	key->ignore = ignore;
+}
+
+unsigned AiTraceCache::Hash( const Key &key ) {
+	const int32_t *words = (const int32_t *)&key;
+	unsigned hash = 2166136261u;
+	for( unsigned i = 0; i < sizeof( Key ) / sizeof( int32_t ); ++i ) {
+		hash = ( hash ^ (unsigned)words[i] ) * 16777619u;
+	}
+	return hash ^ ( hash >> 16 );
+}
+
+AiTraceCache::Entry *AiTraceCache::FindEntry( const Key &key, Category category, bool *found ) {
+	const unsigned hash = Hash( key );
+	Entry *freeEntry = nullptr;
+
+	for( unsigned i = 0; i < MAX_PROBES; ++i ) {
+		Entry *entry = &entries[( hash + i ) & ( NUM_ENTRIES - 1 )];
+		if( entry->frameNum != level.framenum ) {
+			// Keep probing, the key might be further
+			if( !freeEntry ) {
+				freeEntry = entry;
+			}
+			continue;
+		}
+		if( entry->key == key ) {
+			stats[category].hits++;
+			*found = true;
+			return entry;
+		}
+	}
+
+	stats[category].misses++;
+	*found = false;
+
+	if( freeEntry ) {
+		return freeEntry;
+	}
+
+	// All probed entries are used in this frame, overwrite the first one
+	stats[category].evictions++;
+	return &entries[hash & ( NUM_ENTRIES - 1 )];
+}
+
+void AiTraceCache::Trace( trace_t *trace, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end,
+						  const edict_t *ignore, int contentMask, Category category ) {
+	if( !mins ) {
+		mins = vec3_origin;
+	}
+	if( !maxs ) {
+		maxs = vec3_origin;
+	}
+
+	Key key;
+	MakeKey( &key, start, mins, maxs, end, contentMask, ignore ? ENTNUM( ignore ) + 1 : 0 );
+
+	bool found;
+	Entry *entry = FindEntry( key, category, &found );
+	if( !found ) {
+		edict_t *ignore_ = const_cast<edict_t *>( ignore );
+		G_Trace( &entry->trace, const_cast<float *>( start ), const_cast<float *>( mins ), const_cast<float *>( maxs ),
+				 const_cast<float *>( end ), ignore_, contentMask );
+		entry->key = key;
+		entry->frameNum = level.framenum;
+	}
+
+	*trace = entry->trace;
+}
+
+void AiTraceCache::StaticWorldTrace( trace_t *trace, const vec3_t from, const vec3_t to, int contentMask,
+									 const vec3_t mins, const vec3_t maxs, Category category ) {
+	Key key;
+	MakeKey( &key, from, mins, maxs, to, contentMask, IGNORE_WORLD_ONLY );
+
+	bool found;
+	Entry *entry = FindEntry( key, category, &found );
+	if( !found ) {
+		::StaticWorldTrace( &entry->trace, from, to, contentMask, mins, maxs );
+		entry->key = key;
+		entry->frameNum = level.framenum;
+	}
+
+	*trace = entry->trace;
+}
+
+void AiTraceCache::StaticWorldTraceBatch( trace_t *traces, const vec3_t *from, const vec3_t *to, int numTraces,
+										  int contentMask, const vec3_t mins, const vec3_t maxs, Category category ) {
+	vec3_t missFrom[MAX_BATCH_MISSES], missTo[MAX_BATCH_MISSES];
+	trace_t missTraces[MAX_BATCH_MISSES];
+	Key missKeys[MAX_BATCH_MISSES];
+	int missIndices[MAX_BATCH_MISSES];
+	int numMisses = 0;
+
+	auto flushMisses = [&]() {
+		::StaticWorldTraceBatch( missTraces, missFrom, missTo, numMisses, contentMask, mins, maxs );
+		for( int j = 0; j < numMisses; ++j ) {
+			traces[missIndices[j]] = missTraces[j];
+			// Entries are looked up again as the ones found on lookup might have been taken by previous misses
+			const unsigned hash = Hash( missKeys[j] );
+			Entry *entry = &entries[hash & ( NUM_ENTRIES - 1 )];
+			for( unsigned k = 0; k < MAX_PROBES; ++k ) {
+				Entry *probed = &entries[( hash + k ) & ( NUM_ENTRIES - 1 )];
+				if( probed->frameNum != level.framenum ) {
+					entry = probed;
+					break;
+				}
+			}
+			entry->key = missKeys[j];
+			entry->frameNum = level.framenum;
+			entry->trace = missTraces[j];
+		}
+		numMisses = 0;
+	};
+
+	for( int i = 0; i < numTraces; ++i ) {
+		Key key;
+		MakeKey( &key, from[i], mins, maxs, to[i], contentMask, IGNORE_WORLD_ONLY );
+
+		bool found;
+		Entry *entry = FindEntry( key, category, &found );
+		if( found ) {
+			traces[i] = entry->trace;
+			continue;
+		}
+
+		VectorCopy( from[i], missFrom[numMisses] );
+		VectorCopy( to[i], missTo[numMisses] );
+		missKeys[numMisses] = key;
+		missIndices[numMisses] = i;
+		if( ++numMisses == MAX_BATCH_MISSES ) {
+			flushMisses();
+		}
+	}
+
+	if( numMisses ) {
+		flushMisses();
+	}
+}
+
+void AiTraceCache::PrintStats() const {
+	G_Printf( "%-12s %10s %10s %6s %10s\n", "category", "hits", "misses", "hit %", "evictions" );
+	for( int i = 0; i < NUM_CATEGORIES; ++i ) {
+		const Stats &s = stats[i];
+		const uint64_t total = s.hits + s.misses;
+		G_Printf( "%-12s %10" PRIu64 " %10" PRIu64 " %6.1f %10" PRIu64 "\n", categoryNames[i],
+				  s.hits, s.misses, total ? 100.0 * s.hits / total : 0.0, s.evictions );
+	}
+}
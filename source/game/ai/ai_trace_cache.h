@@ -0,0 +1,98 @@
+#ifndef QFUSION_AI_TRACE_CACHE_H
+#define QFUSION_AI_TRACE_CACHE_H
+
+#include "ai_local.h"
+
+// Memoizes traces done by all bots during a game frame, so equal rays are cast once.
+// Keys are quantized, so rays that differ by less than a quantization step share the result.
+// The storage is a fixed-size hash table, entries of previous frames are considered free.
+class AiTraceCache
+{
+public:
+	// Hit/miss counters are kept for each category of callers
+	enum Category {
+		GROUND,
+		ENVIRONMENT,
+		NEXT_REACH,
+		FIRE_TARGET,
+		OTHER,
+
+		NUM_CATEGORIES
+	};
+
+private:
+	static constexpr unsigned NUM_ENTRIES = 4096;   // must be a power of two
+	static constexpr unsigned MAX_PROBES = 8;
+	static constexpr float KEY_STEPS_PER_UNIT = 8.0f;
+	// Rays of a batch that missed are traced in chunks of this size
+	static constexpr int MAX_BATCH_MISSES = 16;
+
+	// A key ignore value of traces that do not check entities at all
+	static constexpr int IGNORE_WORLD_ONLY = -1;
+
+	struct Key {
+		int32_t start[3];
+		int32_t end[3];
+		int32_t mins[3];
+		int32_t maxs[3];
+		int contentMask;
+		int ignore;
+
+		bool operator==( const Key &that ) const {
+			return !memcmp( this, &that, sizeof( Key ) );
+		}
+	};
+
+	struct Entry {
+		Key key;
+		int64_t frameNum;
+		trace_t trace;
+	};
+
+	struct Stats {
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t evictions;
+	};
+
+	Entry *entries;
+	Stats stats[NUM_CATEGORIES];
+
+	AiTraceCache();
+	AiTraceCache( const AiTraceCache &that ) = delete;
+	AiTraceCache &operator=( const AiTraceCache &that ) = delete;
+
+	static void MakeKey( Key *key, const vec3_t start, const vec3_t mins, const vec3_t maxs,
+						 const vec3_t end, int contentMask, int ignore );
+	static unsigned Hash( const Key &key );
+
+	// Returns either an entry having the key or an entry the trace for the key should be written to
+	Entry *FindEntry( const Key &key, Category category, bool *found );
+
+public:
+	AiTraceCache( AiTraceCache &&that ) {
+		entries = that.entries;
+		memcpy( stats, that.stats, sizeof( stats ) );
+		that.entries = nullptr;
+	}
+	~AiTraceCache();
+
+	static AiTraceCache *Instance();
+
+	// A memoized G_Trace()
+	void Trace( trace_t *trace, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end,
+				const edict_t *ignore, int contentMask, Category category );
+
+	// A memoized ::StaticWorldTrace()
+	void StaticWorldTrace( trace_t *trace, const vec3_t from, const vec3_t to, int contentMask,
+						   const vec3_t mins, const vec3_t maxs, Category category );
+
+	// A memoized ::StaticWorldTraceBatch(), rays that are not cached yet are traced in batches
+	void StaticWorldTraceBatch( trace_t *traces, const vec3_t *from, const vec3_t *to, int numTraces,
+								int contentMask, const vec3_t mins, const vec3_t maxs, Category category );
+
+	void PrintStats() const;
+	void ResetStats() { memset( stats, 0, sizeof( stats ) ); }
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "AwarenessModule.h"
+#include "PerceptionSnapshot.h"
 #include "../teamplay/SquadBasedTeam.h"
 #include "../bot.h"
 
@@ -252,11 +253,10 @@ static bool IsEnemyVisible( const edict_t *self, const edict_t *enemyEnt ) {
 		// considered visible for a bot but is really visible, the bot behavior looks weird.
 		// That's why this special test is added.
 
-		// If the view height makes a considerable spatial distinction
+		// If the view height makes a considerable spatial distinction.
+		// The result is shared with the enemy (if it is a bot) for the current frame.
 		if( abs( enemyEnt->viewheight ) > 8 ) {
-			traceEnd.Z() += enemyEnt->viewheight;
-			G_Trace( &trace, traceStart.Data(), nullptr, nullptr, traceEnd.Data(), ignore, MASK_OPAQUE );
-			if( trace.fraction == 1.0f || gameEdicts + trace.ent == enemyEnt ) {
+			if( PerceptionSnapshot::Instance()->AreViewPointsVisible( self, enemyEnt ) ) {
 				return true;
 			}
 		}
@@ -325,9 +325,11 @@ void BotAwarenessModule::RegisterVisibleEnemies() {
 	// Note: non-client entities also may be candidate targets.
 	StaticVector<EntAndDistance, MAX_EDICTS> candidateTargets;
 
+	// Bot-independent tests have been already done for entities of the shared snapshot
+	// but an entity might have been freed after the snapshot has been built, so all tests are still performed.
 	edict_t *const gameEdicts = game.edicts;
-	for( int i = 1; i < game.numentities; ++i ) {
-		edict_t *ent = gameEdicts + i;
+	for( auto entNum: PerceptionSnapshot::Instance()->PotentialEnemies() ) {
+		edict_t *ent = gameEdicts + entNum;
 		if( self->ai->botRef->MayNotBeFeasibleEnemy( ent ) ) {
 			continue;
 		}
@@ -1,4 +1,5 @@
 #include "EnemiesTracker.h"
+#include "PerceptionSnapshot.h"
 #include "../bot.h"
 
 constexpr float MAX_ENEMY_WEIGHT = 5.0f;
@@ -229,10 +230,19 @@ int TrackedEnemy::GetBoxLeafNums( int **leafNums ) const {
 
 	boxLeafNumsComputedAt = levelTime;
 
+	// Leafs of a box at the current client origin are shared by all bots that track the client
+	Vec3 origin( LastSeenOrigin() );
+	if( ent->r.client && VectorCompare( origin.Data(), ent->s.origin ) ) {
+		const int *snapshotLeafNums;
+		numBoxLeafNums = PerceptionSnapshot::Instance()->GetClientBoxLeafNums( ent, &snapshotLeafNums );
+		std::copy_n( snapshotLeafNums, numBoxLeafNums, boxLeafNums );
+		*leafNums = boxLeafNums;
+		return numBoxLeafNums;
+	}
+
 	// We can't reuse entity leaf nums that were set on linking it to area grid since the origin differs
 	Vec3 enemyBoxMins( playerbox_stand_mins );
 	Vec3 enemyBoxMaxs( playerbox_stand_maxs );
-	Vec3 origin( LastSeenOrigin() );
 	enemyBoxMins += origin;
 	enemyBoxMaxs += origin;
 
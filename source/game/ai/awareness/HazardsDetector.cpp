@@ -1,7 +1,11 @@
 #include "HazardsDetector.h"
 #include "EntitiesPvsCache.h"
+#include "PerceptionSnapshot.h"
 
-
+// An entity might have been freed (and maybe reused) after the perception snapshot has been built this frame
+static inline bool IsStillOfType( const edict_t *ent, int type ) {
+	return ent->r.inuse && ent->s.type == type;
+}
 
 void HazardsDetector::Clear() {
 	maybeDangerousRockets.clear();
@@ -40,30 +44,37 @@ void HazardsDetector::Exec() {
 	// Own grenades are the only exception. We check grenade think time to skip grenades just fired by bot.
 	// If a grenade is about to explode and is close to bot, its likely it has bounced of the world and can hurt.
 
+	// Entities are already partitioned by type in the shared perception snapshot
+	const PerceptionSnapshot *snapshot = PerceptionSnapshot::Instance();
 	const edict_t *gameEdicts = game.edicts;
-	for( int i = gs.maxclients + 1, end = game.numentities; i < end; ++i ) {
-		const edict_t *ent = gameEdicts + i;
-		switch( ent->s.type ) {
-			case ET_ROCKET:
-				TryAddEntity( ent, DETECT_ROCKET_SQ_RADIUS, maybeDangerousRockets, maybeVisibleOtherRockets );
-				break;
-			case ET_WAVE:
-				TryAddEntity( ent, DETECT_WAVE_SQ_RADIUS, maybeDangerousWaves, maybeVisibleOtherWaves );
-				break;
-			case ET_PLASMA:
-				TryAddEntity( ent, DETECT_PLASMA_SQ_RADIUS, maybeDangerousPlasmas, maybeVisibleOtherPlasmas );
-				break;
-			case ET_BLASTER:
-				TryAddEntity( ent, DETECT_GB_BLAST_SQ_RADIUS, maybeDangerousBlasts, maybeVisibleOtherBlasts );
-				break;
-			case ET_GRENADE:
-				TryAddGrenade( ent, maybeDangerousGrenades, maybeVisibleOtherGrenades );
-				break;
-			case ET_LASERBEAM:
-				TryAddEntity( ent, DETECT_LG_BEAM_SQ_RADIUS, maybeDangerousLasers, maybeVisibleOtherLasers );
-				break;
-			default:
-				break;
+	for( auto entNum: snapshot->HazardEnts( PerceptionSnapshot::ROCKET ) ) {
+		if( IsStillOfType( gameEdicts + entNum, ET_ROCKET ) ) {
+			TryAddEntity( gameEdicts + entNum, DETECT_ROCKET_SQ_RADIUS, maybeDangerousRockets, maybeVisibleOtherRockets );
+		}
+	}
+	for( auto entNum: snapshot->HazardEnts( PerceptionSnapshot::WAVE ) ) {
+		if( IsStillOfType( gameEdicts + entNum, ET_WAVE ) ) {
+			TryAddEntity( gameEdicts + entNum, DETECT_WAVE_SQ_RADIUS, maybeDangerousWaves, maybeVisibleOtherWaves );
+		}
+	}
+	for( auto entNum: snapshot->HazardEnts( PerceptionSnapshot::PLASMA ) ) {
+		if( IsStillOfType( gameEdicts + entNum, ET_PLASMA ) ) {
+			TryAddEntity( gameEdicts + entNum, DETECT_PLASMA_SQ_RADIUS, maybeDangerousPlasmas, maybeVisibleOtherPlasmas );
+		}
+	}
+	for( auto entNum: snapshot->HazardEnts( PerceptionSnapshot::BLAST ) ) {
+		if( IsStillOfType( gameEdicts + entNum, ET_BLASTER ) ) {
+			TryAddEntity( gameEdicts + entNum, DETECT_GB_BLAST_SQ_RADIUS, maybeDangerousBlasts, maybeVisibleOtherBlasts );
+		}
+	}
+	for( auto entNum: snapshot->HazardEnts( PerceptionSnapshot::GRENADE ) ) {
+		if( IsStillOfType( gameEdicts + entNum, ET_GRENADE ) ) {
+			TryAddGrenade( gameEdicts + entNum, maybeDangerousGrenades, maybeVisibleOtherGrenades );
+		}
+	}
+	for( auto entNum: snapshot->HazardEnts( PerceptionSnapshot::LASER ) ) {
+		if( IsStillOfType( gameEdicts + entNum, ET_LASERBEAM ) ) {
+			TryAddEntity( gameEdicts + entNum, DETECT_LG_BEAM_SQ_RADIUS, maybeDangerousLasers, maybeVisibleOtherLasers );
 		}
 	}
 
@@ -1,5 +1,6 @@
 #include "HazardsSelector.h"
 #include "AwarenessModule.h"
+#include "PerceptionSnapshot.h"
 
 #include "../ai_shutdown_hooks_holder.h"
 #include "../ai_caching_game_allocator.h"
@@ -460,22 +461,22 @@ void HazardsSelector::FindLaserHazards( const EntNumsVector &entNums ) {
 }
 
 void HazardsSelector::FindProjectileHazards( const EntNumsVector &entNums ) {
-	trace_t trace;
 	float minPrjFraction = 1.0f;
 	float minDamageScore = 0.0f;
 	Vec3 botOrigin( self->s.origin );
 	edict_t *const gameEdicts = game.edicts;
+	// Impacts are predicted once per frame for all bots
+	PerceptionSnapshot *snapshot = PerceptionSnapshot::Instance();
 
 	for( unsigned i = 0; i < entNums.size(); ++i ) {
 		edict_t *target = gameEdicts + entNums[i];
-		Vec3 end = Vec3( target->s.origin ) + 2.0f * Vec3( target->velocity );
-		G_Trace( &trace, target->s.origin, target->r.mins, target->r.maxs, end.Data(), target, MASK_AISOLID );
-		if( trace.fraction >= minPrjFraction ) {
+		const auto &impact = snapshot->PredictedImpact( target );
+		if( impact.fraction >= minPrjFraction ) {
 			continue;
 		}
 
-		minPrjFraction = trace.fraction;
-		float hitVecLen = botOrigin.FastDistanceTo( trace.endpos );
+		minPrjFraction = impact.fraction;
+		float hitVecLen = botOrigin.FastDistanceTo( impact.point );
 		if( hitVecLen >= 1.25f * target->projectileInfo.radius ) {
 			continue;
 		}
@@ -494,7 +495,7 @@ void HazardsSelector::FindProjectileHazards( const EntNumsVector &entNums ) {
 		} else {
 			direction = Vec3( &axis_identity[AXIS_UP] );
 		}
-		if( TryAddHazard( damageScore, trace.endpos, direction.Data(),
+		if( TryAddHazard( damageScore, impact.point, direction.Data(),
 						  gameEdicts + target->s.ownerNum,
 						  1.25f * target->projectileInfo.radius ) ) {
 			minDamageScore = damageScore;
@@ -0,0 +1,197 @@
+#include "PerceptionSnapshot.h"
+#include "../ai_trajectory_predictor.h"
+
+PerceptionSnapshot PerceptionSnapshot::instance;
+
+void PerceptionSnapshot::ResetTimestamps() {
+	builtAtFrame = -1;
+	std::fill_n( impactsComputedAt, MAX_EDICTS, -1 );
+	std::fill_n( clientLeafsComputedAt, MAX_CLIENTS, -1 );
+}
+
+void PerceptionSnapshot::Build() {
+	builtAtFrame = level.framenum;
+
+	for( auto &ents: hazardEnts ) {
+		ents.clear();
+	}
+	potentialEnemies.clear();
+	// Visibility of clients changes every frame and it is cheaper to clear it at once than to keep timestamps
+	memset( &viewPointsVisStrings[0][0], 0, sizeof( viewPointsVisStrings ) );
+
+	const edict_t *gameEdicts = game.edicts;
+	const int maxClients = gs.maxclients;
+	for( int i = 1, end = game.numentities; i < end; ++i ) {
+		const edict_t *ent = gameEdicts + i;
+		if( !ent->r.inuse ) {
+			continue;
+		}
+
+		if( i > maxClients ) {
+			switch( ent->s.type ) {
+				case ET_ROCKET:
+					hazardEnts[ROCKET].push_back( (uint16_t)i );
+					break;
+				case ET_WAVE:
+					hazardEnts[WAVE].push_back( (uint16_t)i );
+					break;
+				case ET_PLASMA:
+					hazardEnts[PLASMA].push_back( (uint16_t)i );
+					break;
+				case ET_BLASTER:
+					hazardEnts[BLAST].push_back( (uint16_t)i );
+					break;
+				case ET_GRENADE:
+					hazardEnts[GRENADE].push_back( (uint16_t)i );
+					break;
+				case ET_LASERBEAM:
+					hazardEnts[LASER].push_back( (uint16_t)i );
+					break;
+				default:
+					break;
+			}
+		}
+
+		// These tests are the same as bot-independent tests of Ai::MayNotBeFeasibleEnemy()
+		if( !ent->r.client && ent->aiIntrinsicEnemyWeight <= 0.0f ) {
+			continue;
+		}
+		if( G_ISGHOSTING( ent ) ) {
+			continue;
+		}
+		if( ( ent->flags & ( FL_NOTARGET | FL_BUSY ) ) && !( ent->s.effects & EF_CARRIER ) ) {
+			continue;
+		}
+		potentialEnemies.push_back( (uint16_t)i );
+	}
+}
+
+const PerceptionSnapshot::ProjectileImpact &PerceptionSnapshot::PredictedImpact( const edict_t *projectile ) {
+	const int entNum = ENTNUM( projectile );
+	ProjectileImpact *impact = &impacts[entNum];
+	if( impactsComputedAt[entNum] != level.framenum ) {
+		PredictProjectileImpact( projectile, impact );
+		impactsComputedAt[entNum] = level.framenum;
+	}
+	return *impact;
+}
+
+void PerceptionSnapshot::PredictProjectileImpact( const edict_t *projectile, ProjectileImpact *impact ) {
+	auto *ent = const_cast<edict_t *>( projectile );
+	trace_t trace;
+
+	if( projectile->s.type != ET_GRENADE ) {
+		Vec3 end( projectile->velocity );
+		end *= PROJECTILE_PREDICTION_SECONDS;
+		end += projectile->s.origin;
+		G_Trace( &trace, ent->s.origin, ent->r.mins, ent->r.maxs, end.Data(), ent, MASK_AISOLID );
+		VectorCopy( trace.endpos, impact->point );
+		impact->fraction = trace.fraction;
+		return;
+	}
+
+	constexpr unsigned stepMillis = 250;
+	AiTrajectoryPredictor predictor;
+	predictor.SetStepMillis( stepMillis );
+	predictor.SetNumSteps( (unsigned)( 1000 * PROJECTILE_PREDICTION_SECONDS ) / stepMillis );
+	predictor.SetColliderBounds( projectile->r.mins, projectile->r.maxs );
+	predictor.SetEntitiesCollisionProps( true, ENTNUM( projectile ) );
+	predictor.AddStopEventFlags( AiTrajectoryPredictor::HIT_SOLID );
+
+	AiTrajectoryPredictor::Results predictionResults;
+	predictionResults.trace = &trace;
+	auto stopEvents = predictor.Run( projectile->velocity, projectile->s.origin, &predictionResults );
+	if( !( stopEvents & ( AiTrajectoryPredictor::HIT_SOLID | AiTrajectoryPredictor::HIT_ENTITY ) ) ) {
+		VectorCopy( predictionResults.origin, impact->point );
+		impact->fraction = 1.0f;
+		return;
+	}
+
+	VectorCopy( trace.endpos, impact->point );
+	// The trace covers the last prediction step
+	const float impactMillis = predictionResults.millisAhead - stepMillis + trace.fraction * stepMillis;
+	impact->fraction = std::min( 1.0f, impactMillis / ( 1000 * PROJECTILE_PREDICTION_SECONDS ) );
+}
+
+int PerceptionSnapshot::GetClientBoxLeafNums( const edict_t *client, const int **leafNums ) {
+	const int playerNum = PLAYERNUM( client );
+	if( clientLeafsComputedAt[playerNum] != level.framenum || !VectorCompare( clientLeafsOrigins[playerNum], client->s.origin ) ) {
+		Vec3 boxMins( playerbox_stand_mins );
+		Vec3 boxMaxs( playerbox_stand_maxs );
+		boxMins += client->s.origin;
+		boxMaxs += client->s.origin;
+
+		int topNode;
+		int numLeafs = trap_CM_BoxLeafnums( boxMins.Data(), boxMaxs.Data(), clientLeafNums[playerNum], MAX_CLIENT_LEAFS, &topNode );
+		clamp_high( numLeafs, MAX_CLIENT_LEAFS );
+		numClientLeafs[playerNum] = numLeafs;
+		clientLeafsComputedAt[playerNum] = level.framenum;
+		VectorCopy( client->s.origin, clientLeafsOrigins[playerNum] );
+	}
+
+	*leafNums = clientLeafNums[playerNum];
+	return numClientLeafs[playerNum];
+}
+
+bool PerceptionSnapshot::AreViewPointsVisible( const edict_t *client1, const edict_t *client2 ) {
+	// Bots think one after another, so a result may have been computed before one of clients has moved
+	InvalidateViewPointsVisIfMoved( client1 );
+	InvalidateViewPointsVisIfMoved( client2 );
+
+	// Prevent undefined behaviour of signed shifts
+	const auto playerNum1 = (unsigned)PLAYERNUM( client1 );
+	const auto playerNum2 = (unsigned)PLAYERNUM( client2 );
+
+	uint32_t *client1Vis = viewPointsVisStrings[playerNum1];
+	const unsigned client2ArrayOffset = ( playerNum2 * 2 ) / 32;
+	const unsigned client2BitsOffset = ( playerNum2 * 2 ) % 32;
+
+	unsigned client2Bits = ( client1Vis[client2ArrayOffset] >> client2BitsOffset ) & 0x3;
+	if( client2Bits != 0 ) {
+		return client2Bits == 2;
+	}
+
+	const bool result = AreViewPointsVisibleUncached( client1, client2 );
+
+	// Set the result for both clients
+	uint32_t *client2Vis = viewPointsVisStrings[playerNum2];
+	const unsigned client1ArrayOffset = ( playerNum1 * 2 ) / 32;
+	const unsigned client1BitsOffset = ( playerNum1 * 2 ) % 32;
+
+	const unsigned bits = (unsigned)result + 1;
+	client1Vis[client2ArrayOffset] &= ~( 0x3u << client2BitsOffset );
+	client1Vis[client2ArrayOffset] |= bits << client2BitsOffset;
+	client2Vis[client1ArrayOffset] &= ~( 0x3u << client1BitsOffset );
+	client2Vis[client1ArrayOffset] |= bits << client1BitsOffset;
+
+	return result;
+}
+
+void PerceptionSnapshot::InvalidateViewPointsVisIfMoved( const edict_t *client ) {
+	const auto playerNum = (unsigned)PLAYERNUM( client );
+	if( VectorCompare( viewPointsVisOrigins[playerNum], client->s.origin ) ) {
+		return;
+	}
+
+	VectorCopy( client->s.origin, viewPointsVisOrigins[playerNum] );
+
+	// Clear the row and the column of the client
+	memset( viewPointsVisStrings[playerNum], 0, sizeof( viewPointsVisStrings[playerNum] ) );
+	const unsigned arrayOffset = ( playerNum * 2 ) / 32;
+	const uint32_t bitsMask = ~( 0x3u << ( ( playerNum * 2 ) % 32 ) );
+	for( auto &visString: viewPointsVisStrings ) {
+		visString[arrayOffset] &= bitsMask;
+	}
+}
+
+bool PerceptionSnapshot::AreViewPointsVisibleUncached( const edict_t *client1, const edict_t *client2 ) {
+	Vec3 viewPoint1( client1->s.origin );
+	viewPoint1.Z() += client1->viewheight;
+	Vec3 viewPoint2( client2->s.origin );
+	viewPoint2.Z() += client2->viewheight;
+
+	// Bodies are not opaque, so the result does not depend on a direction of the trace
+	trace_t trace;
+	G_Trace( &trace, viewPoint1.Data(), nullptr, nullptr, viewPoint2.Data(), const_cast<edict_t *>( client1 ), MASK_OPAQUE );
+	return trace.fraction == 1.0f || trace.ent == ENTNUM( client2 );
+}
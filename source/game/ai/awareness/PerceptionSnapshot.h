@@ -0,0 +1,100 @@
+#ifndef QFUSION_PERCEPTIONSNAPSHOT_H
+#define QFUSION_PERCEPTIONSNAPSHOT_H
+
+#include "AwarenessLocal.h"
+
+// A part of the world state that is perceived in the same way by all bots.
+// It is built once per frame on the first request, so awareness modules of every bot
+// do not have to scan all entities and repeat the same bot-independent tests.
+// Results of costly tests are computed lazily and are kept until the next frame.
+class PerceptionSnapshot {
+public:
+	enum HazardType {
+		ROCKET,
+		WAVE,
+		PLASMA,
+		BLAST,
+		GRENADE,
+		LASER,
+
+		NUM_HAZARD_TYPES
+	};
+
+	// A first solid or entity hit by a projectile during the prediction period
+	struct ProjectileImpact {
+		vec3_t point;
+		// A part of the prediction period the projectile flies before the impact (1.0 if there is no impact)
+		float fraction;
+	};
+
+	static constexpr float PROJECTILE_PREDICTION_SECONDS = 2.0f;
+
+private:
+	static constexpr int MAX_CLIENT_LEAFS = 8;
+	// 2 bits for every pair of clients
+	static constexpr unsigned VIS_DATA_STRIDE = 2 * ( MAX_CLIENTS / 32 );
+
+	int64_t builtAtFrame;
+
+	EntNumsVector hazardEnts[NUM_HAZARD_TYPES];
+	StaticVector<uint16_t, MAX_EDICTS> potentialEnemies;
+
+	// Indexed by entity numbers
+	ProjectileImpact impacts[MAX_EDICTS];
+	int64_t impactsComputedAt[MAX_EDICTS];
+
+	// Indexed by player numbers
+	int clientLeafNums[MAX_CLIENTS][MAX_CLIENT_LEAFS];
+	int numClientLeafs[MAX_CLIENTS];
+	int64_t clientLeafsComputedAt[MAX_CLIENTS];
+	// Clients (bots) may move during a frame, so leafs are valid only for this origin
+	vec3_t clientLeafsOrigins[MAX_CLIENTS];
+
+	// A mutual visibility of view points of clients (it is symmetric, so a result is shared by both clients).
+	// An entry is 0 if the visibility has not been tested yet, 1 if view points are not visible, 2 otherwise.
+	uint32_t viewPointsVisStrings[MAX_CLIENTS][VIS_DATA_STRIDE];
+	// Entries of a client are valid only for this origin
+	vec3_t viewPointsVisOrigins[MAX_CLIENTS];
+
+	static PerceptionSnapshot instance;
+
+	void Build();
+	void ResetTimestamps();
+	void InvalidateViewPointsVisIfMoved( const edict_t *client );
+
+	static void PredictProjectileImpact( const edict_t *projectile, ProjectileImpact *impact );
+	static bool AreViewPointsVisibleUncached( const edict_t *client1, const edict_t *client2 );
+public:
+	PerceptionSnapshot() {
+		ResetTimestamps();
+	}
+
+	// Frame numbers start from zero on every map, so timestamps of a previous map must be dropped
+	static void Init() {
+		instance.ResetTimestamps();
+	}
+
+	static PerceptionSnapshot *Instance() {
+		if( instance.builtAtFrame != level.framenum ) {
+			instance.Build();
+		}
+		return &instance;
+	}
+
+	// Entities of the hazard type that were in use at the moment of building (owners and teams are not tested)
+	const EntNumsVector &HazardEnts( HazardType type ) const { return hazardEnts[type]; }
+
+	// Entities that pass all tests of Ai::MayNotBeFeasibleEnemy() that do not depend on a particular bot
+	const StaticVector<uint16_t, MAX_EDICTS> &PotentialEnemies() const { return potentialEnemies; }
+
+	// Predicts a straight movement for rockets and blasts and a gravity-affected one for grenades
+	const ProjectileImpact &PredictedImpact( const edict_t *projectile );
+
+	// Returns leafs touched by a standing player box at the current client origin
+	int GetClientBoxLeafNums( const edict_t *client, const int **leafNums );
+
+	// Tests whether there is a clear line between view points of clients
+	bool AreViewPointsVisible( const edict_t *client1, const edict_t *client2 );
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include "FireTargetCache.h"
 #include "../ai_trajectory_predictor.h"
 #include "../ai_shutdown_hooks_holder.h"
+#include "../ai_trace_cache.h"
 #include "../bot.h"
 
 class FixedBitVector
@@ -235,7 +236,8 @@ bool BotFireTargetCache::AdjustTargetByEnvironmentTracing( const SelectedEnemies
 		groundPoint.Z() += playerbox_stand_maxs[2];
 		// Check whether shot to this point is not blocked
 		edict_t *self = game.edicts + bot->EntNum();
-		G_Trace( &trace, firePoint, nullptr, nullptr, groundPoint.Data(), self, MASK_AISOLID );
+		AiTraceCache::Instance()->Trace( &trace, firePoint, nullptr, nullptr,
+										 groundPoint.Data(), self, MASK_AISOLID, AiTraceCache::FIRE_TARGET );
 		if( trace.fraction > 0.999f || selectedEnemies.TraceKey() == game.edicts + trace.ent ) {
 			float skill = bot->Skill();
 			// For mid-skill bots it may be enough. Do not waste cycles.
@@ -263,7 +265,8 @@ bool BotFireTargetCache::AdjustTargetByEnvironmentTracing( const SelectedEnemies
 
 	// We hope this function will be called rarely only when somebody wants to load a stripped Q3 AAS.
 	// Just trace an environment behind the bot, it is better than it used to be anyway.
-	G_Trace( &trace, aimParams->fireTarget, nullptr, nullptr, traceEnd.Data(), traceKey, MASK_AISOLID );
+	AiTraceCache::Instance()->Trace( &trace, aimParams->fireTarget, nullptr, nullptr,
+									 traceEnd.Data(), traceKey, MASK_AISOLID, AiTraceCache::FIRE_TARGET );
 	if( trace.fraction != 1.0f ) {
 		// First check whether an explosion in the point behind may damage the target to cut a trace quickly
 		float sqDistance = DistanceSquared( aimParams->fireTarget, trace.endpos );
@@ -272,7 +275,8 @@ bool BotFireTargetCache::AdjustTargetByEnvironmentTracing( const SelectedEnemies
 			Vec3 pointBehind( trace.endpos );
 			// Check whether shot to this point is not blocked
 			edict_t *self = game.edicts + bot->EntNum();
-			G_Trace( &trace, firePoint, nullptr, nullptr, pointBehind.Data(), self, MASK_AISOLID );
+			AiTraceCache::Instance()->Trace( &trace, firePoint, nullptr, nullptr,
+											 pointBehind.Data(), self, MASK_AISOLID, AiTraceCache::FIRE_TARGET );
 			if( trace.fraction > 0.999f || selectedEnemies.TraceKey() == game.edicts + trace.ent ) {
 				minSqDistance = sqDistance;
 				VectorCopy( pointBehind.Data(), nearestPoint );
@@ -305,7 +309,8 @@ bool BotFireTargetCache::AdjustTargetByEnvironmentWithAAS( const SelectedEnemies
 	for( const PointAndDistance &pointAndDistance: closestAreaFacePoints ) {
 		float *traceEnd = const_cast<float*>( pointAndDistance.point.Data() );
 		edict_t *passent = game.edicts + bot->EntNum();
-		G_Trace( &trace, aimParams->fireOrigin, nullptr, nullptr, traceEnd, passent, MASK_AISOLID );
+		AiTraceCache::Instance()->Trace( &trace, aimParams->fireOrigin, nullptr, nullptr,
+										 traceEnd, passent, MASK_AISOLID, AiTraceCache::FIRE_TARGET );
 
 		if( trace.fraction > 0.999f || selectedEnemies.TraceKey() == game.edicts + trace.ent ) {
 			VectorCopy( traceEnd, aimParams->fireTarget );
@@ -562,7 +567,8 @@ static inline void TryAimingAtGround( trace_t *trace, AimParams *aimParams, edic
 	// In this case try fallback to the ground below the target.
 	Vec3 endPoint( 0, 0, -128 );
 	endPoint += aimParams->fireTarget;
-	G_Trace( trace, aimParams->fireTarget, nullptr, nullptr, endPoint.Data(), traceKey, MASK_AISOLID );
+	AiTraceCache::Instance()->Trace( trace, aimParams->fireTarget, nullptr, nullptr,
+									 endPoint.Data(), traceKey, MASK_AISOLID, AiTraceCache::FIRE_TARGET );
 	if( trace->fraction != 1.0f ) {
 		VectorCopy( trace->endpos, aimParams->fireTarget );
 		// Add some offset from the ground (enviroment tests probably expect this input).
@@ -729,7 +735,8 @@ void BotFireTargetCache::PredictProjectileShot( const SelectedEnemies &selectedE
 	// Test a segment between predicted target and initial target
 	// Aim at the trace hit point if there is an obstacle.
 	// Aim at the predicted target otherwise.
-	G_Trace( &trace, aimParams->fireTarget, nullptr, nullptr, predictedTarget.Data(), traceKey, MASK_AISOLID );
+	AiTraceCache::Instance()->Trace( &trace, aimParams->fireTarget, nullptr, nullptr,
+									 predictedTarget.Data(), traceKey, MASK_AISOLID, AiTraceCache::FIRE_TARGET );
 	if( trace.fraction == 1.0f ) {
 		VectorCopy( predictedTarget.Data(), aimParams->fireTarget );
 	} else {
@@ -37,10 +37,25 @@ SpotsAndScoreVector &TacticalSpotsProblemSolver::SelectCandidateSpots( const Spo
 	return result;
 }
 
+void TacticalSpotsProblemSolver::FindTravelTimesFromOrigin( const SpotAndScore *spotsAndScores, int numSpots,
+															 const bool *skipSpots, int *travelTimes ) {
+	const auto *const spots = tacticalSpotsRegistry->spots;
+	// AAS uses travel time in centiseconds
+	const int maxFeasibleTravelTimeCentis = problemParams.maxFeasibleTravelTimeMillis / 10;
+
+	int areaNums[MAX_ROUTING_QUERY_SPOTS];
+	for( int i = 0; i < numSpots; ++i ) {
+		// Zero area numbers are not valid goals and are just skipped by the routing query
+		areaNums[i] = skipSpots[i] ? 0 : spots[spotsAndScores[i].spotNum].aasAreaNum;
+	}
+
+	// The search stops as soon as all spots are reached or the max feasible travel time is exceeded
+	originParams.routeCache->TravelTimesToGoalAreas( &originParams.originAreaNum, 1, areaNums, numSpots,
+													 Bot::ALLOWED_TRAVEL_FLAGS, maxFeasibleTravelTimeCentis, travelTimes );
+}
+
 SpotsAndScoreVector &TacticalSpotsProblemSolver::CheckSpotsReachFromOrigin( SpotsAndScoreVector &candidateSpots,
 																			uint16_t insideSpotNum ) {
-	AiAasRouteCache *routeCache = originParams.routeCache;
-	const int originAreaNum = originParams.originAreaNum;
 	const float *origin = originParams.origin;
 	const float searchRadius = originParams.searchRadius;
 	// AAS uses travel time in centiseconds
@@ -48,42 +63,34 @@ SpotsAndScoreVector &TacticalSpotsProblemSolver::CheckSpotsReachFromOrigin( Spot
 	const float weightFalloffDistanceRatio = problemParams.originWeightFalloffDistanceRatio;
 	const float distanceInfluence = problemParams.originDistanceInfluence;
 	const float travelTimeInfluence = problemParams.travelTimeInfluence;
-	const auto travelFlags = Bot::ALLOWED_TRAVEL_FLAGS;
 	const auto *const spots = tacticalSpotsRegistry->spots;
 
 	SpotsAndScoreVector &result = tacticalSpotsRegistry->temporariesAllocator.GetNextCleanSpotsAndScoreVector();
 
-	// Do not more than result.capacity() iterations.
-	// Some feasible areas in candidateAreas tai that pass test may be skipped,
-	// but this is intended to reduce performance drops (do not more than result.capacity() pathfinder calls).
-	if( insideSpotNum < MAX_SPOTS ) {
-		const auto *travelTimeTable = tacticalSpotsRegistry->spotTravelTimeTable;
-		const auto tableRowOffset = insideSpotNum * this->tacticalSpotsRegistry->numSpots;
-		for( const SpotAndScore &spotAndScore: candidateSpots ) {
-			const TacticalSpot &spot = spots[spotAndScore.spotNum];
-			// If zero, the spotNum spot is not reachable from insideSpotNum
-			int tableTravelTime = travelTimeTable[tableRowOffset + spotAndScore.spotNum];
-			if( !tableTravelTime || tableTravelTime > maxFeasibleTravelTimeCentis ) {
-				continue;
+	bool skipSpots[MAX_ROUTING_QUERY_SPOTS];
+	int travelTimes[MAX_ROUTING_QUERY_SPOTS];
+	const auto *travelTimeTable = tacticalSpotsRegistry->spotTravelTimeTable;
+	const auto tableRowOffset = insideSpotNum * this->tacticalSpotsRegistry->numSpots;
+	// Travel times to spots are found by a single routing query for MAX_ROUTING_QUERY_SPOTS spots
+	for( unsigned chunkStart = 0; chunkStart < candidateSpots.size(); chunkStart += MAX_ROUTING_QUERY_SPOTS ) {
+		const SpotAndScore *chunkSpots = candidateSpots.begin() + chunkStart;
+		const int chunkSize = (int)std::min( candidateSpots.size() - chunkStart, (unsigned)MAX_ROUTING_QUERY_SPOTS );
+		for( int i = 0; i < chunkSize; ++i ) {
+			skipSpots[i] = false;
+			if( insideSpotNum < MAX_SPOTS ) {
+				// If zero, the spotNum spot is not reachable from insideSpotNum.
+				// A non-zero table value does not guarantee reachability, so an actual travel time is still found.
+				int tableTravelTime = travelTimeTable[tableRowOffset + chunkSpots[i].spotNum];
+				skipSpots[i] = !tableTravelTime || tableTravelTime > maxFeasibleTravelTimeCentis;
 			}
+		}
 
-			// Get an actual travel time (non-zero table value does not guarantee reachability)
-			int travelTime = routeCache->TravelTimeToGoalArea( originAreaNum, spot.aasAreaNum, travelFlags );
-			if( !travelTime || travelTime > maxFeasibleTravelTimeCentis ) {
-				continue;
-			}
+		FindTravelTimesFromOrigin( chunkSpots, chunkSize, skipSpots, travelTimes );
 
-			float travelTimeFactor = 1.0f - ComputeTravelTimeFactor( travelTime, maxFeasibleTravelTimeCentis );
-			float distanceFactor = ComputeDistanceFactor( spot.origin, origin, weightFalloffDistanceRatio, searchRadius );
-			float newScore = spotAndScore.score;
-			newScore = ApplyFactor( newScore, distanceFactor, distanceInfluence );
-			newScore = ApplyFactor( newScore, travelTimeFactor, travelTimeInfluence );
-			result.push_back( SpotAndScore( spotAndScore.spotNum, newScore ) );
-		}
-	} else {
-		for( const SpotAndScore &spotAndScore: candidateSpots ) {
+		for( int i = 0; i < chunkSize; ++i ) {
+			const SpotAndScore &spotAndScore = chunkSpots[i];
 			const TacticalSpot &spot = spots[spotAndScore.spotNum];
-			int travelTime = routeCache->TravelTimeToGoalArea( originAreaNum, spot.aasAreaNum, travelFlags );
+			const int travelTime = travelTimes[i];
 			if( !travelTime || travelTime > maxFeasibleTravelTimeCentis ) {
 				continue;
 			}
@@ -118,31 +125,36 @@ SpotsAndScoreVector &TacticalSpotsProblemSolver::CheckSpotsReachFromOriginAndBac
 
 	SpotsAndScoreVector &result = tacticalSpotsRegistry->temporariesAllocator.GetNextCleanSpotsAndScoreVector();
 
-	// Do not more than result.capacity() iterations.
-	// Some feasible areas in candidateAreas tai that pass test may be skipped,
-	// but it is intended to reduce performance drops (do not more than 2 * result.capacity() pathfinder calls).
-	if( insideSpotNum < MAX_SPOTS ) {
-		const auto *travelTimeTable = tacticalSpotsRegistry->spotTravelTimeTable;
-		const auto numSpots_ = tacticalSpotsRegistry->numSpots;
-		for( const SpotAndScore &spotAndScore : candidateSpots ) {
-			const TacticalSpot &spot = spots[spotAndScore.spotNum];
-
-			// If the table element i * numSpots_ + j is zero, j-th spot is not reachable from i-th one.
-			int tableToTravelTime = travelTimeTable[insideSpotNum * numSpots_ + spotAndScore.spotNum];
-			if( !tableToTravelTime ) {
-				continue;
-			}
-			int tableBackTravelTime = travelTimeTable[spotAndScore.spotNum * numSpots_ + insideSpotNum];
-			if( !tableBackTravelTime ) {
-				continue;
-			}
-			if( tableToTravelTime + tableBackTravelTime > maxFeasibleTravelTimeCentis ) {
-				continue;
+	bool skipSpots[MAX_ROUTING_QUERY_SPOTS];
+	int toTravelTimes[MAX_ROUTING_QUERY_SPOTS];
+	const auto *travelTimeTable = tacticalSpotsRegistry->spotTravelTimeTable;
+	const auto numSpots_ = tacticalSpotsRegistry->numSpots;
+	// `To` travel times are found by a single routing query for MAX_ROUTING_QUERY_SPOTS spots.
+	// `Back` travel times are to the same origin area, so they share the same area routing cache.
+	for( unsigned chunkStart = 0; chunkStart < candidateSpots.size(); chunkStart += MAX_ROUTING_QUERY_SPOTS ) {
+		const SpotAndScore *chunkSpots = candidateSpots.begin() + chunkStart;
+		const int chunkSize = (int)std::min( candidateSpots.size() - chunkStart, (unsigned)MAX_ROUTING_QUERY_SPOTS );
+		for( int i = 0; i < chunkSize; ++i ) {
+			skipSpots[i] = false;
+			if( insideSpotNum < MAX_SPOTS ) {
+				// If the table element i * numSpots_ + j is zero, j-th spot is not reachable from i-th one.
+				// Non-zero table values do not guarantee reachability, so actual travel times are still found.
+				const auto spotNum = chunkSpots[i].spotNum;
+				int tableToTravelTime = travelTimeTable[insideSpotNum * numSpots_ + spotNum];
+				int tableBackTravelTime = travelTimeTable[spotNum * numSpots_ + insideSpotNum];
+				skipSpots[i] = !tableToTravelTime || !tableBackTravelTime ||
+							   tableToTravelTime + tableBackTravelTime > maxFeasibleTravelTimeCentis;
 			}
+		}
+
+		FindTravelTimesFromOrigin( chunkSpots, chunkSize, skipSpots, toTravelTimes );
+
+		for( int i = 0; i < chunkSize; ++i ) {
+			const SpotAndScore &spotAndScore = chunkSpots[i];
+			const TacticalSpot &spot = spots[spotAndScore.spotNum];
 
-			// Get an actual travel time (non-zero table values do not guarantee reachability)
-			int toTravelTime = routeCache->TravelTimeToGoalArea( originAreaNum, spot.aasAreaNum, travelFlags );
 			// If `to` travel time is apriori greater than maximum allowed one (and thus the sum would be), reject early.
+			const int toTravelTime = toTravelTimes[i];
 			if( !toTravelTime || toTravelTime > maxFeasibleTravelTimeCentis ) {
 				continue;
 			}
@@ -159,26 +171,6 @@ SpotsAndScoreVector &TacticalSpotsProblemSolver::CheckSpotsReachFromOriginAndBac
 			newScore = ApplyFactor( newScore, travelTimeFactor, travelTimeInfluence );
 			result.push_back( SpotAndScore( spotAndScore.spotNum, newScore ) );
 		}
-	} else {
-		for( const SpotAndScore &spotAndScore : candidateSpots ) {
-			const TacticalSpot &spot = spots[spotAndScore.spotNum];
-			int toSpotTime = routeCache->TravelTimeToGoalArea( originAreaNum, spot.aasAreaNum, Bot::ALLOWED_TRAVEL_FLAGS );
-			if( !toSpotTime ) {
-				continue;
-			}
-			int toEntityTime = routeCache->TravelTimeToGoalArea( spot.aasAreaNum, originAreaNum, Bot::ALLOWED_TRAVEL_FLAGS );
-			if( !toEntityTime ) {
-				continue;
-			}
-
-			int totalTravelTimeCentis = 10 * ( toSpotTime + toEntityTime );
-			float travelTimeFactor = ComputeTravelTimeFactor( totalTravelTimeCentis, maxFeasibleTravelTimeCentis );
-			float distanceFactor = ComputeDistanceFactor( spot.origin, origin, weightFalloffDistanceRatio, searchRadius );
-			float newScore = spotAndScore.score;
-			newScore = ApplyFactor( newScore, distanceFactor, distanceInfluence );
-			newScore = ApplyFactor( newScore, travelTimeFactor, travelTimeInfluence );
-			result.push_back( SpotAndScore( spotAndScore.spotNum, newScore ) );
-		}
 	}
 
 	// Sort result so best score areas are first
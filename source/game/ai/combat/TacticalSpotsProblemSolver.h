@@ -60,6 +60,13 @@ protected:
 
 	virtual SpotsAndScoreVector &SelectCandidateSpots( const SpotsQueryVector &spotsFromQuery );
 
+	// A number of spots that travel times are found for by a single routing query
+	static constexpr int MAX_ROUTING_QUERY_SPOTS = 768;
+
+	// Finds travel times from the origin to spots using allowed travel flags.
+	// Zero travel times are set for skipped spots, unreachable ones and ones that are not reachable in a feasible time.
+	void FindTravelTimesFromOrigin( const SpotAndScore *spotsAndScores, int numSpots, const bool *skipSpots, int *travelTimes );
+
 	virtual SpotsAndScoreVector &CheckSpotsReachFromOrigin( SpotsAndScoreVector &candidateSpots,
 															uint16_t insideSpotNum );
 
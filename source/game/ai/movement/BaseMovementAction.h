@@ -37,6 +37,9 @@ protected:
 	bool stopPredictionOnTouchingNavEntity;
 	bool stopPredictionOnEnteringWater;
 	bool failPredictionOnEnteringHazardImpactZone;
+	// Whether plans that consist of this action may be replayed by other bots from MovementRolloutCache.
+	// An input of the action should depend only on a state captured by a rollout key.
+	bool allowsRolloutCaching;
 
 	inline BaseMovementAction &DummyAction();
 	inline BaseMovementAction &DefaultWalkAction();
@@ -75,7 +78,8 @@ public:
 		, stopPredictionOnTouchingPlatform( true )
 		, stopPredictionOnTouchingNavEntity( true )
 		, stopPredictionOnEnteringWater( true )
-		, failPredictionOnEnteringHazardImpactZone( true ) {
+		, failPredictionOnEnteringHazardImpactZone( true )
+		, allowsRolloutCaching( false ) {
 		RegisterSelf();
 	}
 	virtual void PlanPredictionStep( MovementPredictionContext *context ) = 0;
@@ -110,6 +114,7 @@ public:
 	inline int DebugColor() const { return debugColor; }
 	inline unsigned ActionNum() const { return actionNum; }
 	inline bool IsDisabledForPlanning() const { return isDisabledForPlanning; }
+	inline bool AllowsRolloutCaching() const { return allowsRolloutCaching; }
 };
 
 #define DECLARE_MOVEMENT_ACTION_CONSTRUCTOR( name, debugColor_ ) \
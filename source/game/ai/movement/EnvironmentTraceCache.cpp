@@ -1,5 +1,6 @@
 #include "EnvironmentTraceCache.h"
 #include "MovementLocal.h"
+#include "../ai_trace_cache.h"
 
 inline unsigned EnvironmentTraceCache::SelectNonBlockedDirs( Context *context, unsigned *nonBlockedDirIndices ) {
 	this->TestForResultsMask( context, this->FullHeightMask( FULL_SIDES_MASK ) );
@@ -99,11 +100,11 @@ void EnvironmentTraceCache::MakeRandomKeyMoves( Context *context, int *keyMoves
 }
 
 void EnvironmentTraceCache::SetFullHeightCachedTracesEmpty( const vec3_t front2DDir, const vec3_t right2DDir ) {
-	for( unsigned i = 0; i < 6; ++i ) {
+	for( unsigned i = 0; i < 8; ++i ) {
 		auto &fullResult = results[i + 0];
-		auto &jumpableResult = results[i + 6];
-		fullResult.trace.fraction = 1.0f;
+		auto &jumpableResult = results[i + 8];
 		fullResult.trace.fraction = 1.0f;
+		jumpableResult.trace.fraction = 1.0f;
 		// We have to save a legal trace dir
 		MakeTraceDir( i, front2DDir, right2DDir, fullResult.traceDir );
 		VectorCopy( fullResult.traceDir, jumpableResult.traceDir );
@@ -113,8 +114,8 @@ void EnvironmentTraceCache::SetFullHeightCachedTracesEmpty( const vec3_t front2D
 }
 
 void EnvironmentTraceCache::SetJumpableHeightCachedTracesEmpty( const vec3_t front2DDir, const vec3_t right2DDir ) {
-	for( unsigned i = 0; i < 6; ++i ) {
-		auto &result = results[i + 6];
+	for( unsigned i = 0; i < 8; ++i ) {
+		auto &result = results[i + 8];
 		result.trace.fraction = 1.0f;
 		// We have to save a legal trace dir
 		MakeTraceDir( i, front2DDir, right2DDir, result.traceDir );
@@ -221,14 +222,16 @@ bool EnvironmentTraceCache::TrySkipTracingForCurrOrigin( Context *context, const
 
 	trace_t trace;
 	mins.Z() += 0.25f;
-	StaticWorldTrace( &trace, origin, origin, MASK_SOLID | MASK_WATER, mins.Data(), maxs.Data() );
+	AiTraceCache::Instance()->StaticWorldTrace( &trace, origin, origin, MASK_SOLID | MASK_WATER,
+												mins.Data(), maxs.Data(), AiTraceCache::ENVIRONMENT );
 	if( trace.fraction == 1.0f ) {
 		SetFullHeightCachedTracesEmpty( front2DDir, right2DDir );
 		return true;
 	}
 
 	mins.Z() += AI_JUMPABLE_HEIGHT - 1.0f;
-	StaticWorldTrace( &trace, origin, origin, MASK_SOLID | MASK_WATER, mins.Data(), maxs.Data() );
+	AiTraceCache::Instance()->StaticWorldTrace( &trace, origin, origin, MASK_SOLID | MASK_WATER,
+												mins.Data(), maxs.Data(), AiTraceCache::ENVIRONMENT );
 	if( trace.fraction == 1.0f ) {
 		SetJumpableHeightCachedTracesEmpty( front2DDir, right2DDir );
 		// We might still need to perform full height traces in TestForResultsMask()
@@ -264,10 +267,18 @@ void EnvironmentTraceCache::TestForResultsMask( Context *context, unsigned requi
 	// First, test all full side traces.
 	// If a full side trace is empty, a corresponding "jumpable" side trace can be set as empty too.
 
+	// Traces of the same height share the box and are done as a single batch
+	vec3_t traceEnds[8];
+	vec3_t traceStarts[8];
+	trace_t traces[8];
+	unsigned traceSides[8];
+	int numTraces;
+
 	// Test these bits for a quick computations shortcut
 	unsigned actualFullSides = this->resultsMask & FULL_SIDES_MASK;
 	unsigned resultFullSides = requiredResultsMask & FULL_SIDES_MASK;
 	if( ( actualFullSides & resultFullSides ) != resultFullSides ) {
+		numTraces = 0;
 		const unsigned endMask = FullHeightMask( LAST_SIDE );
 		for( unsigned i = 0, mask = FullHeightMask( FIRST_SIDE ); mask <= endMask; ++i, mask *= 2 ) {
 			if( !( mask & requiredResultsMask ) || ( mask & this->resultsMask ) ) {
@@ -276,20 +287,30 @@ void EnvironmentTraceCache::TestForResultsMask( Context *context, unsigned requi
 
 			MakeTraceDir( i, front2DDir, right2DDir, traceEnd );
 			// Save the trace dir
-			auto &fullResult = results[i];
-			VectorCopy( traceEnd, fullResult.traceDir );
+			VectorCopy( traceEnd, results[i].traceDir );
 			// Convert from a direction to the end point
 			VectorScale( traceEnd, TRACE_DEPTH, traceEnd );
-			VectorAdd( traceEnd, origin, traceEnd );
-			StaticWorldTrace( &fullResult.trace, origin, traceEnd, MASK_SOLID | MASK_WATER,
-							  playerbox_stand_mins, playerbox_stand_maxs );
+			VectorAdd( traceEnd, origin, traceEnds[numTraces] );
+			VectorCopy( origin, traceStarts[numTraces] );
+			traceSides[numTraces++] = i;
+		}
+
+		AiTraceCache::Instance()->StaticWorldTraceBatch( traces, traceStarts, traceEnds, numTraces,
+														 MASK_SOLID | MASK_WATER, playerbox_stand_mins,
+														 playerbox_stand_maxs, AiTraceCache::ENVIRONMENT );
+
+		for( int j = 0; j < numTraces; ++j ) {
+			const unsigned i = traceSides[j];
+			const unsigned mask = FullHeightMask( FIRST_SIDE ) << i;
+			auto &fullResult = results[i];
+			fullResult.trace = traces[j];
 			this->resultsMask |= mask;
 			// If full trace is empty, we can set partial trace as empty too
 			if( fullResult.trace.fraction == 1.0f ) {
-				auto &jumpableResult = results[i + 6];
+				auto &jumpableResult = results[i + 8];
 				jumpableResult.trace.fraction = 1.0f;
 				VectorCopy( fullResult.traceDir, jumpableResult.traceDir );
-				this->resultsMask |= ( mask << 6 );
+				this->resultsMask |= ( mask << 8 );
 			}
 		}
 	}
@@ -299,6 +320,7 @@ void EnvironmentTraceCache::TestForResultsMask( Context *context, unsigned requi
 	if( ( actualJumpableSides & resultJumpableSides ) != resultJumpableSides ) {
 		Vec3 mins( playerbox_stand_mins );
 		mins.Z() += AI_JUMPABLE_HEIGHT;
+		numTraces = 0;
 		const unsigned endMask = JumpableHeightMask( LAST_SIDE );
 		for( unsigned i = 0, mask = JumpableHeightMask( FIRST_SIDE ); mask <= endMask; ++i, mask *= 2 ) {
 			if( !( mask & requiredResultsMask ) || ( mask & this->resultsMask ) ) {
@@ -307,14 +329,22 @@ void EnvironmentTraceCache::TestForResultsMask( Context *context, unsigned requi
 
 			MakeTraceDir( i, front2DDir, right2DDir, traceEnd );
 			// Save the trace dir
-			auto &result = results[i + 6];
-			VectorCopy( traceEnd, result.traceDir );
+			VectorCopy( traceEnd, results[i + 8].traceDir );
 			// Convert from a direction to the end point
 			VectorScale( traceEnd, TRACE_DEPTH, traceEnd );
-			VectorAdd( traceEnd, origin, traceEnd );
-			StaticWorldTrace( &result.trace, origin, traceEnd, MASK_SOLID | MASK_WATER, mins.Data(), playerbox_stand_maxs );
+			VectorAdd( traceEnd, origin, traceEnds[numTraces] );
+			VectorCopy( origin, traceStarts[numTraces] );
+			traceSides[numTraces++] = i;
 			this->resultsMask |= mask;
 		}
+
+		AiTraceCache::Instance()->StaticWorldTraceBatch( traces, traceStarts, traceEnds, numTraces,
+														 MASK_SOLID | MASK_WATER, mins.Data(),
+														 playerbox_stand_maxs, AiTraceCache::ENVIRONMENT );
+
+		for( int j = 0; j < numTraces; ++j ) {
+			results[traceSides[j] + 8].trace = traces[j];
+		}
 	}
 
 	// Check whether all requires side traces have been computed
@@ -103,6 +103,7 @@ public:
 		ResetObstacleAvoidanceState();
 		// Do NOT stop prediction on this! We have to check where the bot is going to land!
 		stopPredictionOnTouchingNavEntity = false;
+		allowsRolloutCaching = true;
 	}
 
 	void CheckPredictionStepResults( MovementPredictionContext *context ) override;
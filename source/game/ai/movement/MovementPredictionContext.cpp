@@ -1,5 +1,6 @@
 #include "MovementPredictionContext.h"
 #include "MovementLocal.h"
+#include "MovementRolloutCache.h"
 
 bool MovementPredictionContext::CanSafelyKeepHighSpeed() {
 	if( const bool *cachedValue = canSafelyKeepHighSpeedCachesStack.GetCached() ) {
@@ -835,43 +836,49 @@ void MovementPredictionContext::BuildPlan() {
 	const AiEntityPhysicsState currEntityPhysicsState = module->movementState.entityPhysicsState;
 
 	// Remember to reset these values before each planning session
-	this->totalMillisAhead = 0;
-	this->savepointTopOfStackIndex = 0;
-	this->topOfStackIndex = 0;
-	this->activeAction = nullptr;
-	this->actionSuggestedByAction = nullptr;
-	this->sequenceStopReason = UNSPECIFIED;
-	this->isCompleted = false;
-	this->isTruncated = false;
-	this->shouldRollback = false;
+	ResetForPlanning();
+
+	MovementRolloutKey rolloutKey;
+	int travelTimeAtStart = 0;
+	const bool canUseRolloutCache = MakeRolloutKey( &rolloutKey, &travelTimeAtStart );
+	bool hasReplayedRollout = false;
+	if( canUseRolloutCache ) {
+		hasReplayedRollout = TryReplayCachedRollout( rolloutKey, travelTimeAtStart );
+		if( !hasReplayedRollout ) {
+			// Fall back to the full prediction starting from scratch
+			ResetForPlanning();
+		}
+	}
 
+	if( !hasReplayedRollout ) {
 #ifndef CHECK_INFINITE_NEXT_STEP_LOOPS
-	for(;; ) {
-		if( !NextPredictionStep() ) {
-			break;
+		for(;; ) {
+			if( !NextPredictionStep() ) {
+				break;
+			}
 		}
-	}
 #else
-	::nextStepIterationsCounter = 0;
-	for(;; ) {
-		if( !NextPredictionStep() ) {
-			break;
-		}
-		++nextStepIterationsCounter;
-		if( nextStepIterationsCounter < NEXT_STEP_INFINITE_LOOP_THRESHOLD ) {
-			continue;
-		}
-		// An verbose output has been enabled at this stage
-		if( nextStepIterationsCounter < NEXT_STEP_INFINITE_LOOP_THRESHOLD + 200 ) {
-			continue;
+		::nextStepIterationsCounter = 0;
+		for(;; ) {
+			if( !NextPredictionStep() ) {
+				break;
+			}
+			++nextStepIterationsCounter;
+			if( nextStepIterationsCounter < NEXT_STEP_INFINITE_LOOP_THRESHOLD ) {
+				continue;
+			}
+			// An verbose output has been enabled at this stage
+			if( nextStepIterationsCounter < NEXT_STEP_INFINITE_LOOP_THRESHOLD + 200 ) {
+				continue;
+			}
+			constexpr const char *message =
+				"MovementPredictionContext::BuildPlan(): "
+				"an infinite NextPredictionStep() loop has been detected. "
+				"Check the server console output of last 200 steps\n";
+			G_Error( "%s", message );
 		}
-		constexpr const char *message =
-			"MovementPredictionContext::BuildPlan(): "
-			"an infinite NextPredictionStep() loop has been detected. "
-			"Check the server console output of last 200 steps\n";
-		G_Error( "%s", message );
-	}
 #endif
+	}
 
 	// The entity might be linked for some predicted state by Intercepted_PMoveTouchTriggers()
 	GClip_UnlinkEntity( self );
@@ -906,6 +913,153 @@ void MovementPredictionContext::BuildPlan() {
 
 	for( auto *movementAction: module->movementActions )
 		movementAction->AfterPlanning();
+
+	if( canUseRolloutCache && !hasReplayedRollout ) {
+		SaveRolloutToCache( rolloutKey );
+	}
+}
+
+void MovementPredictionContext::ResetForPlanning() {
+	this->totalMillisAhead = 0;
+	this->savepointTopOfStackIndex = 0;
+	this->topOfStackIndex = 0;
+	this->activeAction = nullptr;
+	this->actionSuggestedByAction = nullptr;
+	this->sequenceStopReason = UNSPECIFIED;
+	this->isCompleted = false;
+	this->isTruncated = false;
+	this->shouldRollback = false;
+	this->cannotApplyAction = false;
+}
+
+bool MovementPredictionContext::MakeRolloutKey( MovementRolloutKey *key, int *travelTimeToNavTarget ) const {
+	// Check whether SuggestSuitableAction() is going to lead to regular bunnying actions
+	const auto &actualMovementState = module->movementState;
+	if( actualMovementState.GetContainedStatesMask() || module->activeMovementFallback ) {
+		return false;
+	}
+
+	const auto &entityPhysicsState = actualMovementState.entityPhysicsState;
+	if( entityPhysicsState.waterLevel > 1 ) {
+		return false;
+	}
+
+	if( const edict_t *groundEntity = entityPhysicsState.GroundEntity() ) {
+		if( groundEntity->use == Use_Plat ) {
+			return false;
+		}
+	}
+
+	// Bunnying input depends on an enemy origin in this case
+	if( bot->ShouldKeepXhairOnEnemy() ) {
+		return false;
+	}
+
+	const int navTargetAreaNum = NavTargetAasAreaNum();
+	if( !navTargetAreaNum ) {
+		return false;
+	}
+
+	int fromAreaNums[2];
+	const int numFromAreas = entityPhysicsState.PrepareRoutingStartAreas( fromAreaNums );
+	int reachNum = 0;
+	*travelTimeToNavTarget = bot->RouteCache()->PreferredRouteToGoalArea( fromAreaNums, numFromAreas, navTargetAreaNum, &reachNum );
+	if( !*travelTimeToNavTarget ) {
+		return false;
+	}
+
+	const edict_t *self = game.edicts + bot->EntNum();
+	const int pmoveFeatures = self->r.client->ps.pmove.stats[PM_STAT_FEATURES];
+	MovementRolloutCache::MakeKey( key, entityPhysicsState, navTargetAreaNum, reachNum, pmoveFeatures );
+	return true;
+}
+
+bool MovementPredictionContext::TryReplayCachedRollout( const MovementRolloutKey &key, int travelTimeAtStart ) {
+	auto *rolloutCache = MovementRolloutCache::Instance();
+	const auto *rollout = rolloutCache->Find( key );
+	if( !rollout ) {
+		return false;
+	}
+
+	const Vec3 startOrigin( module->movementState.entityPhysicsState.Origin() );
+	for( unsigned i = 0; i < rollout->numSteps; ++i ) {
+		const auto &step = rollout->steps[i];
+		SetupStackForStep();
+
+		// The replayed trajectory should not diverge from the cached one
+		Vec3 expectedOrigin( step.originOffset[0], step.originOffset[1], step.originOffset[2] );
+		expectedOrigin += startOrigin;
+		const float squareDeviation = expectedOrigin.SquareDistanceTo( movementState->entityPhysicsState.Origin() );
+		if( squareDeviation > MAX_ROLLOUT_REPLAY_DEVIATION * MAX_ROLLOUT_REPLAY_DEVIATION ) {
+			Debug( "Cached rollout replay has diverged at frame %d\n", topOfStackIndex );
+			rolloutCache->OnReplayFailed( key );
+			return false;
+		}
+
+		BaseMovementAction *action = module->movementActions[step.actionNum];
+		// Keep the pending weapon of the actual bot
+		const auto pendingWeapon = this->record->pendingWeapon;
+		*this->record = step.record;
+		this->record->pendingWeapon = pendingWeapon;
+		this->activeAction = action;
+		this->predictionStepMillis = step.stepMillis;
+
+		// The last step is a final state of the plan, there is no movement step for it
+		if( i + 1 < rollout->numSteps ) {
+			NextMovementStep();
+			// Skip checks of action subclasses as they rely on an application sequence state
+			action->BaseMovementAction::CheckPredictionStepResults( this );
+			if( this->shouldRollback || this->cannotApplyAction || this->isCompleted ) {
+				Debug( "Cached rollout replay has failed a prediction step check at frame %d\n", topOfStackIndex );
+				rolloutCache->OnReplayFailed( key );
+				return false;
+			}
+		}
+
+		SaveActionOnStack( action );
+	}
+
+	// Make sure the replayed plan leads closer to the nav target.
+	// Require the progress GenericRunBunnyingAction needs for stopping a prediction early.
+	const int travelTime = TravelTimeToNavTarget();
+	const float squareDistanceFromStart = startOrigin.SquareDistanceTo( movementState->entityPhysicsState.Origin() );
+	if( !travelTime || travelTime + 1 >= travelTimeAtStart || squareDistanceFromStart < SQUARE( 72 ) ) {
+		Debug( "Cached rollout replay has not lead closer to the nav target\n" );
+		rolloutCache->OnReplayFailed( key );
+		return false;
+	}
+
+	this->activeAction = nullptr;
+	this->isCompleted = true;
+	return true;
+}
+
+void MovementPredictionContext::SaveRolloutToCache( const MovementRolloutKey &key ) {
+	if( !isCompleted || predictedMovementActions.size() < 2 ) {
+		return;
+	}
+
+	for( const auto &predictedAction: predictedMovementActions ) {
+		if( !predictedAction.action || !predictedAction.action->AllowsRolloutCaching() ) {
+			return;
+		}
+	}
+
+	const Vec3 startOrigin( predictedMovementActions[0].entityPhysicsState.Origin() );
+	auto *rollout = MovementRolloutCache::Instance()->PrepareForStore( key );
+	for( const auto &predictedAction: predictedMovementActions ) {
+		auto *step = &rollout->steps[rollout->numSteps++];
+		step->record = predictedAction.record;
+		step->actionNum = (uint8_t)predictedAction.action->ActionNum();
+		step->stepMillis = (uint8_t)predictedAction.stepMillis;
+		Vec3 originOffset( predictedAction.entityPhysicsState.Origin() );
+		originOffset -= startOrigin;
+		for( int i = 0; i < 3; ++i ) {
+			float value = originOffset.Data()[i];
+			clamp( value, std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max() );
+			step->originOffset[i] = (int16_t)value;
+		}
+	}
 }
 
 void MovementPredictionContext::NextMovementStep() {
@@ -67,6 +67,7 @@ struct MovementPredictionConstants {
 
 class Bot;
 class BotMovementModule;
+struct MovementRolloutKey;
 
 class MovementPredictionContext : public MovementPredictionConstants
 {
@@ -187,6 +188,17 @@ private:
 	// The server code uses a hardcoded one too.
 	// Its easy to change it here at least.
 	const unsigned defaultFrameTime { 16 };
+
+	// A maximal distance between a replayed trajectory and a cached one
+	static constexpr float MAX_ROLLOUT_REPLAY_DEVIATION = 24.0f;
+
+	void ResetForPlanning();
+
+	// Returns false if a plan should not be looked up in or saved to the rollout cache for the current bot state
+	bool MakeRolloutKey( MovementRolloutKey *key, int *travelTimeToNavTarget ) const;
+	// Fills the stack by a cached plan input executing steps without searching for an input
+	bool TryReplayCachedRollout( const MovementRolloutKey &key, int travelTimeAtStart );
+	void SaveRolloutToCache( const MovementRolloutKey &key );
 public:
 	struct NearbyTriggersCache {
 		vec3_t lastComputedForMins;
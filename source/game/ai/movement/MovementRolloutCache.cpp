@@ -0,0 +1,131 @@
+#include "MovementRolloutCache.h"
+#include "MovementLocal.h"
+#include "../ai_shutdown_hooks_holder.h"
+
+MovementRolloutCache::MovementRolloutCache() {
+	entries = (Entry *)G_Malloc( NUM_SETS * NUM_WAYS * sizeof( Entry ) );
+	for( unsigned i = 0; i < NUM_SETS * NUM_WAYS; ++i ) {
+		entries[i].usedAt = -1;
+	}
+	memset( &stats, 0, sizeof( stats ) );
+}
+
+MovementRolloutCache::~MovementRolloutCache() {
+	if( entries ) {
+		G_Free( entries );
+	}
+}
+
+static StaticVector<MovementRolloutCache, 1> instanceHolder;
+
+MovementRolloutCache *MovementRolloutCache::Instance() {
+	if( instanceHolder.empty() ) {
+		instanceHolder.emplace_back( MovementRolloutCache() );
+		AiShutdownHooksHolder::Instance()->RegisterHook([&] { instanceHolder.clear(); } );
+	}
+	return &instanceHolder.front();
+}
+
+int16_t MovementRolloutCache::YawBucket( float yaw ) {
+	const int bucket = (int)( AngleNormalize360( yaw ) * ( NUM_YAW_BUCKETS / 360.0f ) );
+	return (int16_t)( bucket < (int)NUM_YAW_BUCKETS ? bucket : 0 );
+}
+
+void MovementRolloutCache::MakeKey( MovementRolloutKey *key, const AiEntityPhysicsState &physicsState,
+									int navTargetAreaNum, int nextReachNum, int pmoveFeatures ) {
+	// Make sure there is no garbage in padding as keys are compared bytewise
+	memset( key, 0, sizeof( MovementRolloutKey ) );
+
+	key->areaNum = physicsState.CurrAasAreaNum();
+	key->navTargetAreaNum = navTargetAreaNum;
+	key->nextReachNum = nextReachNum;
+	key->pmoveFeatures = pmoveFeatures;
+
+	const float *velocity = physicsState.Velocity();
+	key->speedBucket = (int16_t)( physicsState.Speed2D() / SPEED_BUCKET_SIZE );
+	// A direction of a very slow movement does not matter
+	if( physicsState.Speed2D() > 1.0f ) {
+		key->velocityYawBucket = YawBucket( RAD2DEG( atan2f( velocity[1], velocity[0] ) ) );
+	}
+	key->velocityZBucket = (int16_t)floorf( velocity[2] / VERTICAL_SPEED_BUCKET_SIZE );
+
+	const Vec3 angles( physicsState.Angles() );
+	key->lookYawBucket = YawBucket( angles.Data()[YAW] );
+	key->lookPitchBucket = (int16_t)floorf( ( AngleNormalize180( angles.Data()[PITCH] ) + 90.0f ) / PITCH_BUCKET_SIZE );
+	key->isOnGround = physicsState.GroundEntity() != nullptr;
+}
+
+unsigned MovementRolloutCache::Hash( const MovementRolloutKey &key ) {
+	static_assert( !( sizeof( MovementRolloutKey ) % sizeof( int32_t ) ), "The key is hashed by 32-bit words" );
+	const int32_t *words = (const int32_t *)&key;
+	unsigned hash = 2166136261u;
+	for( unsigned i = 0; i < sizeof( MovementRolloutKey ) / sizeof( int32_t ); ++i ) {
+		hash = ( hash ^ (unsigned)words[i] ) * 16777619u;
+	}
+	return hash ^ ( hash >> 16 );
+}
+
+const MovementRolloutCache::Rollout *MovementRolloutCache::Find( const MovementRolloutKey &key ) {
+	stats.lookups++;
+
+	Entry *set = SetForKey( key );
+	for( unsigned i = 0; i < NUM_WAYS; ++i ) {
+		Entry *entry = set + i;
+		if( entry->usedAt >= 0 && entry->key == key ) {
+			entry->usedAt = level.time;
+			stats.hits++;
+			return &entry->rollout;
+		}
+	}
+
+	return nullptr;
+}
+
+MovementRolloutCache::Rollout *MovementRolloutCache::PrepareForStore( const MovementRolloutKey &key ) {
+	stats.stores++;
+
+	Entry *set = SetForKey( key );
+	Entry *chosenEntry = set;
+	for( unsigned i = 0; i < NUM_WAYS; ++i ) {
+		Entry *entry = set + i;
+		// Overwrite an existing rollout for the key
+		if( entry->usedAt >= 0 && entry->key == key ) {
+			chosenEntry = entry;
+			break;
+		}
+		// Free entries have a negative timestamp and are chosen first this way
+		if( entry->usedAt < chosenEntry->usedAt ) {
+			chosenEntry = entry;
+		}
+	}
+
+	if( chosenEntry->usedAt >= 0 && !( chosenEntry->key == key ) ) {
+		stats.evictions++;
+	}
+
+	chosenEntry->key = key;
+	chosenEntry->usedAt = level.time;
+	chosenEntry->rollout.numSteps = 0;
+	return &chosenEntry->rollout;
+}
+
+void MovementRolloutCache::OnReplayFailed( const MovementRolloutKey &key ) {
+	stats.failedReplays++;
+
+	Entry *set = SetForKey( key );
+	for( unsigned i = 0; i < NUM_WAYS; ++i ) {
+		if( set[i].usedAt >= 0 && set[i].key == key ) {
+			set[i].usedAt = -1;
+			return;
+		}
+	}
+}
+
+void MovementRolloutCache::PrintStats() const {
+	// Counters might be reset between a lookup and a replay
+	const uint64_t replays = stats.hits > stats.failedReplays ? stats.hits - stats.failedReplays : 0;
+	G_Printf( "%10s %10s %6s %10s %9s %10s %10s\n", "lookups", "hits", "hit %", "replays", "replay %", "stores", "evictions" );
+	G_Printf( "%10" PRIu64 " %10" PRIu64 " %6.1f %10" PRIu64 " %9.1f %10" PRIu64 " %10" PRIu64 "\n",
+			  stats.lookups, stats.hits, stats.lookups ? 100.0 * stats.hits / stats.lookups : 0.0,
+			  replays, stats.lookups ? 100.0 * replays / stats.lookups : 0.0, stats.stores, stats.evictions );
+}
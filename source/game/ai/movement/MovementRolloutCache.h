@@ -0,0 +1,107 @@
+#ifndef QFUSION_MOVEMENTROLLOUTCACHE_H
+#define QFUSION_MOVEMENTROLLOUTCACHE_H
+
+#include "MovementPredictionContext.h"
+
+// A quantized state of a bot at the start of movement planning
+struct MovementRolloutKey {
+	int32_t areaNum;
+	int32_t navTargetAreaNum;
+	int32_t nextReachNum;
+	int32_t pmoveFeatures;
+	int16_t speedBucket;
+	int16_t velocityYawBucket;
+	int16_t velocityZBucket;
+	int16_t lookYawBucket;
+	int16_t lookPitchBucket;
+	int16_t isOnGround;
+
+	bool operator==( const MovementRolloutKey &that ) const {
+		return !memcmp( this, &that, sizeof( MovementRolloutKey ) );
+	}
+};
+
+// Keeps successfully predicted bunnying plans shared by all bots.
+// Bots that follow popular routes often start planning in almost the same state,
+// so a plan found for a quantized start state is replayed first (an input of every step is known already).
+// The replay is a single Pmove() pass instead of a search over many look dirs with rollbacks.
+// The full prediction is performed if the replay fails validation.
+// The storage is a set-associative table, the least recently used entry of a set is evicted.
+class MovementRolloutCache
+{
+public:
+	struct Step {
+		MovementActionRecord record;
+		// An origin before the step relative to an origin of the first step
+		int16_t originOffset[3];
+		uint8_t actionNum;
+		uint8_t stepMillis;
+	};
+
+	struct Rollout {
+		Step steps[MovementPredictionContext::MAX_PREDICTED_STATES];
+		unsigned numSteps;
+	};
+
+private:
+	static constexpr unsigned NUM_SETS = 128;   // must be a power of two
+	static constexpr unsigned NUM_WAYS = 4;
+
+	static constexpr float SPEED_BUCKET_SIZE = 20.0f;
+	static constexpr float VERTICAL_SPEED_BUCKET_SIZE = 50.0f;
+	static constexpr float PITCH_BUCKET_SIZE = 15.0f;
+	static constexpr unsigned NUM_YAW_BUCKETS = 64;
+
+	struct Entry {
+		MovementRolloutKey key;
+		// A negative value for free entries
+		int64_t usedAt;
+		Rollout rollout;
+	};
+
+	struct Stats {
+		uint64_t lookups;
+		uint64_t hits;
+		uint64_t failedReplays;
+		uint64_t stores;
+		uint64_t evictions;
+	};
+
+	Entry *entries;
+	Stats stats;
+
+	MovementRolloutCache();
+	MovementRolloutCache( const MovementRolloutCache &that ) = delete;
+	MovementRolloutCache &operator=( const MovementRolloutCache &that ) = delete;
+
+	static unsigned Hash( const MovementRolloutKey &key );
+	static int16_t YawBucket( float yaw );
+
+	inline Entry *SetForKey( const MovementRolloutKey &key ) {
+		return entries + ( Hash( key ) & ( NUM_SETS - 1 ) ) * NUM_WAYS;
+	}
+public:
+	MovementRolloutCache( MovementRolloutCache &&that ) {
+		entries = that.entries;
+		stats = that.stats;
+		that.entries = nullptr;
+	}
+	~MovementRolloutCache();
+
+	static MovementRolloutCache *Instance();
+
+	static void MakeKey( MovementRolloutKey *key, const AiEntityPhysicsState &physicsState,
+						 int navTargetAreaNum, int nextReachNum, int pmoveFeatures );
+
+	// Returns null if there is no rollout for the key
+	const Rollout *Find( const MovementRolloutKey &key );
+	// Returns a rollout that should be filled for the key (the least recently used one of a set gets evicted)
+	Rollout *PrepareForStore( const MovementRolloutKey &key );
+	// Drops a rollout that has failed replay validation
+	void OnReplayFailed( const MovementRolloutKey &key );
+
+	void PrintStats() const;
+	void ResetStats() { memset( &stats, 0, sizeof( stats ) ); }
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "MovementLocal.h"
 #include "VisibleNextReachCache.h"
+#include "../ai_trace_cache.h"
 
 const Ai::ReachChainVector &VisibleNextReachCache::GetVisibleReachVector( MovementPredictionContext *context ) {
 #ifndef PUBLIC_BUILD
@@ -58,7 +59,8 @@ void VisibleNextReachCache::FindVisibleReachChainVector( MovementPredictionConte
 			}
 		}
 
-		SolidWorldTrace( &trace, origin, reach.start );
+		AiTraceCache::Instance()->StaticWorldTrace( &trace, origin, reach.start, MASK_SOLID,
+													vec3_origin, vec3_origin, AiTraceCache::NEXT_REACH );
 		if( trace.fraction != 1.0f ) {
 			continue;
 		}
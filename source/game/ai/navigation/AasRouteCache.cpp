@@ -100,6 +100,9 @@ AiAasRouteCache::AiAasRouteCache( AiAasRouteCache &&that )
 
 	maxreachabilityareas = that.maxreachabilityareas;
 
+	oneToManyBuffers = that.oneToManyBuffers;
+	stats = that.stats;
+
 	that.loaded = false;
 }
 
@@ -150,6 +153,9 @@ AiAasRouteCache::~AiAasRouteCache() {
 	FreeMemory( areaupdate );
 	FreeMemory( portalupdate );
 	FreeMemory( dijkstralabels );
+	if( oneToManyBuffers ) {
+		FreeMemory( oneToManyBuffers );
+	}
 	// free lists with areas the reachabilities go through
 	FreeRefCountedMemory( reachabilityareas );
 	// free the reachability area index
@@ -1116,6 +1122,9 @@ void AiAasRouteCache::InitRoutingUpdate( void ) {
 
 	oldestcache = nullptr;
 	newestcache = nullptr;
+
+	oneToManyBuffers = nullptr;
+	ResetStats();
 }
 
 constexpr auto MAX_REACHABILITYPASSAREAS = 32;
@@ -1356,6 +1365,7 @@ AiAasRouteCache::aas_routingcache_t *AiAasRouteCache::GetAreaRoutingCache( int c
 		}
 		clusterareacache[clusternum][clusterareanum] = cache;
 		UpdateAreaRoutingCache( cache );
+		stats.areaCacheFills++;
 	} else {
 		UnlinkCache( cache );
 	}
@@ -1486,6 +1496,7 @@ AiAasRouteCache::aas_routingcache_t *AiAasRouteCache::GetPortalRoutingCache( int
 		portalcache[areanum] = cache;
 		//update the cache
 		UpdatePortalRoutingCache( cache );
+		stats.portalCacheFills++;
 	} else {
 		UnlinkCache( cache );
 	}
@@ -1495,6 +1506,257 @@ AiAasRouteCache::aas_routingcache_t *AiAasRouteCache::GetPortalRoutingCache( int
 	return cache;
 }
 
+struct OneToManySearchBuffers {
+	struct HeapEntry {
+		int areaNum;
+		int travelTime;
+
+		inline HeapEntry( int areaNum_, int travelTime_ ): areaNum( areaNum_ ), travelTime( travelTime_ ) {}
+
+		inline bool operator<( const HeapEntry &that ) const {
+			return travelTime > that.travelTime;
+		}
+	};
+
+	// Best known travel times to areas
+	int *travelTimes;
+	// Reachabilities areas have been entered by (used to find a travel time within an area)
+	int *entryReachNums;
+	// Dijkstra's algorithm labels
+	signed char *labels;
+	// Non-zero values correspond to goals of the current query
+	signed char *goalMarks;
+	// Heap entries are not updated on travel time decrease, an area is added again instead.
+	// Every reachability is relaxed at most once, so this capacity is sufficient.
+	HeapEntry *heap;
+	int heapCapacity;
+};
+
+OneToManySearchBuffers *AiAasRouteCache::GetOneToManySearchBuffers() {
+	if( oneToManyBuffers ) {
+		return oneToManyBuffers;
+	}
+
+	const int numAreas = aasWorld.NumAreas();
+	const int heapCapacity = aasWorld.NumReachabilities() + numAreas;
+	// Allocate all buffers in a single memory block, put arrays of larger alignment first
+	size_t size = sizeof( OneToManySearchBuffers );
+	size += heapCapacity * sizeof( OneToManySearchBuffers::HeapEntry );
+	size += 2 * numAreas * sizeof( int );
+	size += 2 * numAreas * sizeof( signed char );
+	auto *mem = (uint8_t *)GetClearedMemory( (int)size );
+	memset( mem, 0, size );
+
+	auto *buffers = (OneToManySearchBuffers *)mem;
+	mem += sizeof( OneToManySearchBuffers );
+	buffers->heap = (OneToManySearchBuffers::HeapEntry *)mem;
+	buffers->heapCapacity = heapCapacity;
+	mem += heapCapacity * sizeof( OneToManySearchBuffers::HeapEntry );
+	buffers->travelTimes = (int *)mem;
+	mem += numAreas * sizeof( int );
+	buffers->entryReachNums = (int *)mem;
+	mem += numAreas * sizeof( int );
+	buffers->labels = (signed char *)mem;
+	mem += numAreas * sizeof( signed char );
+	buffers->goalMarks = (signed char *)mem;
+
+	oneToManyBuffers = buffers;
+	return buffers;
+}
+
+int AiAasRouteCache::FindTravelTimesToGoalAreas( const int *fromAreaNums, int numFromAreas,
+												 const int *goalAreaNums, int numGoalAreas,
+												 int travelFlags, int maxTravelTime, int *travelTimes ) {
+	const uint64_t startedAt = trap_Microseconds();
+	stats.oneToManyQueries++;
+
+	OneToManySearchBuffers *const buffers = GetOneToManySearchBuffers();
+	const int numAreas = aasWorld.NumAreas();
+
+	// Precache all references to avoid pointer chasing in loop
+	const aas_areasettings_t *areaSettings = aasWorld.AreaSettings();
+	const aas_reachability_t *reachabilities = aasWorld.Reachabilities();
+	const aas_reversedreachability_t *reversedReachability = this->reversedreachability;
+	const int *areaContentsTravelFlags = this->areacontentstravelflags;
+	const auto *areaDisabledStatus = this->areasDisabledStatus;
+	unsigned short ***areaTravelTimes = this->areatraveltimes;
+	int *const bestTravelTimes = buffers->travelTimes;
+	int *const entryReachNums = buffers->entryReachNums;
+	signed char *const labels = buffers->labels;
+	signed char *const goalMarks = buffers->goalMarks;
+	OneToManySearchBuffers::HeapEntry *const heap = buffers->heap;
+
+	memset( labels, UNREACHED, (size_t)numAreas );
+
+	int numGoalsLeft = 0;
+	for( int i = 0; i < numGoalAreas; ++i ) {
+		// Goals that already have a travel time are not searched for
+		if( travelTimes[i] ) {
+			continue;
+		}
+		stats.oneToManyGoals++;
+		const int goalAreaNum = goalAreaNums[i];
+		if( goalAreaNum > 0 && goalAreaNum < numAreas && !goalMarks[goalAreaNum] ) {
+			goalMarks[goalAreaNum] = 1;
+			numGoalsLeft++;
+		}
+	}
+
+	int numHeapEntries = 0;
+	for( int i = 0; i < numFromAreas; ++i ) {
+		const int fromAreaNum = fromAreaNums[i];
+		if( fromAreaNum <= 0 || fromAreaNum >= numAreas || labels[fromAreaNum] != UNREACHED ) {
+			continue;
+		}
+		// Allow leaving a do-not-enter area the same way RoutingResultToGoalArea() does
+		if( aasWorld.AreaDoNotEnter( fromAreaNum ) ) {
+			travelFlags |= TFL_DONOTENTER;
+		}
+		// Follow the pairwise routing convention (a travel time to the start area is 1)
+		bestTravelTimes[fromAreaNum] = 1;
+		entryReachNums[fromAreaNum] = 0;
+		labels[fromAreaNum] = LABELED;
+		heap[numHeapEntries++] = OneToManySearchBuffers::HeapEntry( fromAreaNum, 1 );
+	}
+
+	const int badTravelFlags = ~travelFlags;
+
+	while( numHeapEntries && numGoalsLeft ) {
+		std::pop_heap( heap, heap + numHeapEntries );
+		const OneToManySearchBuffers::HeapEntry entry = heap[--numHeapEntries];
+		const int areaNum = entry.areaNum;
+		// Skip outdated entries of areas that have been added again with a lower travel time
+		if( labels[areaNum] == SCANNED ) {
+			continue;
+		}
+		// The heap top has the lowest travel time, so all remaining goals are not feasible
+		if( maxTravelTime && entry.travelTime > maxTravelTime ) {
+			break;
+		}
+
+		labels[areaNum] = SCANNED;
+		stats.oneToManyScannedAreas++;
+
+		if( goalMarks[areaNum] ) {
+			if( !--numGoalsLeft ) {
+				break;
+			}
+		}
+
+		const int entryReachNum = entryReachNums[areaNum];
+		// Do not pass through goal areas that are allowed to be entered only as goals (see below)
+		if( entryReachNum && ( areaContentsTravelFlags[areaNum] & badTravelFlags ) ) {
+			continue;
+		}
+
+		// Find an index of the entry reachability in reversed links of the area
+		// (that is how travel times within areas are addressed). Start areas do not have an entry link.
+		int entryLinkIndex = -1;
+		if( entryReachNum ) {
+			int n = 0;
+			for( auto *revlink = reversedReachability[areaNum].first; revlink; revlink = revlink->next, n++ ) {
+				if( revlink->linknum == entryReachNum ) {
+					entryLinkIndex = n;
+					break;
+				}
+			}
+		}
+
+		// Apply ledge and junk area penalties the same way UpdateAreaRoutingCache() does
+		int penalty = 0;
+		const int areaFlags = areaSettings[areaNum].areaflags;
+		if( areaFlags & AREA_LEDGE ) {
+			penalty += areaFlags & AREA_WALL ? 50 : 150;
+		}
+		if( areaFlags & AREA_JUNK ) {
+			penalty += areaFlags & AREA_WALL ? 100 : 50;
+		}
+
+		const int firstReachNum = areaSettings[areaNum].firstreachablearea;
+		//NOTE: not more than 128 reachabilities per area are linked (see CreateReversedReachability())
+		const int numReachabilities = std::min( areaSettings[areaNum].numreachableareas, 128 );
+		for( int i = 0; i < numReachabilities; ++i ) {
+			const int reachNum = firstReachNum + i;
+			const aas_reachability_t *reach = &reachabilities[reachNum];
+			//if there is used an undesired travel type
+			if( travelflagfortype[reach->traveltype & TRAVELTYPE_MASK] & badTravelFlags ) {
+				continue;
+			}
+			const int nextAreaNum = reach->areanum;
+			if( labels[nextAreaNum] == SCANNED ) {
+				continue;
+			}
+			//if not allowed to enter the next area
+			if( areaDisabledStatus[nextAreaNum].CurrStatus() ) {
+				continue;
+			}
+			// Respect global flags too
+			if( areaSettings[nextAreaNum].areaflags & AREA_DISABLED ) {
+				continue;
+			}
+			//if the next area has a not allowed travel flag
+			if( const int contentsFlags = areaContentsTravelFlags[nextAreaNum] & badTravelFlags ) {
+				// Allow entering do-not-enter goal areas the same way RoutingResultToGoalArea() does
+				if( !goalMarks[nextAreaNum] || ( contentsFlags & ~TFL_DONOTENTER ) ) {
+					continue;
+				}
+			}
+
+			int t = entry.travelTime + reach->traveltime + penalty;
+			if( entryLinkIndex >= 0 ) {
+				t += areaTravelTimes[areaNum][i][entryLinkIndex];
+			}
+
+			if( labels[nextAreaNum] == UNREACHED || bestTravelTimes[nextAreaNum] > t ) {
+				bestTravelTimes[nextAreaNum] = t;
+				entryReachNums[nextAreaNum] = reachNum;
+				labels[nextAreaNum] = LABELED;
+				heap[numHeapEntries++] = OneToManySearchBuffers::HeapEntry( nextAreaNum, t );
+				std::push_heap( heap, heap + numHeapEntries );
+			}
+		}
+	}
+
+	int numReachedGoals = 0;
+	for( int i = 0; i < numGoalAreas; ++i ) {
+		const int goalAreaNum = goalAreaNums[i];
+		if( goalAreaNum <= 0 || goalAreaNum >= numAreas ) {
+			continue;
+		}
+		// Reset marks for further queries
+		goalMarks[goalAreaNum] = 0;
+		if( !travelTimes[i] && labels[goalAreaNum] == SCANNED ) {
+			travelTimes[i] = bestTravelTimes[goalAreaNum];
+			numReachedGoals++;
+		}
+	}
+
+	stats.oneToManyMicros += trap_Microseconds() - startedAt;
+	return numReachedGoals;
+}
+
+int AiAasRouteCache::PreferredTravelTimesToGoalAreas( const int *fromAreaNums, int numFromAreas,
+													  const int *goalAreaNums, int numGoalAreas,
+													  int *travelTimes ) const {
+	int numReachedGoals = TravelTimesToGoalAreas( fromAreaNums, numFromAreas, goalAreaNums, numGoalAreas,
+												  travelFlags[0], 0, travelTimes );
+	if( numReachedGoals == numGoalAreas ) {
+		return numReachedGoals;
+	}
+
+	// Query all goals that have not been reached using allowed travel flags by a single search.
+	// Goals that have been reached keep their travel times and are skipped by the search.
+	auto *nonConstThis = const_cast<AiAasRouteCache *>( this );
+	numReachedGoals += nonConstThis->FindTravelTimesToGoalAreas( fromAreaNums, numFromAreas, goalAreaNums, numGoalAreas,
+																  travelFlags[1], 0, travelTimes );
+	return numReachedGoals;
+}
+
+void AiAasRouteCache::ResetStats() const {
+	memset( &stats, 0, sizeof( stats ) );
+	stats.resetAt = level.time;
+}
+
 int AiAasRouteCache::PreferredRouteToGoalArea( int fromAreaNum, int toAreaNum, int *reachNum ) const {
 	for( int i = 0; i < 2; ++i ) {
 		RoutingResult routingResult;
@@ -275,6 +275,9 @@ public:
 
 	ResultCache resultCache;
 
+	// Scratch buffers of one-to-many travel time queries (allocated on demand)
+	struct OneToManySearchBuffers *oneToManyBuffers;
+
 	inline int ClusterAreaNum( int cluster, int areanum );
 	void InitTravelFlagFromType();
 
@@ -328,6 +331,12 @@ public:
 	bool RouteToGoalArea( const RoutingRequest &request, RoutingResult *result );
 	bool RouteToGoalPortal( const RoutingRequest &request, aas_routingcache_t *portalCache, RoutingResult *result );
 
+	OneToManySearchBuffers *GetOneToManySearchBuffers();
+	// Searches only for goals that have zero travel times, others are left as they are
+	int FindTravelTimesToGoalAreas( const int *fromAreaNums, int numFromAreas,
+									const int *goalAreaNums, int numGoalAreas,
+									int travelFlags, int maxTravelTime, int *travelTimes );
+
 	int PortalMaxTravelTime( int portalnum );
 
 	void InitDisabledAreasStatusAndHelpers();
@@ -350,6 +359,20 @@ public:
 
 	static AiAasRouteCache *shared;
 
+public:
+	// Counters of expensive routing operations (they are mutable as const queries fill the cache too)
+	struct Stats {
+		uint64_t areaCacheFills;
+		uint64_t portalCacheFills;
+		uint64_t oneToManyQueries;
+		uint64_t oneToManyGoals;
+		uint64_t oneToManyScannedAreas;
+		uint64_t oneToManyMicros;
+		// A level time when counting has been started
+		int64_t resetAt;
+	};
+private:
+	mutable Stats stats;
 public:
 	// AiRoutingCache should be init and shutdown explicitly
 	// (a game library is not unloaded when a map changes)
@@ -412,6 +435,32 @@ public:
 		return FastestRouteToGoalArea( fromAreaNums, numFromAreas, toAreaNum, dummyIntPtr );
 	}
 
+	// Computes travel times from start areas to every goal area by a single forward search over the area graph.
+	// The search stops as soon as all goal areas are reached or the (non-zero) max travel time is exceeded.
+	// Zero travel times are set for unreachable goals. Returns a number of goals that have been reached.
+	// Travel times are exact and might be a bit lower than ones returned by TravelTimeToGoalArea()
+	// that does not leave a cluster while routing inside it, so do not compare results of these calls.
+	int TravelTimesToGoalAreas( const int *fromAreaNums, int numFromAreas,
+								const int *goalAreaNums, int numGoalAreas,
+								int travelFlags, int maxTravelTime, int *travelTimes ) const {
+		memset( travelTimes, 0, sizeof( *travelTimes ) * numGoalAreas );
+		auto *nonConstThis = const_cast<AiAasRouteCache *>( this );
+		return nonConstThis->FindTravelTimesToGoalAreas( fromAreaNums, numFromAreas, goalAreaNums, numGoalAreas,
+														 travelFlags, maxTravelTime, travelTimes );
+	}
+
+	inline int TravelTimesToGoalAreas( int fromAreaNum, const int *goalAreaNums, int numGoalAreas,
+									   int travelFlags, int *travelTimes ) const {
+		return TravelTimesToGoalAreas( &fromAreaNum, 1, goalAreaNums, numGoalAreas, travelFlags, 0, travelTimes );
+	}
+
+	// Tests preferred travel flags for the owner first and allowed ones for goals that have not been reached.
+	int PreferredTravelTimesToGoalAreas( const int *fromAreaNums, int numFromAreas,
+										 const int *goalAreaNums, int numGoalAreas, int *travelTimes ) const;
+
+	const Stats &GetStats() const { return stats; }
+	void ResetStats() const;
+
 	inline bool AreaDisabled( int areaNum ) const {
 		return areasDisabledStatus[areaNum].CurrStatus() || ( aasWorld.AreaSettings()[areaNum].areaflags & AREA_DISABLED );
 	}
@@ -89,19 +89,26 @@ void AiNavMeshManager::Shutdown() {
 	instanceHolder.clear();
 }
 
+void AiNavMeshManager::Frame() {
+	if( !instanceHolder.empty() ) {
+		instanceHolder.front().AddBuiltTiles();
+	}
+}
+
 AiNavMeshManager::AiNavMeshManager()
 	: underlyingNavMesh( nullptr ),
-	  polyCenters( nullptr ),
-	  polyBounds( nullptr ),
-	  dataToSave( nullptr ),
-	  dataToSaveSize( 0 ) {
+	  tilePolyCenters( nullptr ),
+	  tilePolyBounds( nullptr ),
+	  maxTiles( 0 ),
+	  tiledBuild( nullptr ),
+	  needsSaving( false ) {
 	for( auto &query: querySlots ) {
 		query.parent = this;
 		query.underlying = nullptr;
 	}
 }
 
-constexpr const uint32_t PRECOMPUTED_FILE_VERSION = 0x1337B001;
+constexpr const uint32_t PRECOMPUTED_FILE_VERSION = 0x1337B002;
 
 // PrecomputedFileReader/Writer rely on G_LevelMalloc() by default,
 // while the rest of code uses G_Malloc for reasons explained above.
@@ -120,49 +127,6 @@ static const char *MakePrecomputedFilePath( char *buffer, size_t bufferSize, con
 	return buffer;
 }
 
-AiNavMeshManager::~AiNavMeshManager() {
-#ifndef PUBLIC_BUILD
-	for( auto &query: querySlots ) {
-		if( query.underlying ) {
-			AI_FailWith( "~AiNavMeshManager()", "The query for slot %d is still in use", (int)( &query - querySlots ) );
-		}
-	}
-#endif
-
-	if( dataToSave ) {
-		char filePath[MAX_QPATH];
-		MakePrecomputedFilePath( filePath, sizeof( filePath ), level.mapname );
-		constexpr const char *writerTag = "PrecomputedFileWriter@AiNavMeshManager";
-		AiPrecomputedFileWriter writer( writerTag, PRECOMPUTED_FILE_VERSION, PrecomputedIOAlloc, PrecomputedIOFree );
-		if( writer.BeginWriting( filePath ) ) {
-			if( writer.WriteLengthAndData( dataToSave, (uint32_t)dataToSaveSize ) ) {
-				G_Printf( "Precomputed nav mesh has been saved successfully to %s\n", filePath );
-			} else {
-				G_Printf( S_COLOR_RED "Can't write precomputed nav mesh data to file %s\n", filePath );
-			}
-		} else {
-			G_Printf( S_COLOR_RED "Can't write precomputed nav mesh file header to file %s\n", filePath );
-		}
-
-		// Do not release an actual memory chunk referred from underlying nav mesh
-		// at this moment too, just prevent using of THIS pointer.
-		dataToSave = nullptr;
-	}
-
-	if( underlyingNavMesh ) {
-		dtFreeNavMesh( underlyingNavMesh );
-		underlyingNavMesh = nullptr;
-	}
-
-	if( polyCenters ) {
-		G_LevelFree( polyCenters );
-	}
-
-	if( polyBounds ) {
-		G_LevelFree( polyBounds );
-	}
-}
-
 AiNavMeshQuery *AiNavMeshManager::AllocQuery( const gclient_t *client ) const {
 	constexpr const char *tag = "AiNavMeshQuery::AllocQuery()";
 
@@ -221,22 +185,32 @@ static_assert( ( (dtPolyRef)-1 ) > 0, "dtPolyRef and uint32_t are not compatible
 
 static const dtQueryFilter DEFAULT_QUERY_FILTER;
 
+const float *AiNavMeshManager::PolyCenter( uint32_t polyRef ) const {
+	const auto tileIndex = underlyingNavMesh->decodePolyIdTile( polyRef );
+	const auto polyIndex = underlyingNavMesh->decodePolyIdPoly( polyRef );
+	return tilePolyCenters[tileIndex] + polyIndex * 3;
+}
+
+const float *AiNavMeshManager::PolyBounds( uint32_t polyRef ) const {
+	const auto tileIndex = underlyingNavMesh->decodePolyIdTile( polyRef );
+	const auto polyIndex = underlyingNavMesh->decodePolyIdPoly( polyRef );
+	return tilePolyBounds[tileIndex] + polyIndex * 6;
+}
+
 void AiNavMeshManager::GetPolyCenter( uint32_t polyRef, vec3_t center ) const {
-	auto polyIndex = underlyingNavMesh->decodePolyIdPoly( polyRef );
-	CopySwappingYZ( this->polyCenters + polyIndex * 3, center );
+	CopySwappingYZ( PolyCenter( polyRef ), center );
 }
 
 void AiNavMeshManager::GetPolyBounds( uint32_t polyRef, vec3_t mins, vec3_t maxs ) const {
-	auto polyIndex = underlyingNavMesh->decodePolyIdPoly( polyRef );
-	float *recastData = this->polyBounds + polyIndex * 6;
+	const float *recastData = PolyBounds( polyRef );
 	CopySwappingYZ( recastData + 0, mins );
 	CopySwappingYZ( recastData + 3, maxs );
 }
 
 int AiNavMeshManager::GetPolyVertices( uint32_t polyRef, float *vertices ) const {
-	auto polyIndex = underlyingNavMesh->decodePolyIdPoly( polyRef );
-	const auto *tile = ( (const dtNavMesh *)underlyingNavMesh )->getTile(0);
-	const auto *poly = tile->polys + polyIndex;
+	const dtMeshTile *tile;
+	const dtPoly *poly;
+	underlyingNavMesh->getTileAndPolyByRefUnsafe( polyRef, &tile, &poly );
 	const float *tileVertices = tile->verts;
 	const auto numPolyVertices = poly->vertCount;
 	const auto *polyVertexOffsets = poly->verts;
@@ -307,9 +281,8 @@ int AiNavMeshQuery::FindPath( const vec3_t startAbsMins, const vec3_t startAbsMa
 }
 
 int AiNavMeshQuery::FindPath( uint32_t startPolyRef, uint32_t endPolyRef, uint32_t *resultPolys, int maxResultPolys ) {
-	const auto *mesh = underlying->getAttachedNavMesh();
-	const float *startPolyCenter = parent->polyCenters + mesh->decodePolyIdPoly( startPolyRef ) * 3;
-	const float *endPolyCenter = parent->polyCenters + mesh->decodePolyIdPoly( endPolyRef ) * 3;
+	const float *startPolyCenter = parent->PolyCenter( startPolyRef );
+	const float *endPolyCenter = parent->PolyCenter( endPolyRef );
 
 	int result;
 	const dtQueryFilter *filter = &DEFAULT_QUERY_FILTER;
@@ -336,8 +309,7 @@ int AiNavMeshQuery::FindPolysInRadius( const vec3_t startAbsMins, const vec3_t s
 }
 
 int AiNavMeshQuery::FindPolysInRadius( uint32_t startPolyRef, float radius, uint32_t *resultPolys, int maxResultPolys ) {
-	const auto *mesh = underlying->getAttachedNavMesh();
-	const float *startPolyCenter = parent->polyCenters + mesh->decodePolyIdPoly( startPolyRef ) * 3;
+	const float *startPolyCenter = parent->PolyCenter( startPolyRef );
 
 	int result;
 	const dtQueryFilter *filter = &DEFAULT_QUERY_FILTER;
@@ -348,23 +320,20 @@ int AiNavMeshQuery::FindPolysInRadius( uint32_t startPolyRef, float radius, uint
 }
 
 bool AiNavMeshQuery::TraceWalkability( uint32_t startPolyRef, uint32_t endPolyRef ) {
-	const auto *mesh = underlying->getAttachedNavMesh();
-	const float *startPolyCenter = parent->polyCenters + mesh->decodePolyIdPoly( startPolyRef ) * 3;
-	const float *endPolyCenter = parent->polyCenters + mesh->decodePolyIdPoly( endPolyRef ) * 3;
+	const float *startPolyCenter = parent->PolyCenter( startPolyRef );
+	const float *endPolyCenter = parent->PolyCenter( endPolyRef );
 	return TraceWalkabilityImpl( startPolyRef, startPolyCenter, endPolyCenter );
 }
 
 bool AiNavMeshQuery::TraceWalkability( uint32_t startPolyRef, const vec3_t startPos, uint32_t endPolyRef ) {
-	const auto *mesh = underlying->getAttachedNavMesh();
-	const float *endPolyCenter = parent->polyCenters + mesh->decodePolyIdPoly( endPolyRef ) * 3;
+	const float *endPolyCenter = parent->PolyCenter( endPolyRef );
 	vec3_t detourStartPos;
 	CopySwappingYZ( startPos, detourStartPos );
 	return TraceWalkabilityImpl( startPolyRef, detourStartPos, endPolyCenter );
 }
 
 bool AiNavMeshQuery::TraceWalkability( uint32_t startPolyRef, const vec3_t endPos ) {
-	const auto *mesh = underlying->getAttachedNavMesh();
-	const float *startPolyCenter = parent->polyCenters + mesh->decodePolyIdPoly( startPolyRef ) * 3;
+	const float *startPolyCenter = parent->PolyCenter( startPolyRef );
 	vec3_t detourEndPos;
 	CopySwappingYZ( endPos, detourEndPos );
 	return TraceWalkabilityImpl( startPolyRef, startPolyCenter, detourEndPos );
@@ -469,8 +438,40 @@ public:
 	virtual bool BuildTris( NavMeshInputTris *tris ) = 0;
 };
 
+// Parameters shared by all tiles of a build (in Recast/Detour coordinate system)
+struct NavMeshTiling {
+	// Bounds of the input tris, the mins are the origin of the tiles grid
+	float mins[3], maxs[3];
+	float cellSize;
+	// A tile side size in cells (excluding the border)
+	int tileCells;
+	// Cells around a tile that are rasterized for correct erosion and regions near tile edges
+	// but are cut off from the resulting tile polys
+	int borderCells;
+	int numTilesX, numTilesZ;
+
+	float TileSize() const { return tileCells * cellSize; }
+};
+
+struct NavMeshTileTask {
+	int tileX, tileZ;
+	// A range of tile tris indices of the build
+	int firstTri, numTris;
+	// Detour tile data, might be null if the tile does not contain any polys
+	unsigned char *data;
+	int dataSize;
+	uint64_t buildMicros;
+	bool failed;
+};
+
+// Builds Detour data of a single tile.
+// Instances are used by worker threads, so only thread-safe facilities (G_Malloc(), G_Printf()) are allowed.
 class NavMeshBuilder {
-	// Bounds of the supplied triangles set in Recast/Detour coordinate system
+	const NavMeshInputTris *tris;
+	const NavMeshTiling *tiling;
+	int tileX, tileZ;
+
+	// Bounds of the tile including the border in Recast/Detour coordinate system
 	vec3_t mins, maxs;
 
 	float xzCellSize;
@@ -478,6 +479,7 @@ class NavMeshBuilder {
 
 	int gridWidth, gridHeight;
 
+	int *tileTris;
 	unsigned char *trisAreaFlags;
 	rcHeightfield *heightField;
 	rcCompactHeightfield *compactHeightField;
@@ -490,19 +492,28 @@ class NavMeshBuilder {
 	static constexpr auto WALKABLE_CLIMB = 18;
 	static constexpr auto WALKABLE_RADIUS = 12;   // A bit lower than the actual half-hitbox width
 	static constexpr auto WALKABLE_SLOPE = 55;    // A bit higher than the actual slope limit
+	static constexpr auto ERODE_RADIUS = 4;
 
-	bool PrepareHeightField( NavMeshInputTris *tris );
+	bool PrepareHeightField( const int *trisIndices, int numTris );
 	bool PrepareCompactHeightField();
 	bool PrepareContourSet();
 	bool PrepareMesh();
 	bool PrepareDetailMesh();
 	bool CreateNavMeshDataFromIntermediates( unsigned char **data, int *dataSize );
 public:
-	NavMeshBuilder()
-		: xzCellSize( -1.0f ),
-		  yCellSize( -1.0f ),
-		  gridWidth( -1 ),
-		  gridHeight( -1 ),
+	// Recast demo uses a border of the erode radius + 3 cells
+	static constexpr auto BORDER_CELLS = ERODE_RADIUS + 3;
+
+	NavMeshBuilder( const NavMeshInputTris *tris_, const NavMeshTiling *tiling_, int tileX_, int tileZ_ )
+		: tris( tris_ ),
+		  tiling( tiling_ ),
+		  tileX( tileX_ ),
+		  tileZ( tileZ_ ),
+		  xzCellSize( tiling_->cellSize ),
+		  yCellSize( tiling_->cellSize ),
+		  gridWidth( tiling_->tileCells + 2 * tiling_->borderCells ),
+		  gridHeight( tiling_->tileCells + 2 * tiling_->borderCells ),
+		  tileTris( nullptr ),
 		  trisAreaFlags( nullptr ),
 		  heightField( nullptr ),
 		  compactHeightField( nullptr ),
@@ -511,17 +522,31 @@ public:
 		  polyMeshDetail( nullptr ) {
 		context.enableLog( false );
 		context.enableTimer( false );
+
+		const float tileSize = tiling->TileSize();
+		const float borderSize = tiling->borderCells * tiling->cellSize;
+		mins[0] = tiling->mins[0] + tileX * tileSize - borderSize;
+		mins[1] = tiling->mins[1];
+		mins[2] = tiling->mins[2] + tileZ * tileSize - borderSize;
+		maxs[0] = tiling->mins[0] + ( tileX + 1 ) * tileSize + borderSize;
+		maxs[1] = tiling->maxs[1];
+		maxs[2] = tiling->mins[2] + ( tileZ + 1 ) * tileSize + borderSize;
 	}
 
 	~NavMeshBuilder() {
 		ForceClear();
 	}
 
-	bool BuildMeshData( unsigned char **data, int *dataSize );
+	// Sets null data if the tile does not contain any polys
+	bool BuildTileData( const int *trisIndices, int numTris, unsigned char **data, int *dataSize );
 	void ForceClear();
 };
 
 void NavMeshBuilder::ForceClear() {
+	if( tileTris ) {
+		G_Free( tileTris );
+		tileTris = nullptr;
+	}
 	if( trisAreaFlags ) {
 		G_Free( trisAreaFlags );
 		trisAreaFlags = nullptr;
@@ -694,18 +719,15 @@ bool AasNavMeshInputTrisSource::BuildTris( NavMeshInputTris *tris ) {
 	return true;
 }
 
-bool NavMeshBuilder::BuildMeshData( unsigned char **data, int *dataSize ) {
-	constexpr const char *tag = "NavMeshBuilder::BuildMeshData()";
+bool NavMeshBuilder::BuildTileData( const int *trisIndices, int numTris, unsigned char **data, int *dataSize ) {
+	*data = nullptr;
+	*dataSize = 0;
 
-	NavMeshInputTris tris;
-	AasNavMeshInputTrisSource trisSource;
-
-	if( !trisSource.BuildTris( &tris ) ) {
-		G_Printf( S_COLOR_RED "%s: Tris source has failed its execution, there is no tris to process\n", tag );
-		return false;
+	if( !numTris ) {
+		return true;
 	}
 
-	if( !PrepareHeightField( &tris ) ) {
+	if( !PrepareHeightField( trisIndices, numTris ) ) {
 		return false;
 	}
 
@@ -721,6 +743,11 @@ bool NavMeshBuilder::BuildMeshData( unsigned char **data, int *dataSize ) {
 		return false;
 	}
 
+	// Tris of the tile might be non-walkable or might be in the border only
+	if( !polyMesh->npolys ) {
+		return true;
+	}
+
 	if( !PrepareDetailMesh() ) {
 		return false;
 	}
@@ -728,25 +755,9 @@ bool NavMeshBuilder::BuildMeshData( unsigned char **data, int *dataSize ) {
 	return CreateNavMeshDataFromIntermediates( data, dataSize );
 }
 
-bool NavMeshBuilder::PrepareHeightField( NavMeshInputTris *tris ) {
+bool NavMeshBuilder::PrepareHeightField( const int *trisIndices, int numTris ) {
 	constexpr const char *tag = "NavMeshBuilder::PrepareHeightField()";
 
-	// Save bounds (we are going to clean tris data early to save allocation space)
-	// Copying via this macro is still valid for Recast/Detour coord system
-	VectorCopy( tris->mins, this->mins );
-	VectorCopy( tris->maxs, this->maxs );
-
-	// Get world bounds
-	vec3_t worldMins, worldMaxs, worldSize;
-	trap_CM_InlineModelBounds( trap_CM_InlineModel( 0 ), worldMins, worldMaxs );
-	// Compute world size and the largest dimension
-	VectorSubtract( worldMaxs, worldMins, worldSize );
-	float maxDimension = std::max( std::max( worldSize[0], worldSize[1] ), worldSize[2] );
-
-	// We have to use these very low values, otherwise a resulting mesh has lots of holes and bad overall quality
-	this->xzCellSize = this->yCellSize = 0.75f + BoundedFraction( maxDimension, 8192.0f );
-	rcCalcGridSize( tris->mins, tris->maxs, this->xzCellSize, &this->gridWidth, &this->gridHeight );
-
 	// Allocate and create the height field
 	this->heightField = rcAllocHeightfield();
 	if( !heightField ) {
@@ -755,30 +766,38 @@ bool NavMeshBuilder::PrepareHeightField( NavMeshInputTris *tris ) {
 	}
 
 	if( !rcCreateHeightfield( &context, *heightField, gridWidth,
-							  gridHeight, tris->mins, tris->maxs,
+							  gridHeight, this->mins, this->maxs,
 							  this->xzCellSize, this->yCellSize ) ) {
 		G_Printf( S_COLOR_RED "%s: Cannot create (initialize) the initial Recast height field\n", tag );
 		return false;
 	}
 
+	// Gather tris of the tile in a contiguous array as Recast expects
+	tileTris = (int *)G_Malloc( sizeof( int ) * 3 * numTris );
+	for( int i = 0; i < numTris; ++i ) {
+		memcpy( tileTris + i * 3, tris->tris + trisIndices[i] * 3, sizeof( int ) * 3 );
+	}
+
 	// Allocate an array holding marked walkable tris
 	// Should not return on failure?
-	trisAreaFlags = (unsigned char *)G_Malloc( (size_t)tris->numTris );
+	trisAreaFlags = (unsigned char *)G_Malloc( (size_t)numTris );
 
 	// Mark and rasterize walkable tris
-	memset( trisAreaFlags, 0, (size_t)tris->numTris );
+	memset( trisAreaFlags, 0, (size_t)numTris );
 	rcMarkWalkableTriangles( &context, WALKABLE_SLOPE, tris->vertices,
-							 tris->numVertices, tris->tris,
-							 tris->numTris, trisAreaFlags );
+							 tris->numVertices, tileTris,
+							 numTris, trisAreaFlags );
 
 	if( !rcRasterizeTriangles( &context, tris->vertices, tris->numVertices,
-							   tris->tris, trisAreaFlags,
-							   tris->numTris, *heightField ) ) {
+							   tileTris, trisAreaFlags,
+							   numTris, *heightField ) ) {
 		G_Printf( S_COLOR_RED "%s: Cannot rasterize Recast walkable triangles\n", tag );
 		return false;
 	}
 
-	// Release trisAreaFlags immediately as they are no longer needed
+	// Release tris data immediately as it is no longer needed
+	G_Free( tileTris );
+	tileTris = nullptr;
 	G_Free( trisAreaFlags );
 	trisAreaFlags = nullptr;
 
@@ -809,7 +828,7 @@ bool NavMeshBuilder::PrepareCompactHeightField() {
 	}
 
 	// Erode walkable areas
-	if( !rcErodeWalkableArea( &context, 4, *compactHeightField ) ) {
+	if( !rcErodeWalkableArea( &context, ERODE_RADIUS, *compactHeightField ) ) {
 		G_Printf( S_COLOR_RED "%s: Cannot erode walkable Recast area in the compact heightfield\n", tag );
 		return false;
 	}
@@ -818,7 +837,6 @@ bool NavMeshBuilder::PrepareCompactHeightField() {
 	// This method is neither the fastest nor the best (as Recast docs promise),
 	// but it produces better results for the actual input.
 
-	constexpr int BORDER_SIZE = 0;
 	constexpr int MIN_REGION_AREA = 24 * 24;
 	constexpr int MERGE_REGION_AREA = 48 * 48;
 
@@ -829,7 +847,7 @@ bool NavMeshBuilder::PrepareCompactHeightField() {
 	}
 
 	// Partition the walkable surface into simple regions without holes.
-	if( !rcBuildRegions( &context, *compactHeightField, BORDER_SIZE, MIN_REGION_AREA, MERGE_REGION_AREA ) ) {
+	if( !rcBuildRegions( &context, *compactHeightField, tiling->borderCells, MIN_REGION_AREA, MERGE_REGION_AREA ) ) {
 		G_Printf( S_COLOR_RED "%s: Can't build regions in the compact height field\n", tag );
 		return false;
 	}
@@ -934,8 +952,11 @@ bool NavMeshBuilder::CreateNavMeshDataFromIntermediates( unsigned char **data, i
 	params.walkableHeight = WALKABLE_HEIGHT;
 	params.walkableRadius = WALKABLE_RADIUS;
 	params.walkableClimb = WALKABLE_CLIMB;
-	VectorCopy( mins, params.bmin );
-	VectorCopy( maxs, params.bmax );
+	VectorCopy( polyMesh->bmin, params.bmin );
+	VectorCopy( polyMesh->bmax, params.bmax );
+	params.tileX = tileX;
+	params.tileY = tileZ;
+	params.tileLayer = 0;
 	params.cs = xzCellSize;
 	params.ch = yCellSize;
 	params.buildBvTree = true;
@@ -948,8 +969,294 @@ bool NavMeshBuilder::CreateNavMeshDataFromIntermediates( unsigned char **data, i
 	return true;
 }
 
-bool AiNavMeshManager::InitNavMeshFromData( unsigned char *data, int dataSize ) {
-	constexpr const char *tag = "AiNavMeshManager::InitNavMeshFromData()";
+// A state of a nav mesh build that is split in tiles processed by engine job workers.
+// Tiles are independent: each one rasterizes input tris that overlap the tile and its border.
+class NavMeshTiledBuild {
+	friend class AiNavMeshManager;
+
+	// A tile side size in world units.
+	// Smaller tiles become available earlier and balance better between workers,
+	// but tile borders are rasterized redundantly and a tile count is limited by poly ref bits.
+	static constexpr float TILE_SIZE = 512.0f;
+
+	NavMeshInputTris tris;
+	NavMeshTiling tiling;
+
+	// Indices of tris that overlap each tile (tasks refer to ranges of this array)
+	int *tileTrisIndices;
+	// Tasks are created only for tiles that have some tris
+	NavMeshTileTask *tasks;
+	int numTasks;
+
+	// Indices of finished tasks in order of completion
+	int *finishedTasks;
+	int numFinishedTasks;
+	struct qmutex_s *finishedTasksLock;
+	// Finished tasks that have been already processed by the game thread
+	int numAddedTasks;
+	int numFailedTasks;
+
+	struct qjobcounter_s *jobCounter;
+	volatile bool cancelled;
+	uint64_t startedAt;
+
+	void GetTriTilesRange( int triNum, int *minX, int *maxX, int *minZ, int *maxZ ) const;
+
+	static void BuildTilesJob( unsigned first, unsigned items, void *arg );
+	void BuildTile( NavMeshTileTask *task );
+public:
+	NavMeshTiledBuild()
+		: tileTrisIndices( nullptr ),
+		  tasks( nullptr ),
+		  numTasks( 0 ),
+		  finishedTasks( nullptr ),
+		  numFinishedTasks( 0 ),
+		  finishedTasksLock( nullptr ),
+		  numAddedTasks( 0 ),
+		  numFailedTasks( 0 ),
+		  jobCounter( nullptr ),
+		  cancelled( false ),
+		  startedAt( 0 ) {
+		memset( &tiling, 0, sizeof( tiling ) );
+	}
+
+	~NavMeshTiledBuild();
+
+	// Builds input tris and splits them in tiles on the game thread
+	bool Prepare();
+	void Start();
+};
+
+NavMeshTiledBuild::~NavMeshTiledBuild() {
+	if( jobCounter ) {
+		// Make remaining jobs return immediately
+		cancelled = true;
+		trap_Jobs_Wait( jobCounter );
+		trap_JobCounter_Destroy( &jobCounter );
+	}
+
+	if( finishedTasksLock ) {
+		trap_Mutex_Destroy( &finishedTasksLock );
+	}
+
+	// Release data of tiles that have not been added to the nav mesh
+	for( int i = numAddedTasks; i < numFinishedTasks; ++i ) {
+		if( unsigned char *data = tasks[finishedTasks[i]].data ) {
+			dtFree( data );
+		}
+	}
+
+	if( finishedTasks ) {
+		G_Free( finishedTasks );
+	}
+	if( tasks ) {
+		G_Free( tasks );
+	}
+	if( tileTrisIndices ) {
+		G_Free( tileTrisIndices );
+	}
+}
+
+void NavMeshTiledBuild::GetTriTilesRange( int triNum, int *minX, int *maxX, int *minZ, int *maxZ ) const {
+	vec3_t triMins, triMaxs;
+	ClearBounds( triMins, triMaxs );
+	for( int i = 0; i < 3; ++i ) {
+		AddPointToBounds( tris.vertices + tris.tris[triNum * 3 + i] * 3, triMins, triMaxs );
+	}
+
+	const float tileSize = tiling.TileSize();
+	const float borderSize = tiling.borderCells * tiling.cellSize;
+	// Recast/Detour coordinate system is used, so the second horizontal axis is Z
+	*minX = (int)floorf( ( triMins[0] - borderSize - tiling.mins[0] ) / tileSize );
+	*maxX = (int)floorf( ( triMaxs[0] + borderSize - tiling.mins[0] ) / tileSize );
+	*minZ = (int)floorf( ( triMins[2] - borderSize - tiling.mins[2] ) / tileSize );
+	*maxZ = (int)floorf( ( triMaxs[2] + borderSize - tiling.mins[2] ) / tileSize );
+	*minX = std::max( 0, *minX );
+	*maxX = std::min( tiling.numTilesX - 1, *maxX );
+	*minZ = std::max( 0, *minZ );
+	*maxZ = std::min( tiling.numTilesZ - 1, *maxZ );
+}
+
+bool NavMeshTiledBuild::Prepare() {
+	constexpr const char *tag = "NavMeshTiledBuild::Prepare()";
+
+	AasNavMeshInputTrisSource trisSource;
+	if( !trisSource.BuildTris( &tris ) ) {
+		G_Printf( S_COLOR_RED "%s: Tris source has failed its execution, there is no tris to process\n", tag );
+		return false;
+	}
+
+	if( !tris.numTris ) {
+		G_Printf( S_COLOR_RED "%s: There are no tris to process\n", tag );
+		return false;
+	}
+
+	// Get world bounds
+	vec3_t worldMins, worldMaxs, worldSize;
+	trap_CM_InlineModelBounds( trap_CM_InlineModel( 0 ), worldMins, worldMaxs );
+	// Compute world size and the largest dimension
+	VectorSubtract( worldMaxs, worldMins, worldSize );
+	float maxDimension = std::max( std::max( worldSize[0], worldSize[1] ), worldSize[2] );
+
+	// Copying via this macro is still valid for Recast/Detour coord system
+	VectorCopy( tris.mins, tiling.mins );
+	VectorCopy( tris.maxs, tiling.maxs );
+	// We have to use these very low values, otherwise a resulting mesh has lots of holes and bad overall quality
+	tiling.cellSize = 0.75f + BoundedFraction( maxDimension, 8192.0f );
+	tiling.tileCells = (int)ceilf( TILE_SIZE / tiling.cellSize );
+	tiling.borderCells = NavMeshBuilder::BORDER_CELLS;
+	tiling.numTilesX = std::max( 1, (int)ceilf( ( tiling.maxs[0] - tiling.mins[0] ) / tiling.TileSize() ) );
+	tiling.numTilesZ = std::max( 1, (int)ceilf( ( tiling.maxs[2] - tiling.mins[2] ) / tiling.TileSize() ) );
+
+	const int numTiles = tiling.numTilesX * tiling.numTilesZ;
+	tasks = (NavMeshTileTask *)G_Malloc( sizeof( NavMeshTileTask ) * numTiles );
+	memset( tasks, 0, sizeof( NavMeshTileTask ) * numTiles );
+	for( int z = 0; z < tiling.numTilesZ; ++z ) {
+		for( int x = 0; x < tiling.numTilesX; ++x ) {
+			tasks[z * tiling.numTilesX + x].tileX = x;
+			tasks[z * tiling.numTilesX + x].tileZ = z;
+		}
+	}
+
+	// Count tris of each tile first
+	int minX, maxX, minZ, maxZ;
+	for( int triNum = 0; triNum < tris.numTris; ++triNum ) {
+		GetTriTilesRange( triNum, &minX, &maxX, &minZ, &maxZ );
+		for( int z = minZ; z <= maxZ; ++z ) {
+			for( int x = minX; x <= maxX; ++x ) {
+				tasks[z * tiling.numTilesX + x].numTris++;
+			}
+		}
+	}
+
+	int numTileTris = 0;
+	for( int i = 0; i < numTiles; ++i ) {
+		tasks[i].firstTri = numTileTris;
+		numTileTris += tasks[i].numTris;
+		tasks[i].numTris = 0;
+	}
+
+	// Fill the tris ranges of tiles
+	tileTrisIndices = (int *)G_Malloc( sizeof( int ) * std::max( 1, numTileTris ) );
+	for( int triNum = 0; triNum < tris.numTris; ++triNum ) {
+		GetTriTilesRange( triNum, &minX, &maxX, &minZ, &maxZ );
+		for( int z = minZ; z <= maxZ; ++z ) {
+			for( int x = minX; x <= maxX; ++x ) {
+				NavMeshTileTask *task = &tasks[z * tiling.numTilesX + x];
+				tileTrisIndices[task->firstTri + task->numTris++] = triNum;
+			}
+		}
+	}
+
+	// Drop tiles that do not have any tris
+	for( int i = 0; i < numTiles; ++i ) {
+		if( tasks[i].numTris ) {
+			tasks[numTasks++] = tasks[i];
+		}
+	}
+
+	finishedTasks = (int *)G_Malloc( sizeof( int ) * std::max( 1, numTasks ) );
+
+	G_Printf( "%s: %d tris, %d of %dx%d tiles of %d cells are non-empty\n", tag,
+			  tris.numTris, numTasks, tiling.numTilesX, tiling.numTilesZ, tiling.tileCells );
+
+	return numTasks > 0;
+}
+
+void NavMeshTiledBuild::Start() {
+	finishedTasksLock = trap_Mutex_Create();
+	jobCounter = trap_JobCounter_Create();
+	startedAt = trap_Microseconds();
+
+	// Schedule a job per tile so tiles are added to the mesh one by one as they are ready.
+	// This is executed synchronously if there are no job workers.
+	trap_Jobs_ParallelFor( BuildTilesJob, this, (unsigned)numTasks, 1, jobCounter, nullptr );
+}
+
+void NavMeshTiledBuild::BuildTilesJob( unsigned first, unsigned items, void *arg ) {
+	auto *build = (NavMeshTiledBuild *)arg;
+	for( unsigned i = first; i < first + items; ++i ) {
+		build->BuildTile( build->tasks + i );
+	}
+}
+
+void NavMeshTiledBuild::BuildTile( NavMeshTileTask *task ) {
+	if( !cancelled ) {
+		const uint64_t tileStartedAt = trap_Microseconds();
+		NavMeshBuilder builder( &tris, &tiling, task->tileX, task->tileZ );
+		const int *trisIndices = tileTrisIndices + task->firstTri;
+		task->failed = !builder.BuildTileData( trisIndices, task->numTris, &task->data, &task->dataSize );
+		task->buildMicros = trap_Microseconds() - tileStartedAt;
+	} else {
+		task->failed = true;
+	}
+
+	trap_Mutex_Lock( finishedTasksLock );
+	finishedTasks[numFinishedTasks++] = (int)( task - tasks );
+	trap_Mutex_Unlock( finishedTasksLock );
+}
+
+// Precomputed file layout: this header chunk followed by a chunk of Detour data for each tile
+struct NavMeshFileHeader {
+	dtNavMeshParams params;
+	int32_t numTiles;
+};
+
+void AiNavMeshManager::ResetNavMesh() {
+	if( underlyingNavMesh ) {
+		dtFreeNavMesh( underlyingNavMesh );
+		underlyingNavMesh = nullptr;
+	}
+
+	for( int i = 0; i < maxTiles; ++i ) {
+		if( tilePolyCenters[i] ) {
+			G_LevelFree( tilePolyCenters[i] );
+		}
+		if( tilePolyBounds[i] ) {
+			G_LevelFree( tilePolyBounds[i] );
+		}
+	}
+
+	if( tilePolyCenters ) {
+		G_LevelFree( tilePolyCenters );
+		tilePolyCenters = nullptr;
+	}
+
+	if( tilePolyBounds ) {
+		G_LevelFree( tilePolyBounds );
+		tilePolyBounds = nullptr;
+	}
+
+	maxTiles = 0;
+}
+
+AiNavMeshManager::~AiNavMeshManager() {
+#ifndef PUBLIC_BUILD
+	for( auto &query: querySlots ) {
+		if( query.underlying ) {
+			AI_FailWith( "~AiNavMeshManager()", "The query for slot %d is still in use", (int)( &query - querySlots ) );
+		}
+	}
+#endif
+
+	// Tile jobs must not outlive the manager
+	if( tiledBuild ) {
+		tiledBuild->~NavMeshTiledBuild();
+		G_Free( tiledBuild );
+		tiledBuild = nullptr;
+	}
+
+	if( needsSaving ) {
+		char filePath[MAX_QPATH];
+		MakePrecomputedFilePath( filePath, sizeof( filePath ), level.mapname );
+		SaveToFile( filePath );
+	}
+
+	ResetNavMesh();
+}
+
+bool AiNavMeshManager::InitNavMesh( const dtNavMeshParams *params ) {
+	constexpr const char *tag = "AiNavMeshManager::InitNavMesh()";
 
 	underlyingNavMesh = dtAllocNavMesh();
 	if( !underlyingNavMesh ) {
@@ -957,9 +1264,36 @@ bool AiNavMeshManager::InitNavMeshFromData( unsigned char *data, int dataSize )
 		return false;
 	}
 
-	dtStatus status = underlyingNavMesh->init( data, dataSize, DT_TILE_FREE_DATA );
+	dtStatus status = underlyingNavMesh->init( params );
 	if( dtStatusFailed( status ) ) {
-		G_Printf( S_COLOR_RED "%s: Can't initialize Detour nav mesh with the given data\n", tag );
+		G_Printf( S_COLOR_RED "%s: Can't initialize Detour nav mesh with the given params\n", tag );
+		return false;
+	}
+
+	maxTiles = params->maxTiles;
+	// Never returns on failure
+	tilePolyCenters = (float **)G_LevelMalloc( sizeof( float * ) * maxTiles );
+	tilePolyBounds = (float **)G_LevelMalloc( sizeof( float * ) * maxTiles );
+	memset( tilePolyCenters, 0, sizeof( float * ) * maxTiles );
+	memset( tilePolyBounds, 0, sizeof( float * ) * maxTiles );
+	return true;
+}
+
+bool AiNavMeshManager::AddTile( unsigned char *data, int dataSize ) {
+	constexpr const char *tag = "AiNavMeshManager::AddTile()";
+
+	// Poly indices must fit bits of a poly ref reserved for them
+	const auto *header = (const dtMeshHeader *)data;
+	if( dataSize < (int)sizeof( dtMeshHeader ) || header->polyCount > underlyingNavMesh->getParams()->maxPolys ) {
+		G_Printf( S_COLOR_RED "%s: Illegal tile data\n", tag );
+		dtFree( data );
+		return false;
+	}
+
+	dtTileRef tileRef = 0;
+	dtStatus status = underlyingNavMesh->addTile( data, dataSize, DT_TILE_FREE_DATA, 0, &tileRef );
+	if( dtStatusFailed( status ) ) {
+		G_Printf( S_COLOR_RED "%s: Can't add a tile to Detour nav mesh\n", tag );
 		if( dtStatusDetail( status, DT_WRONG_MAGIC ) ) {
 			G_Printf( S_COLOR_RED "%s: Wrong data magic number\n", tag );
 		}
@@ -969,24 +1303,21 @@ bool AiNavMeshManager::InitNavMeshFromData( unsigned char *data, int dataSize )
 		if( dtStatusDetail( status, DT_OUT_OF_MEMORY ) ) {
 			G_Printf( S_COLOR_RED "%s: Out of memory\n", tag );
 		}
+		// The data is not owned by the nav mesh in this case
+		dtFree( data );
 		return false;
 	}
 
-	const int maxTiles = underlyingNavMesh->getMaxTiles();
-	if( maxTiles != 1 ) {
-		G_Printf( S_COLOR_RED "%s: Illegal nav mesh tiles count: %d (must be 1)\n", tag, maxTiles );
-		return false;
-	}
-
-	// Why a compiler prefers private non-const version, and thus fails?
-	const dtMeshTile *tile = ( (const dtNavMesh *) underlyingNavMesh )->getTile( 0 );
+	// A tile ref has the same layout as a poly ref of the first tile poly
+	const auto tileIndex = underlyingNavMesh->decodePolyIdTile( (dtPolyRef)tileRef );
+	const dtMeshTile *tile = underlyingNavMesh->getTileByRef( tileRef );
 
 	const auto numPolys = (unsigned)tile->header->polyCount;
 	const float *vertices = tile->verts;
 	const dtPoly *polys = tile->polys;
 	// Never returns on failure
-	polyCenters = (float *)G_LevelMalloc( 3 * sizeof( float ) * numPolys );
-	polyBounds = (float *)G_LevelMalloc( 6 * sizeof( float ) * numPolys );
+	float *polyCenters = (float *)G_LevelMalloc( 3 * sizeof( float ) * numPolys );
+	float *polyBounds = (float *)G_LevelMalloc( 6 * sizeof( float ) * numPolys );
 
 	for( unsigned i = 0; i < numPolys; ++i ) {
 		float *mins = polyBounds + i * 6;
@@ -1008,62 +1339,245 @@ bool AiNavMeshManager::InitNavMeshFromData( unsigned char *data, int dataSize )
 		VectorScale( center, scale, center );
 	}
 
-	G_Printf( "AiNavMeshLoader: Nav mesh data size: %d bytes, poly count: %d\n", dataSize, tile->header->polyCount );
+	// A tile slot might be reused if a tile has been removed (tiles are not removed at the moment)
+	if( tilePolyCenters[tileIndex] ) {
+		G_LevelFree( tilePolyCenters[tileIndex] );
+		G_LevelFree( tilePolyBounds[tileIndex] );
+	}
+	tilePolyCenters[tileIndex] = polyCenters;
+	tilePolyBounds[tileIndex] = polyBounds;
 
 	return true;
 }
 
-bool AiNavMeshManager::Load( const char *mapName ) {
+bool AiNavMeshManager::LoadFromFile( const char *filePath, const char *mapName ) {
 	constexpr const char *tag = "AiNavMeshManager";
 
-	char filePath[MAX_QPATH];
-	MakePrecomputedFilePath( filePath, sizeof( filePath ), mapName );
-
-	unsigned char *data = nullptr;
-	int dataSize = 0;
-
 	constexpr const char *readerTag = "PrecomputedFileReader@AiNavMeshManager";
 	AiPrecomputedFileReader reader( readerTag, PRECOMPUTED_FILE_VERSION, PrecomputedIOAlloc, PrecomputedIOFree );
 	const auto loadingStatus = reader.BeginReading( filePath );
-	if( loadingStatus == AiPrecomputedFileReader::SUCCESS ) {
-		if( reader.ReadLengthAndData( (uint8_t **)&data, (uint32_t *)&dataSize ) ) {
-			if( this->InitNavMeshFromData( data, dataSize ) ) {
-				G_Printf( "%s: A precomputed mesh data for map %s has been loaded successfully\n", tag, mapName );
-				return true;
-			} else {
-				G_Printf( S_COLOR_RED "%s: Can't load nav mesh data from the read blob\n", tag );
-			}
-		} else {
-			G_Printf( S_COLOR_RED "%s: Can't read nav mesh data from the file\n", tag );
-		}
-	} else if( loadingStatus == AiPrecomputedFileReader::MISSING ) {
+	if( loadingStatus == AiPrecomputedFileReader::MISSING ) {
 		G_Printf( "%s: Looks like there is no precomputed nav mesh for map %s\n", tag, mapName );
+		return false;
 	} else if( loadingStatus == AiPrecomputedFileReader::VERSION_MISMATCH ) {
 		G_Printf( "%s: Looks like the precomputed nav mesh for map %s has a different version\n", tag, mapName );
+		return false;
 	} else if( loadingStatus == AiPrecomputedFileReader::FAILURE ) {
 		G_Printf( S_COLOR_RED "%s: An error has occurred while reading a nav mesh header for map %s\n", tag, mapName );
+		return false;
 	}
 
-	G_Printf( "%s: Building nav mesh data for map %s (it might take a while...)\n", tag, mapName );
+	uint8_t *headerData;
+	uint32_t headerDataSize;
+	if( !reader.ReadLengthAndData( &headerData, &headerDataSize ) ) {
+		G_Printf( S_COLOR_RED "%s: Can't read nav mesh params from the file\n", tag );
+		return false;
+	}
 
-	NavMeshBuilder builder;
-	if( !builder.BuildMeshData( &data, &dataSize ) ) {
-		G_Printf( S_COLOR_RED "%s: Can't build nav mesh data for map %s\n", tag, mapName );
+	NavMeshFileHeader header;
+	const bool isHeaderValid = headerDataSize == sizeof( header );
+	if( isHeaderValid ) {
+		memcpy( &header, headerData, sizeof( header ) );
+	}
+	PrecomputedIOFree( headerData );
+
+	if( !isHeaderValid || header.numTiles <= 0 || header.numTiles > header.params.maxTiles ) {
+		G_Printf( S_COLOR_RED "%s: Illegal nav mesh params in the file\n", tag );
+		return false;
+	}
+
+	if( !InitNavMesh( &header.params ) ) {
+		return false;
+	}
+
+	int dataSize = 0, numPolys = 0;
+	for( int i = 0; i < header.numTiles; ++i ) {
+		uint8_t *tileData;
+		uint32_t tileDataSize;
+		if( !reader.ReadLengthAndData( &tileData, &tileDataSize ) ) {
+			G_Printf( S_COLOR_RED "%s: Can't read nav mesh tile data from the file\n", tag );
+			ResetNavMesh();
+			return false;
+		}
+		if( !AddTile( tileData, (int)tileDataSize ) ) {
+			G_Printf( S_COLOR_RED "%s: Can't load nav mesh tile data from the read blob\n", tag );
+			ResetNavMesh();
+			return false;
+		}
+		dataSize += (int)tileDataSize;
+		numPolys += ( (const dtMeshHeader *)tileData )->polyCount;
+	}
+
+	G_Printf( "%s: Nav mesh data size: %d bytes, tiles count: %d, poly count: %d\n",
+			  tag, dataSize, header.numTiles, numPolys );
+	return true;
+}
+
+void AiNavMeshManager::SaveToFile( const char *filePath ) {
+	constexpr const char *writerTag = "PrecomputedFileWriter@AiNavMeshManager";
+	AiPrecomputedFileWriter writer( writerTag, PRECOMPUTED_FILE_VERSION, PrecomputedIOAlloc, PrecomputedIOFree );
+	if( !writer.BeginWriting( filePath ) ) {
+		G_Printf( S_COLOR_RED "Can't write precomputed nav mesh file header to file %s\n", filePath );
+		return;
+	}
+
+	const dtNavMesh *navMesh = underlyingNavMesh;
+
+	NavMeshFileHeader header;
+	memcpy( &header.params, navMesh->getParams(), sizeof( header.params ) );
+	header.numTiles = 0;
+	for( int i = 0; i < maxTiles; ++i ) {
+		if( navMesh->getTile( i )->header ) {
+			header.numTiles++;
+		}
+	}
+
+	if( !writer.WriteLengthAndData( (const uint8_t *)&header, sizeof( header ) ) ) {
+		G_Printf( S_COLOR_RED "Can't write precomputed nav mesh data to file %s\n", filePath );
+		return;
+	}
+
+	// Write the data of tiles directly without making a single blob
+	for( int i = 0; i < maxTiles; ++i ) {
+		const dtMeshTile *tile = navMesh->getTile( i );
+		if( !tile->header ) {
+			continue;
+		}
+		if( !writer.WriteLengthAndData( tile->data, (uint32_t)tile->dataSize ) ) {
+			G_Printf( S_COLOR_RED "Can't write precomputed nav mesh data to file %s\n", filePath );
+			return;
+		}
+	}
+
+	G_Printf( "Precomputed nav mesh has been saved successfully to %s\n", filePath );
+}
+
+bool AiNavMeshManager::StartTiledBuild() {
+	constexpr const char *tag = "AiNavMeshManager::StartTiledBuild()";
+
+	tiledBuild = new( G_Malloc( sizeof( NavMeshTiledBuild ) ) )NavMeshTiledBuild;
+	if( !tiledBuild->Prepare() ) {
+		tiledBuild->~NavMeshTiledBuild();
+		G_Free( tiledBuild );
+		tiledBuild = nullptr;
 		return false;
 	}
 
-	// Release allocated memory without waiting for leaving the scope to save space for further allocations
-	builder.ForceClear();
+	dtNavMeshParams params;
+	memset( &params, 0, sizeof( params ) );
+	VectorCopy( tiledBuild->tiling.mins, params.orig );
+	params.tileWidth = tiledBuild->tiling.TileSize();
+	params.tileHeight = tiledBuild->tiling.TileSize();
+	params.maxTiles = tiledBuild->numTasks;
 
-	if( !this->InitNavMeshFromData( data, dataSize ) ) {
-		G_Printf( S_COLOR_RED "%s: Can't load nav mesh data from the computed blob for map %s\n", tag, mapName );
+	// Detour requires at least 10 of 32 poly ref bits for a salt
+	int tileBits = 0;
+	while( ( 1 << tileBits ) < params.maxTiles ) {
+		tileBits++;
+	}
+	if( tileBits > 12 ) {
+		G_Printf( S_COLOR_RED "%s: Too many tiles: %d\n", tag, params.maxTiles );
+		tiledBuild->~NavMeshTiledBuild();
+		G_Free( tiledBuild );
+		tiledBuild = nullptr;
 		return false;
 	}
+	params.maxPolys = 1 << ( 22 - tileBits );
 
-	// Mark the data for saving
-	this->dataToSave = data;
-	this->dataToSaveSize = dataSize;
+	if( !InitNavMesh( &params ) ) {
+		tiledBuild->~NavMeshTiledBuild();
+		G_Free( tiledBuild );
+		tiledBuild = nullptr;
+		return false;
+	}
 
-	G_Printf( "%s: The nav mesh data has been initialized successfully\n", tag );
+	tiledBuild->Start();
+	// Add tiles that might have been built synchronously
+	AddBuiltTiles();
 	return true;
-}
\ No newline at end of file
+}
+
+void AiNavMeshManager::AddBuiltTiles() {
+	constexpr const char *tag = "AiNavMeshManager";
+
+	if( !tiledBuild ) {
+		return;
+	}
+
+	NavMeshTiledBuild *build = tiledBuild;
+
+	// Entries before this number are written by workers before the lock is released
+	trap_Mutex_Lock( build->finishedTasksLock );
+	const int numFinishedTasks = build->numFinishedTasks;
+	trap_Mutex_Unlock( build->finishedTasksLock );
+
+	for(; build->numAddedTasks < numFinishedTasks; build->numAddedTasks++ ) {
+		NavMeshTileTask *task = build->tasks + build->finishedTasks[build->numAddedTasks];
+		if( task->failed ) {
+			G_Printf( S_COLOR_YELLOW "%s: Can't build nav mesh tile (%d, %d)\n", tag, task->tileX, task->tileZ );
+			build->numFailedTasks++;
+			continue;
+		}
+
+		int numPolys = 0;
+		if( unsigned char *data = task->data ) {
+			// The data is owned by the nav mesh (or released) after this call
+			task->data = nullptr;
+			numPolys = ( (const dtMeshHeader *)data )->polyCount;
+			if( !AddTile( data, task->dataSize ) ) {
+				build->numFailedTasks++;
+				continue;
+			}
+		}
+
+		if( developer->integer ) {
+			G_Printf( "%s: Nav mesh tile (%d, %d): %d tris, %d polys, %.2f ms\n", tag,
+					  task->tileX, task->tileZ, task->numTris, numPolys, task->buildMicros * 0.001 );
+		}
+	}
+
+	if( build->numAddedTasks < build->numTasks ) {
+		return;
+	}
+
+	uint64_t tilesMicros = 0;
+	for( int i = 0; i < build->numTasks; ++i ) {
+		tilesMicros += build->tasks[i].buildMicros;
+	}
+
+	G_Printf( "%s: The nav mesh has been built in %.2f ms (%d tiles, %d failed, %.2f ms spent in tile jobs)\n",
+			  tag, ( trap_Microseconds() - build->startedAt ) * 0.001, build->numTasks,
+			  build->numFailedTasks, tilesMicros * 0.001 );
+
+	// Do not save a mesh with holes, try building it again next time
+	needsSaving = !build->numFailedTasks;
+
+	tiledBuild->~NavMeshTiledBuild();
+	G_Free( tiledBuild );
+	tiledBuild = nullptr;
+}
+
+bool AiNavMeshManager::Load( const char *mapName ) {
+	constexpr const char *tag = "AiNavMeshManager";
+
+	char filePath[MAX_QPATH];
+	MakePrecomputedFilePath( filePath, sizeof( filePath ), mapName );
+
+	if( LoadFromFile( filePath, mapName ) ) {
+		G_Printf( "%s: A precomputed mesh data for map %s has been loaded successfully\n", tag, mapName );
+		return true;
+	}
+
+	// Release a partially initialized mesh (if any)
+	ResetNavMesh();
+
+	G_Printf( "%s: Building nav mesh data for map %s in background (it might take a while...)\n", tag, mapName );
+
+	if( !StartTiledBuild() ) {
+		G_Printf( S_COLOR_RED "%s: Can't build nav mesh data for map %s\n", tag, mapName );
+		ResetNavMesh();
+		return false;
+	}
+
+	return true;
+}
@@ -36,18 +36,31 @@ class AiNavMeshManager
 	friend class AiNavMeshQuery;
 
 	class dtNavMesh *underlyingNavMesh;
-	float *polyCenters;
-	float *polyBounds;
+	// Poly centers and bounds are stored per tile (addressed by a tile index of a poly ref)
+	float **tilePolyCenters;
+	float **tilePolyBounds;
+	int maxTiles;
 
-	// A data to save (might be null and is usually null).
+	// A tiled build that is still running on worker threads (if any).
+	// Tiles are added to the nav mesh as they are ready, so queries work on a partial mesh meanwhile.
+	class NavMeshTiledBuild *tiledBuild;
+
+	// Whether the mesh has been built completely and should be saved.
 	// We have decided to defer saving just computed data until map shutdown
 	// to follow the existing TacticalSpotsRegistry behavior.
-	// This data is not really large, should be several hundreds of KiBs.
-	unsigned char *dataToSave;
-	int dataToSaveSize;
+	bool needsSaving;
 
 	bool Load( const char *mapName );
-	bool InitNavMeshFromData( unsigned char *data, int dataSize );
+	bool LoadFromFile( const char *filePath, const char *mapName );
+	bool StartTiledBuild();
+	bool InitNavMesh( const struct dtNavMeshParams *params );
+	void ResetNavMesh();
+	bool AddTile( unsigned char *data, int dataSize );
+	void AddBuiltTiles();
+	void SaveToFile( const char *filePath );
+
+	const float *PolyCenter( uint32_t polyRef ) const;
+	const float *PolyBounds( uint32_t polyRef ) const;
 
 	// Add a slot for a world too
 	mutable AiNavMeshQuery querySlots[MAX_CLIENTS + 1];
@@ -61,6 +74,8 @@ public:
 	~AiNavMeshManager();
 	static void Init( const char *mapName );
 	static void Shutdown();
+	// Adds tiles built since the last call while a tiled build is running
+	static void Frame();
 
 	void GetPolyCenter( uint32_t polyRef, vec3_t center ) const;
 	void GetPolyBounds( uint32_t polyRef, vec3_t mins, vec3_t maxs ) const;
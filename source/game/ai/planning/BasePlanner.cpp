@@ -50,6 +50,15 @@ inline void PoolBase::Unlink( int16_t itemIndex, int16_t listIndex ) {
 }
 
 void *PoolBase::Alloc() {
+	if( concurrentFreeList ) {
+		const int itemIndex = concurrentFreeList->Pop();
+		if( itemIndex < 0 ) {
+			return nullptr;
+		}
+		concurrentUsedMarks[itemIndex].store( true, std::memory_order_relaxed );
+		return &ItemAt( (int16_t)itemIndex );
+	}
+
 	if( listFirst[FREE_LIST] < 0 ) {
 		return nullptr;
 	}
@@ -64,20 +73,40 @@ void *PoolBase::Alloc() {
 
 void PoolBase::Free( PoolItem *item ) {
 	int16_t itemIndex = IndexOf( item );
+	if( concurrentFreeList ) {
+		concurrentUsedMarks[itemIndex].store( false, std::memory_order_relaxed );
+		concurrentFreeList->Push( itemIndex );
+		return;
+	}
+
 	// Unlink from used
 	Unlink( itemIndex, USED_LIST );
 	// Link to free
 	Link( itemIndex, FREE_LIST );
 }
 
-PoolBase::PoolBase( char *basePtr_, const char *tag_, uint16_t itemSize, uint16_t itemsCount )
+PoolBase::PoolBase( char *basePtr_, const char *tag_, uint16_t itemSize, uint16_t itemsCount_, bool isConcurrent )
 	: basePtr( basePtr_ ),
 	tag( tag_ ),
 	linksOffset( LinksOffset( itemSize ) ),
-	alignedChunkSize( AlignedChunkSize( itemSize ) ) {
-	listFirst[FREE_LIST] = 0;
+	alignedChunkSize( AlignedChunkSize( itemSize ) ),
+	itemsCount( itemsCount_ ),
+	concurrentFreeList( nullptr ),
+	concurrentUsedMarks( nullptr ) {
+	listFirst[FREE_LIST] = -1;
 	listFirst[USED_LIST] = -1;
 
+	if( isConcurrent ) {
+		concurrentFreeList = new( G_Malloc( sizeof( ConcurrentFreeList ) ) )ConcurrentFreeList( itemsCount );
+		concurrentUsedMarks = (std::atomic<bool> *)G_Malloc( sizeof( std::atomic<bool> ) * itemsCount );
+		for( unsigned i = 0; i < itemsCount; ++i ) {
+			new( concurrentUsedMarks + i )std::atomic<bool>( false );
+		}
+		return;
+	}
+
+	listFirst[FREE_LIST] = 0;
+
 	// Link all items to the free list
 	int16_t lastIndex = (int16_t)( itemsCount - 1 );
 	ItemLinksAt( 0 ).Prev() = -1;
@@ -90,7 +119,24 @@ PoolBase::PoolBase( char *basePtr_, const char *tag_, uint16_t itemSize, uint16_
 	}
 }
 
+PoolBase::~PoolBase() {
+	if( concurrentFreeList ) {
+		concurrentFreeList->~ConcurrentFreeList();
+		G_Free( concurrentFreeList );
+		G_Free( concurrentUsedMarks );
+	}
+}
+
 void PoolBase::Clear() {
+	if( concurrentFreeList ) {
+		for( int16_t itemIndex = 0; itemIndex < (int16_t)itemsCount; ++itemIndex ) {
+			if( concurrentUsedMarks[itemIndex].load( std::memory_order_relaxed ) ) {
+				ItemAt( itemIndex ).DeleteSelf();
+			}
+		}
+		return;
+	}
+
 	int16_t itemIndex = listFirst[USED_LIST];
 	while( itemIndex >= 0 ) {
 		auto &item = ItemAt( itemIndex );
@@ -5,6 +5,7 @@
 #include "GoalEntities.h"
 #include "../ai_frame_aware_updatable.h"
 #include "../static_vector.h"
+#include "../ai_concurrent_free_list.h"
 #include "../navigation/AasRouteCache.h"
 #include "../ai_base_ai.h"
 #include "WorldState.h"
@@ -67,6 +68,12 @@ class alignas ( sizeof( void * ) )PoolBase
 
 	int16_t listFirst[2];
 
+	const uint16_t itemsCount;
+	// Non-null for pools that may be used by multiple threads.
+	// Lists above are not used in this case, an item is marked as used instead.
+	ConcurrentFreeList *concurrentFreeList;
+	std::atomic<bool> *concurrentUsedMarks;
+
 #ifdef _DEBUG
 	inline const char *ListName( int index ) {
 		switch( index ) {
@@ -138,8 +145,13 @@ protected:
 		return *(ItemLinks *)mem;
 	}
 public:
-	PoolBase( char *basePtr_, const char *tag_, uint16_t itemSize, uint16_t itemsCount );
+	PoolBase( char *basePtr_, const char *tag_, uint16_t itemSize, uint16_t itemsCount_, bool isConcurrent = false );
+	~PoolBase();
+
+	PoolBase( const PoolBase &that ) = delete;
+	PoolBase &operator=( const PoolBase &that ) = delete;
 
+	// Must not be called concurrently with other calls for concurrent pools
 	void Clear();
 };
 
@@ -160,7 +172,9 @@ public:
 	}
 };
 
-template<class Item, unsigned N>
+// Pools are not thread-safe by default.
+// Set IsConcurrent if items are allocated and freed by multiple threads (see ConcurrentFreeList).
+template<class Item, unsigned N, bool IsConcurrent = false>
 class alignas ( sizeof( void * ) )Pool : public PoolBase
 {
 	// We have to introduce these intermediates instead of variables since we are limited to C++11 (not 14) standard.
@@ -188,7 +202,7 @@ class alignas ( sizeof( void * ) )Pool : public PoolBase
 	alignas( alignof( void * ) ) char buffer[N * ChunkSize()];
 
 public:
-	Pool( const char *tag_ ) : PoolBase( buffer, tag_, sizeof( Item ), (uint16_t)N ) {
+	Pool( const char *tag_ ) : PoolBase( buffer, tag_, sizeof( Item ), (uint16_t)N, IsConcurrent ) {
 		static_assert( N <= std::numeric_limits<int16_t>::max(), "Links can't handle more than 2^15 elements in pool" );
 	}
 
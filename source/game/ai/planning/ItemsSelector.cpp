@@ -291,18 +291,28 @@ SelectedNavEntity BotItemsSelector::SuggestGoalNavEntity( const SelectedNavEntit
 	const int numFromAreas = entityPhysicsState->PrepareRoutingStartAreas( fromAreaNums );
 	const auto *routeCache = self->ai->botRef->routeCache;
 
+	// Find travel times to all candidates by a single routing query instead of querying them one by one
+	int candidateAreaNums[MAX_NAVENTS];
+	int candidateTravelTimes[MAX_NAVENTS];
+	for( unsigned i = 0; i < rawWeightCandidates.size(); ++i ) {
+		candidateAreaNums[i] = rawWeightCandidates[i].goal->AasAreaNum();
+	}
+	routeCache->PreferredTravelTimesToGoalAreas( fromAreaNums, numFromAreas, candidateAreaNums,
+												 (int)rawWeightCandidates.size(), candidateTravelTimes );
+
 	// Pick the best raw weight nav entity.
 	// This nav entity is not necessarily the best final nav entity
 	// by the final weight that is influenced by routing cost,
 	// but the best raw weight means the high importance of it.
-	// The picked entity must be reachable from the current location
+	// The picked entity must be reachable from the current location.
+	// Use the same pairwise query the travel time from a candidate to the raw best entity is computed by,
+	// as these times are compared to each other
 	auto rawCandidatesIter = rawWeightCandidates.begin();
 	const auto rawCandidatesEnd = rawWeightCandidates.end();
 	const NavEntity *rawBestNavEnt = ( *rawCandidatesIter ).goal;
-	int rawBestAreaNum = rawBestNavEnt->AasAreaNum();
 	unsigned botToBestRawEntMoveDuration = 0;
 	for(;; ) {
-		botToBestRawEntMoveDuration = 10U * routeCache->PreferredRouteToGoalArea( fromAreaNums, numFromAreas, rawBestAreaNum );
+		botToBestRawEntMoveDuration = 10U * routeCache->PreferredRouteToGoalArea( fromAreaNums, numFromAreas, rawBestNavEnt->AasAreaNum() );
 		if( botToBestRawEntMoveDuration ) {
 			break;
 		}
@@ -312,7 +322,6 @@ SelectedNavEntity BotItemsSelector::SuggestGoalNavEntity( const SelectedNavEntit
 			return SelectedNavEntity( nullptr, std::numeric_limits<float>::max(), 0.0f, level.time + 200 );
 		}
 		rawBestNavEnt = ( *rawCandidatesIter ).goal;
-		rawBestAreaNum = rawBestNavEnt->AasAreaNum();
 	}
 
 	const EnemyPathBlockingDetector pathBlockingDetector( self );
@@ -342,7 +351,7 @@ SelectedNavEntity BotItemsSelector::SuggestGoalNavEntity( const SelectedNavEntit
 		float weight = ( *rawCandidatesIter ).weight;
 
 		const unsigned botToCandidateMoveDuration =
-			routeCache->PreferredRouteToGoalArea( fromAreaNums, numFromAreas, navEnt->AasAreaNum() ) * 10U;
+			candidateTravelTimes[rawCandidatesIter - rawWeightCandidates.begin()] * 10U;
 
 		// AAS functions return 0 as a "none" value, 1 as a lowest feasible value
 		if( !botToCandidateMoveDuration ) {
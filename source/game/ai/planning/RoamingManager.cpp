@@ -130,28 +130,15 @@ int BotRoamingManager::TrySuggestTacticalSpot() {
 int BotRoamingManager::TryFindReachableSpot( const Candidates &candidateSpots, int travelFlags,
 											 const int *fromAreaNums, int numFromAreas ) {
 	const auto *spots = tacticalSpotsRegistry->spots;
-	const auto *routeCache = self->ai->botRef->routeCache;
 
-	int travelTime = 0;
-	// Add an optimized branch for this common case
-	if( numFromAreas == 1 ) {
-		for( unsigned i = 0; i < candidateSpots.size(); ++i ) {
-			const auto spotNum = candidateSpots[i];
-			const int spotAreaNum = spots[spotNum].aasAreaNum;
-			if( ( travelTime = routeCache->TravelTimeToGoalArea( fromAreaNums[0], spotAreaNum, travelFlags ) ) ) {
-				return spotNum;
-			}
-		}
-	} else {
-		for( unsigned i = 0; i < candidateSpots.size(); ++i ) {
-			const auto spotNum = candidateSpots[i];
-			const int spotAreaNum = spots[spotNum].aasAreaNum;
-			for( int j = 0; j < numFromAreas; ++j ) {
-				if( ( travelTime = routeCache->TravelTimeToGoalArea( fromAreaNums[j], spotAreaNum, travelFlags ) ) ) {
-					return spotNum;
-				}
-			}
-		}
+	int spotAreaNums[Candidates::capacity()];
+	for( unsigned i = 0; i < candidateSpots.size(); ++i ) {
+		spotAreaNums[i] = spots[candidateSpots[i]].aasAreaNum;
+	}
+
+	int index = FindFirstReachableArea( spotAreaNums, (int)candidateSpots.size(), travelFlags, fromAreaNums, numFromAreas );
+	if( index >= 0 ) {
+		return candidateSpots[index];
 	}
 
 	return -1;
@@ -159,28 +146,31 @@ int BotRoamingManager::TryFindReachableSpot( const Candidates &candidateSpots, i
 
 int BotRoamingManager::TryFindReachableArea( const Candidates &candidateAreas, int travelFlags,
 											 const int *fromAreaNums, int numFromAreas ) {
+	int index = FindFirstReachableArea( candidateAreas.begin(), (int)candidateAreas.size(), travelFlags, fromAreaNums, numFromAreas );
+	if( index >= 0 ) {
+		return candidateAreas[index];
+	}
+
+	return 0;
+}
+
+int BotRoamingManager::FindFirstReachableArea( const int *areaNums, int numAreas, int travelFlags,
+											   const int *fromAreaNums, int numFromAreas ) {
 	const auto *routeCache = self->ai->botRef->routeCache;
 
-	int travelTime = 0;
-	if( numFromAreas == 1 ) {
-		for( unsigned i = 0; i < candidateAreas.size(); ++i ) {
-			const auto areaNum = candidateAreas[i];
-			if( ( travelTime = routeCache->TravelTimeToGoalArea( fromAreaNums[0], areaNum, travelFlags ) ) ) {
-				return areaNum;
-			}
-		}
-	} else {
-		for( unsigned i = 0; i < candidateAreas.size(); ++i ) {
-			const auto areaNum = candidateAreas[i];
-			for( int j = 0; j < numFromAreas; ++j ) {
-				if( ( travelTime = routeCache->TravelTimeToGoalArea( fromAreaNums[j], areaNum, travelFlags ) ) ) {
-					return areaNum;
-				}
-			}
+	// Test all candidates by a single routing query instead of querying them one by one
+	int travelTimes[Candidates::capacity()];
+	if( !routeCache->TravelTimesToGoalAreas( fromAreaNums, numFromAreas, areaNums, numAreas, travelFlags, 0, travelTimes ) ) {
+		return -1;
+	}
+
+	for( int i = 0; i < numAreas; ++i ) {
+		if( travelTimes[i] ) {
+			return i;
 		}
 	}
 
-	return 0;
+	return -1;
 }
 
 int BotRoamingManager::TrySuggestRandomAasArea() {
@@ -41,6 +41,8 @@ class BotRoamingManager
 	int TryFindReachableSpot( const Candidates &candidateSpots, int travelFlags, const int *fromAreaNums, int numFromAreas );
 	// Positive return values are feasible
 	int TryFindReachableArea( const Candidates &candidateAreas, int travelFlags, const int *fromAreaNums, int numFromAreas );
+	// Returns an index of the first reachable area (non-negative return values are feasible)
+	int FindFirstReachableArea( const int *areaNums, int numAreas, int travelFlags, const int *fromAreaNums, int numFromAreas );
 	void TryResetAllSpotsDisabledState();
 	// Positive return values are feasible
 	int TrySuggestRandomAasArea();
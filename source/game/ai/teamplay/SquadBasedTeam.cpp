@@ -5,11 +5,61 @@
 #include <algorithm>
 #include <limits>
 
+void CachedTravelTimesMatrix::Clear() {
+	std::fill( aasTravelTimes, aasTravelTimes + MAX_CLIENTS * MAX_CLIENTS, -1 );
+	std::fill( clientAreaNums, clientAreaNums + MAX_CLIENTS, 0 );
+	std::fill( clientFrameNums, clientFrameNums + MAX_CLIENTS, -1 );
+	memset( clientTravelFlags, 0, sizeof( clientTravelFlags ) );
+	numTrackedClients = 0;
+}
+
+void CachedTravelTimesMatrix::Update( Bot *const *bots, unsigned numBots ) {
+	numTrackedClients = 0;
+	for( unsigned i = 0; i < numBots; ++i ) {
+		trackedClientNums[numTrackedClients++] = UpdateClient( bots[i]->self );
+	}
+}
+
+int CachedTravelTimesMatrix::UpdateClient( const edict_t *client ) {
+	const int clientNum = ENTNUM( client ) - 1;
+	if( clientFrameNums[clientNum] == level.framenum ) {
+		return clientNum;
+	}
+
+	clientFrameNums[clientNum] = level.framenum;
+
+	int areaNum = 0;
+	vec3_t origin;
+	if( AiGroundTraceCache::Instance()->TryDropToFloor( client, 96.0f, origin ) ) {
+		areaNum = AiAasWorld::Instance()->FindAreaNum( origin );
+	}
+
+	const int preferredTravelFlags = client->ai->aiRef->PreferredTravelFlags();
+	const int allowedTravelFlags = client->ai->aiRef->AllowedTravelFlags();
+	int *travelFlags = clientTravelFlags[clientNum];
+	if( areaNum != clientAreaNums[clientNum] || preferredTravelFlags != travelFlags[0] || allowedTravelFlags != travelFlags[1] ) {
+		clientAreaNums[clientNum] = areaNum;
+		travelFlags[0] = preferredTravelFlags;
+		travelFlags[1] = allowedTravelFlags;
+		InvalidateClient( clientNum );
+	}
+
+	return clientNum;
+}
+
+void CachedTravelTimesMatrix::InvalidateClient( int clientNum ) {
+	// Invalidate travel times from the client
+	std::fill_n( aasTravelTimes + clientNum * MAX_CLIENTS, MAX_CLIENTS, -1 );
+	// Invalidate travel times to the client
+	for( int i = 0; i < MAX_CLIENTS; ++i ) {
+		aasTravelTimes[i * MAX_CLIENTS + clientNum] = -1;
+	}
+}
+
 int CachedTravelTimesMatrix::GetAASTravelTime( const edict_t *client1, const edict_t *client2 ) {
+#ifdef _DEBUG
 	int client1Num = client1 - game.edicts;
 	int client2Num = client2 - game.edicts;
-
-#ifdef _DEBUG
 	if( client1Num <= 0 || client1Num > gs.maxclients ) {
 		AI_FailWith( "CachedTravelTimesMatrix::GetAASTravelTime()", "Entity `client1` #%d is not a client\n", client1Num );
 	}
@@ -17,9 +67,11 @@ int CachedTravelTimesMatrix::GetAASTravelTime( const edict_t *client1, const edi
 		AI_FailWith( "CachedTravelTimesMatrix::GetAASTravelTime()", "Entity `client2` #%d is not a client\n", client2Num );
 	}
 #endif
-	int index = client1Num * MAX_CLIENTS + client2Num;
+	const int fromClientNum = UpdateClient( client1 );
+	const int toClientNum = UpdateClient( client2 );
+	const int index = fromClientNum * MAX_CLIENTS + toClientNum;
 	if( aasTravelTimes[index] < 0 ) {
-		aasTravelTimes[index] = FindAASTravelTime( client1, client2 );
+		FillRow( fromClientNum, toClientNum );
 	}
 	return aasTravelTimes[index];
 }
@@ -29,34 +81,67 @@ int CachedTravelTimesMatrix::GetAASTravelTime( const Bot *from, const Bot *to )
 	return GetAASTravelTime( from->self, to->self );
 }
 
-int CachedTravelTimesMatrix::FindAASTravelTime( const edict_t *client1, const edict_t *client2 ) {
-	AiGroundTraceCache *groundTraceCache = AiGroundTraceCache::Instance();
-	AiAasWorld *aasWorld = AiAasWorld::Instance();
-	AiAasRouteCache *routeCache = AiAasRouteCache::Shared();
-
-	const edict_t *clients[2] = { client1, client2 };
-	vec3_t origins[2];
-	int areaNums[2] = { 0, 0 };
+void CachedTravelTimesMatrix::FillRow( int fromClientNum, int requestedClientNum ) {
+	int *const row = aasTravelTimes + fromClientNum * MAX_CLIENTS;
 
-	for( int i = 0; i < 2; ++i ) {
-		if( !groundTraceCache->TryDropToFloor( clients[i], 96.0f, origins[i] ) ) {
-			return 0;
+	// Compute the requested entry along with all missing entries of tracked clients.
+	// Clients are likely to query their mates in this frame anyway.
+	int goalClientNums[MAX_CLIENTS + 1];
+	int numGoalClients = 0;
+	goalClientNums[numGoalClients++] = requestedClientNum;
+	for( int i = 0; i < numTrackedClients; ++i ) {
+		const int clientNum = trackedClientNums[i];
+		if( clientNum != requestedClientNum && row[clientNum] < 0 ) {
+			goalClientNums[numGoalClients++] = clientNum;
 		}
-		areaNums[i] = aasWorld->FindAreaNum( origins[i] );
-		if( !areaNums[i] ) {
-			return 0;
+	}
+
+	// Clients standing in the same area share the goal area
+	int goalAreaNums[MAX_CLIENTS + 1];
+	int goalTravelTimes[MAX_CLIENTS + 1];
+	int numGoalAreas = 0;
+	for( int i = 0; i < numGoalClients; ++i ) {
+		const int areaNum = clientAreaNums[goalClientNums[i]];
+		if( areaNum && std::find( goalAreaNums, goalAreaNums + numGoalAreas, areaNum ) == goalAreaNums + numGoalAreas ) {
+			goalAreaNums[numGoalAreas++] = areaNum;
 		}
 	}
 
-	int travelFlags[2] = { client1->ai->aiRef->PreferredTravelFlags(), client1->ai->aiRef->AllowedTravelFlags() };
-	for( int i = 0; i < 2; ++i ) {
-		int travelTime = routeCache->TravelTimeToGoalArea( areaNums[0], areaNums[1], travelFlags[i] );
-		if( travelTime ) {
-			return travelTime;
+	if( clientAreaNums[fromClientNum] ) {
+		FindTravelTimes( fromClientNum, goalAreaNums, numGoalAreas, goalTravelTimes );
+	} else {
+		std::fill_n( goalTravelTimes, numGoalAreas, 0 );
+	}
+
+	for( int i = 0; i < numGoalClients; ++i ) {
+		const int clientNum = goalClientNums[i];
+		const int areaNum = clientAreaNums[clientNum];
+		row[clientNum] = 0;
+		if( areaNum ) {
+			row[clientNum] = goalTravelTimes[std::find( goalAreaNums, goalAreaNums + numGoalAreas, areaNum ) - goalAreaNums];
 		}
 	}
+}
 
-	return 0;
+void CachedTravelTimesMatrix::FindTravelTimes( int fromClientNum, const int *goalAreaNums,
+											   int numGoalAreas, int *travelTimes ) {
+	const AiAasRouteCache *routeCache = AiAasRouteCache::Shared();
+	const int fromAreaNum = clientAreaNums[fromClientNum];
+	const int *travelFlags = clientTravelFlags[fromClientNum];
+
+	// Find travel times to all goals by a single search using preferred travel flags
+	if( routeCache->TravelTimesToGoalAreas( fromAreaNum, goalAreaNums, numGoalAreas, travelFlags[0], travelTimes ) == numGoalAreas ) {
+		return;
+	}
+
+	// Repeat the search using allowed travel flags and take its results for goals that have not been reached
+	int allowedFlagsTravelTimes[MAX_CLIENTS + 1];
+	routeCache->TravelTimesToGoalAreas( fromAreaNum, goalAreaNums, numGoalAreas, travelFlags[1], allowedFlagsTravelTimes );
+	for( int i = 0; i < numGoalAreas; ++i ) {
+		if( !travelTimes[i] ) {
+			travelTimes[i] = allowedFlagsTravelTimes[i];
+		}
+	}
 }
 
 AiSquad::SquadEnemiesTracker::SquadEnemiesTracker( AiSquad *squad_, float skill )
@@ -1089,7 +1174,16 @@ void AiSquadBasedTeam::Frame() {
 	}
 
 	// This should be called before AiSquad::Update() (since squads refer to this matrix)
-	travelTimesMatrix.Clear();
+	StaticVector<Bot *, MAX_CLIENTS> teamBots;
+	for( Bot *bot: orphanBots )
+		teamBots.push_back( bot );
+	for( auto &squad: squads ) {
+		if( squad.InUse() ) {
+			for( Bot *bot: squad.bots )
+				teamBots.push_back( bot );
+		}
+	}
+	travelTimesMatrix.Update( teamBots.begin(), teamBots.size() );
 
 	// Call squads Update() (and, thus, Frame() and, maybe, Think()) each frame as it is expected
 	// even if all squad AI logic is performed only in AiSquad::Think()
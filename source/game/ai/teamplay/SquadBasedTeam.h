@@ -11,16 +11,37 @@
 
 class Bot;
 
+// Travel times between AAS areas clients are in.
+// An entry stays valid while both clients remain in areas it has been computed for,
+// so entries survive across frames and only ones of clients that have changed areas are recomputed.
 class CachedTravelTimesMatrix
 {
+	// -1 means that a value should be lazily computed on demand
 	int aasTravelTimes[MAX_CLIENTS * MAX_CLIENTS];
-	int FindAASTravelTime( const edict_t *fromClient, const edict_t *toClient );
+	// Areas and travel flags entries of a client have been computed for
+	int clientAreaNums[MAX_CLIENTS];
+	int clientTravelFlags[MAX_CLIENTS][2];
+	// A frame when the client area has been checked last time
+	int64_t clientFrameNums[MAX_CLIENTS];
+
+	// Clients supplied in the last Update() call, missing entries of a row are computed for all of them at once
+	int trackedClientNums[MAX_CLIENTS];
+	int numTrackedClients;
+
+	// Checks whether the client has changed its area (once per frame) and invalidates its entries if so
+	int UpdateClient( const edict_t *client );
+	void InvalidateClient( int clientNum );
+	void FillRow( int fromClientNum, int requestedClientNum );
+	void FindTravelTimes( int fromClientNum, const int *goalAreaNums, int numGoalAreas, int *travelTimes );
 
 public:
-	inline void Clear() {
-		// -1 means that a value should be lazily computed on demand
-		std::fill( aasTravelTimes, aasTravelTimes + MAX_CLIENTS * MAX_CLIENTS, -1 );
-	}
+	CachedTravelTimesMatrix() { Clear(); }
+
+	// Invalidates all entries
+	void Clear();
+	// Should be called each frame before querying travel times
+	void Update( Bot *const *bots, unsigned numBots );
+
 	int GetAASTravelTime( const edict_t *fromClient, const edict_t *toClient );
 	int GetAASTravelTime( const Bot *from, const Bot *to );
 };
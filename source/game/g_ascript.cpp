@@ -3859,3 +3859,63 @@ void G_asDumpAPI_f( void ) {
 	Q_snprintfz( path, sizeof( path ), "AS_API/v%.g/", trap_Cvar_Value( "version" ) );
 	G_asDumpAPIToFile( path );
 }
+
+/*
+* G_asBuildBytecodeCacheForDir
+*/
+static void G_asBuildBytecodeCacheForDir( const char *dir, const char *ext, int *numBuilt, int *numFailed ) {
+	int i;
+	char path[MAX_QPATH];
+	char *list;
+	const char *name;
+	const char *moduleName = "bytecodecache";
+
+	Q_snprintfz( path, sizeof( path ), "%s/%s", GAME_SCRIPTS_DIRECTORY, dir );
+	list = G_AllocCreateNamesList( path, ext, ';' );
+	if( !list ) {
+		return;
+	}
+
+	for( i = 0; ( name = COM_ListNameForPosition( list, i, ';' ) ) != NULL; i++ ) {
+		if( G_LoadGameScript( moduleName, dir, name, ext ) ) {
+			( *numBuilt )++;
+		} else {
+			( *numFailed )++;
+		}
+		GAME_AS_ENGINE()->DiscardModule( moduleName );
+	}
+
+	G_Free( list );
+}
+
+/*
+* G_asBuildBytecodeCache_f
+*
+* Compiles all gametype and map scripts so their bytecode cache is ready before they are needed
+*/
+void G_asBuildBytecodeCache_f( void ) {
+	int numBuilt = 0, numFailed = 0;
+	asIScriptEngine *asEngine = GAME_AS_ENGINE();
+	asPWORD initGlobals;
+
+	if( !asEngine ) {
+		G_Printf( "buildAScache: Angelscript API unavailable\n" );
+		return;
+	}
+
+	if( !trap_Cvar_Value( "as_bytecodeCache" ) ) {
+		G_Printf( "buildAScache: as_bytecodeCache is disabled\n" );
+		return;
+	}
+
+	// the modules are thrown away right after the build, so don't run any global initializers
+	initGlobals = asEngine->GetEngineProperty( asEP_INIT_GLOBAL_VARS_AFTER_BUILD );
+	asEngine->SetEngineProperty( asEP_INIT_GLOBAL_VARS_AFTER_BUILD, false );
+
+	G_asBuildBytecodeCacheForDir( GAMETYPE_SCRIPTS_DIRECTORY, GAMETYPE_PROJECT_EXTENSION, &numBuilt, &numFailed );
+	G_asBuildBytecodeCacheForDir( MAP_SCRIPTS_DIRECTORY, MAP_SCRIPTS_PROJECT_EXTENSION, &numBuilt, &numFailed );
+
+	asEngine->SetEngineProperty( asEP_INIT_GLOBAL_VARS_AFTER_BUILD, initGlobals );
+
+	G_Printf( "Built bytecode cache for %i scripts, %i failed\n", numBuilt, numFailed );
+}
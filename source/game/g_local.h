@@ -516,6 +516,7 @@ void G_asInitGameModuleEngine( void );
 void G_asShutdownGameModuleEngine( void );
 void G_asGarbageCollect( bool force );
 void G_asDumpAPI_f( void );
+void G_asBuildBytecodeCache_f( void );
 
 #define world   ( (edict_t *)game.edicts )
 
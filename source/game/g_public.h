@@ -20,7 +20,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 // g_public.h -- game dll information visible to server
 
-#define GAME_API_VERSION    51
+#define GAME_API_VERSION    54
 
 //===============================================================
 
@@ -99,6 +99,7 @@ typedef struct {
 	int ( *SkinIndex )( const char *name );
 
 	int64_t ( *Milliseconds )( void );
+	uint64_t ( *Microseconds )( void );
 
 	bool ( *inPVS )( const vec3_t p1, const vec3_t p2 );
 
@@ -106,6 +107,7 @@ typedef struct {
 	struct cmodel_s *( *CM_InlineModel )( int num );
 	int ( *CM_TransformedPointContents )( vec3_t p, struct cmodel_s *cmodel, vec3_t origin, vec3_t angles );
 	void ( *CM_TransformedBoxTrace )( trace_t *tr, vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs, struct cmodel_s *cmodel, int brushmask, vec3_t origin, vec3_t angles );
+	void ( *CM_TraceBatch )( trace_t *traces, vec3_t *starts, vec3_t *ends, int numtraces, vec3_t mins, vec3_t maxs, int brushmask );
 	void ( *CM_InlineModelBounds )( struct cmodel_s *cmodel, vec3_t mins, vec3_t maxs );
 	struct cmodel_s *( *CM_ModelForBBox )( vec3_t mins, vec3_t maxs );
 	struct cmodel_s *( *CM_OctagonModelForBBox )( vec3_t mins, vec3_t maxs );
@@ -187,6 +189,23 @@ typedef struct {
 	struct stat_query_api_s *( *GetStatQueryAPI )( void );
 	void ( *MM_SendQuery )( struct stat_query_s *query );
 	void ( *MM_GameState )( bool state );
+
+	// multithreading
+	struct qmutex_s *( *Mutex_Create )( void );
+	void ( *Mutex_Destroy )( struct qmutex_s **mutex );
+	void ( *Mutex_Lock )( struct qmutex_s *mutex );
+	void ( *Mutex_Unlock )( struct qmutex_s *mutex );
+
+	// jobs are executed by the engine worker threads
+	int ( *Jobs_NumWorkers )( void );
+	struct qjobcounter_s *( *JobCounter_Create )( void );
+	void ( *JobCounter_Destroy )( struct qjobcounter_s **pcounter );
+	bool ( *JobCounter_IsDone )( struct qjobcounter_s *counter );
+	void ( *Jobs_Schedule )( void ( *func )( unsigned, unsigned, void * ), void *arg,
+							 struct qjobcounter_s *counter, struct qjobcounter_s *dependency );
+	void ( *Jobs_ParallelFor )( void ( *func )( unsigned, unsigned, void * ), void *arg, unsigned items, unsigned grain,
+								struct qjobcounter_s *counter, struct qjobcounter_s *dependency );
+	void ( *Jobs_Wait )( struct qjobcounter_s *counter );
 } game_import_t;
 
 //
@@ -217,6 +236,9 @@ typedef struct {
 	void ( *SnapFrame )( void );
 	void ( *ClearSnap )( void );
 
+	// returns microseconds spent in AI code since the previous call
+	uint64_t ( *GetAIFrameTime )( void );
+
 	game_state_t *( *GetGameState )( void );
 
 	bool ( *AllowDownload )( edict_t *ent, const char *requestname, const char *uploadname );
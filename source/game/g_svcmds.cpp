@@ -1318,11 +1318,17 @@ void G_AddServerCommands( void ) {
 #endif
 
 	trap_Cmd_AddCommand( "dumpASapi", G_asDumpAPI_f );
+	trap_Cmd_AddCommand( "buildAScache", G_asBuildBytecodeCache_f );
 
 	trap_Cmd_AddCommand( "listratings", G_ListRatings_f );
 	trap_Cmd_AddCommand( "listraces", G_ListRaces_f );
 
 	trap_Cmd_AddCommand( "listlocations", Cmd_ListLocations_f );
+
+	trap_Cmd_AddCommand( "aitracecache", AI_TraceCacheStats_f );
+	trap_Cmd_AddCommand( "aimovecache", AI_MovementRolloutCacheStats_f );
+	trap_Cmd_AddCommand( "airoutecache", AI_RouteCacheStats_f );
+	trap_Cmd_AddCommand( "aipoolbench", AI_PoolsBenchmark_f );
 }
 
 /*
@@ -1347,9 +1353,15 @@ void G_RemoveCommands( void ) {
 #endif
 
 	trap_Cmd_RemoveCommand( "dumpASapi" );
+	trap_Cmd_RemoveCommand( "buildAScache" );
 
 	trap_Cmd_RemoveCommand( "listratings" );
 	trap_Cmd_RemoveCommand( "listraces" );
 
 	trap_Cmd_RemoveCommand( "listlocations" );
+
+	trap_Cmd_RemoveCommand( "aitracecache" );
+	trap_Cmd_RemoveCommand( "aimovecache" );
+	trap_Cmd_RemoveCommand( "airoutecache" );
+	trap_Cmd_RemoveCommand( "aipoolbench" );
 }
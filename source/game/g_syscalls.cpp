@@ -52,6 +52,8 @@ extern "C" QF_DLL_EXPORT game_export_t * GetGameAPI( game_import_t * import )
 	globals.SnapFrame = G_SnapFrame;
 	globals.ClearSnap = G_ClearSnap;
 
+	globals.GetAIFrameTime = AI_GetFrameTime;
+
 	globals.GetGameState = G_GetGameState;
 
 	globals.AllowDownload = G_AllowDownload;
@@ -78,6 +78,10 @@ static inline int64_t trap_Milliseconds( void ) {
 	return GAME_IMPORT.Milliseconds();
 }
 
+static inline uint64_t trap_Microseconds( void ) {
+	return GAME_IMPORT.Microseconds();
+}
+
 static inline bool trap_inPVS( const vec3_t p1, const vec3_t p2 ) {
 	return GAME_IMPORT.inPVS( p1, p2 ) == true;
 }
@@ -90,6 +94,10 @@ static inline void trap_CM_TransformedBoxTrace( trace_t *tr, vec3_t start, vec3_
 	GAME_IMPORT.CM_TransformedBoxTrace( tr, start, end, mins, maxs, cmodel, brushmask, origin, angles );
 }
 
+static inline void trap_CM_TraceBatch( trace_t *traces, vec3_t *starts, vec3_t *ends, int numtraces, vec3_t mins, vec3_t maxs, int brushmask ) {
+	GAME_IMPORT.CM_TraceBatch( traces, starts, ends, numtraces, mins, maxs, brushmask );
+}
+
 static inline int trap_CM_NumInlineModels( void ) {
 	return GAME_IMPORT.CM_NumInlineModels();
 }
@@ -297,3 +305,50 @@ static inline void trap_MM_SendQuery( struct stat_query_s *query ) {
 static inline void trap_MM_GameState( bool state ) {
 	GAME_IMPORT.MM_GameState( state == true ? true : false );
 }
+
+// Multithreading
+static inline struct qmutex_s *trap_Mutex_Create( void ) {
+	return GAME_IMPORT.Mutex_Create();
+}
+
+static inline void trap_Mutex_Destroy( struct qmutex_s **mutex ) {
+	GAME_IMPORT.Mutex_Destroy( mutex );
+}
+
+static inline void trap_Mutex_Lock( struct qmutex_s *mutex ) {
+	GAME_IMPORT.Mutex_Lock( mutex );
+}
+
+static inline void trap_Mutex_Unlock( struct qmutex_s *mutex ) {
+	GAME_IMPORT.Mutex_Unlock( mutex );
+}
+
+static inline int trap_Jobs_NumWorkers( void ) {
+	return GAME_IMPORT.Jobs_NumWorkers();
+}
+
+static inline struct qjobcounter_s *trap_JobCounter_Create( void ) {
+	return GAME_IMPORT.JobCounter_Create();
+}
+
+static inline void trap_JobCounter_Destroy( struct qjobcounter_s **pcounter ) {
+	GAME_IMPORT.JobCounter_Destroy( pcounter );
+}
+
+static inline bool trap_JobCounter_IsDone( struct qjobcounter_s *counter ) {
+	return GAME_IMPORT.JobCounter_IsDone( counter );
+}
+
+static inline void trap_Jobs_Schedule( void ( *func )( unsigned, unsigned, void * ), void *arg,
+									   struct qjobcounter_s *counter, struct qjobcounter_s *dependency ) {
+	GAME_IMPORT.Jobs_Schedule( func, arg, counter, dependency );
+}
+
+static inline void trap_Jobs_ParallelFor( void ( *func )( unsigned, unsigned, void * ), void *arg, unsigned items, unsigned grain,
+										  struct qjobcounter_s *counter, struct qjobcounter_s *dependency ) {
+	GAME_IMPORT.Jobs_ParallelFor( func, arg, items, grain, counter, dependency );
+}
+
+static inline void trap_Jobs_Wait( struct qjobcounter_s *counter ) {
+	GAME_IMPORT.Jobs_Wait( counter );
+}
@@ -165,6 +165,7 @@ void Com_ScriptModule_Init( void ) {
 	import.Print = Com_ScriptModule_Print;
 
 	import.Milliseconds = Sys_Milliseconds;
+	import.Microseconds = Sys_Microseconds;
 
 	import.Cvar_Get = Cvar_Get;
 	import.Cvar_Set = Cvar_Set;
@@ -0,0 +1,757 @@
+/*
+Copyright (C) 2017 Warsow development team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+// cm_bvh.cpp -- bounding volume hierarchy over world brushes and patches
+
+// Must be included before qcommon.h that defines min/max macros
+#include <algorithm>
+#include <float.h>
+
+#include "qcommon.h"
+#include "cm_local.h"
+#include "cm_trace.h"
+
+#define CM_BVH_MAGIC            "CMBV"
+#define CM_BVH_VERSION          1
+
+// Leaves having less primitives are never split, leaves having more are always split (if the depth allows)
+#define CM_BVH_MIN_LEAF_PRIMS   4
+#define CM_BVH_MAX_LEAF_PRIMS   16
+#define CM_BVH_MAX_DEPTH        64
+
+// Every popped node pushes at most 4 children so this is enough for the maximal depth
+#define CM_BVH_STACK_SIZE       ( 3 * CM_BVH_MAX_DEPTH + 4 )
+
+// Node bounds are expanded by this value during traversal to cover DIST_EPSILON of brush clipping
+#define CM_BVH_BOUNDS_MARGIN    1.0f
+
+// Unused node slots get degenerate bounds that are far away from any possible ray
+#define CM_BVH_EMPTY_BOUNDS     1e30f
+
+typedef struct {
+	char magic[4];
+	int version;
+	unsigned checksum;
+	int worldbrushes, worldfaces;   // a mismatch means the map loader has been changed
+	int numnodes, numleaves;
+	int numbrushes, numfaces;
+} cm_bvhcacheheader_t;
+
+struct CMBvhBuildPrim {
+	vec3_t mins, maxs, center;
+	int num;                        // >= 0 for world brushes, -1 - facenum for world patches
+};
+
+struct CMBvhBuildNode {
+	vec3_t mins, maxs;
+	int children[2];                // both are negative for leaves
+	int firstprim, numprims;
+};
+
+static inline float CM_BvhBoundsArea( const vec3_t mins, const vec3_t maxs ) {
+	float dx = maxs[0] - mins[0], dy = maxs[1] - mins[1], dz = maxs[2] - mins[2];
+	return dx * dy + dy * dz + dz * dx;
+}
+
+static inline void CM_BvhAddBounds( vec3_t mins, vec3_t maxs, const vec3_t addmins, const vec3_t addmaxs ) {
+	for( int i = 0; i < 3; i++ ) {
+		if( addmins[i] < mins[i] ) {
+			mins[i] = addmins[i];
+		}
+		if( addmaxs[i] > maxs[i] ) {
+			maxs[i] = addmaxs[i];
+		}
+	}
+}
+
+/*
+* CMBvhBuilder
+*
+* Builds a binary tree using the surface area heuristic and collapses it into a 4-wide one.
+* The result is kept in a form suitable for caching: leaves refer to world model brushes and faces by index.
+*/
+class CMBvhBuilder {
+	CMBvhBuildPrim *prims;
+	int numprims;
+
+	CMBvhBuildNode *buildnodes;
+	int numbuildnodes;
+
+	float *rightareas;
+
+	int BuildNode( int firstprim, int numprims, int depth );
+	int FindBestSplit( const CMBvhBuildNode *node, int *bestaxis );
+	void SortPrims( int firstprim, int numprims, int axis );
+	int EmitLeaf( const CMBvhBuildNode *node );
+	int EmitNode( const int *candidates, int numcandidates );
+	int CollapseNode( const CMBvhBuildNode *node );
+
+public:
+	cm_bvhnode_t *nodes;
+	int numnodes;
+	cm_bvhleaf_t *leaves;
+	int numleaves;
+	int *brushnums;
+	int numbrushes;
+	int *facenums;
+	int numfaces;
+
+	CMBvhBuilder( CMBvhBuildPrim *prims_, int numprims_ );
+	~CMBvhBuilder();
+
+	void Build();
+};
+
+CMBvhBuilder::CMBvhBuilder( CMBvhBuildPrim *prims_, int numprims_ )
+	: prims( prims_ ), numprims( numprims_ ), numbuildnodes( 0 ), numnodes( 0 ),
+	numleaves( 0 ), numbrushes( 0 ), numfaces( 0 ) {
+	// A binary tree having N leaves has 2 * N - 1 nodes, a 4-wide one can't have more nodes or leaves
+	buildnodes = ( CMBvhBuildNode * )Mem_TempMalloc( ( 2 * numprims - 1 ) * sizeof( CMBvhBuildNode ) );
+	rightareas = ( float * )Mem_TempMalloc( numprims * sizeof( float ) );
+	nodes = ( cm_bvhnode_t * )Mem_TempMalloc( numprims * sizeof( cm_bvhnode_t ) );
+	leaves = ( cm_bvhleaf_t * )Mem_TempMalloc( numprims * sizeof( cm_bvhleaf_t ) );
+	brushnums = ( int * )Mem_TempMalloc( numprims * sizeof( int ) );
+	facenums = ( int * )Mem_TempMalloc( numprims * sizeof( int ) );
+}
+
+CMBvhBuilder::~CMBvhBuilder() {
+	Mem_TempFree( buildnodes );
+	Mem_TempFree( rightareas );
+	Mem_TempFree( nodes );
+	Mem_TempFree( leaves );
+	Mem_TempFree( brushnums );
+	Mem_TempFree( facenums );
+}
+
+void CMBvhBuilder::SortPrims( int firstprim, int numprims_, int axis ) {
+	std::sort( prims + firstprim, prims + firstprim + numprims_, [=]( const CMBvhBuildPrim &a, const CMBvhBuildPrim &b ) {
+		// Make the order strict so the tree does not depend on the sort implementation
+		if( a.center[axis] != b.center[axis] ) {
+			return a.center[axis] < b.center[axis];
+		}
+		return a.num < b.num;
+	} );
+}
+
+/*
+* CMBvhBuilder::FindBestSplit
+*
+* Returns a number of primitives that should be put to the left child (zero if the node should be a leaf)
+*/
+int CMBvhBuilder::FindBestSplit( const CMBvhBuildNode *node, int *bestaxis ) {
+	vec3_t mins, maxs;
+	const int firstprim = node->firstprim;
+	const int count = node->numprims;
+
+	// The cost of testing a node is considered the same as the cost of testing a primitive
+	float bestcost = count * CM_BvhBoundsArea( node->mins, node->maxs );
+	if( count > CM_BVH_MAX_LEAF_PRIMS ) {
+		bestcost = FLT_MAX;
+	}
+
+	int bestsplit = 0;
+	for( int axis = 0; axis < 3; axis++ ) {
+		SortPrims( firstprim, count, axis );
+
+		ClearBounds( mins, maxs );
+		for( int i = count - 1; i > 0; i-- ) {
+			CM_BvhAddBounds( mins, maxs, prims[firstprim + i].mins, prims[firstprim + i].maxs );
+			rightareas[i] = CM_BvhBoundsArea( mins, maxs );
+		}
+
+		ClearBounds( mins, maxs );
+		for( int i = 1; i < count; i++ ) {
+			CM_BvhAddBounds( mins, maxs, prims[firstprim + i - 1].mins, prims[firstprim + i - 1].maxs );
+			float cost = CM_BvhBoundsArea( node->mins, node->maxs ) +
+						 CM_BvhBoundsArea( mins, maxs ) * i + rightareas[i] * ( count - i );
+			if( cost < bestcost ) {
+				bestcost = cost;
+				bestsplit = i;
+				*bestaxis = axis;
+			}
+		}
+	}
+
+	return bestsplit;
+}
+
+int CMBvhBuilder::BuildNode( int firstprim, int numprims_, int depth ) {
+	int nodenum = numbuildnodes++;
+	CMBvhBuildNode *node = &buildnodes[nodenum];
+
+	node->firstprim = firstprim;
+	node->numprims = numprims_;
+	node->children[0] = node->children[1] = -1;
+	ClearBounds( node->mins, node->maxs );
+	for( int i = 0; i < numprims_; i++ ) {
+		CM_BvhAddBounds( node->mins, node->maxs, prims[firstprim + i].mins, prims[firstprim + i].maxs );
+	}
+
+	if( numprims_ <= CM_BVH_MIN_LEAF_PRIMS || depth >= CM_BVH_MAX_DEPTH ) {
+		return nodenum;
+	}
+
+	int axis = 0;
+	int split = FindBestSplit( node, &axis );
+	if( !split ) {
+		return nodenum;
+	}
+
+	// Primitives are left sorted by the last tested axis
+	if( axis != 2 ) {
+		SortPrims( firstprim, numprims_, axis );
+	}
+
+	node->children[0] = BuildNode( firstprim, split, depth + 1 );
+	node->children[1] = BuildNode( firstprim + split, numprims_ - split, depth + 1 );
+	return nodenum;
+}
+
+int CMBvhBuilder::EmitLeaf( const CMBvhBuildNode *node ) {
+	cm_bvhleaf_t *leaf = &leaves[numleaves];
+
+	// Keep brushes and patches of a leaf in contiguous ranges so they can be fed to ClipBoxToLeaf()
+	leaf->firstbrush = numbrushes;
+	leaf->firstface = numfaces;
+	for( int i = 0; i < node->numprims; i++ ) {
+		int num = prims[node->firstprim + i].num;
+		if( num >= 0 ) {
+			brushnums[numbrushes++] = num;
+		} else {
+			facenums[numfaces++] = -1 - num;
+		}
+	}
+	leaf->numbrushes = numbrushes - leaf->firstbrush;
+	leaf->numfaces = numfaces - leaf->firstface;
+	leaf->contents = 0;
+
+	return -1 - numleaves++;
+}
+
+int CMBvhBuilder::EmitNode( const int *candidates, int numcandidates ) {
+	int nodenum = numnodes++;
+	cm_bvhnode_t *node = &nodes[nodenum];
+
+	for( int i = 0; i < 4; i++ ) {
+		if( i >= numcandidates ) {
+			for( int j = 0; j < 3; j++ ) {
+				node->mins[j][i] = node->maxs[j][i] = CM_BVH_EMPTY_BOUNDS;
+			}
+			node->children[i] = CM_BVH_EMPTY;
+			continue;
+		}
+
+		const CMBvhBuildNode *child = &buildnodes[candidates[i]];
+		for( int j = 0; j < 3; j++ ) {
+			node->mins[j][i] = child->mins[j];
+			node->maxs[j][i] = child->maxs[j];
+		}
+		node->children[i] = CollapseNode( child );
+	}
+
+	return nodenum;
+}
+
+int CMBvhBuilder::CollapseNode( const CMBvhBuildNode *node ) {
+	if( node->children[0] < 0 ) {
+		return EmitLeaf( node );
+	}
+
+	// Pull grandchildren up replacing the largest inner node until there are 4 children
+	int candidates[4] = { node->children[0], node->children[1] };
+	int numcandidates = 2;
+	while( numcandidates < 4 ) {
+		int best = -1;
+		float bestarea = -1.0f;
+		for( int i = 0; i < numcandidates; i++ ) {
+			const CMBvhBuildNode *child = &buildnodes[candidates[i]];
+			if( child->children[0] < 0 ) {
+				continue;
+			}
+			float area = CM_BvhBoundsArea( child->mins, child->maxs );
+			if( area > bestarea ) {
+				bestarea = area;
+				best = i;
+			}
+		}
+		if( best < 0 ) {
+			break;
+		}
+		const CMBvhBuildNode *child = &buildnodes[candidates[best]];
+		candidates[best] = child->children[0];
+		candidates[numcandidates++] = child->children[1];
+	}
+
+	return EmitNode( candidates, numcandidates );
+}
+
+void CMBvhBuilder::Build() {
+	int root = BuildNode( 0, numprims, 0 );
+
+	// The root should always be an inner node, even if it holds a single leaf
+	if( buildnodes[root].children[0] < 0 ) {
+		EmitNode( &root, 1 );
+	} else {
+		CollapseNode( &buildnodes[root] );
+	}
+}
+
+/*
+* CM_BvhCachePath
+*/
+static void CM_BvhCachePath( const cmodel_state_t *cms, char *path, size_t size ) {
+	Q_snprintfz( path, size, "cache/%s", cms->map_name );
+	COM_ReplaceExtension( path, ".cmbvh", size );
+}
+
+/*
+* CM_SetupBvh
+*
+* Makes brushes and patches of BVH leaves contiguous copies of world model ones
+*/
+static void CM_SetupBvh( cmodel_state_t *cms, const cm_bvhnode_t *nodes, int numnodes,
+						 const cm_bvhleaf_t *leaves, int numleaves,
+						 const int *brushnums, int numbrushes, const int *facenums, int numfaces ) {
+	const cmodel_t *world = &cms->map_cmodels[0];
+	cm_bvh_t *bvh;
+
+	bvh = ( cm_bvh_t * )Mem_Alloc( cms->mempool, sizeof( *bvh ) );
+	bvh->numnodes = numnodes;
+	bvh->nodes = ( cm_bvhnode_t * )Mem_Alloc( cms->mempool, numnodes * sizeof( *bvh->nodes ) );
+	memcpy( bvh->nodes, nodes, numnodes * sizeof( *bvh->nodes ) );
+
+	bvh->numleaves = numleaves;
+	bvh->leaves = ( cm_bvhleaf_t * )Mem_Alloc( cms->mempool, numleaves * sizeof( *bvh->leaves ) );
+	memcpy( bvh->leaves, leaves, numleaves * sizeof( *bvh->leaves ) );
+
+	bvh->numbrushes = numbrushes;
+	bvh->brushes = ( cbrush_t * )Mem_Alloc( cms->mempool, ( numbrushes + 1 ) * sizeof( *bvh->brushes ) );
+	for( int i = 0; i < numbrushes; i++ ) {
+		bvh->brushes[i] = world->brushes[brushnums[i]];
+	}
+
+	bvh->numfaces = numfaces;
+	bvh->faces = ( cface_t * )Mem_Alloc( cms->mempool, ( numfaces + 1 ) * sizeof( *bvh->faces ) );
+	for( int i = 0; i < numfaces; i++ ) {
+		bvh->faces[i] = world->faces[facenums[i]];
+	}
+
+	// Leaf contents are not cached as they are trivially restored
+	for( int i = 0; i < numleaves; i++ ) {
+		cm_bvhleaf_t *leaf = &bvh->leaves[i];
+		for( int j = 0; j < leaf->numbrushes; j++ ) {
+			leaf->contents |= bvh->brushes[leaf->firstbrush + j].contents;
+		}
+		for( int j = 0; j < leaf->numfaces; j++ ) {
+			leaf->contents |= bvh->faces[leaf->firstface + j].contents;
+		}
+	}
+
+	cms->bvh = bvh;
+}
+
+/*
+* CM_BvhCacheIsValid
+*
+* Checks all references of a cached tree so a damaged file does not crash the traversal.
+* The builder emits inner nodes after their parents, so requiring that rules out cycles,
+* and the depth limit keeps the traversal within its fixed stack.
+*/
+static bool CM_BvhCacheIsValid( const cmodel_t *world, const cm_bvhcacheheader_t *header,
+								const cm_bvhnode_t *nodes, const cm_bvhleaf_t *leaves,
+								const int *brushnums, const int *facenums ) {
+	int i, j;
+	bool valid = true;
+	int *depths = ( int * )Mem_TempMalloc( header->numnodes * sizeof( int ) );
+
+	for( i = 0; i < header->numnodes && valid; i++ ) {
+		for( j = 0; j < 4; j++ ) {
+			int child = nodes[i].children[j];
+			if( child == CM_BVH_EMPTY ) {
+				continue;
+			}
+			if( child >= header->numnodes || ( child < 0 && -1 - child >= header->numleaves ) ) {
+				valid = false;
+				break;
+			}
+			if( child < 0 ) {
+				continue;
+			}
+			if( child <= i || depths[i] >= CM_BVH_MAX_DEPTH ) {
+				valid = false;
+				break;
+			}
+			if( depths[child] < depths[i] + 1 ) {
+				depths[child] = depths[i] + 1;
+			}
+		}
+	}
+
+	Mem_TempFree( depths );
+	if( !valid ) {
+		return false;
+	}
+
+	for( i = 0; i < header->numleaves; i++ ) {
+		const cm_bvhleaf_t *leaf = &leaves[i];
+		if( leaf->firstbrush < 0 || leaf->numbrushes < 0 || leaf->firstbrush + leaf->numbrushes > header->numbrushes ) {
+			return false;
+		}
+		if( leaf->firstface < 0 || leaf->numfaces < 0 || leaf->firstface + leaf->numfaces > header->numfaces ) {
+			return false;
+		}
+	}
+
+	for( i = 0; i < header->numbrushes; i++ ) {
+		if( brushnums[i] < 0 || brushnums[i] >= world->numbrushes ) {
+			return false;
+		}
+	}
+
+	for( i = 0; i < header->numfaces; i++ ) {
+		if( facenums[i] < 0 || facenums[i] >= world->numfaces ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+* CM_LoadBvhCache
+*/
+static bool CM_LoadBvhCache( cmodel_state_t *cms ) {
+	int length;
+	char path[MAX_QPATH];
+	uint8_t *buffer;
+	cm_bvhcacheheader_t header;
+	const cmodel_t *world = &cms->map_cmodels[0];
+
+	CM_BvhCachePath( cms, path, sizeof( path ) );
+
+	length = FS_LoadCacheFile( path, ( void ** )&buffer, NULL, 0 );
+	if( !buffer ) {
+		return false;
+	}
+
+	if( length < (int)sizeof( header ) ) {
+		FS_FreeFile( buffer );
+		return false;
+	}
+
+	memcpy( &header, buffer, sizeof( header ) );
+	if( memcmp( header.magic, CM_BVH_MAGIC, sizeof( header.magic ) ) || header.version != CM_BVH_VERSION ||
+		header.checksum != cms->checksum || header.worldbrushes != world->numbrushes || header.worldfaces != world->numfaces ) {
+		FS_FreeFile( buffer );
+		return false;
+	}
+
+	if( header.numnodes <= 0 || header.numleaves < 0 || header.numbrushes < 0 || header.numfaces < 0 ||
+		length != (int)( sizeof( header ) + header.numnodes * sizeof( cm_bvhnode_t ) +
+						 header.numleaves * sizeof( cm_bvhleaf_t ) +
+						 ( header.numbrushes + header.numfaces ) * sizeof( int ) ) ) {
+		FS_FreeFile( buffer );
+		return false;
+	}
+
+	const cm_bvhnode_t *nodes = ( const cm_bvhnode_t * )( buffer + sizeof( header ) );
+	const cm_bvhleaf_t *leaves = ( const cm_bvhleaf_t * )( nodes + header.numnodes );
+	const int *brushnums = ( const int * )( leaves + header.numleaves );
+	const int *facenums = brushnums + header.numbrushes;
+
+	if( !CM_BvhCacheIsValid( world, &header, nodes, leaves, brushnums, facenums ) ) {
+		Com_Printf( S_COLOR_YELLOW "%s is damaged\n", path );
+		FS_FreeFile( buffer );
+		return false;
+	}
+
+	CM_SetupBvh( cms, nodes, header.numnodes, leaves, header.numleaves,
+				 brushnums, header.numbrushes, facenums, header.numfaces );
+
+	FS_FreeFile( buffer );
+	return true;
+}
+
+/*
+* CM_WriteBvhCache
+*/
+static void CM_WriteBvhCache( cmodel_state_t *cms, const CMBvhBuilder *builder ) {
+	int file;
+	char path[MAX_QPATH];
+	cm_bvhcacheheader_t header;
+	const cmodel_t *world = &cms->map_cmodels[0];
+
+	CM_BvhCachePath( cms, path, sizeof( path ) );
+
+	if( FS_FOpenFile( path, &file, FS_WRITE | FS_CACHE ) == -1 ) {
+		Com_Printf( S_COLOR_YELLOW "Could not write %s\n", path );
+		return;
+	}
+
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magic, CM_BVH_MAGIC, sizeof( header.magic ) );
+	header.version = CM_BVH_VERSION;
+	header.checksum = cms->checksum;
+	header.worldbrushes = world->numbrushes;
+	header.worldfaces = world->numfaces;
+	header.numnodes = builder->numnodes;
+	header.numleaves = builder->numleaves;
+	header.numbrushes = builder->numbrushes;
+	header.numfaces = builder->numfaces;
+
+	FS_Write( &header, sizeof( header ), file );
+	FS_Write( builder->nodes, builder->numnodes * sizeof( cm_bvhnode_t ), file );
+	FS_Write( builder->leaves, builder->numleaves * sizeof( cm_bvhleaf_t ), file );
+	FS_Write( builder->brushnums, builder->numbrushes * sizeof( int ), file );
+	FS_Write( builder->facenums, builder->numfaces * sizeof( int ), file );
+
+	FS_FCloseFile( file );
+}
+
+/*
+* CM_BuildBvh
+*/
+static void CM_BuildBvh( cmodel_state_t *cms ) {
+	int i, numprims;
+	CMBvhBuildPrim *prims;
+	const cmodel_t *world = &cms->map_cmodels[0];
+
+	prims = ( CMBvhBuildPrim * )Mem_TempMalloc( ( world->numbrushes + world->numfaces ) * sizeof( *prims ) );
+
+	numprims = 0;
+	for( i = 0; i < world->numbrushes; i++ ) {
+		const cbrush_t *brush = &world->brushes[i];
+		if( !brush->numsides ) {
+			continue;
+		}
+		CMBvhBuildPrim *prim = &prims[numprims++];
+		VectorCopy( brush->mins, prim->mins );
+		VectorCopy( brush->maxs, prim->maxs );
+		VectorCopy( brush->center, prim->center );
+		prim->num = i;
+	}
+
+	// Faces that have no facets are skipped in leaves too
+	for( i = 0; i < world->numfaces; i++ ) {
+		const cface_t *face = &world->faces[i];
+		if( !face->numfacets ) {
+			continue;
+		}
+		CMBvhBuildPrim *prim = &prims[numprims++];
+		VectorCopy( face->mins, prim->mins );
+		VectorCopy( face->maxs, prim->maxs );
+		VectorCopy( face->center, prim->center );
+		prim->num = -1 - i;
+	}
+
+	if( numprims ) {
+		CMBvhBuilder builder( prims, numprims );
+		builder.Build();
+
+		CM_SetupBvh( cms, builder.nodes, builder.numnodes, builder.leaves, builder.numleaves,
+					 builder.brushnums, builder.numbrushes, builder.facenums, builder.numfaces );
+
+		CM_WriteBvhCache( cms, &builder );
+	}
+
+	Mem_TempFree( prims );
+}
+
+/*
+* CM_LoadBvh
+*
+* Loads the BVH of the world model from the cache or builds it if the trace computer is going to use it
+*/
+void CM_LoadBvh( cmodel_state_t *cms, bool force ) {
+	if( cms->bvh ) {
+		return;
+	}
+	if( !force && !cms->traceComputer->useBvh ) {
+		return;
+	}
+	if( !cms->numnodes || !cms->numcmodels ) {
+		return;
+	}
+
+	if( CM_LoadBvhCache( cms ) ) {
+		return;
+	}
+
+	int64_t start = Sys_Milliseconds();
+	CM_BuildBvh( cms );
+	if( cms->bvh ) {
+		Com_DPrintf( "Built collision BVH for %s: %d nodes, %d leaves in %d msec\n", cms->map_name,
+					 cms->bvh->numnodes, cms->bvh->numleaves, (int)( Sys_Milliseconds() - start ) );
+	}
+}
+
+/*
+* CM_FreeBvh
+*/
+void CM_FreeBvh( cmodel_state_t *cms ) {
+	cm_bvh_t *bvh = cms->bvh;
+
+	if( !bvh ) {
+		return;
+	}
+
+	Mem_Free( bvh->nodes );
+	Mem_Free( bvh->leaves );
+	Mem_Free( bvh->brushes );
+	Mem_Free( bvh->faces );
+	Mem_Free( bvh );
+
+	cms->bvh = NULL;
+}
+
+#ifdef CM_USE_SSE
+/*
+* CM_BvhNodeHits
+*
+* Clips the ray against slabs of all 4 children at once.
+* Returns a mask of children that are touched within [0, fraction].
+*/
+static inline int CM_BvhNodeHits( const cm_bvhnode_t *node, const __m128 *minsShift, const __m128 *maxsShift,
+								  const __m128 *invDir, float fraction, float *enterFracs ) {
+	__m128 tmin = _mm_setzero_ps();
+	__m128 tmax = _mm_set1_ps( fraction );
+
+	for( int i = 0; i < 3; i++ ) {
+		__m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( node->mins[i] ), minsShift[i] ), invDir[i] );
+		__m128 t2 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( node->maxs[i] ), maxsShift[i] ), invDir[i] );
+		tmin = _mm_max_ps( tmin, _mm_min_ps( t1, t2 ) );
+		tmax = _mm_min_ps( tmax, _mm_max_ps( t1, t2 ) );
+	}
+
+	_mm_storeu_ps( enterFracs, tmin );
+	return _mm_movemask_ps( _mm_cmple_ps( tmin, tmax ) );
+}
+#else
+static inline int CM_BvhNodeHits( const cm_bvhnode_t *node, const vec3_t minsShift, const vec3_t maxsShift,
+								  const vec3_t invDir, float fraction, float *enterFracs ) {
+	int mask = 0;
+
+	for( int j = 0; j < 4; j++ ) {
+		float tmin = 0.0f;
+		float tmax = fraction;
+		for( int i = 0; i < 3; i++ ) {
+			float t1 = ( node->mins[i][j] - minsShift[i] ) * invDir[i];
+			float t2 = ( node->maxs[i][j] - maxsShift[i] ) * invDir[i];
+			if( t1 > t2 ) {
+				std::swap( t1, t2 );
+			}
+			if( t1 > tmin ) {
+				tmin = t1;
+			}
+			if( t2 < tmax ) {
+				tmax = t2;
+			}
+		}
+		enterFracs[j] = tmin;
+		if( tmin <= tmax ) {
+			mask |= 1 << j;
+		}
+	}
+
+	return mask;
+}
+#endif
+
+void CMTraceComputer::BvhHullCheck( CMTraceContext *tlc ) {
+	const cm_bvh_t *bvh = cms->bvh;
+	struct {
+		int child;
+		float enterFrac;
+	} stack[CM_BVH_STACK_SIZE];
+	int stackSize;
+
+	// Save the exact address to avoid pointer chasing in loops
+	const float *fraction = &tlc->trace->fraction;
+
+	// A child box is touched by the swept box if the ray start is within the box expanded by trace box size.
+	// Zero direction components get a huge (but finite) reciprocal so slab distances never turn into NaN.
+	vec3_t invDir, minsShift, maxsShift;
+	for( int i = 0; i < 3; i++ ) {
+		float dir = tlc->end[i] - tlc->start[i];
+		invDir[i] = dir ? 1.0f / dir : 1e30f;
+		minsShift[i] = tlc->start[i] + tlc->maxs[i] + CM_BVH_BOUNDS_MARGIN;
+		maxsShift[i] = tlc->start[i] + tlc->mins[i] - CM_BVH_BOUNDS_MARGIN;
+	}
+
+#ifdef CM_USE_SSE
+	__m128 xmmInvDir[3], xmmMinsShift[3], xmmMaxsShift[3];
+	for( int i = 0; i < 3; i++ ) {
+		xmmInvDir[i] = _mm_set1_ps( invDir[i] );
+		xmmMinsShift[i] = _mm_set1_ps( minsShift[i] );
+		xmmMaxsShift[i] = _mm_set1_ps( maxsShift[i] );
+	}
+#define CM_BVH_NODE_HITS( node, enterFracs ) CM_BvhNodeHits( node, xmmMinsShift, xmmMaxsShift, xmmInvDir, *fraction, enterFracs )
+#else
+#define CM_BVH_NODE_HITS( node, enterFracs ) CM_BvhNodeHits( node, minsShift, maxsShift, invDir, *fraction, enterFracs )
+#endif
+
+	stack[0].child = 0;
+	stack[0].enterFrac = 0.0f;
+	stackSize = 1;
+
+	while( stackSize ) {
+		stackSize--;
+		// Something nearer has been already hit
+		if( stack[stackSize].enterFrac > *fraction ) {
+			continue;
+		}
+
+		int child = stack[stackSize].child;
+		if( child < 0 ) {
+			const cm_bvhleaf_t *leaf = &bvh->leaves[-1 - child];
+			if( leaf->contents & tlc->contents ) {
+				ClipBoxToLeaf( tlc, bvh->brushes + leaf->firstbrush, leaf->numbrushes,
+							   bvh->faces + leaf->firstface, leaf->numfaces );
+				// Such traces are replayed with the BSP walk by the caller
+				if( !*fraction ) {
+					return;
+				}
+			}
+			continue;
+		}
+
+		const cm_bvhnode_t *node = &bvh->nodes[child];
+		ATTRIBUTE_ALIGNED( 16 ) float enterFracs[4];
+		int mask = CM_BVH_NODE_HITS( node, enterFracs );
+		if( !mask ) {
+			continue;
+		}
+
+		// Push touched children so the nearest one is popped first
+		int first = stackSize;
+		for( int i = 0; i < 4; i++ ) {
+			if( !( mask & ( 1 << i ) ) || node->children[i] == CM_BVH_EMPTY ) {
+				continue;
+			}
+			int j = stackSize++;
+			for(; j > first && stack[j - 1].enterFrac < enterFracs[i]; j-- ) {
+				stack[j] = stack[j - 1];
+			}
+			stack[j].child = node->children[i];
+			stack[j].enterFrac = enterFracs[i];
+		}
+	}
+
+#undef CM_BVH_NODE_HITS
+}
@@ -64,6 +64,17 @@ typedef struct {
 	int surfFlags;
 } cbrushside_t;
 
+#ifdef CM_USE_SSE
+#define CM_PLANEBLOCK_SIZE  8
+
+// Brush planes are also kept in SoA blocks so the AVX2 trace computer can test 8 planes at once.
+// Unused lanes of the last block have zero normals and a huge distance so they never clip anything.
+typedef struct cm_planeblock_s {
+	float normal[3][CM_PLANEBLOCK_SIZE];
+	float dist[CM_PLANEBLOCK_SIZE];
+} cm_planeblock_t;
+#endif
+
 #ifdef CM_TRY_SIMD
 typedef vec4_t vec_bounds_t;
 #else
@@ -72,6 +83,9 @@ typedef vec3_t vec_bounds_t;
 
 typedef struct cbrush_s {
 	cbrushside_t *brushsides;
+#ifdef CM_USE_SSE
+	cm_planeblock_t *planeblocks;   // NULL for builtin hulls which planes are modified on the fly
+#endif
 
 	vec_bounds_t mins, maxs, center;
 	float radius;
@@ -90,7 +104,7 @@ typedef struct cface_s {
 	int numfacets;
 } cface_t;
 
-typedef struct {
+typedef struct cleaf_s {
 	cbrush_t *brushes;
 	cface_t *faces;
 
@@ -117,6 +131,36 @@ typedef struct cmodel_s {
 	bool builtin;
 } cmodel_t;
 
+// A 4-wide bounding volume hierarchy over world brushes and patches.
+// Child bounds are kept in SoA form so all children of a node are tested at once.
+#define CM_BVH_EMPTY    INT_MIN
+
+typedef struct cm_bvhnode_s {
+	float mins[3][4];
+	float maxs[3][4];
+	int children[4];            // >= 0 for nodes, -1 - leafnum for leaves, CM_BVH_EMPTY for unused slots
+} cm_bvhnode_t;
+
+typedef struct cm_bvhleaf_s {
+	int firstbrush, numbrushes;
+	int firstface, numfaces;
+	int contents;
+} cm_bvhleaf_t;
+
+typedef struct cm_bvh_s {
+	int numnodes;
+	cm_bvhnode_t *nodes;
+
+	int numleaves;
+	cm_bvhleaf_t *leaves;
+
+	int numbrushes;
+	cbrush_t *brushes;          // copies of world model brushes in leaves order
+
+	int numfaces;
+	cface_t *faces;             // copies of world model patches in leaves order
+} cm_bvh_t;
+
 typedef struct {
 	int floodnum;               // if two areas have equal floodnums, they are connected
 	int floodvalid;
@@ -157,6 +201,9 @@ struct cmodel_state_s {
 
 	int numbrushes;
 	cbrush_t *map_brushes;          // instance-local (is not shared)
+#ifdef CM_USE_SSE
+	cm_planeblock_t *map_brushplaneblocks;
+#endif
 
 	int numfaces;
 	cface_t *map_faces;             // instance-local (is not shared)
@@ -207,10 +254,7 @@ struct cmodel_state_s {
 	cbrush_t *oct_markbrushes[1];
 	cmodel_t oct_cmodel[1];
 
-	int leaf_count, leaf_maxcount;
-	int *leaf_list;
-	float *leaf_mins, *leaf_maxs;
-	int leaf_topnode;
+	cm_bvh_t *bvh;                  // NULL if the trace computer walks BSP nodes
 
 	struct CMTraceComputer *traceComputer;
 };
@@ -219,12 +263,34 @@ struct cmodel_state_s {
 
 struct CMTraceComputer *CM_GetTraceComputer( cmodel_state_t *cms );
 
+extern cvar_t *cm_useBvh;
+
+void CM_LoadBvh( cmodel_state_t *cms, bool force );
+void CM_FreeBvh( cmodel_state_t *cms );
+
+extern volatile bool cm_traceRecording;
+
+void CM_RecordTrace( cmodel_state_t *cms, const trace_t *tr, const vec3_t start, const vec3_t end,
+					 const vec3_t mins, const vec3_t maxs, const cmodel_t *cmodel, int brushmask,
+					 const vec3_t origin, const vec3_t angles );
+
+void CM_InitTraceBench( void );
+void CM_ShutdownTraceBench( void );
+
 void CM_InitBoxHull( cmodel_state_t *cms );
 
 void CM_InitOctagonHull( cmodel_state_t *cms );
 
 void CM_BoundBrush( cmodel_state_t *cms, cbrush_t *brush );
 
+#ifdef CM_USE_SSE
+static inline int CM_NumPlaneBlocks( int numsides ) {
+	return ( numsides + CM_PLANEBLOCK_SIZE - 1 ) / CM_PLANEBLOCK_SIZE;
+}
+
+cm_planeblock_t *CM_BuildPlaneBlocks( cbrush_t *brush, cm_planeblock_t *blocks );
+#endif
+
 void CM_FloodAreaConnections( cmodel_state_t *cms );
 
 uint8_t *CM_DecompressVis( const uint8_t *in, int rowsize, uint8_t *decompressed );
@@ -28,6 +28,7 @@ static bool cm_initialized = false;
 static mempool_t *cmap_mempool;
 
 static cvar_t *cm_noAreas;
+cvar_t *cm_useBvh;
 
 void CM_LoadQ3BrushModel( cmodel_state_t *cms, void *parent, void *buffer, bspFormatDesc_t *format );
 
@@ -56,12 +57,21 @@ static void CM_Clear( cmodel_state_t *cms ) {
 
 	// Release instance-local (non-shared data) first
 
+	CM_FreeBvh( cms );
+
 	if( cms->map_brushes ) {
 		Mem_Free( cms->map_brushes );
 		cms->map_brushes = NULL;
 		cms->numbrushes = 0;
 	}
 
+#ifdef CM_USE_SSE
+	if( cms->map_brushplaneblocks ) {
+		Mem_Free( cms->map_brushplaneblocks );
+		cms->map_brushplaneblocks = NULL;
+	}
+#endif
+
 	if( cms->map_faces ) {
 		Mem_Free( cms->map_faces );
 		cms->map_faces = NULL;
@@ -273,6 +283,8 @@ cmodel_t *CM_LoadMap( cmodel_state_t *cms, const char *name, bool clientload, un
 
 	Q_strncpyz( cms->map_name, name, sizeof( cms->map_name ) );
 
+	CM_LoadBvh( cms, false );
+
 	return cms->map_cmodels;
 }
 
@@ -917,6 +929,7 @@ cmodel_state_t *CM_New( void *mempool ) {
 static void CM_Free( cmodel_state_t *cms ) {
 	CM_Clear( cms );
 
+	Mem_Free( cms->traceComputer );
 	Mem_Free( cms );
 }
 
@@ -950,6 +963,9 @@ void CM_Init( void ) {
 	cmap_mempool = Mem_AllocPool( NULL, "Collision Map" );
 
 	cm_noAreas =        Cvar_Get( "cm_noAreas", "0", CVAR_CHEAT );
+	cm_useBvh =         Cvar_Get( "cm_useBvh", "0", CVAR_ARCHIVE | CVAR_LATCH );
+
+	CM_InitTraceBench();
 
 	cm_initialized = true;
 }
@@ -962,6 +978,8 @@ void CM_Shutdown( void ) {
 		return;
 	}
 
+	CM_ShutdownTraceBench();
+
 	Mem_FreePool( &cmap_mempool );
 
 	cm_initialized = false;
@@ -288,8 +288,16 @@ static void CM_CreatePatch( cmodel_state_t *cms, cface_t *patch, cshaderref_t *s
 
 	if( patch->numfacets ) {
 		uint8_t *fdata;
+		size_t fsize;
 
-		fdata = Mem_Alloc( cms->mempool, patch->numfacets * sizeof( cbrush_t ) + totalsides * ( sizeof( cbrushside_t ) + sizeof( cplane_t ) ) );
+		fsize = patch->numfacets * sizeof( cbrush_t ) + totalsides * ( sizeof( cbrushside_t ) + sizeof( cplane_t ) );
+#ifdef CM_USE_SSE
+		for( i = 0; i < patch->numfacets; i++ ) {
+			fsize += CM_NumPlaneBlocks( facets[i].numsides ) * sizeof( cm_planeblock_t );
+		}
+#endif
+
+		fdata = Mem_Alloc( cms->mempool, fsize );
 		cms->map_face_brushdata[patch - cms->map_faces] = fdata;
 
 		patch->facets = ( cbrush_t * )fdata; fdata += patch->numfacets * sizeof( cbrush_t );
@@ -308,6 +316,11 @@ static void CM_CreatePatch( cmodel_state_t *cms, cface_t *patch, cshaderref_t *s
 				CM_CopyRawToCMPlane( &planes[j], &s->plane );
 				s->surfFlags = shaderref->flags;
 			}
+
+#ifdef CM_USE_SSE
+			facet->planeblocks = ( cm_planeblock_t * )fdata;
+			fdata = ( uint8_t * )CM_BuildPlaneBlocks( facet, facet->planeblocks );
+#endif
 		}
 
 		patch->contents = shaderref->contents;
@@ -472,13 +485,70 @@ static inline void CMod_LoadFace( cmodel_state_t *cms, cface_t *out, int shadern
 	CM_CreatePatch( cms, out, shaderref, cms->map_verts + firstvert, patch_cp );
 }
 
+typedef struct {
+	cmodel_state_t *cms;
+	const void *in;
+} cfacesjob_t;
+
+/*
+* CMod_LoadFacesJob
+*/
+static void CMod_LoadFacesJob( unsigned first, unsigned items, void *arg ) {
+	unsigned i;
+	const cfacesjob_t *job = arg;
+	dface_t *in = ( dface_t * )job->in + first;
+
+	for( i = first; i < first + items; i++, in++ ) {
+		if( LittleLong( in->facetype ) != FACETYPE_PATCH ) {
+			continue;
+		}
+		CMod_LoadFace( job->cms, job->cms->map_faces + i, in->shadernum, in->firstvert, in->numverts, in->patch_cp );
+	}
+}
+
+/*
+* CMod_LoadFacesJob_RBSP
+*/
+static void CMod_LoadFacesJob_RBSP( unsigned first, unsigned items, void *arg ) {
+	unsigned i;
+	const cfacesjob_t *job = arg;
+	rdface_t *in = ( rdface_t * )job->in + first;
+
+	for( i = first; i < first + items; i++, in++ ) {
+		if( LittleLong( in->facetype ) != FACETYPE_PATCH ) {
+			continue;
+		}
+		CMod_LoadFace( job->cms, job->cms->map_faces + i, in->shadernum, in->firstvert, in->numverts, in->patch_cp );
+	}
+}
+
+/*
+* CMod_CreatePatches
+*
+* Patches are independent from each other, so they are tessellated in parallel.
+*/
+static void CMod_CreatePatches( cmodel_state_t *cms, qjobfunc_t func, const void *in ) {
+	cfacesjob_t job;
+	qjobcounter_t *counter;
+	uint64_t start = Sys_Microseconds();
+
+	job.cms = cms;
+	job.in = in;
+
+	counter = QJobCounter_Create();
+	QJobs_ParallelFor( func, &job, cms->numfaces, 0, counter, NULL );
+	QJobs_Wait( counter );
+	QJobCounter_Destroy( &counter );
+
+	Com_DPrintf( "CMod_CreatePatches: %i faces in %.2f ms\n", cms->numfaces, ( Sys_Microseconds() - start ) * 0.001 );
+}
+
 /*
 * CMod_LoadFaces
 */
 static void CMod_LoadFaces( cmodel_state_t *cms, lump_t *l ) {
-	int i, count;
+	int count;
 	dface_t *in;
-	cface_t *out;
 
 	in = ( void * )( cms->cmod_base + l->fileofs );
 	if( l->filelen % sizeof( *in ) ) {
@@ -489,29 +559,19 @@ static void CMod_LoadFaces( cmodel_state_t *cms, lump_t *l ) {
 		Com_Error( ERR_DROP, "Map with no faces" );
 	}
 
-	out = cms->map_faces = Mem_Alloc( cms->mempool, count * sizeof( *out ) );
+	cms->map_faces = Mem_Alloc( cms->mempool, count * sizeof( *cms->map_faces ) );
 	cms->map_face_brushdata = Mem_Alloc( cms->mempool, count * sizeof( *cms->map_face_brushdata ) );
 	cms->numfaces = count;
 
-	for( i = 0; i < count; i++, in++, out++ ) {
-		out->contents = 0;
-		out->numfacets = 0;
-		out->facets = NULL;
-		cms->map_face_brushdata[i] = NULL;
-		if( LittleLong( in->facetype ) != FACETYPE_PATCH ) {
-			continue;
-		}
-		CMod_LoadFace( cms, out, in->shadernum, in->firstvert, in->numverts, in->patch_cp );
-	}
+	CMod_CreatePatches( cms, CMod_LoadFacesJob, in );
 }
 
 /*
 * CMod_LoadFaces_RBSP
 */
 static void CMod_LoadFaces_RBSP( cmodel_state_t *cms, lump_t *l ) {
-	int i, count;
+	int count;
 	rdface_t *in;
-	cface_t *out;
 
 	in = ( void * )( cms->cmod_base + l->fileofs );
 	if( l->filelen % sizeof( *in ) ) {
@@ -522,20 +582,11 @@ static void CMod_LoadFaces_RBSP( cmodel_state_t *cms, lump_t *l ) {
 		Com_Error( ERR_DROP, "Map with no faces" );
 	}
 
-	out = cms->map_faces = Mem_Alloc( cms->mempool, count * sizeof( *out ) );
+	cms->map_faces = Mem_Alloc( cms->mempool, count * sizeof( *cms->map_faces ) );
 	cms->map_face_brushdata = Mem_Alloc( cms->mempool, count * sizeof( *cms->map_face_brushdata ) );
 	cms->numfaces = count;
 
-	for( i = 0; i < count; i++, in++, out++ ) {
-		out->contents = 0;
-		out->numfacets = 0;
-		out->facets = NULL;
-		cms->map_face_brushdata[0] = NULL;
-		if( LittleLong( in->facetype ) != FACETYPE_PATCH ) {
-			continue;
-		}
-		CMod_LoadFace( cms, out, in->shadernum, in->firstvert, in->numverts, in->patch_cp );
-	}
+	CMod_CreatePatches( cms, CMod_LoadFacesJob_RBSP, in );
 }
 
 /*
@@ -916,6 +967,23 @@ static void CMod_LoadBrushes( cmodel_state_t *cms, lump_t *l ) {
 		out->brushsides = cms->map_brushsides + LittleLong( in->firstside );
 		CM_BoundBrush( cms, out );
 	}
+
+#ifdef CM_USE_SSE
+	{
+		int numblocks = 0;
+		cm_planeblock_t *blocks;
+
+		for( i = 0, out = cms->map_brushes; i < count; i++, out++ ) {
+			numblocks += CM_NumPlaneBlocks( out->numsides );
+		}
+
+		blocks = cms->map_brushplaneblocks = Mem_Alloc( cms->mempool, numblocks * sizeof( *blocks ) );
+		for( i = 0, out = cms->map_brushes; i < count; i++, out++ ) {
+			out->planeblocks = blocks;
+			blocks = CM_BuildPlaneBlocks( out, blocks );
+		}
+	}
+#endif
 }
 
 /*
@@ -1003,6 +1071,43 @@ void CM_LoadQ3BrushModel( cmodel_state_t *cms, void *parent, void *buf, bspForma
 	}
 }
 
+#ifdef CM_USE_SSE
+/*
+* CM_BuildPlaneBlocks
+*
+* Returns the first block past the brush blocks
+*/
+cm_planeblock_t *CM_BuildPlaneBlocks( cbrush_t *brush, cm_planeblock_t *blocks ) {
+	int i, j;
+	const cbrushside_t *side;
+	cm_planeblock_t *block;
+
+	if( !brush->numsides ) {
+		brush->planeblocks = NULL;
+		return blocks;
+	}
+
+	side = brush->brushsides;
+	for( i = 0; i < brush->numsides; i += CM_PLANEBLOCK_SIZE ) {
+		block = &blocks[i / CM_PLANEBLOCK_SIZE];
+		for( j = 0; j < CM_PLANEBLOCK_SIZE; j++ ) {
+			if( i + j < brush->numsides ) {
+				block->normal[0][j] = side->plane.normal[0];
+				block->normal[1][j] = side->plane.normal[1];
+				block->normal[2][j] = side->plane.normal[2];
+				block->dist[j] = side->plane.dist;
+				side++;
+			} else {
+				block->normal[0][j] = block->normal[1][j] = block->normal[2][j] = 0;
+				block->dist[j] = 1e30f;
+			}
+		}
+	}
+
+	return blocks + CM_NumPlaneBlocks( brush->numsides );
+}
+#endif
+
 void CM_BoundBrush( cmodel_state_t *cms, cbrush_t *brush ) {
 	int i;
 
@@ -20,18 +20,25 @@ int CM_PointLeafnum( cmodel_state_t *cms, const vec3_t p ) {
 	return -1 - num;
 }
 
+typedef struct {
+	int count, maxcount;
+	int *list;
+	float *mins, *maxs;
+	int topnode;
+} cleafnums_t;
+
 /*
 * CM_BoxLeafnums
 *
 * Fills in a list of all the leafs touched
 */
-static void CM_BoxLeafnums_r( cmodel_state_t *cms, int nodenum ) {
+static void CM_BoxLeafnums_r( cmodel_state_t *cms, cleafnums_t *ln, int nodenum ) {
 	int s;
 	cnode_t *node;
 
 	while( nodenum >= 0 ) {
 		node = &cms->map_nodes[nodenum];
-		s = BOX_ON_PLANE_SIDE( cms->leaf_mins, cms->leaf_maxs, node->plane ) - 1;
+		s = BOX_ON_PLANE_SIDE( ln->mins, ln->maxs, node->plane ) - 1;
 
 		if( s < 2 ) {
 			nodenum = node->children[s];
@@ -39,37 +46,41 @@ static void CM_BoxLeafnums_r( cmodel_state_t *cms, int nodenum ) {
 		}
 
 		// go down both sides
-		if( cms->leaf_topnode == -1 ) {
-			cms->leaf_topnode = nodenum;
+		if( ln->topnode == -1 ) {
+			ln->topnode = nodenum;
 		}
-		CM_BoxLeafnums_r( cms, node->children[0] );
+		CM_BoxLeafnums_r( cms, ln, node->children[0] );
 		nodenum = node->children[1];
 	}
 
-	if( cms->leaf_count < cms->leaf_maxcount ) {
-		cms->leaf_list[cms->leaf_count++] = -1 - nodenum;
+	if( ln->count < ln->maxcount ) {
+		ln->list[ln->count++] = -1 - nodenum;
 	}
 }
 
 /*
 * CM_BoxLeafnums
+*
+* The state is kept on the stack, so world traces can be done from several threads at once
 */
 int CM_BoxLeafnums( cmodel_state_t *cms, vec3_t mins, vec3_t maxs, int *list, int listsize, int *topnode ) {
-	cms->leaf_list = list;
-	cms->leaf_count = 0;
-	cms->leaf_maxcount = listsize;
-	cms->leaf_mins = mins;
-	cms->leaf_maxs = maxs;
+	cleafnums_t ln;
+
+	ln.list = list;
+	ln.count = 0;
+	ln.maxcount = listsize;
+	ln.mins = mins;
+	ln.maxs = maxs;
 
-	cms->leaf_topnode = -1;
+	ln.topnode = -1;
 
-	CM_BoxLeafnums_r( cms, 0 );
+	CM_BoxLeafnums_r( cms, &ln, 0 );
 
 	if( topnode ) {
-		*topnode = cms->leaf_topnode;
+		*topnode = ln.topnode;
 	}
 
-	return cms->leaf_count;
+	return ln.count;
 }
 
 /*
@@ -23,6 +23,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "cm_local.h"
 #include "cm_trace.h"
 
+#include <new>
+
 static inline void CM_SetBuiltinBrushBounds( vec_bounds_t mins, vec_bounds_t maxs ) {
 	for( int i = 0; i < sizeof( vec_bounds_t ) / sizeof( vec_t ); ++i ) {
 		mins[i] = +999999;
@@ -30,33 +32,46 @@ static inline void CM_SetBuiltinBrushBounds( vec_bounds_t mins, vec_bounds_t max
 	}
 }
 
-static CMGenericTraceComputer genericTraceComputer;
-static CMSse42TraceComputer sse42TraceComputer;
+static bool traceComputerSelected = false;
+static unsigned traceComputerFeatures = 0;
 
-static CMTraceComputer *selectedTraceComputer = nullptr;
+template <typename T>
+static inline CMTraceComputer *CM_NewTraceComputer( cmodel_state_t *cms ) {
+	T *computer = new( Mem_Alloc( cms->mempool, sizeof( T ) ) )T;
+	computer->cms = cms;
+	computer->useBvh = cm_useBvh && cm_useBvh->integer;
+	return computer;
+}
 
+/*
+* CM_GetTraceComputer
+*
+* Every cms instance gets its own trace computer so different instances
+* (e.g. a map loaded for benchmarking) may be used simultaneously.
+* The cm_useBvh value at the moment of the instance creation decides
+* whether the world is swept using the brushes BVH or BSP nodes.
+*/
 struct CMTraceComputer *CM_GetTraceComputer( cmodel_state_t *cms ) {
 	// This is mostly to avoid annoying console spam on every map loading
-	if( selectedTraceComputer ) {
-		// Just set the appropriate cms pointer
-		// (the selected computer once it's selected remains the same during the entire executable lifetime).
-		// Warning: If different cms instances (e.g. cloned ones)
-		// are used simultaneously, this is plain wrong in environment of that kind.
-		// Instantiate separate trace computer instances in such cases.
-		selectedTraceComputer->cms = cms;
-		return selectedTraceComputer;
-	}
-
-	if( COM_CPUFeatures() & QF_CPU_FEATURE_SSE42 ) {
-		Com_Printf( "SSE4.2 instructions are supported. An optimized collision code will be used\n" );
-		selectedTraceComputer = &sse42TraceComputer;
-	} else {
-		Com_Printf( "SSE4.2 instructions support has not been found. A generic collision code will be used\n" );
-		selectedTraceComputer = &genericTraceComputer;
+	if( !traceComputerSelected ) {
+		traceComputerFeatures = COM_CPUFeatures();
+		if( traceComputerFeatures & QF_CPU_FEATURE_AVX2 ) {
+			Com_Printf( "AVX2 instructions are supported. An optimized collision code will be used\n" );
+		} else if( traceComputerFeatures & QF_CPU_FEATURE_SSE42 ) {
+			Com_Printf( "SSE4.2 instructions are supported. An optimized collision code will be used\n" );
+		} else {
+			Com_Printf( "SSE4.2 instructions support has not been found. A generic collision code will be used\n" );
+		}
+		traceComputerSelected = true;
 	}
 
-	selectedTraceComputer->cms = cms;
-	return selectedTraceComputer;
+	if( traceComputerFeatures & QF_CPU_FEATURE_AVX2 ) {
+		return CM_NewTraceComputer<CMAvx2TraceComputer>( cms );
+	}
+	if( traceComputerFeatures & QF_CPU_FEATURE_SSE42 ) {
+		return CM_NewTraceComputer<CMSse42TraceComputer>( cms );
+	}
+	return CM_NewTraceComputer<CMGenericTraceComputer>( cms );
 }
 
 /*
@@ -393,6 +408,9 @@ void CMTraceComputer::ClipBoxToBrush( CMTraceContext *tlc, cbrush_t *brush ) {
 			CM_CopyCMToRawPlane( clipplane, &tlc->trace->plane );
 			tlc->trace->surfFlags = leadside->surfFlags;
 			tlc->trace->contents = brush->contents;
+		} else if( enterfrac == tlc->trace->fraction ) {
+			// The first clipped brush wins, so the result depends on the order of brushes
+			tlc->tiedFraction = enterfrac;
 		}
 	}
 }
@@ -689,6 +707,176 @@ loc0:
 	RecursiveHullCheck( tlc, node->children[side ^ 1], midf, p2f, mid, p2 );
 }
 
+void CMTraceComputer::ClipBoxesToLeaf( CMTraceSegment *segments, int numsegments, cleaf_t *leaf ) {
+	// All batched traces share the brush mask
+	if( !( leaf->contents & segments[0].tlc->contents ) ) {
+		return;
+	}
+
+	// Leaf brushes are fetched once and are likely to stay in cache for the rest of segments
+	for( int i = 0; i < numsegments; i++ ) {
+		ClipBoxToLeaf( segments[i].tlc, leaf->brushes, leaf->numbrushes, leaf->faces, leaf->numfaces );
+	}
+}
+
+void CMTraceComputer::RecursiveHullCheckBatch( CMTraceSegment *segments, int numsegments, int num ) {
+	cnode_t *node;
+	cplane_t *plane;
+	float t1, t2, offset;
+	float frac, frac2;
+	float idist;
+	// Per-segment plane distances: 0 - back only, 1 - front only, 2 - crossing the plane
+	int kinds[CM_MAX_BATCHED_TRACES];
+	float dists[CM_MAX_BATCHED_TRACES][3];
+	// Each input segment produces at most two child segments.
+	// There are three groups of these: back child ones that go first, front child ones and back child ones.
+	// This keeps the children visiting order of every single trace the same as RecursiveHullCheck() has.
+	CMTraceSegment childSegments[CM_MAX_BATCHED_TRACES * 2];
+	int groupCount[3];
+	CMTraceSegment *groups[3];
+	CMTraceSegment *child;
+
+loc0:
+	// drop segments of traces that have already hit something nearer
+	for( int i = 0; i < numsegments; i++ ) {
+		if( segments[i].tlc->trace->fraction <= segments[i].p1f ) {
+			segments[i--] = segments[--numsegments];
+		}
+	}
+	if( !numsegments ) {
+		return;
+	}
+
+	// if < 0, we are in a leaf node
+	if( num < 0 ) {
+		ClipBoxesToLeaf( segments, numsegments, &cms->map_leafs[-1 - num] );
+		return;
+	}
+
+	node = cms->map_nodes + num;
+	plane = node->plane;
+
+	int numcrossing = 0;
+	groupCount[0] = groupCount[1] = groupCount[2] = 0;
+	for( int i = 0; i < numsegments; i++ ) {
+		const CMTraceSegment *segment = &segments[i];
+		const CMTraceContext *tlc = segment->tlc;
+
+		//
+		// find the point distances to the seperating plane
+		// and the offset for the size of the box
+		//
+		if( plane->type < 3 ) {
+			t1 = segment->p1[plane->type] - plane->dist;
+			t2 = segment->p2[plane->type] - plane->dist;
+			offset = tlc->extents[plane->type];
+		} else {
+			t1 = DotProduct( plane->normal, segment->p1 ) - plane->dist;
+			t2 = DotProduct( plane->normal, segment->p2 ) - plane->dist;
+			if( tlc->ispoint ) {
+				offset = 0;
+			} else {
+				offset = fabsf( tlc->extents[0] * plane->normal[0] ) +
+						 fabsf( tlc->extents[1] * plane->normal[1] ) +
+						 fabsf( tlc->extents[2] * plane->normal[2] );
+			}
+		}
+
+		// see which sides we need to consider
+		if( t1 >= offset && t2 >= offset ) {
+			kinds[i] = 1;
+			groupCount[1]++;
+		} else if( t1 < -offset && t2 < -offset ) {
+			kinds[i] = 0;
+			groupCount[0]++;
+		} else {
+			kinds[i] = 2;
+			numcrossing++;
+			dists[i][0] = t1;
+			dists[i][1] = t2;
+			dists[i][2] = offset;
+			// the near side is 1 if t1 < t2
+			groupCount[t1 < t2 ? 0 : 1]++;
+			groupCount[t1 < t2 ? 1 : 2]++;
+		}
+	}
+
+	// all segments go to a single child, continue without splitting the packet
+	if( numcrossing == 0 ) {
+		if( groupCount[1] == numsegments ) {
+			num = node->children[0];
+			goto loc0;
+		}
+		if( groupCount[0] == numsegments ) {
+			num = node->children[1];
+			goto loc0;
+		}
+	}
+
+	groups[0] = childSegments;
+	groups[1] = groups[0] + groupCount[0];
+	groups[2] = groups[1] + groupCount[1];
+	groupCount[0] = groupCount[1] = groupCount[2] = 0;
+
+	for( int i = 0; i < numsegments; i++ ) {
+		const CMTraceSegment *segment = &segments[i];
+		if( kinds[i] != 2 ) {
+			groups[kinds[i]][groupCount[kinds[i]]++] = *segment;
+			continue;
+		}
+
+		int side;
+		t1 = dists[i][0];
+		t2 = dists[i][1];
+		offset = dists[i][2];
+
+		// put the crosspoint DIST_EPSILON pixels on the near side
+		if( t1 < t2 ) {
+			idist = 1.0 / ( t1 - t2 );
+			side = 1;
+			frac2 = ( t1 + offset + DIST_EPSILON ) * idist;
+			frac = ( t1 - offset + DIST_EPSILON ) * idist;
+		} else if( t1 > t2 ) {
+			idist = 1.0 / ( t1 - t2 );
+			side = 0;
+			frac2 = ( t1 - offset - DIST_EPSILON ) * idist;
+			frac = ( t1 + offset + DIST_EPSILON ) * idist;
+		} else {
+			side = 0;
+			frac = 1;
+			frac2 = 0;
+		}
+
+		// move up to the node
+		clamp( frac, 0, 1 );
+		child = &groups[side ? 0 : 1][groupCount[side ? 0 : 1]++];
+		child->tlc = segment->tlc;
+		child->p1f = segment->p1f;
+		child->p2f = segment->p1f + ( segment->p2f - segment->p1f ) * frac;
+		VectorCopy( segment->p1, child->p1 );
+		VectorLerp( segment->p1, frac, segment->p2, child->p2 );
+
+		// go past the node
+		clamp( frac2, 0, 1 );
+		child = &groups[side ? 1 : 2][groupCount[side ? 1 : 2]++];
+		child->tlc = segment->tlc;
+		child->p1f = segment->p1f + ( segment->p2f - segment->p1f ) * frac2;
+		child->p2f = segment->p2f;
+		VectorLerp( segment->p1, frac2, segment->p2, child->p1 );
+		VectorCopy( segment->p2, child->p2 );
+	}
+
+	if( groupCount[0] ) {
+		RecursiveHullCheckBatch( groups[0], groupCount[0], node->children[1] );
+	}
+	if( groupCount[1] ) {
+		RecursiveHullCheckBatch( groups[1], groupCount[1], node->children[0] );
+	}
+	if( groupCount[2] ) {
+		RecursiveHullCheckBatch( groups[2], groupCount[2], node->children[1] );
+	}
+}
+
 //======================================================================
 
 
@@ -697,6 +885,7 @@ void CMTraceComputer::SetupCollideContext( CMTraceContext *tlc, trace_t *tr, con
 										   const vec3_t end, const vec3_t mins, const vec3_t maxs, int brushmask ) {
 	tlc->trace = tr;
 	tlc->contents = brushmask;
+	tlc->tiedFraction = -1;
 	VectorCopy( start, tlc->start );
 	VectorCopy( end, tlc->end );
 	VectorCopy( mins, tlc->mins );
@@ -720,6 +909,48 @@ void CMTraceComputer::SetupCollideContext( CMTraceContext *tlc, trace_t *tr, con
 
 
 
+void CMTraceComputer::SetupSweepContext( CMTraceContext *tlc, const vec_t *start, const vec_t *end,
+										 const vec_t *mins, const vec_t *maxs ) {
+	//
+	// check for point special case
+	//
+	if( VectorCompare( mins, vec3_origin ) && VectorCompare( maxs, vec3_origin ) ) {
+		tlc->ispoint = true;
+		VectorClear( tlc->extents );
+	} else {
+		tlc->ispoint = false;
+		VectorSet( tlc->extents,
+				   -mins[0] > maxs[0] ? -mins[0] : maxs[0],
+				   -mins[1] > maxs[1] ? -mins[1] : maxs[1],
+				   -mins[2] > maxs[2] ? -mins[2] : maxs[2] );
+	}
+
+	// TODO: Why do we have to prepare all these vars for all cases, otherwise platforms/movers are malfunctioning?
+	SetupClipContext( tlc );
+
+	VectorSubtract( end, start, tlc->traceDir );
+	VectorNormalize( tlc->traceDir );
+	float squareDiameter = DistanceSquared( mins, maxs );
+	if( squareDiameter >= 2.0f ) {
+		tlc->boxRadius = 0.5f * sqrtf( squareDiameter ) + 8.0f;
+	} else {
+		tlc->boxRadius = 8.0f;
+	}
+}
+
+static inline void CM_SetTraceEndpos( trace_t *tr, const vec3_t start, const vec3_t end ) {
+	if( tr->fraction == 1 ) {
+		VectorCopy( end, tr->endpos );
+	} else {
+		VectorLerp( start, tr->fraction, end, tr->endpos );
+#ifdef TRACE_NOAXIAL
+		if( PlaneTypeForNormal( tr->plane.normal ) == PLANE_NONAXIAL ) {
+			VectorMA( tr->endpos, TRACE_NOAXIAL_SAFETY_OFFSET, tr->plane.normal, tr->endpos );
+		}
+#endif
+	}
+}
+
 void CMTraceComputer::Trace( trace_t *tr, const vec3_t start, const vec3_t end,
 							 const vec3_t mins, const vec3_t maxs, cmodel_t *cmodel, int brushmask ) {
 	ATTRIBUTE_ALIGNED( 16 ) CMTraceContext tlc;
@@ -767,51 +998,81 @@ void CMTraceComputer::Trace( trace_t *tr, const vec3_t start, const vec3_t end,
 		return;
 	}
 
-	//
-	// check for point special case
-	//
-	if( VectorCompare( mins, vec3_origin ) && VectorCompare( maxs, vec3_origin ) ) {
-		tlc.ispoint = true;
-		VectorClear( tlc.extents );
-	} else {
-		tlc.ispoint = false;
-		VectorSet( tlc.extents,
-				   -mins[0] > maxs[0] ? -mins[0] : maxs[0],
-				   -mins[1] > maxs[1] ? -mins[1] : maxs[1],
-				   -mins[2] > maxs[2] ? -mins[2] : maxs[2] );
-	}
-
-	// TODO: Why do we have to prepare all these vars for all cases, otherwise platforms/movers are malfunctioning?
-	SetupClipContext( &tlc );
-
-	VectorSubtract( end, start, tlc.traceDir );
-	VectorNormalize( tlc.traceDir );
-	float squareDiameter = DistanceSquared( mins, maxs );
-	if( squareDiameter >= 2.0f ) {
-		tlc.boxRadius = 0.5f * sqrtf( squareDiameter ) + 8.0f;
-	} else {
-		tlc.boxRadius = 8.0f;
-	}
+	SetupSweepContext( &tlc, start, end, mins, maxs );
 
 	//
 	// general sweeping through world
 	//
 	if( cmodel == cms->map_cmodels ) {
-		RecursiveHullCheck( &tlc, 0, 0, 1, const_cast<float *>( start ), const_cast<float *>( end ) );
+		if( useBvh && cms->bvh ) {
+			BvhHullCheck( &tlc );
+			// Some results depend on the order of clipped brushes: the last brush containing the start sets contents,
+			// the first zero fraction stops the walk and the first of brushes hit at the same fraction wins.
+			// These traces are rare, replay them with the BSP walk so results are the same for both paths.
+			if( tr->startsolid || !tr->fraction || tlc.tiedFraction == tr->fraction ) {
+				memset( tr, 0, sizeof( *tr ) );
+				tr->fraction = 1;
+				RecursiveHullCheck( &tlc, 0, 0, 1, const_cast<float *>( start ), const_cast<float *>( end ) );
+			}
+		} else {
+			RecursiveHullCheck( &tlc, 0, 0, 1, const_cast<float *>( start ), const_cast<float *>( end ) );
+		}
 	} else if( BoundsIntersect( cmodel->mins, cmodel->maxs, tlc.absmins, tlc.absmaxs ) ) {
 		auto func = &CMTraceComputer::ClipBoxToBrush;
 		CollideBox( &tlc, func, cmodel->brushes, cmodel->numbrushes, cmodel->faces, cmodel->numfaces );
 	}
 
-	if( tr->fraction == 1 ) {
-		VectorCopy( end, tr->endpos );
-	} else {
-		VectorLerp( start, tr->fraction, end, tr->endpos );
-#ifdef TRACE_NOAXIAL
-		if( PlaneTypeForNormal( tr->plane.normal ) == PLANE_NONAXIAL ) {
-			VectorMA( tr->endpos, TRACE_NOAXIAL_SAFETY_OFFSET, tr->plane.normal, tr->endpos );
+	CM_SetTraceEndpos( tr, start, end );
+}
+
+void CMTraceComputer::TraceBatch( trace_t *traces, const vec3_t *starts, const vec3_t *ends, int numtraces,
+								  const vec3_t mins, const vec3_t maxs, int brushmask ) {
+	ATTRIBUTE_ALIGNED( 16 ) CMTraceContext tlcs[CM_MAX_BATCHED_TRACES];
+	CMTraceSegment segments[CM_MAX_BATCHED_TRACES];
+	int numsegments = 0;
+
+	assert( numtraces <= CM_MAX_BATCHED_TRACES );
+
+	// The BVH does not have a shared packet traversal, its nearest-first order differs for every ray
+	if( useBvh && cms->bvh ) {
+		for( int i = 0; i < numtraces; i++ ) {
+			Trace( &traces[i], starts[i], ends[i], mins, maxs, cms->map_cmodels, brushmask );
+		}
+		return;
+	}
+
+	for( int i = 0; i < numtraces; i++ ) {
+		// Position tests do not walk the tree, just perform these ones separately
+		if( VectorCompare( starts[i], ends[i] ) || !cms->numnodes ) {
+			Trace( &traces[i], starts[i], ends[i], mins, maxs, cms->map_cmodels, brushmask );
+			continue;
+		}
+
+		memset( &traces[i], 0, sizeof( trace_t ) );
+		traces[i].fraction = 1;
+
+		CMTraceContext *tlc = &tlcs[numsegments];
+		SetupCollideContext( tlc, &traces[i], starts[i], ends[i], mins, maxs, brushmask );
+		SetupSweepContext( tlc, starts[i], ends[i], mins, maxs );
+
+		CMTraceSegment *segment = &segments[numsegments++];
+		segment->tlc = tlc;
+		segment->p1f = 0;
+		segment->p2f = 1;
+		VectorCopy( starts[i], segment->p1 );
+		VectorCopy( ends[i], segment->p2 );
+	}
+
+	if( numsegments > 1 ) {
+		RecursiveHullCheckBatch( segments, numsegments, 0 );
+	} else if( numsegments ) {
+		RecursiveHullCheck( segments[0].tlc, 0, 0, 1, segments[0].p1, segments[0].p2 );
+	}
+
+	for( int i = 0; i < numtraces; i++ ) {
+		if( !VectorCompare( starts[i], ends[i] ) && cms->numnodes ) {
+			CM_SetTraceEndpos( &traces[i], starts[i], ends[i] );
 		}
-#endif
 	}
 }
 
@@ -905,4 +1166,33 @@ extern "C" void CM_TransformedBoxTrace( cmodel_state_t *cms, trace_t *tr, vec3_t
 		}
 #endif
 	}
+
+	if( cm_traceRecording ) {
+		CM_RecordTrace( cms, tr, start, end, mins, maxs, cmodel, brushmask, origin, angles );
+	}
+}
+
+/*
+* CM_TraceBatch
+*/
+extern "C" void CM_TraceBatch( cmodel_state_t *cms, trace_t *traces, vec3_t *starts, vec3_t *ends, int numtraces,
+							   vec3_t mins, vec3_t maxs, int brushmask ) {
+	if( !mins ) {
+		mins = vec3_origin;
+	}
+	if( !maxs ) {
+		maxs = vec3_origin;
+	}
+
+	for( int i = 0; i < numtraces; i += CM_MAX_BATCHED_TRACES ) {
+		int count = numtraces - i < CM_MAX_BATCHED_TRACES ? numtraces - i : CM_MAX_BATCHED_TRACES;
+		cms->traceComputer->TraceBatch( traces + i, starts + i, ends + i, count, mins, maxs, brushmask );
+	}
+
+	if( cm_traceRecording ) {
+		for( int i = 0; i < numtraces; i++ ) {
+			CM_RecordTrace( cms, &traces[i], starts[i], ends[i], mins, maxs, cms->map_cmodels, brushmask,
+							vec3_origin, vec3_origin );
+		}
+	}
 }
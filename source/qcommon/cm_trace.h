@@ -8,6 +8,7 @@ struct cmodel_state_s;
 struct cbrush_s;
 struct cface_s;
 struct cmodel_s;
+struct cleaf_s;
 
 // 1/32 epsilon to keep floating point happy
 #define DIST_EPSILON    ( 1.0f / 32.0f )
@@ -33,12 +34,26 @@ struct CMTraceContext {
 
 	int contents;
 	bool ispoint;      // optimized case
+
+	// A fraction of a hit that has been equal to the trace fraction at the moment of clipping (-1 if none)
+	float tiedFraction;
+};
+
+// A part of a batched trace that is tested against a BSP subtree
+struct CMTraceSegment {
+	CMTraceContext *tlc;
+	float p1f, p2f;
+	vec3_t p1, p2;
 };
 
+#define CM_MAX_BATCHED_TRACES   16
+
 struct CMTraceComputer {
 	struct cmodel_state_s *cms;
+	// Sweep through the world using the brushes BVH (if it has been built) instead of BSP nodes
+	bool useBvh;
 
-	CMTraceComputer(): cms( nullptr ) {}
+	CMTraceComputer(): cms( nullptr ), useBvh( false ) {}
 
 	virtual void SetupCollideContext( CMTraceContext *tlc, trace_t *tr, const vec_t *start, const vec_t *end,
 									  const vec_t *mins, const vec_t *maxs, int brushmask );
@@ -61,13 +76,27 @@ struct CMTraceComputer {
 
 	void RecursiveHullCheck( CMTraceContext *tlc, int num, float p1f, float p2f, vec3_t p1, vec3_t p2 );
 
+	// Walks the tree once for all segments splitting the packet only at nodes where segments diverge
+	void RecursiveHullCheckBatch( CMTraceSegment *segments, int numsegments, int num );
+	void ClipBoxesToLeaf( CMTraceSegment *segments, int numsegments, struct cleaf_s *leaf );
+
+	// Visits BVH leaves touched by the swept box nearest first, see cm_bvh.cpp
+	void BvhHullCheck( CMTraceContext *tlc );
+
+	void SetupSweepContext( CMTraceContext *tlc, const vec_t *start, const vec_t *end,
+							const vec_t *mins, const vec_t *maxs );
+
 	void Trace( trace_t *tr, const vec3_t start, const vec3_t end, const vec3_t mins,
 				const vec3_t maxs, cmodel_s *cmodel, int brushmask );
+
+	// Traces up to CM_MAX_BATCHED_TRACES boxes of the same size against the world model
+	void TraceBatch( trace_t *traces, const vec3_t *starts, const vec3_t *ends, int numtraces,
+					 const vec3_t mins, const vec3_t maxs, int brushmask );
 };
 
 struct CMGenericTraceComputer final: public CMTraceComputer {};
 
-struct CMSse42TraceComputer final: public CMTraceComputer {
+struct CMSse42TraceComputer: public CMTraceComputer {
 	// Don't even bother about making prototypes if there is no attempt to compile SSE code
 	// (this should aid calls devirtualization)
 #ifdef CM_USE_SSE
@@ -84,4 +113,59 @@ struct CMSse42TraceComputer final: public CMTraceComputer {
 #endif
 };
 
+// Reuses the SSE4.2 context setup, but clips against 8 brush planes at once using SoA plane blocks
+struct CMAvx2TraceComputer final: public CMSse42TraceComputer {
+#ifdef CM_USE_SSE
+	void ClipBoxToLeaf( CMTraceContext *tlc, cbrush_s *brushes, int numbrushes,
+						cface_s *markfaces, int nummarkfaces ) override;
+
+	// Overrides a base member by hiding it
+	void ClipBoxToBrush( CMTraceContext *tlc, cbrush_s *brush );
+#endif
+};
+
+#ifdef CM_USE_SSE
+// These are shared by all SSE-based trace computers
+static inline bool CM_BoundsIntersect_SSE42( __m128 traceAbsmins, __m128 traceAbsmaxs,
+											 const vec4_t shapeMins, const vec4_t shapeMaxs ) {
+	// This version relies on fast unaligned loads, that's why it requires SSE4.
+	__m128 xmmShapeMins = _mm_loadu_ps( shapeMins );
+	__m128 xmmShapeMaxs = _mm_loadu_ps( shapeMaxs );
+
+	__m128 cmp1 = _mm_cmpge_ps( xmmShapeMins, traceAbsmaxs );
+	__m128 cmp2 = _mm_cmpge_ps( traceAbsmins, xmmShapeMaxs );
+	__m128 orCmp = _mm_or_ps( cmp1, cmp2 );
+
+	return _mm_movemask_epi8( _mm_cmpeq_epi32( _mm_castps_si128( orCmp ), _mm_setzero_si128() ) ) == 0xFFFF;
+}
+
+static inline bool CM_MightCollide_SSE42( const vec_bounds_t shapeMins,
+										  const vec_bounds_t shapeMaxs,
+										  const CMTraceContext *tlc ) {
+	return CM_BoundsIntersect_SSE42( tlc->xmmAbsmins, tlc->xmmAbsmaxs, shapeMins, shapeMaxs );
+}
+
+static inline bool CM_MightCollideInLeaf_SSE42( const vec_bounds_t shapeMins,
+												const vec_bounds_t shapeMaxs,
+												const vec_bounds_t shapeCenter,
+												float shapeRadius,
+												const CMTraceContext *tlc ) {
+	if( !CM_MightCollide_SSE42( shapeMins, shapeMaxs, tlc ) ) {
+		return false;
+	}
+
+	// TODO: Vectorize this part. This task is not completed for various reasons.
+
+	vec3_t centerToStart;
+	vec3_t proj, perp;
+
+	VectorSubtract( tlc->start, shapeCenter, centerToStart );
+	float projMagnitude = DotProduct( centerToStart, tlc->traceDir );
+	VectorScale( tlc->traceDir, projMagnitude, proj );
+	VectorSubtract( centerToStart, proj, perp );
+	float distanceThreshold = shapeRadius + tlc->boxRadius;
+	return VectorLengthSquared( perp ) <= distanceThreshold * distanceThreshold;
+}
+#endif
+
 #endif //QFUSION_CM_TRACE_H
@@ -0,0 +1,174 @@
+#include "qcommon.h"
+#include "cm_local.h"
+#include "cm_trace.h"
+
+#ifdef CM_USE_SSE
+
+void CMAvx2TraceComputer::ClipBoxToLeaf( CMTraceContext *tlc, cbrush_t *brushes,
+										 int numbrushes, cface_t *markfaces, int nummarkfaces ) {
+	int i, j;
+	cbrush_t *b;
+	cface_t *patch;
+	cbrush_t *facet;
+
+	// Save the exact address to avoid pointer chasing in loops
+	const float *fraction = &tlc->trace->fraction;
+
+	// trace line against all brushes
+	for( i = 0; i < numbrushes; i++ ) {
+		b = &brushes[i];
+		if( !( b->contents & tlc->contents ) ) {
+			continue;
+		}
+		if( !CM_MightCollideInLeaf_SSE42( b->mins, b->maxs, b->center, b->radius, tlc ) ) {
+			continue;
+		}
+		// Specify the "overridden" method explicitly
+		CMAvx2TraceComputer::ClipBoxToBrush( tlc, b );
+		if( !*fraction ) {
+			return;
+		}
+	}
+
+	// trace line against all patches
+	for( i = 0; i < nummarkfaces; i++ ) {
+		patch = &markfaces[i];
+		if( !( patch->contents & tlc->contents ) ) {
+			continue;
+		}
+		if( !CM_MightCollideInLeaf_SSE42( patch->mins, patch->maxs, patch->center, patch->radius, tlc ) ) {
+			continue;
+		}
+		facet = patch->facets;
+		for( j = 0; j < patch->numfacets; j++, facet++ ) {
+			if( !CM_MightCollideInLeaf_SSE42( facet->mins, facet->maxs, facet->center, facet->radius, tlc ) ) {
+				continue;
+			}
+			// Specify the "overridden" method explicitly
+			CMAvx2TraceComputer::ClipBoxToBrush( tlc, facet );
+			if( !*fraction ) {
+				return;
+			}
+		}
+	}
+}
+
+void CMAvx2TraceComputer::ClipBoxToBrush( CMTraceContext *tlc, cbrush_t *brush ) {
+	const cm_planeblock_t *block = brush->planeblocks;
+
+	// Builtin box and octagon hulls have no plane blocks since their planes are modified for every trace
+	if( !block ) {
+		CMSse42TraceComputer::ClipBoxToBrush( tlc, brush );
+		return;
+	}
+
+	float enterfrac = -1;
+	float leavefrac = 1;
+	int leadsidenum = -1;
+
+	int getout = 0;
+	int startout = 0;
+
+	// Each plane is tested against the box corner selected by the plane normal signs, that's exactly
+	// what the signbits lookup of the scalar code does (axial planes yield the same values as well).
+	// Keep the multiplication/addition order of DotProduct() so results are bit-exact with other computers.
+	const __m256 startMinsX = _mm256_set1_ps( tlc->startmins[0] );
+	const __m256 startMinsY = _mm256_set1_ps( tlc->startmins[1] );
+	const __m256 startMinsZ = _mm256_set1_ps( tlc->startmins[2] );
+	const __m256 startMaxsX = _mm256_set1_ps( tlc->startmaxs[0] );
+	const __m256 startMaxsY = _mm256_set1_ps( tlc->startmaxs[1] );
+	const __m256 startMaxsZ = _mm256_set1_ps( tlc->startmaxs[2] );
+	const __m256 endMinsX = _mm256_set1_ps( tlc->endmins[0] );
+	const __m256 endMinsY = _mm256_set1_ps( tlc->endmins[1] );
+	const __m256 endMinsZ = _mm256_set1_ps( tlc->endmins[2] );
+	const __m256 endMaxsX = _mm256_set1_ps( tlc->endmaxs[0] );
+	const __m256 endMaxsY = _mm256_set1_ps( tlc->endmaxs[1] );
+	const __m256 endMaxsZ = _mm256_set1_ps( tlc->endmaxs[2] );
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 epsilon = _mm256_set1_ps( DIST_EPSILON );
+
+	alignas( 32 ) float fracs[CM_PLANEBLOCK_SIZE];
+
+	for( int blockStart = 0; blockStart < brush->numsides; blockStart += CM_PLANEBLOCK_SIZE, block++ ) {
+		__m256 nx = _mm256_loadu_ps( block->normal[0] );
+		__m256 ny = _mm256_loadu_ps( block->normal[1] );
+		__m256 nz = _mm256_loadu_ps( block->normal[2] );
+		__m256 dist = _mm256_loadu_ps( block->dist );
+
+		// blendv selects the second argument for lanes having the sign bit set
+		__m256 d1 = _mm256_mul_ps( _mm256_blendv_ps( startMinsX, startMaxsX, nx ), nx );
+		d1 = _mm256_add_ps( d1, _mm256_mul_ps( _mm256_blendv_ps( startMinsY, startMaxsY, ny ), ny ) );
+		d1 = _mm256_add_ps( d1, _mm256_mul_ps( _mm256_blendv_ps( startMinsZ, startMaxsZ, nz ), nz ) );
+		d1 = _mm256_sub_ps( d1, dist );
+
+		__m256 d2 = _mm256_mul_ps( _mm256_blendv_ps( endMinsX, endMaxsX, nx ), nx );
+		d2 = _mm256_add_ps( d2, _mm256_mul_ps( _mm256_blendv_ps( endMinsY, endMaxsY, ny ), ny ) );
+		d2 = _mm256_add_ps( d2, _mm256_mul_ps( _mm256_blendv_ps( endMinsZ, endMaxsZ, nz ), nz ) );
+		d2 = _mm256_sub_ps( d2, dist );
+
+		__m256 d1Positive = _mm256_cmp_ps( d1, zero, _CMP_GT_OQ );
+		__m256 d2Positive = _mm256_cmp_ps( d2, zero, _CMP_GT_OQ );
+
+		// if completely in front of any face, no intersection
+		if( _mm256_movemask_ps( _mm256_and_ps( d1Positive, _mm256_cmp_ps( d2, d1, _CMP_GE_OQ ) ) ) ) {
+			return;
+		}
+
+		getout |= _mm256_movemask_ps( d2Positive );
+		startout |= _mm256_movemask_ps( d1Positive );
+
+		// Planes having both distances non-positive are skipped (this also masks out padding lanes)
+		__m256 crosses = _mm256_or_ps( d1Positive, d2Positive );
+		__m256 f = _mm256_sub_ps( d1, d2 );
+
+		int enterMask = _mm256_movemask_ps( _mm256_and_ps( crosses, _mm256_cmp_ps( f, zero, _CMP_GT_OQ ) ) );
+		if( enterMask ) {
+			_mm256_store_ps( fracs, _mm256_div_ps( _mm256_sub_ps( d1, epsilon ), f ) );
+			// Scan lanes in the original planes order so the first plane wins on ties
+			for( int i = 0; i < CM_PLANEBLOCK_SIZE; i++ ) {
+				if( ( enterMask & ( 1 << i ) ) && fracs[i] > enterfrac ) {
+					enterfrac = fracs[i];
+					leadsidenum = blockStart + i;
+				}
+			}
+		}
+
+		int leaveMask = _mm256_movemask_ps( _mm256_and_ps( crosses, _mm256_cmp_ps( f, zero, _CMP_LT_OQ ) ) );
+		if( leaveMask ) {
+			_mm256_store_ps( fracs, _mm256_div_ps( _mm256_add_ps( d1, epsilon ), f ) );
+			for( int i = 0; i < CM_PLANEBLOCK_SIZE; i++ ) {
+				if( ( leaveMask & ( 1 << i ) ) && fracs[i] < leavefrac ) {
+					leavefrac = fracs[i];
+				}
+			}
+		}
+	}
+
+	if( !startout ) {
+		// original point was inside brush
+		tlc->trace->startsolid = true;
+		tlc->trace->contents = brush->contents;
+		if( !getout ) {
+			tlc->trace->allsolid = true;
+			tlc->trace->fraction = 0;
+		}
+		return;
+	}
+	if( enterfrac - ( 1.0f / 1024.0f ) <= leavefrac ) {
+		if( enterfrac > -1 && enterfrac < tlc->trace->fraction ) {
+			if( enterfrac < 0 ) {
+				enterfrac = 0;
+			}
+			const cbrushside_t *leadside = &brush->brushsides[leadsidenum];
+			tlc->trace->fraction = enterfrac;
+			CM_CopyCMToRawPlane( &leadside->plane, &tlc->trace->plane );
+			tlc->trace->surfFlags = leadside->surfFlags;
+			tlc->trace->contents = brush->contents;
+		} else if( enterfrac == tlc->trace->fraction ) {
+			// The first clipped brush wins, so the result depends on the order of brushes
+			tlc->tiedFraction = enterfrac;
+		}
+	}
+}
+
+#endif
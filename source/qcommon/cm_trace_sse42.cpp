@@ -4,47 +4,6 @@
 
 #ifdef CM_USE_SSE
 
-static inline bool CM_BoundsIntersect_SSE42( __m128 traceAbsmins, __m128 traceAbsmaxs,
-											 const vec4_t shapeMins, const vec4_t shapeMaxs ) {
-	// This version relies on fast unaligned loads, that's why it requires SSE4.
-	__m128 xmmShapeMins = _mm_loadu_ps( shapeMins );
-	__m128 xmmShapeMaxs = _mm_loadu_ps( shapeMaxs );
-
-	__m128 cmp1 = _mm_cmpge_ps( xmmShapeMins, traceAbsmaxs );
-	__m128 cmp2 = _mm_cmpge_ps( traceAbsmins, xmmShapeMaxs );
-	__m128 orCmp = _mm_or_ps( cmp1, cmp2 );
-
-	return _mm_movemask_epi8( _mm_cmpeq_epi32( _mm_castps_si128( orCmp ), _mm_setzero_si128() ) ) == 0xFFFF;
-}
-
-static inline bool CM_MightCollide_SSE42( const vec_bounds_t shapeMins,
-										  const vec_bounds_t shapeMaxs,
-										  const CMTraceContext *tlc ) {
-	return CM_BoundsIntersect_SSE42( tlc->xmmAbsmins, tlc->xmmAbsmaxs, shapeMins, shapeMaxs );
-}
-
-static inline bool CM_MightCollideInLeaf_SSE42( const vec_bounds_t shapeMins,
-												const vec_bounds_t shapeMaxs,
-												const vec_bounds_t shapeCenter,
-												float shapeRadius,
-												const CMTraceContext *tlc ) {
-	if( !CM_MightCollide_SSE42( shapeMins, shapeMaxs, tlc ) ) {
-		return false;
-	}
-
-	// TODO: Vectorize this part. This task is not completed for various reasons.
-
-	vec3_t centerToStart;
-	vec3_t proj, perp;
-
-	VectorSubtract( tlc->start, shapeCenter, centerToStart );
-	float projMagnitude = DotProduct( centerToStart, tlc->traceDir );
-	VectorScale( tlc->traceDir, projMagnitude, proj );
-	VectorSubtract( centerToStart, proj, perp );
-	float distanceThreshold = shapeRadius + tlc->boxRadius;
-	return VectorLengthSquared( perp ) <= distanceThreshold * distanceThreshold;
-}
-
 void CMSse42TraceComputer::ClipBoxToLeaf( CMTraceContext *tlc, cbrush_t *brushes,
 										  int numbrushes, cface_t *markfaces, int nummarkfaces ) {
 	int i, j;
@@ -193,6 +152,9 @@ void CMSse42TraceComputer::ClipBoxToBrush( CMTraceContext *tlc, cbrush_t *brush
 			CM_CopyCMToRawPlane( clipplane, &tlc->trace->plane );
 			tlc->trace->surfFlags = leadside->surfFlags;
 			tlc->trace->contents = brush->contents;
+		} else if( enterfrac == tlc->trace->fraction ) {
+			// The first clipped brush wins, so the result depends on the order of brushes
+			tlc->tiedFraction = enterfrac;
 		}
 	}
 }
@@ -0,0 +1,430 @@
+/*
+Copyright (C) 2017 Warsow development team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+// cm_tracebench.cpp -- recording of live collision traces and their replay against every trace computer
+
+#include "qcommon.h"
+#include "sys_threads.h"
+#include "cm_local.h"
+#include "cm_trace.h"
+
+#define CM_TRACEREC_MAGIC       "CMTR"
+#define CM_TRACEREC_VERSION     2
+#define CM_TRACEREC_BUFSIZE     1024
+
+#define CM_TRACEREC_MODEL_BOX       -1
+#define CM_TRACEREC_MODEL_OCTAGON   -2
+
+typedef struct {
+	char magic[4];
+	int version;
+	unsigned checksum;
+	char mapname[MAX_QPATH];
+} cm_tracerec_header_t;
+
+typedef struct {
+	int model;              // inline model number or one of CM_TRACEREC_MODEL_* for bbox hulls
+	int brushmask;
+	vec3_t bmins, bmaxs;    // bbox hull bounds
+	vec3_t start, end;
+	vec3_t mins, maxs;
+	vec3_t origin, angles;
+
+	// the result of the trace as seen by the recording process
+	vec3_t endpos;
+	float fraction;
+	vec3_t normal;
+	float dist;
+	int surfFlags;
+	int contents;
+	int startsolid;
+	int allsolid;
+	int ent;
+} cm_tracerec_t;
+
+volatile bool cm_traceRecording = false;
+
+static qmutex_t *cm_traceRecMutex;
+static int cm_traceRecFile;
+static unsigned cm_traceRecChecksum;
+static int cm_traceRecNumTraces;
+static int cm_traceRecNumBuffered;
+static cm_tracerec_t cm_traceRecBuffer[CM_TRACEREC_BUFSIZE];
+
+/*
+* CM_FlushTraceRecords
+*/
+static void CM_FlushTraceRecords( void ) {
+	if( cm_traceRecNumBuffered ) {
+		FS_Write( cm_traceRecBuffer, cm_traceRecNumBuffered * sizeof( cm_tracerec_t ), cm_traceRecFile );
+		cm_traceRecNumBuffered = 0;
+	}
+}
+
+/*
+* CM_RecordTrace
+*
+* Called from CM_TransformedBoxTrace for every trace while recording.
+* The first traced collision map locks the recording, traces against other maps are ignored.
+*/
+void CM_RecordTrace( cmodel_state_t *cms, const trace_t *tr, const vec3_t start, const vec3_t end,
+					 const vec3_t mins, const vec3_t maxs, const cmodel_t *cmodel, int brushmask,
+					 const vec3_t origin, const vec3_t angles ) {
+	cm_tracerec_t *rec;
+
+	if( !cms->numnodes ) {
+		return;
+	}
+
+	QMutex_Lock( cm_traceRecMutex );
+
+	if( !cm_traceRecording ) {
+		QMutex_Unlock( cm_traceRecMutex );
+		return;
+	}
+
+	if( !cm_traceRecNumTraces && !cm_traceRecNumBuffered ) {
+		cm_tracerec_header_t header;
+
+		memset( &header, 0, sizeof( header ) );
+		memcpy( header.magic, CM_TRACEREC_MAGIC, sizeof( header.magic ) );
+		header.version = CM_TRACEREC_VERSION;
+		header.checksum = cms->checksum;
+		Q_strncpyz( header.mapname, cms->map_name, sizeof( header.mapname ) );
+		FS_Write( &header, sizeof( header ), cm_traceRecFile );
+
+		cm_traceRecChecksum = cms->checksum;
+	} else if( cms->checksum != cm_traceRecChecksum ) {
+		QMutex_Unlock( cm_traceRecMutex );
+		return;
+	}
+
+	rec = &cm_traceRecBuffer[cm_traceRecNumBuffered];
+	memset( rec, 0, sizeof( *rec ) );
+
+	if( cmodel == cms->box_cmodel ) {
+		rec->model = CM_TRACEREC_MODEL_BOX;
+		VectorCopy( cmodel->mins, rec->bmins );
+		VectorCopy( cmodel->maxs, rec->bmaxs );
+	} else if( cmodel == cms->oct_cmodel ) {
+		// the octagon hull is stored centered, restore the original bounds
+		rec->model = CM_TRACEREC_MODEL_OCTAGON;
+		VectorAdd( cmodel->mins, cmodel->cyl_offset, rec->bmins );
+		VectorAdd( cmodel->maxs, cmodel->cyl_offset, rec->bmaxs );
+	} else if( cmodel >= cms->map_cmodels && cmodel < cms->map_cmodels + cms->numcmodels ) {
+		rec->model = (int)( cmodel - cms->map_cmodels );
+	} else {
+		QMutex_Unlock( cm_traceRecMutex );
+		return;
+	}
+
+	rec->brushmask = brushmask;
+	VectorCopy( start, rec->start );
+	VectorCopy( end, rec->end );
+	VectorCopy( mins, rec->mins );
+	VectorCopy( maxs, rec->maxs );
+	VectorCopy( origin, rec->origin );
+	VectorCopy( angles, rec->angles );
+
+	VectorCopy( tr->endpos, rec->endpos );
+	rec->fraction = tr->fraction;
+	VectorCopy( tr->plane.normal, rec->normal );
+	rec->dist = tr->plane.dist;
+	rec->surfFlags = tr->surfFlags;
+	rec->contents = tr->contents;
+	rec->startsolid = tr->startsolid ? 1 : 0;
+	rec->allsolid = tr->allsolid ? 1 : 0;
+	rec->ent = tr->ent;
+
+	cm_traceRecNumTraces++;
+	if( ++cm_traceRecNumBuffered == CM_TRACEREC_BUFSIZE ) {
+		CM_FlushTraceRecords();
+	}
+
+	QMutex_Unlock( cm_traceRecMutex );
+}
+
+/*
+* CM_StopTraceRecording
+*/
+static void CM_StopTraceRecording( void ) {
+	QMutex_Lock( cm_traceRecMutex );
+
+	if( cm_traceRecording ) {
+		CM_FlushTraceRecords();
+		FS_FCloseFile( cm_traceRecFile );
+		cm_traceRecording = false;
+
+		Com_Printf( "Recorded %i traces\n", cm_traceRecNumTraces );
+	}
+
+	QMutex_Unlock( cm_traceRecMutex );
+}
+
+/*
+* CM_RecordTraces_f
+*/
+static void CM_RecordTraces_f( void ) {
+	char filename[MAX_QPATH];
+
+	if( Cmd_Argc() != 2 ) {
+		Com_Printf( "Usage: %s <filename|stop>\n", Cmd_Argv( 0 ) );
+		return;
+	}
+
+	if( !Q_stricmp( Cmd_Argv( 1 ), "stop" ) ) {
+		CM_StopTraceRecording();
+		return;
+	}
+
+	if( cm_traceRecording ) {
+		Com_Printf( "Already recording traces\n" );
+		return;
+	}
+
+	Q_snprintfz( filename, sizeof( filename ), "traces/%s", Cmd_Argv( 1 ) );
+	COM_DefaultExtension( filename, ".cmtr", sizeof( filename ) );
+
+	QMutex_Lock( cm_traceRecMutex );
+
+	if( FS_FOpenFile( filename, &cm_traceRecFile, FS_WRITE ) == -1 ) {
+		QMutex_Unlock( cm_traceRecMutex );
+		Com_Printf( "Couldn't open %s for writing\n", filename );
+		return;
+	}
+
+	cm_traceRecNumTraces = 0;
+	cm_traceRecNumBuffered = 0;
+	cm_traceRecording = true;
+
+	QMutex_Unlock( cm_traceRecMutex );
+
+	Com_Printf( "Recording traces to %s\n", filename );
+}
+
+/*
+* CM_CompareTraces
+*/
+static bool CM_CompareTraces( const trace_t *tr, const cm_tracerec_t *rec ) {
+	if( tr->fraction != rec->fraction || !VectorCompare( tr->endpos, rec->endpos ) ) {
+		return false;
+	}
+	if( ( tr->startsolid ? 1 : 0 ) != rec->startsolid || ( tr->allsolid ? 1 : 0 ) != rec->allsolid ) {
+		return false;
+	}
+	if( tr->surfFlags != rec->surfFlags || tr->contents != rec->contents || tr->ent != rec->ent ) {
+		return false;
+	}
+	return VectorCompare( tr->plane.normal, rec->normal ) && tr->plane.dist == rec->dist;
+}
+
+/*
+* CM_ReplayTraces
+*
+* Returns the total number of microseconds spent tracing.
+*/
+static uint64_t CM_ReplayTraces( cmodel_state_t *cms, const cm_tracerec_t *recs, int numrecs,
+								 int iterations, int *mismatches ) {
+	int i, j;
+	trace_t tr;
+	cmodel_t *cmodel;
+	cm_tracerec_t rec;
+	uint64_t start, total;
+
+	total = 0;
+	*mismatches = 0;
+
+	for( i = 0; i < iterations; i++ ) {
+		for( j = 0; j < numrecs; j++ ) {
+			// CM_TransformedBoxTrace takes non-const vectors
+			rec = recs[j];
+
+			if( rec.model == CM_TRACEREC_MODEL_BOX ) {
+				cmodel = CM_ModelForBBox( cms, rec.bmins, rec.bmaxs );
+			} else if( rec.model == CM_TRACEREC_MODEL_OCTAGON ) {
+				cmodel = CM_OctagonModelForBBox( cms, rec.bmins, rec.bmaxs );
+			} else {
+				cmodel = CM_InlineModel( cms, rec.model );
+			}
+
+			start = Sys_Microseconds();
+			CM_TransformedBoxTrace( cms, &tr, rec.start, rec.end, rec.mins, rec.maxs,
+									cmodel, rec.brushmask, rec.origin, rec.angles );
+			total += Sys_Microseconds() - start;
+
+			if( !i && !CM_CompareTraces( &tr, &rec ) ) {
+				( *mismatches )++;
+			}
+		}
+	}
+
+	return total;
+}
+
+/*
+* CM_TraceBench_f
+*
+* Replays recorded traces against a private copy of the map using every trace computer
+* walking either BSP nodes or the brushes BVH
+*/
+static void CM_TraceBench_f( void ) {
+	int i;
+	int file, length;
+	int numrecs, iterations, mismatches;
+	unsigned checksum;
+	char filename[MAX_QPATH];
+	cm_tracerec_header_t header;
+	cm_tracerec_t *recs;
+	cmodel_state_t *cms;
+	CMTraceComputer *ownComputer;
+	uint64_t usec;
+	CMGenericTraceComputer genericComputer;
+	CMSse42TraceComputer sse42Computer;
+	CMAvx2TraceComputer avx2Computer;
+	struct {
+		const char *name;
+		CMTraceComputer *computer;
+		bool supported;
+		bool bvh;
+	} computers[] = {
+		{ "generic", &genericComputer, true, false },
+		{ "sse42", &sse42Computer, ( COM_CPUFeatures() & QF_CPU_FEATURE_SSE42 ) != 0, false },
+		{ "avx2", &avx2Computer, ( COM_CPUFeatures() & QF_CPU_FEATURE_AVX2 ) != 0, false },
+		{ "generic+bvh", &genericComputer, true, true },
+		{ "sse42+bvh", &sse42Computer, ( COM_CPUFeatures() & QF_CPU_FEATURE_SSE42 ) != 0, true },
+		{ "avx2+bvh", &avx2Computer, ( COM_CPUFeatures() & QF_CPU_FEATURE_AVX2 ) != 0, true },
+	};
+
+	if( Cmd_Argc() < 2 ) {
+		Com_Printf( "Usage: %s <filename> [iterations]\n", Cmd_Argv( 0 ) );
+		return;
+	}
+
+	if( cm_traceRecording ) {
+		Com_Printf( "Can't benchmark while recording traces\n" );
+		return;
+	}
+
+	iterations = Cmd_Argc() > 2 ? max( atoi( Cmd_Argv( 2 ) ), 1 ) : 10;
+
+	Q_snprintfz( filename, sizeof( filename ), "traces/%s", Cmd_Argv( 1 ) );
+	COM_DefaultExtension( filename, ".cmtr", sizeof( filename ) );
+
+	length = FS_FOpenFile( filename, &file, FS_READ );
+	if( length < (int)sizeof( header ) ) {
+		if( length >= 0 ) {
+			FS_FCloseFile( file );
+		}
+		Com_Printf( "Couldn't open %s\n", filename );
+		return;
+	}
+
+	FS_Read( &header, sizeof( header ), file );
+	header.mapname[sizeof( header.mapname ) - 1] = '\0';
+	if( memcmp( header.magic, CM_TRACEREC_MAGIC, sizeof( header.magic ) ) || header.version != CM_TRACEREC_VERSION ) {
+		FS_FCloseFile( file );
+		Com_Printf( "%s is not a trace recording or has a wrong version\n", filename );
+		return;
+	}
+
+	numrecs = ( length - (int)sizeof( header ) ) / (int)sizeof( cm_tracerec_t );
+	if( !numrecs ) {
+		FS_FCloseFile( file );
+		Com_Printf( "%s contains no traces\n", filename );
+		return;
+	}
+
+	recs = ( cm_tracerec_t * )Mem_TempMalloc( numrecs * sizeof( cm_tracerec_t ) );
+	FS_Read( recs, numrecs * sizeof( cm_tracerec_t ), file );
+	FS_FCloseFile( file );
+
+	// load a private copy of the map so the replay does not interfere with the running game
+	cms = CM_New( NULL );
+	CM_AddReference( cms );
+	CM_LoadMap( cms, header.mapname, true, &checksum );
+
+	if( checksum != header.checksum ) {
+		Com_Printf( S_COLOR_YELLOW "Warning: %s checksum differs from the recorded one\n", header.mapname );
+	}
+
+	for( i = 0; i < numrecs; i++ ) {
+		if( recs[i].model >= CM_NumInlineModels( cms ) ) {
+			break;
+		}
+	}
+
+	if( i != numrecs ) {
+		Com_Printf( "%s references inline models not present in %s\n", filename, header.mapname );
+	} else {
+		Com_Printf( "Replaying %i traces on %s, %i iterations\n", numrecs, header.mapname, iterations );
+
+		ownComputer = cms->traceComputer;
+
+		// Build the BVH (or load it from cache) regardless of cm_useBvh
+		CM_LoadBvh( cms, true );
+
+		for( i = 0; i < (int)( sizeof( computers ) / sizeof( computers[0] ) ); i++ ) {
+			if( !computers[i].supported ) {
+				Com_Printf( "%s: not supported by this CPU\n", computers[i].name );
+				continue;
+			}
+
+			if( computers[i].bvh && !cms->bvh ) {
+				Com_Printf( "%s: the map has no brushes\n", computers[i].name );
+				continue;
+			}
+
+			computers[i].computer->cms = cms;
+			computers[i].computer->useBvh = computers[i].bvh;
+			cms->traceComputer = computers[i].computer;
+
+			usec = CM_ReplayTraces( cms, recs, numrecs, iterations, &mismatches );
+
+			Com_Printf( "%s: %.3f sec, %.0f traces/sec, %i mismatches\n", computers[i].name,
+						usec * 1e-6, usec ? (double)numrecs * iterations * 1e6 / usec : 0.0, mismatches );
+		}
+
+		cms->traceComputer = ownComputer;
+	}
+
+	CM_ReleaseReference( cms );
+	Mem_TempFree( recs );
+}
+
+/*
+* CM_InitTraceBench
+*/
+void CM_InitTraceBench( void ) {
+	cm_traceRecMutex = QMutex_Create();
+
+	Cmd_AddCommand( "cm_recordtraces", CM_RecordTraces_f );
+	Cmd_AddCommand( "cm_tracebench", CM_TraceBench_f );
+}
+
+/*
+* CM_ShutdownTraceBench
+*/
+void CM_ShutdownTraceBench( void ) {
+	Cmd_RemoveCommand( "cm_recordtraces" );
+	Cmd_RemoveCommand( "cm_tracebench" );
+
+	CM_StopTraceRecording();
+
+	QMutex_Destroy( &cm_traceRecMutex );
+}
@@ -47,6 +47,11 @@ int CM_TransformedPointContents( cmodel_state_t *cms, vec3_t p, struct cmodel_s
 void CM_TransformedBoxTrace( cmodel_state_t *cms, trace_t *tr, vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
 							 struct cmodel_s *cmodel, int brushmask, vec3_t origin, vec3_t angles );
 
+// traces multiple boxes of the same size against the world walking the BSP tree once for all of them,
+// results are the same as if every box was traced by CM_TransformedBoxTrace()
+void CM_TraceBatch( cmodel_state_t *cms, trace_t *traces, vec3_t *starts, vec3_t *ends, int numtraces,
+					vec3_t mins, vec3_t maxs, int brushmask );
+
 int CM_ClusterRowSize( cmodel_state_t *cms );
 int CM_AreaRowSize( cmodel_state_t *cms );
 int CM_PointLeafnum( cmodel_state_t *cms, const vec3_t p );
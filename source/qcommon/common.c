@@ -604,11 +604,20 @@ unsigned int COM_CPUFeatures( void ) {
 	if( cpuInfo[0] == 0 ) {
 		return 0;
 	}
+	const int maxLeaf = cpuInfo[0];
 	// Get standard feature bits (look for description here https://en.wikipedia.org/wiki/CPUID)
 	__cpuid( cpuInfo, 1 );
 	const int ECX = cpuInfo[2];
 	const int EDX = cpuInfo[3];
-	if( ECX & ( 1 << 28 ) ) {
+	int EBX7 = 0;
+	if( maxLeaf >= 7 ) {
+		// Get extended feature bits
+		__cpuidex( cpuInfo, 7, 0 );
+		EBX7 = cpuInfo[1];
+	}
+	if( ( ECX & ( 1 << 28 ) ) && ( EBX7 & ( 1 << 5 ) ) ) {
+		features |= QF_CPU_FEATURE_AVX2;
+	} else if( ECX & ( 1 << 28 ) ) {
 		features |= QF_CPU_FEATURE_AVX;
 	} else if( ECX & ( 1 << 20 ) ) {
 		features |= QF_CPU_FEATURE_SSE42;
@@ -622,7 +631,9 @@ unsigned int COM_CPUFeatures( void ) {
 	// Clang does not even have this intrinsic, executables work fine without it.
 	__builtin_cpu_init();
 #endif // clang-specific code
-	if( __builtin_cpu_supports( "avx" ) ) {
+	if( __builtin_cpu_supports( "avx2" ) ) {
+		features |= QF_CPU_FEATURE_AVX2;
+	} else if( __builtin_cpu_supports( "avx" ) ) {
 		features |= QF_CPU_FEATURE_AVX;
 	} else if( __builtin_cpu_supports( "sse4.2" ) ) {
 		features |= QF_CPU_FEATURE_SSE42;
@@ -864,6 +875,8 @@ void Qcommon_Init( int argc, char **argv ) {
 
 	Sys_Init();
 
+	QJobs_Init();
+
 	NET_Init();
 	Netchan_Init();
 
@@ -1015,6 +1028,7 @@ void Qcommon_Shutdown( void ) {
 
 	Com_ScriptModule_Shutdown();
 	CM_Shutdown();
+	QJobs_Shutdown();
 	Netchan_Shutdown();
 	NET_Shutdown();
 	Key_Shutdown();
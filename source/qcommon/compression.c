@@ -32,6 +32,14 @@ int( ZEXPORT * qzinflateInit2_ )( z_streamp strm, int windowBits, const char *ve
 int( ZEXPORT * qzinflate )( z_streamp strm, int flush );
 int( ZEXPORT * qzinflateEnd )( z_streamp strm );
 int( ZEXPORT * qzinflateReset )( z_streamp strm );
+int( ZEXPORT * qzinflateSetDictionary )( z_streamp strm, const Bytef * dictionary, uInt dictLength );
+int( ZEXPORT * qzdeflateInit2_ )( z_streamp strm, int level, int method, int windowBits, int memLevel,
+								   int strategy, const char *version, int stream_size );
+int( ZEXPORT * qzdeflate )( z_streamp strm, int flush );
+int( ZEXPORT * qzdeflateEnd )( z_streamp strm );
+int( ZEXPORT * qzdeflateReset )( z_streamp strm );
+int( ZEXPORT * qzdeflateSetDictionary )( z_streamp strm, const Bytef * dictionary, uInt dictLength );
+uLong( ZEXPORT * qzcrc32 )( uLong crc, const Bytef * buf, uInt len );
 gzFile( ZEXPORT * qgzopen )( const char *, const char * );
 z_off_t( ZEXPORT * qgzseek )( gzFile, z_off_t, int );
 z_off_t( ZEXPORT * qgztell )( gzFile );
@@ -52,6 +60,13 @@ static dllfunc_t zlibfuncs[] =
 	{ "inflate", ( void **)&qzinflate },
 	{ "inflateEnd", ( void **)&qzinflateEnd },
 	{ "inflateReset", ( void **)&qzinflateReset },
+	{ "inflateSetDictionary", ( void **)&qzinflateSetDictionary },
+	{ "deflateInit2_", ( void **)&qzdeflateInit2_ },
+	{ "deflate", ( void **)&qzdeflate },
+	{ "deflateEnd", ( void **)&qzdeflateEnd },
+	{ "deflateReset", ( void **)&qzdeflateReset },
+	{ "deflateSetDictionary", ( void **)&qzdeflateSetDictionary },
+	{ "crc32", ( void **)&qzcrc32 },
 	{ "gzopen", ( void **)&qgzopen },
 	{ "gzseek", ( void **)&qgzseek },
 	{ "gztell", ( void **)&qgztell },
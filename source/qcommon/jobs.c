@@ -0,0 +1,396 @@
+/*
+Copyright (C) 2017 Warsow development team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "qcommon.h"
+#include "sys_threads.h"
+
+/*
+* Engine job system
+*
+* A pool of worker threads sized to the hardware. Each worker owns a deque of jobs:
+* the owner pops the most recently pushed jobs, while idle workers and threads
+* waiting for a counter steal the oldest jobs from the other deques.
+*
+* Every scheduled job increments its counter, which is decremented when the job is
+* done, so a counter can be waited for or used as a dependency of other jobs.
+* Jobs depending on a counter are held back until the counter reaches zero.
+*/
+
+#define MAX_JOB_WORKERS     32
+#define JOB_DEQUE_SIZE      1024
+
+typedef struct qjob_s {
+	qjobfunc_t func;
+	void *arg;
+	unsigned first, items;
+	qjobcounter_t *counter;
+	struct qjob_s *next;            // in the list of jobs waiting for a dependency
+} qjob_t;
+
+struct qjobcounter_s {
+	volatile int value;             // number of unfinished jobs
+	qjob_t *waiting;                // jobs to schedule when the value reaches zero
+};
+
+typedef struct {
+	int self;
+	qthread_t *thread;
+	qmutex_t *lock;
+	unsigned head, tail;            // the owner pops from the tail, thieves take from the head
+	qjob_t jobs[JOB_DEQUE_SIZE];
+} qjobworker_t;
+
+static qjobworker_t *jobs_workers;
+static int jobs_numWorkers;
+static unsigned jobs_nextWorker;
+
+// protects the counters, the dependency lists and the sleeping workers
+static qmutex_t *jobs_lock;
+static qcondvar_t *jobs_cond;
+static int jobs_queued;
+static bool jobs_shutdown;
+
+static void QJobs_PushJob( const qjob_t *job );
+static void *QJobs_WorkerProc( void *param );
+
+/*
+* QJobs_Init
+*/
+void QJobs_Init( void ) {
+	int i;
+	qjobworker_t *worker;
+
+	if( jobs_numWorkers ) {
+		return;
+	}
+
+	jobs_lock = QMutex_Create();
+	jobs_cond = QCondVar_Create();
+	jobs_queued = 0;
+	jobs_shutdown = false;
+	jobs_nextWorker = 0;
+
+	// the threads that wait for jobs help executing them, so leave them a core
+	jobs_numWorkers = bound( 1, QThread_GetNumCPUs() - 1, MAX_JOB_WORKERS );
+	jobs_workers = Q_malloc( sizeof( *jobs_workers ) * jobs_numWorkers );
+	memset( jobs_workers, 0, sizeof( *jobs_workers ) * jobs_numWorkers );
+
+	for( i = 0, worker = jobs_workers; i < jobs_numWorkers; i++, worker++ ) {
+		worker->self = i;
+		worker->lock = QMutex_Create();
+		worker->thread = QThread_Create( QJobs_WorkerProc, worker );
+	}
+}
+
+/*
+* QJobs_Shutdown
+*
+* Runs all queued jobs and stops the workers.
+*/
+void QJobs_Shutdown( void ) {
+	int i;
+	qjobworker_t *worker;
+
+	if( !jobs_numWorkers ) {
+		return;
+	}
+
+	QMutex_Lock( jobs_lock );
+	jobs_shutdown = true;
+	for( i = 0; i < jobs_numWorkers; i++ ) {
+		QCondVar_Wake( jobs_cond );
+	}
+	QMutex_Unlock( jobs_lock );
+
+	for( i = 0, worker = jobs_workers; i < jobs_numWorkers; i++, worker++ ) {
+		QThread_Join( worker->thread );
+		QMutex_Destroy( &worker->lock );
+	}
+
+	Q_free( jobs_workers );
+	jobs_workers = NULL;
+	jobs_numWorkers = 0;
+
+	QCondVar_Destroy( &jobs_cond );
+	QMutex_Destroy( &jobs_lock );
+}
+
+/*
+* QJobs_NumWorkers
+*/
+int QJobs_NumWorkers( void ) {
+	return jobs_numWorkers;
+}
+
+/*
+* QJobCounter_Create
+*/
+qjobcounter_t *QJobCounter_Create( void ) {
+	qjobcounter_t *counter;
+
+	counter = Q_malloc( sizeof( *counter ) );
+	memset( counter, 0, sizeof( *counter ) );
+	return counter;
+}
+
+/*
+* QJobCounter_Destroy
+*/
+void QJobCounter_Destroy( qjobcounter_t **pcounter ) {
+	assert( pcounter != NULL );
+	if( pcounter && *pcounter ) {
+		QJobs_Wait( *pcounter );
+		Q_free( *pcounter );
+		*pcounter = NULL;
+	}
+}
+
+/*
+* QJobCounter_IsDone
+*/
+bool QJobCounter_IsDone( qjobcounter_t *counter ) {
+	// the value is modified under the lock by other threads, so a plain read
+	// might not see results of finished jobs on weakly ordered CPUs
+	return Sys_Atomic_CAS( &counter->value, 0, 0, jobs_lock );
+}
+
+/*
+* QJobs_CompleteJob
+*/
+static void QJobs_CompleteJob( qjobcounter_t *counter ) {
+	qjob_t *waiting = NULL, *next;
+
+	if( !counter ) {
+		return;
+	}
+
+	// the counter must not be touched after the lock is released,
+	// a waiting thread is free to reuse or destroy it by then
+	QMutex_Lock( jobs_lock );
+	if( !--counter->value ) {
+		waiting = counter->waiting;
+		counter->waiting = NULL;
+	}
+	QMutex_Unlock( jobs_lock );
+
+	for( ; waiting; waiting = next ) {
+		next = waiting->next;
+		QJobs_PushJob( waiting );
+		Q_free( waiting );
+	}
+}
+
+/*
+* QJobs_RunJob
+*/
+static void QJobs_RunJob( const qjob_t *job ) {
+	job->func( job->first, job->items, job->arg );
+
+	QJobs_CompleteJob( job->counter );
+}
+
+/*
+* QJobs_PushJob
+*/
+static void QJobs_PushJob( const qjob_t *job ) {
+	int i;
+	qjobworker_t *worker;
+	unsigned start = jobs_nextWorker++; // racy, but it's only used to spread the jobs
+
+	for( i = 0; i < jobs_numWorkers; i++ ) {
+		worker = &jobs_workers[( start + i ) % jobs_numWorkers];
+
+		QMutex_Lock( worker->lock );
+		if( worker->tail - worker->head < JOB_DEQUE_SIZE ) {
+			worker->jobs[worker->tail++ % JOB_DEQUE_SIZE] = *job;
+			QMutex_Unlock( worker->lock );
+
+			QMutex_Lock( jobs_lock );
+			jobs_queued++;
+			QCondVar_Wake( jobs_cond );
+			QMutex_Unlock( jobs_lock );
+			return;
+		}
+		QMutex_Unlock( worker->lock );
+	}
+
+	// all deques are full
+	QJobs_RunJob( job );
+}
+
+/*
+* QJobs_TakeJob
+*
+* Pops a job from the worker's own deque or steals one from another worker.
+* Threads that are not workers pass -1 and can only steal.
+*/
+static bool QJobs_TakeJob( int self, qjob_t *job ) {
+	int i;
+	qjobworker_t *worker;
+	bool taken = false;
+
+	if( self >= 0 ) {
+		worker = &jobs_workers[self];
+
+		QMutex_Lock( worker->lock );
+		if( worker->head != worker->tail ) {
+			*job = worker->jobs[--worker->tail % JOB_DEQUE_SIZE];
+			taken = true;
+		}
+		QMutex_Unlock( worker->lock );
+	}
+
+	for( i = 1; i <= jobs_numWorkers && !taken; i++ ) {
+		worker = &jobs_workers[( self + i + jobs_numWorkers ) % jobs_numWorkers];
+		if( worker->head == worker->tail ) {
+			// racy check to avoid locking empty deques
+			continue;
+		}
+
+		QMutex_Lock( worker->lock );
+		if( worker->head != worker->tail ) {
+			*job = worker->jobs[worker->head++ % JOB_DEQUE_SIZE];
+			taken = true;
+		}
+		QMutex_Unlock( worker->lock );
+	}
+
+	if( taken ) {
+		QMutex_Lock( jobs_lock );
+		jobs_queued--;
+		QMutex_Unlock( jobs_lock );
+	}
+
+	return taken;
+}
+
+/*
+* QJobs_ParallelFor
+*
+* Splits items into jobs of grain items each and schedules them.
+* Zero grain picks a size that gives every worker a few jobs.
+* If dependency is not NULL, the jobs are only started once it's done.
+*/
+void QJobs_ParallelFor( qjobfunc_t func, void *arg, unsigned items, unsigned grain,
+						qjobcounter_t *counter, qjobcounter_t *dependency ) {
+	unsigned first, numJobs;
+	qjob_t job, *waiting;
+
+	if( !items ) {
+		return;
+	}
+
+	if( !jobs_numWorkers ) {
+		if( dependency ) {
+			QJobs_Wait( dependency );
+		}
+		func( 0, items, arg );
+		return;
+	}
+
+	if( !grain ) {
+		grain = max( 1, items / ( jobs_numWorkers * 4 ) );
+	}
+	numJobs = ( items + grain - 1 ) / grain;
+
+	job.func = func;
+	job.arg = arg;
+	job.counter = counter;
+	job.next = NULL;
+
+	QMutex_Lock( jobs_lock );
+
+	if( counter ) {
+		counter->value += numJobs;
+	}
+
+	if( dependency && dependency->value > 0 ) {
+		for( first = 0; first < items; first += grain ) {
+			waiting = Q_malloc( sizeof( *waiting ) );
+			*waiting = job;
+			waiting->first = first;
+			waiting->items = min( grain, items - first );
+			waiting->next = dependency->waiting;
+			dependency->waiting = waiting;
+		}
+
+		QMutex_Unlock( jobs_lock );
+		return;
+	}
+
+	QMutex_Unlock( jobs_lock );
+
+	for( first = 0; first < items; first += grain ) {
+		job.first = first;
+		job.items = min( grain, items - first );
+		QJobs_PushJob( &job );
+	}
+}
+
+/*
+* QJobs_Schedule
+*/
+void QJobs_Schedule( qjobfunc_t func, void *arg, qjobcounter_t *counter, qjobcounter_t *dependency ) {
+	QJobs_ParallelFor( func, arg, 1, 1, counter, dependency );
+}
+
+/*
+* QJobs_Wait
+*
+* Blocks until all jobs of the counter are done, executing queued jobs meanwhile.
+*/
+void QJobs_Wait( qjobcounter_t *counter ) {
+	qjob_t job;
+
+	while( !QJobCounter_IsDone( counter ) ) {
+		if( QJobs_TakeJob( -1, &job ) ) {
+			QJobs_RunJob( &job );
+			continue;
+		}
+		QThread_Yield();
+	}
+}
+
+/*
+* QJobs_WorkerProc
+*/
+static void *QJobs_WorkerProc( void *param ) {
+	qjobworker_t *worker = param;
+	qjob_t job;
+
+	while( true ) {
+		if( QJobs_TakeJob( worker->self, &job ) ) {
+			QJobs_RunJob( &job );
+			continue;
+		}
+
+		QMutex_Lock( jobs_lock );
+		while( !jobs_queued && !jobs_shutdown ) {
+			QCondVar_Wait( jobs_cond, jobs_lock, Q_THREADS_WAIT_INFINITE );
+		}
+		if( jobs_shutdown && !jobs_queued ) {
+			QMutex_Unlock( jobs_lock );
+			break;
+		}
+		QMutex_Unlock( jobs_lock );
+	}
+
+	return NULL;
+}
@@ -129,6 +129,7 @@ void Netchan_OutOfBandPrint( const socket_t *socket, const netadr_t *address, co
 * called to open a channel to a remote system
 */
 void Netchan_Setup( netchan_t *chan, const socket_t *socket, const netadr_t *address, int game_port ) {
+	Netchan_Release( chan );
 	memset( chan, 0, sizeof( *chan ) );
 
 	chan->socket = socket;
@@ -147,6 +148,58 @@ static uint8_t msg_process_data[MAX_MSGLEN];
 
 #include "compression.h"
 
+// deflate can't reference data further back than its window
+#define MAX_DICTIONARY_SIZE     ( 1 << MAX_WBITS )
+
+// how far back the stream codecs may reference a message, must fit into a byte
+#define NETCHAN_STREAM_FRAMES   16
+
+// set on the acknowledge of the header when it's followed by the stream acknowledge byte
+#define STREAMACK_BIT           ( 1 << 30 )
+#define STREAMACK_NONE          0xFF
+
+typedef struct {
+	const char *name;
+	int ( *compress )( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen );
+	int ( *decompress )( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen );
+} netcodec_t;
+
+typedef struct {
+	int sequence;
+	size_t size;
+	size_t capacity;
+	uint8_t *data;
+} netchan_streamframe_t;
+
+// stream codecs prime the compressor with a message the other side is known to have:
+// each side acknowledges the newest message it has stored in the packet header, the
+// sender picks it and sends its distance in front of the compressed data. Messages
+// that are sent uncompressed are stored as well, lost and undecodable ones are never
+// acknowledged this way and thus never referenced
+typedef struct netchan_stream_s {
+	netchan_streamframe_t sent[NETCHAN_STREAM_FRAMES];
+	netchan_streamframe_t received[NETCHAN_STREAM_FRAMES];
+	int lastDecodedSequence;
+} netchan_stream_t;
+
+static cvar_t *net_compressLevel;
+static cvar_t *net_compressDictionary;
+static cvar_t *net_compressSamples;
+static cvar_t *net_compressStream;
+
+static uint8_t netchan_streamDictionary[MAX_DICTIONARY_SIZE];
+
+static uint8_t *netchan_dictionary;
+static size_t netchan_dictionarySize;
+static unsigned netchan_dictionaryChecksum;
+
+static z_stream netchan_deflateStream;
+static int netchan_deflateLevel = -1;
+static z_stream netchan_inflateStream;
+static bool netchan_inflateInitialized;
+
+static int netchan_samplesFile;
+
 static int Netchan_ZLibCompressChunk( const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen,
 									  int level, int wbits ) {
 	int result, zlerror;
@@ -207,31 +260,486 @@ static int Netchan_ZLibDecompressChunk( const uint8_t *source, unsigned long sou
 	return result;
 }
 
+/*
+* Netchan_DeflateChunk
+*
+* Compresses into a raw deflate stream, optionally primed with a dictionary.
+* Returns 0 if the result doesn't fit into destLen bytes.
+*/
+static int Netchan_DeflateChunk( const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen,
+								 const uint8_t *dictionary, size_t dictionarySize ) {
+	int zlerror;
+	int level = bound( Z_BEST_SPEED, net_compressLevel->integer, Z_BEST_COMPRESSION );
+	z_stream *strm = &netchan_deflateStream;
+
+	// the stream is reused for all messages, only reinitialize it when the level changes
+	if( netchan_deflateLevel != level ) {
+		if( netchan_deflateLevel >= 0 ) {
+			qzdeflateEnd( strm );
+		}
+		memset( strm, 0, sizeof( *strm ) );
+		netchan_deflateLevel = -1;
+
+		zlerror = qzdeflateInit2( strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY );
+		if( zlerror != Z_OK ) {
+			Com_DPrintf( "ZLib data error! Error code %i on deflateInit.\n", zlerror );
+			return -1;
+		}
+		netchan_deflateLevel = level;
+	} else {
+		qzdeflateReset( strm );
+	}
+
+	if( dictionary ) {
+		zlerror = qzdeflateSetDictionary( strm, dictionary, dictionarySize );
+		if( zlerror != Z_OK ) {
+			Com_DPrintf( "ZLib data error! Error code %i on deflateSetDictionary.\n", zlerror );
+			return -1;
+		}
+	}
+
+	strm->next_in = ( Bytef * )source;
+	strm->avail_in = sourceLen;
+	strm->next_out = dest;
+	strm->avail_out = destLen;
+
+	zlerror = qzdeflate( strm, Z_FINISH );
+	if( zlerror == Z_OK || zlerror == Z_BUF_ERROR ) {
+		return 0; // ran out of space, not worth compressing
+	}
+	if( zlerror != Z_STREAM_END ) {
+		Com_DPrintf( "ZLib data error! Error code %i on deflate.\n", zlerror );
+		return -1;
+	}
+
+	return destLen - strm->avail_out;
+}
+
+/*
+* Netchan_InflateChunk
+*/
+static int Netchan_InflateChunk( const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen,
+								 const uint8_t *dictionary, size_t dictionarySize ) {
+	int zlerror;
+	z_stream *strm = &netchan_inflateStream;
+
+	if( !netchan_inflateInitialized ) {
+		memset( strm, 0, sizeof( *strm ) );
+		zlerror = qzinflateInit2( strm, -MAX_WBITS );
+		if( zlerror != Z_OK ) {
+			Com_DPrintf( "ZLib data error! Error code %i on inflateInit.\n", zlerror );
+			return -1;
+		}
+		netchan_inflateInitialized = true;
+	} else {
+		qzinflateReset( strm );
+	}
+
+	// raw streams take the dictionary right away
+	if( dictionary ) {
+		zlerror = qzinflateSetDictionary( strm, dictionary, dictionarySize );
+		if( zlerror != Z_OK ) {
+			Com_DPrintf( "ZLib data error! Error code %i on inflateSetDictionary.\n", zlerror );
+			return -1;
+		}
+	}
+
+	strm->next_in = ( Bytef * )source;
+	strm->avail_in = sourceLen;
+	strm->next_out = dest;
+	strm->avail_out = destLen;
+
+	zlerror = qzinflate( strm, Z_FINISH );
+	if( zlerror != Z_STREAM_END ) {
+		Com_DPrintf( "ZLib data error! Error code %i on inflate.\n", zlerror );
+		return -1;
+	}
+
+	return destLen - strm->avail_out;
+}
+
+static int Netchan_ZLibCompress( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen ) {
+	return Netchan_ZLibCompressChunk( source, sourceLen, dest, destLen, Z_BEST_COMPRESSION, -MAX_WBITS );
+}
+
+static int Netchan_ZLibDecompress( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen ) {
+	return Netchan_ZLibDecompressChunk( source, sourceLen, dest, destLen, -MAX_WBITS );
+}
+
+static int Netchan_DeflateCompress( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen ) {
+	return Netchan_DeflateChunk( source, sourceLen, dest, destLen, NULL, 0 );
+}
+
+static int Netchan_DeflateDecompress( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen ) {
+	return Netchan_InflateChunk( source, sourceLen, dest, destLen, NULL, 0 );
+}
+
+static int Netchan_DeflateDictCompress( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen ) {
+	return Netchan_DeflateChunk( source, sourceLen, dest, destLen, netchan_dictionary, netchan_dictionarySize );
+}
+
+static int Netchan_DeflateDictDecompress( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen ) {
+	return Netchan_InflateChunk( source, sourceLen, dest, destLen, netchan_dictionary, netchan_dictionarySize );
+}
+
+/*
+* Netchan_StoreStreamFrame
+*/
+static void Netchan_StoreStreamFrame( netchan_streamframe_t *frame, int sequence, const uint8_t *data, size_t size ) {
+	if( frame->capacity < size ) {
+		if( frame->data ) {
+			Mem_ZoneFree( frame->data );
+		}
+		frame->capacity = max( size, 1024 );
+		frame->data = Mem_ZoneMalloc( frame->capacity );
+	}
+
+	memcpy( frame->data, data, size );
+	frame->size = size;
+	frame->sequence = sequence;
+}
+
+/*
+* Netchan_StreamDictionary
+*
+* Puts the referenced message right in front of the data, preceded by as much
+* of the shared dictionary as fits into the window
+*/
+static size_t Netchan_StreamDictionary( const netchan_streamframe_t *reference, bool shared ) {
+	size_t referenceSize = 0, sharedSize = 0;
+
+	if( reference ) {
+		referenceSize = min( reference->size, MAX_DICTIONARY_SIZE );
+	}
+	if( shared && netchan_dictionary ) {
+		sharedSize = min( netchan_dictionarySize, MAX_DICTIONARY_SIZE - referenceSize );
+	}
+
+	memcpy( netchan_streamDictionary, netchan_dictionary + netchan_dictionarySize - sharedSize, sharedSize );
+	if( referenceSize ) {
+		memcpy( netchan_streamDictionary + sharedSize, reference->data + reference->size - referenceSize, referenceSize );
+	}
+
+	return sharedSize + referenceSize;
+}
+
+/*
+* Netchan_StreamCompressChunk
+*/
+static int Netchan_StreamCompressChunk( netchan_t *chan, const uint8_t *source, unsigned long sourceLen,
+										uint8_t *dest, unsigned long destLen, bool shared ) {
+	int length;
+	size_t dictionarySize;
+	int sequence = chan->outgoingSequence;
+	int acknowledged = chan->incoming_stream_acknowledged;
+	int distance = sequence - acknowledged;
+	netchan_stream_t *stream = chan->stream;
+	netchan_streamframe_t *reference = NULL;
+
+	if( !stream || sourceLen < 3 ) {
+		return 0;
+	}
+
+	if( distance > 0 && distance < NETCHAN_STREAM_FRAMES ) {
+		reference = &stream->sent[(unsigned)acknowledged % NETCHAN_STREAM_FRAMES];
+		if( reference->sequence != acknowledged || !reference->size ) {
+			reference = NULL;
+		}
+	}
+	if( !reference ) {
+		distance = 0;
+	}
+
+	// the output must be smaller than the input, otherwise the message is sent
+	// uncompressed and the remote side won't have it to reference later
+	destLen = min( destLen, sourceLen - 1 );
+
+	dictionarySize = Netchan_StreamDictionary( reference, shared );
+	length = Netchan_DeflateChunk( source, sourceLen, dest + 1, destLen - 1,
+								   dictionarySize ? netchan_streamDictionary : NULL, dictionarySize );
+	if( length <= 0 ) {
+		return length;
+	}
+
+	dest[0] = distance;
+	Netchan_StoreStreamFrame( &stream->sent[(unsigned)sequence % NETCHAN_STREAM_FRAMES], sequence, source, sourceLen );
+
+	return length + 1;
+}
+
+/*
+* Netchan_StreamDecompressChunk
+*/
+static int Netchan_StreamDecompressChunk( netchan_t *chan, const uint8_t *source, unsigned long sourceLen,
+										  uint8_t *dest, unsigned long destLen, bool shared ) {
+	int length;
+	size_t dictionarySize;
+	int referenceSequence;
+	int sequence = chan->incomingSequence;
+	netchan_stream_t *stream = chan->stream;
+	netchan_streamframe_t *reference = NULL;
+
+	if( !stream || sourceLen < 1 || source[0] >= NETCHAN_STREAM_FRAMES ) {
+		return -1;
+	}
+
+	if( source[0] ) {
+		referenceSequence = sequence - source[0];
+		if( referenceSequence < 0 ) {
+			Com_DPrintf( "Netchan_StreamDecompressChunk: Bad reference distance %i for %i\n", source[0], sequence );
+			return -1;
+		}
+		reference = &stream->received[(unsigned)referenceSequence % NETCHAN_STREAM_FRAMES];
+		if( reference->sequence != referenceSequence || !reference->size ) {
+			Com_DPrintf( "Netchan_StreamDecompressChunk: Missing reference %i for %i\n", referenceSequence, sequence );
+			return -1;
+		}
+	}
+
+	dictionarySize = Netchan_StreamDictionary( reference, shared );
+	length = Netchan_InflateChunk( source + 1, sourceLen - 1, dest, destLen,
+								   dictionarySize ? netchan_streamDictionary : NULL, dictionarySize );
+	if( length < 0 ) {
+		return length;
+	}
+
+	Netchan_StoreStreamFrame( &stream->received[(unsigned)sequence % NETCHAN_STREAM_FRAMES], sequence, dest, length );
+	stream->lastDecodedSequence = sequence;
+
+	return length;
+}
+
+static int Netchan_StreamCompress( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen ) {
+	return Netchan_StreamCompressChunk( chan, source, sourceLen, dest, destLen, false );
+}
+
+static int Netchan_StreamDecompress( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen ) {
+	return Netchan_StreamDecompressChunk( chan, source, sourceLen, dest, destLen, false );
+}
+
+static int Netchan_StreamDictCompress( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen ) {
+	return Netchan_StreamCompressChunk( chan, source, sourceLen, dest, destLen, true );
+}
+
+static int Netchan_StreamDictDecompress( netchan_t *chan, const uint8_t *source, unsigned long sourceLen, uint8_t *dest, unsigned long destLen ) {
+	return Netchan_StreamDecompressChunk( chan, source, sourceLen, dest, destLen, true );
+}
+
+static const netcodec_t netchan_codecs[NETCHAN_CODEC_TOTAL] =
+{
+	{ "zlib", Netchan_ZLibCompress, Netchan_ZLibDecompress },
+	{ "deflate", Netchan_DeflateCompress, Netchan_DeflateDecompress },
+	{ "deflate+dict", Netchan_DeflateDictCompress, Netchan_DeflateDictDecompress },
+	{ "stream", Netchan_StreamCompress, Netchan_StreamDecompress },
+	{ "stream+dict", Netchan_StreamDictCompress, Netchan_StreamDictDecompress },
+};
+
+/*
+* Netchan_LoadDictionary
+*
+* Both sides must have the very same dictionary, which is verified by checksum at connect.
+*/
+static void Netchan_LoadDictionary( void ) {
+	int length;
+	uint8_t *buffer;
+
+	if( netchan_dictionary ) {
+		Mem_ZoneFree( netchan_dictionary );
+		netchan_dictionary = NULL;
+	}
+	netchan_dictionarySize = 0;
+	netchan_dictionaryChecksum = 0;
+
+	if( !net_compressDictionary->string[0] ) {
+		return;
+	}
+
+	length = FS_LoadFile( net_compressDictionary->string, ( void ** )&buffer, NULL, 0 );
+	if( !buffer ) {
+		Com_Printf( "Compression dictionary %s not found, dictionary codecs are disabled\n", net_compressDictionary->string );
+		return;
+	}
+
+	if( length > 0 ) {
+		// the tail of the dictionary is closest to the data so it's the most valuable part
+		netchan_dictionarySize = min( length, MAX_DICTIONARY_SIZE );
+		netchan_dictionary = Mem_ZoneMalloc( netchan_dictionarySize );
+		memcpy( netchan_dictionary, buffer + length - netchan_dictionarySize, netchan_dictionarySize );
+		netchan_dictionaryChecksum = qzcrc32( 0, netchan_dictionary, netchan_dictionarySize );
+	}
+
+	FS_FreeFile( buffer );
+}
+
+/*
+* Netchan_RecordSample
+*
+* Appends outgoing uncompressed server messages to the net_compressSamples file,
+* which can be turned into a dictionary with net_builddictionary.
+*/
+static void Netchan_RecordSample( const netchan_t *chan, const msg_t *msg ) {
+	int length;
+
+	if( net_compressSamples->modified ) {
+		net_compressSamples->modified = false;
+		if( netchan_samplesFile ) {
+			FS_FCloseFile( netchan_samplesFile );
+			netchan_samplesFile = 0;
+		}
+		if( net_compressSamples->string[0] ) {
+			if( FS_FOpenFile( net_compressSamples->string, &netchan_samplesFile, FS_APPEND ) == -1 ) {
+				Com_Printf( "Couldn't open %s for writing\n", net_compressSamples->string );
+				netchan_samplesFile = 0;
+			}
+		}
+	}
+
+	if( !netchan_samplesFile || !chan->socket->server ) {
+		return;
+	}
+
+	length = LittleLong( (int)msg->cursize );
+	FS_Write( &length, sizeof( length ), netchan_samplesFile );
+	FS_Write( msg->data, msg->cursize, netchan_samplesFile );
+}
+
+/*
+* Netchan_CodecMask
+*
+* Returns the codecs supported by this side of a connection
+*/
+unsigned Netchan_CodecMask( void ) {
+	unsigned mask = ( 1 << NETCHAN_CODEC_ZLIB ) | ( 1 << NETCHAN_CODEC_DEFLATE );
+
+	if( net_compressStream->integer ) {
+		mask |= ( 1 << NETCHAN_CODEC_STREAM );
+	}
+	if( netchan_dictionary ) {
+		mask |= ( 1 << NETCHAN_CODEC_DEFLATE_DICT );
+		if( net_compressStream->integer ) {
+			mask |= ( 1 << NETCHAN_CODEC_STREAM_DICT );
+		}
+	}
+	return mask;
+}
+
+/*
+* Netchan_DictionaryChecksum
+*/
+unsigned Netchan_DictionaryChecksum( void ) {
+	return netchan_dictionaryChecksum;
+}
+
+/*
+* Netchan_NegotiateCodec
+*
+* Picks the best codec supported by both sides
+*/
+netchan_codec_t Netchan_NegotiateCodec( unsigned remoteMask, unsigned remoteDictionaryChecksum ) {
+	int codec;
+	unsigned mask = Netchan_CodecMask() & remoteMask;
+
+	if( remoteDictionaryChecksum != netchan_dictionaryChecksum ) {
+		mask &= ~( ( 1 << NETCHAN_CODEC_DEFLATE_DICT ) | ( 1 << NETCHAN_CODEC_STREAM_DICT ) );
+	}
+
+	for( codec = NETCHAN_CODEC_TOTAL - 1; codec > NETCHAN_CODEC_ZLIB; codec-- ) {
+		if( mask & ( 1 << codec ) ) {
+			return ( netchan_codec_t )codec;
+		}
+	}
+	return NETCHAN_CODEC_ZLIB;
+}
+
+/*
+* Netchan_SetCodec
+*/
+void Netchan_SetCodec( netchan_t *chan, netchan_codec_t codec ) {
+	if( (unsigned)codec >= NETCHAN_CODEC_TOTAL ) {
+		codec = NETCHAN_CODEC_ZLIB;
+	}
+
+	if( codec == NETCHAN_CODEC_STREAM || codec == NETCHAN_CODEC_STREAM_DICT ) {
+		if( !chan->stream ) {
+			chan->stream = Mem_ZoneMalloc( sizeof( *chan->stream ) );
+			chan->stream->lastDecodedSequence = -1;
+		}
+	} else {
+		Netchan_Release( chan );
+	}
+
+	chan->codec = codec;
+}
+
+/*
+* Netchan_Release
+*
+* Frees the message history of the stream codecs
+*/
+void Netchan_Release( netchan_t *chan ) {
+	int i;
+	netchan_stream_t *stream = chan->stream;
+
+	if( !stream ) {
+		return;
+	}
+
+	for( i = 0; i < NETCHAN_STREAM_FRAMES; i++ ) {
+		if( stream->sent[i].data ) {
+			Mem_ZoneFree( stream->sent[i].data );
+		}
+		if( stream->received[i].data ) {
+			Mem_ZoneFree( stream->received[i].data );
+		}
+	}
+
+	Mem_ZoneFree( stream );
+	chan->stream = NULL;
+	chan->codec = NETCHAN_CODEC_ZLIB;
+}
+
+/*
+* Netchan_CodecName
+*/
+const char *Netchan_CodecName( netchan_codec_t codec ) {
+	if( (unsigned)codec >= NETCHAN_CODEC_TOTAL ) {
+		return "unknown";
+	}
+	return netchan_codecs[codec].name;
+}
+
 /*
 * Netchan_CompressMessage
 */
-int Netchan_CompressMessage( msg_t *msg ) {
+int Netchan_CompressMessage( netchan_t *chan, msg_t *msg ) {
 	int length;
+	uint64_t time;
 
 	if( msg == NULL || !msg->data ) {
 		return 0;
 	}
 
-	// zero-fill our buffer
-	length = 0;
-	memset( msg_process_data, 0, sizeof( msg_process_data ) );
+	Netchan_RecordSample( chan, msg );
 
 	//compress the message
-	length = Netchan_ZLibCompressChunk( msg->data, msg->cursize,
-										msg_process_data, sizeof( msg_process_data ), Z_BEST_COMPRESSION, -MAX_WBITS );
-	if( length < 0 ) { // failed to compress, return the error
-		return length;
-	}
-
-	if( (size_t)length >= msg->cursize || length >= MAX_MSGLEN ) {
+	time = Sys_Microseconds();
+	length = netchan_codecs[chan->codec].compress( chan, msg->data, msg->cursize, msg_process_data, sizeof( msg_process_data ) );
+
+	chan->compressTime += Sys_Microseconds() - time;
+	chan->compressedPackets++;
+	chan->compressInBytes += msg->cursize;
+
+	if( length <= 0 || (size_t)length >= msg->cursize || length >= MAX_MSGLEN ) {
+		// the stream codec stores the message anyway when transmitting it uncompressed
+		chan->compressOutBytes += msg->cursize;
+		if( length < 0 ) { // failed to compress, return the error
+			return length;
+		}
 		return 0; // compressed was bigger. Send uncompressed
 	}
 
+	chan->compressOutBytes += length;
+
 	//write it back into the original container
 	MSG_Clear( msg );
 	MSG_CopyData( msg, msg_process_data, length );
@@ -243,7 +751,7 @@ int Netchan_CompressMessage( msg_t *msg ) {
 /*
 * Netchan_DecompressMessage
 */
-int Netchan_DecompressMessage( msg_t *msg ) {
+int Netchan_DecompressMessage( netchan_t *chan, msg_t *msg ) {
 	int length;
 
 	if( msg == NULL || !msg->data ) {
@@ -251,11 +759,19 @@ int Netchan_DecompressMessage( msg_t *msg ) {
 	}
 
 	if( msg->compressed == false ) {
+		if( chan->stream ) {
+			Netchan_StoreStreamFrame( &chan->stream->received[(unsigned)chan->incomingSequence % NETCHAN_STREAM_FRAMES],
+									  chan->incomingSequence, msg->data + msg->readcount, msg->cursize - msg->readcount );
+			chan->stream->lastDecodedSequence = chan->incomingSequence;
+		}
 		return 0;
 	}
 
-	length = Netchan_ZLibDecompressChunk( msg->data + msg->readcount, msg->cursize - msg->readcount, msg_process_data, ( sizeof( msg_process_data ) - msg->readcount ), -MAX_WBITS );
+	length = netchan_codecs[chan->codec].decompress( chan, msg->data + msg->readcount, msg->cursize - msg->readcount,
+													 msg_process_data, ( sizeof( msg_process_data ) - msg->readcount ) );
 	if( length < 0 ) {
+		// the stream acknowledge keeps pointing at the last decoded message,
+		// so the remote side won't reference this one
 		return length;
 	}
 
@@ -284,6 +800,32 @@ static void Netchan_DropAllFragments( netchan_t *chan ) {
 	}
 }
 
+/*
+* Netchan_StreamAckFlags
+*/
+static int Netchan_StreamAckFlags( const netchan_t *chan ) {
+	return chan->stream ? STREAMACK_BIT : 0;
+}
+
+/*
+* Netchan_WriteStreamAck
+*
+* Acknowledges the newest message the stream codecs may reference, as a distance to the header acknowledge
+*/
+static void Netchan_WriteStreamAck( const netchan_t *chan, msg_t *msg ) {
+	int distance;
+
+	if( !chan->stream ) {
+		return;
+	}
+
+	distance = chan->incomingSequence - chan->stream->lastDecodedSequence;
+	if( chan->stream->lastDecodedSequence < 0 || distance < 0 || distance >= NETCHAN_STREAM_FRAMES ) {
+		distance = STREAMACK_NONE;
+	}
+	MSG_WriteUint8( msg, distance );
+}
+
 /*
 * Netchan_TransmitNextFragment
 *
@@ -307,9 +849,9 @@ bool Netchan_TransmitNextFragment( netchan_t *chan ) {
 	// wsw : jal : by now our header sends incoming ack too (q3 doesn't)
 	// wsw : also add compressed bit if it's compressed
 	if( chan->unsentIsCompressed ) {
-		MSG_WriteInt32( &send, chan->incomingSequence | FRAGMENT_BIT );
+		MSG_WriteInt32( &send, chan->incomingSequence | FRAGMENT_BIT | Netchan_StreamAckFlags( chan ) );
 	} else {
-		MSG_WriteInt32( &send, chan->incomingSequence );
+		MSG_WriteInt32( &send, chan->incomingSequence | Netchan_StreamAckFlags( chan ) );
 	}
 
 	// send the game port if we are a client
@@ -317,6 +859,8 @@ bool Netchan_TransmitNextFragment( netchan_t *chan ) {
 		MSG_WriteInt16( &send, local_game_port );
 	}
 
+	Netchan_WriteStreamAck( chan, &send );
+
 	// copy the reliable message to the packet first
 	if( chan->unsentFragmentStart + FRAGMENT_SIZE > chan->unsentLength ) {
 		fragmentLength = chan->unsentLength - chan->unsentFragmentStart;
@@ -389,6 +933,13 @@ bool Netchan_Transmit( netchan_t *chan, msg_t *msg ) {
 	chan->unsentFragmentStart = 0;
 	chan->unsentIsCompressed = false;
 
+	// the remote side may acknowledge any message, so keep uncompressed ones as stream references too,
+	// including messages that have not been passed to Netchan_CompressMessage at all
+	if( chan->stream && !msg->compressed ) {
+		Netchan_StoreStreamFrame( &chan->stream->sent[(unsigned)chan->outgoingSequence % NETCHAN_STREAM_FRAMES],
+								  chan->outgoingSequence, msg->data, msg->cursize );
+	}
+
 	// fragment large reliable messages
 	if( msg->cursize >= FRAGMENT_SIZE ) {
 		chan->unsentFragments = true;
@@ -408,9 +959,9 @@ bool Netchan_Transmit( netchan_t *chan, msg_t *msg ) {
 	// wsw : jal : by now our header sends incoming ack too (q3 doesn't)
 	// wsw : jal : also add compressed information if it's compressed
 	if( msg->compressed ) {
-		MSG_WriteInt32( &send, chan->incomingSequence | FRAGMENT_BIT );
+		MSG_WriteInt32( &send, chan->incomingSequence | FRAGMENT_BIT | Netchan_StreamAckFlags( chan ) );
 	} else {
-		MSG_WriteInt32( &send, chan->incomingSequence );
+		MSG_WriteInt32( &send, chan->incomingSequence | Netchan_StreamAckFlags( chan ) );
 	}
 
 	chan->outgoingSequence++;
@@ -420,6 +971,8 @@ bool Netchan_Transmit( netchan_t *chan, msg_t *msg ) {
 		MSG_WriteInt16( &send, local_game_port );
 	}
 
+	Netchan_WriteStreamAck( chan, &send );
+
 	MSG_CopyData( &send, msg->data, msg->cursize );
 
 	// send the datagram
@@ -448,6 +1001,7 @@ bool Netchan_Transmit( netchan_t *chan, msg_t *msg ) {
 bool Netchan_Process( netchan_t *chan, msg_t *msg ) {
 	int sequence, sequence_ack;
 	int game_port = -1;
+	int stream_ack = STREAMACK_NONE;
 	int fragmentStart, fragmentLength;
 	bool fragmented = false;
 	int headerlength;
@@ -485,6 +1039,12 @@ bool Netchan_Process( netchan_t *chan, msg_t *msg ) {
 		game_port = MSG_ReadInt16( msg );
 	}
 
+	// read the acknowledge of the stream codecs, it is not part of reconstructed messages
+	if( sequence_ack & STREAMACK_BIT ) {
+		sequence_ack &= ~STREAMACK_BIT;
+		stream_ack = MSG_ReadUint8( msg );
+	}
+
 	// read the fragment information
 	if( fragmented ) {
 		fragmentStart = MSG_ReadInt16( msg );
@@ -604,6 +1164,10 @@ bool Netchan_Process( netchan_t *chan, msg_t *msg ) {
 	chan->incoming_acknowledged = sequence_ack;
 	// wsw : jal[end]
 
+	if( stream_ack != STREAMACK_NONE ) {
+		chan->incoming_stream_acknowledged = sequence_ack - stream_ack;
+	}
+
 	return true;
 }
 
@@ -624,10 +1188,44 @@ void Netchan_Init( void ) {
 	showpackets = Cvar_Get( "showpackets", "0", 0 );
 	showdrop = Cvar_Get( "showdrop", "0", 0 );
 	net_showfragments = Cvar_Get( "net_showfragments", "0", 0 );
+
+	net_compressLevel = Cvar_Get( "net_compressLevel", "1", CVAR_ARCHIVE );
+	// no dictionary is shipped, one built with net_builddictionary has to be set on both sides.
+	// the dictionary is loaded only here, so changes take effect after restarting the program
+	net_compressDictionary = Cvar_Get( "net_compressDictionary", "", CVAR_ARCHIVE );
+	net_compressSamples = Cvar_Get( "net_compressSamples", "", 0 );
+	net_compressStream = Cvar_Get( "net_compressStream", "0", CVAR_ARCHIVE );
+	net_compressSamples->modified = true;
+
+	Netchan_LoadDictionary();
+
+	Cmd_AddCommand( "net_builddictionary", Netchan_BuildDictionary_f );
 }
 
 /*
 * Netchan_Shutdown
 */
 void Netchan_Shutdown( void ) {
+	Cmd_RemoveCommand( "net_builddictionary" );
+
+	if( netchan_samplesFile ) {
+		FS_FCloseFile( netchan_samplesFile );
+		netchan_samplesFile = 0;
+	}
+
+	if( netchan_deflateLevel >= 0 ) {
+		qzdeflateEnd( &netchan_deflateStream );
+		netchan_deflateLevel = -1;
+	}
+	if( netchan_inflateInitialized ) {
+		qzinflateEnd( &netchan_inflateStream );
+		netchan_inflateInitialized = false;
+	}
+
+	if( netchan_dictionary ) {
+		Mem_ZoneFree( netchan_dictionary );
+		netchan_dictionary = NULL;
+	}
+	netchan_dictionarySize = 0;
+	netchan_dictionaryChecksum = 0;
 }
@@ -0,0 +1,184 @@
+/*
+Copyright (C) 2017 Warsow development team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "qcommon.h"
+
+/*
+* Builds a preset dictionary for the deflate+dict network codec out of packets
+* recorded with net_compressSamples.
+*
+* The data is split into as many epochs as there are segments in the dictionary.
+* Each epoch contributes the segment having the highest sum of frequencies of the
+* short byte sequences (shingles) it contains. Frequencies of the picked shingles
+* are then zeroed so that later epochs don't pick the same content over and over.
+* The dictionary is filled from the end since deflate encodes short distances
+* with fewer bits, so the best segments should be closest to the data.
+*/
+
+#define DICT_SHINGLE_SIZE       8
+#define DICT_SEGMENT_SIZE       32
+#define DICT_HASH_BITS          20
+#define DICT_HASH_SIZE          ( 1 << DICT_HASH_BITS )
+#define DICT_DEFAULT_SIZE       ( 32 * 1024 )
+
+/*
+* Netchan_DictHashShingle
+*/
+static inline unsigned Netchan_DictHashShingle( const uint8_t *data ) {
+	uint64_t v;
+
+	memcpy( &v, data, sizeof( v ) );
+	return (unsigned)( ( v * 0xCF1BBCDCB7A56463ULL ) >> ( 64 - DICT_HASH_BITS ) );
+}
+
+/*
+* Netchan_DictScoreSegment
+*/
+static uint64_t Netchan_DictScoreSegment( const uint32_t *freqs, const uint8_t *data ) {
+	int i;
+	uint64_t score = 0;
+
+	for( i = 0; i <= DICT_SEGMENT_SIZE - DICT_SHINGLE_SIZE; i++ ) {
+		score += freqs[Netchan_DictHashShingle( data + i )];
+	}
+	return score;
+}
+
+/*
+* Netchan_BuildDictionary_f
+*/
+void Netchan_BuildDictionary_f( void ) {
+	int i, length, filenum;
+	size_t dictSize, numSegments, segment;
+	size_t dataSize, numSamples, epochSize;
+	size_t offset, sampleEnd, sampleLen;
+	uint8_t *buffer, *data, *dict;
+	size_t *sampleEnds;
+	uint32_t *freqs;
+	size_t curSample;
+
+	if( Cmd_Argc() < 3 ) {
+		Com_Printf( "Usage: %s <samples> <output> [size]\n", Cmd_Argv( 0 ) );
+		return;
+	}
+
+	dictSize = Cmd_Argc() > 3 ? (size_t)atoi( Cmd_Argv( 3 ) ) : DICT_DEFAULT_SIZE;
+	dictSize = bound( DICT_SEGMENT_SIZE, dictSize, DICT_DEFAULT_SIZE );
+	dictSize -= dictSize % DICT_SEGMENT_SIZE;
+	numSegments = dictSize / DICT_SEGMENT_SIZE;
+
+	length = FS_LoadFile( Cmd_Argv( 1 ), ( void ** )&buffer, NULL, 0 );
+	if( !buffer ) {
+		Com_Printf( "Couldn't load %s\n", Cmd_Argv( 1 ) );
+		return;
+	}
+
+	// strip the length prefixes, remembering where each sample ends
+	// so shingles and segments never cross packet boundaries
+	data = Mem_TempMalloc( length + 1 );
+	sampleEnds = Mem_TempMalloc( ( length / ( sizeof( int ) + 1 ) + 1 ) * sizeof( *sampleEnds ) );
+	dataSize = numSamples = 0;
+
+	for( offset = 0; offset + sizeof( int ) <= (size_t)length; ) {
+		int sampleLenLE;
+
+		memcpy( &sampleLenLE, buffer + offset, sizeof( int ) );
+		sampleLen = (size_t)LittleLong( sampleLenLE );
+		offset += sizeof( int );
+		if( !sampleLen || sampleLen > (size_t)length - offset ) {
+			break;
+		}
+
+		memcpy( data + dataSize, buffer + offset, sampleLen );
+		dataSize += sampleLen;
+		offset += sampleLen;
+		sampleEnds[numSamples++] = dataSize;
+	}
+
+	FS_FreeFile( buffer );
+
+	if( dataSize < dictSize * 2 ) {
+		Com_Printf( "Not enough samples in %s: %u bytes in %u packets\n",
+					Cmd_Argv( 1 ), (unsigned)dataSize, (unsigned)numSamples );
+		Mem_TempFree( sampleEnds );
+		Mem_TempFree( data );
+		return;
+	}
+
+	// count shingles
+	freqs = Mem_TempMalloc( DICT_HASH_SIZE * sizeof( *freqs ) );
+	for( curSample = 0, offset = 0; curSample < numSamples; curSample++ ) {
+		sampleEnd = sampleEnds[curSample];
+		for( ; offset + DICT_SHINGLE_SIZE <= sampleEnd; offset++ ) {
+			freqs[Netchan_DictHashShingle( data + offset )]++;
+		}
+		offset = sampleEnd;
+	}
+
+	dict = Mem_TempMalloc( dictSize );
+	epochSize = dataSize / numSegments;
+
+	for( segment = 0, curSample = 0; segment < numSegments; segment++ ) {
+		size_t epochStart = segment * epochSize;
+		size_t epochEnd = epochStart + epochSize;
+		size_t best = epochStart;
+		uint64_t bestScore = 0;
+
+		// find the best segment in the epoch, segments must lie within a single sample
+		while( curSample < numSamples && sampleEnds[curSample] <= epochStart ) {
+			curSample++;
+		}
+		for( i = curSample, offset = epochStart; (size_t)i < numSamples && offset < epochEnd; i++ ) {
+			sampleEnd = sampleEnds[i];
+			for( ; offset + DICT_SEGMENT_SIZE <= sampleEnd && offset < epochEnd; offset++ ) {
+				uint64_t score = Netchan_DictScoreSegment( freqs, data + offset );
+				if( score > bestScore ) {
+					bestScore = score;
+					best = offset;
+				}
+			}
+			offset = sampleEnd;
+		}
+
+		if( best + DICT_SEGMENT_SIZE > dataSize ) {
+			best = dataSize - DICT_SEGMENT_SIZE;
+		}
+
+		memcpy( dict + dictSize - ( segment + 1 ) * DICT_SEGMENT_SIZE, data + best, DICT_SEGMENT_SIZE );
+
+		for( offset = best; offset <= best + DICT_SEGMENT_SIZE - DICT_SHINGLE_SIZE; offset++ ) {
+			freqs[Netchan_DictHashShingle( data + offset )] = 0;
+		}
+	}
+
+	if( FS_FOpenFile( Cmd_Argv( 2 ), &filenum, FS_WRITE ) == -1 ) {
+		Com_Printf( "Couldn't open %s for writing\n", Cmd_Argv( 2 ) );
+	} else {
+		FS_Write( dict, dictSize, filenum );
+		FS_FCloseFile( filenum );
+		Com_Printf( "Wrote %u bytes dictionary to %s from %u packets\n",
+					(unsigned)dictSize, Cmd_Argv( 2 ), (unsigned)numSamples );
+	}
+
+	Mem_TempFree( dict );
+	Mem_TempFree( freqs );
+	Mem_TempFree( sampleEnds );
+	Mem_TempFree( data );
+}
@@ -510,6 +510,17 @@ void    NET_BroadcastAddress( netadr_t *address, int port );
 
 //============================================================================
 
+// packet compression codecs, negotiated at connect
+typedef enum {
+	NETCHAN_CODEC_ZLIB,             // zlib at best compression, understood by all clients
+	NETCHAN_CODEC_DEFLATE,          // raw deflate at net_compressLevel
+	NETCHAN_CODEC_DEFLATE_DICT,     // raw deflate primed with the shared dictionary
+	NETCHAN_CODEC_STREAM,           // raw deflate primed with the last acknowledged message
+	NETCHAN_CODEC_STREAM_DICT,      // same as above, with the shared dictionary in front
+
+	NETCHAN_CODEC_TOTAL
+} netchan_codec_t;
+
 typedef struct {
 	const socket_t *socket;
 
@@ -521,6 +532,7 @@ typedef struct {
 	// sequencing variables
 	int incomingSequence;
 	int incoming_acknowledged;
+	int incoming_stream_acknowledged;   // the newest of our messages the stream codecs may reference
 	int outgoingSequence;
 
 	// incoming fragment assembly buffer
@@ -537,6 +549,15 @@ typedef struct {
 	bool unsentIsCompressed;
 
 	bool fatal_error;
+
+	netchan_codec_t codec;
+	struct netchan_stream_s *stream;    // history of messages for the stream codecs
+
+	// outgoing compression statistics
+	unsigned compressedPackets;
+	uint64_t compressInBytes;
+	uint64_t compressOutBytes;
+	uint64_t compressTime;      // in microseconds
 } netchan_t;
 
 extern netadr_t net_from;
@@ -545,12 +566,19 @@ extern netadr_t net_from;
 void Netchan_Init( void );
 void Netchan_Shutdown( void );
 void Netchan_Setup( netchan_t *chan, const socket_t *socket, const netadr_t *address, int qport );
+void Netchan_Release( netchan_t *chan );
 bool Netchan_Process( netchan_t *chan, msg_t *msg );
 bool Netchan_Transmit( netchan_t *chan, msg_t *msg );
 bool Netchan_PushAllFragments( netchan_t *chan );
 bool Netchan_TransmitNextFragment( netchan_t *chan );
-int Netchan_CompressMessage( msg_t *msg );
-int Netchan_DecompressMessage( msg_t *msg );
+int Netchan_CompressMessage( netchan_t *chan, msg_t *msg );
+int Netchan_DecompressMessage( netchan_t *chan, msg_t *msg );
+unsigned Netchan_CodecMask( void );
+unsigned Netchan_DictionaryChecksum( void );
+netchan_codec_t Netchan_NegotiateCodec( unsigned remoteMask, unsigned remoteDictionaryChecksum );
+void Netchan_SetCodec( netchan_t *chan, netchan_codec_t codec );
+const char *Netchan_CodecName( netchan_codec_t codec );
+void Netchan_BuildDictionary_f( void );
 void Netchan_OutOfBand( const socket_t *socket, const netadr_t *address, size_t length, const uint8_t *data );
 
 #ifndef _MSC_VER
@@ -879,6 +907,7 @@ CPU FEATURES
 #define QF_CPU_FEATURE_SSE41   ( 0x2 )
 #define QF_CPU_FEATURE_SSE42   ( 0x4 )
 #define QF_CPU_FEATURE_AVX     ( 0x8 )
+#define QF_CPU_FEATURE_AVX2    ( 0x10 )
 
 unsigned int COM_CPUFeatures( void );
 
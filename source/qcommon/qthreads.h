@@ -35,6 +35,12 @@ typedef struct qcondvar_s qcondvar_t;
 struct qbufPipe_s;
 typedef struct qbufPipe_s qbufPipe_t;
 
+struct qjobcounter_s;
+typedef struct qjobcounter_s qjobcounter_t;
+
+// processes items [first, first + items) of a job
+typedef void ( *qjobfunc_t )( unsigned first, unsigned items, void *arg );
+
 qmutex_t *QMutex_Create( void );
 void QMutex_Destroy( qmutex_t **pmutex );
 void QMutex_Lock( qmutex_t *mutex );
@@ -49,6 +55,7 @@ qthread_t *QThread_Create( void *( *routine )( void* ), void *param );
 void QThread_Join( qthread_t *thread );
 int QThread_Cancel( qthread_t *thread );
 void QThread_Yield( void );
+int QThread_GetNumCPUs( void );
 
 void QThreads_Init( void );
 void QThreads_Shutdown( void );
@@ -61,4 +68,15 @@ int QBufPipe_ReadCmds( qbufPipe_t *queue, unsigned( **cmdHandlers )( const void
 void QBufPipe_Wait( qbufPipe_t *queue, int ( *read )( qbufPipe_t *, unsigned( ** )( const void * ), bool ),
 					unsigned( **cmdHandlers )( const void * ), unsigned timeout_msec );
 
+void QJobs_Init( void );
+void QJobs_Shutdown( void );
+int QJobs_NumWorkers( void );
+qjobcounter_t *QJobCounter_Create( void );
+void QJobCounter_Destroy( qjobcounter_t **pcounter );
+bool QJobCounter_IsDone( qjobcounter_t *counter );
+void QJobs_Schedule( qjobfunc_t func, void *arg, qjobcounter_t *counter, qjobcounter_t *dependency );
+void QJobs_ParallelFor( qjobfunc_t func, void *arg, unsigned items, unsigned grain,
+						qjobcounter_t *counter, qjobcounter_t *dependency );
+void QJobs_Wait( qjobcounter_t *counter );
+
 #endif // Q_THREADS_H
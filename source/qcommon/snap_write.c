@@ -550,9 +550,14 @@ static bool SNAP_ViewDirCullEntity( const edict_t *clent, const edict_t *ent ) {
 	return DotProduct( toEntDir, viewDir ) < 0;
 }
 
-static bool SNAP_Raycast( cmodel_state_t *cms, trace_t *trace, const vec3_t from, const vec3_t to ) {
-	CM_TransformedBoxTrace( cms, trace, (float *)from, (float *)to, vec3_origin, vec3_origin, NULL, MASK_SOLID, NULL, NULL );
+#define MAX_SNAP_RAYCAST_BATCH 16
 
+/*
+* SNAP_ContinueRaycast
+*
+* Checks whether an already traced ray reaches the target possibly passing through translucent surfaces
+*/
+static bool SNAP_ContinueRaycast( cmodel_state_t *cms, trace_t *trace, const vec3_t from, const vec3_t to ) {
 	if( trace->fraction == 1.0f ) {
 		return true;
 	}
@@ -587,6 +592,33 @@ static bool SNAP_Raycast( cmodel_state_t *cms, trace_t *trace, const vec3_t from
 	return false;
 }
 
+static bool SNAP_Raycast( cmodel_state_t *cms, trace_t *trace, const vec3_t from, const vec3_t to ) {
+	CM_TransformedBoxTrace( cms, trace, (float *)from, (float *)to, vec3_origin, vec3_origin, NULL, MASK_SOLID, NULL, NULL );
+	return SNAP_ContinueRaycast( cms, trace, from, to );
+}
+
+/*
+* SNAP_RaycastBatch
+*
+* Returns true if any of rays reaches its target
+*/
+static bool SNAP_RaycastBatch( cmodel_state_t *cms, vec3_t *from, vec3_t *to, int numrays ) {
+	int i;
+	trace_t traces[MAX_SNAP_RAYCAST_BATCH];
+
+	assert( numrays <= MAX_SNAP_RAYCAST_BATCH );
+
+	CM_TraceBatch( cms, traces, from, to, numrays, vec3_origin, vec3_origin, MASK_SOLID );
+
+	for( i = 0; i < numrays; i++ ) {
+		if( SNAP_ContinueRaycast( cms, &traces[i], from[i], to[i] ) ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 static inline void SNAP_GetRandomPointInBox( const vec3_t origin, const vec3_t mins, const vec3_t size, vec3_t result ) {
 	result[0] = origin[0] + mins[0] + random() * size[0];
 	result[1] = origin[1] + mins[1] + random() * size[1];
@@ -667,17 +699,19 @@ static bool SNAP_TryCullClientByRaycasting( cmodel_state_t *cms, edict_t *clent,
 		return false;
 	}
 
+	// Rays that follow share the origin and are traced as a single batch
+	vec3_t rayFrom[MAX_SNAP_RAYCAST_BATCH];
+	vec3_t rayTo[MAX_SNAP_RAYCAST_BATCH];
+	int numRays = 0;
+
 	// Do a second raycast at the entity chest/eyes level
-	to[2] += entClient->ps.viewheight;
-	if( SNAP_Raycast( cms, &trace, vieworg, to ) ) {
-		return false;
-	}
+	VectorCopy( vieworg, rayFrom[numRays] );
+	VectorCopy( to, rayTo[numRays] );
+	rayTo[numRays++][2] += entClient->ps.viewheight;
 
 	// Test a random point in entity bounds now
-	SNAP_GetRandomPointInBox( ent->s.origin, ent->r.mins, ent->r.size, to );
-	if( SNAP_Raycast( cms, &trace, vieworg, to ) ) {
-		return false;
-	}
+	VectorCopy( vieworg, rayFrom[numRays] );
+	SNAP_GetRandomPointInBox( ent->s.origin, ent->r.mins, ent->r.size, rayTo[numRays++] );
 
 	// Test all bbox corners at the current position.
 	// Prevent missing a player that should be clearly visible.
@@ -690,12 +724,15 @@ static bool SNAP_TryCullClientByRaycasting( cmodel_state_t *cms, edict_t *clent,
 	}
 
 	for( int i = 0; i < 8; ++i ) {
-		to[0] = ent->s.origin[0] + bounds[(i >> 2) & 1][0];
-		to[1] = ent->s.origin[1] + bounds[(i >> 1) & 1][1];
-		to[2] = ent->s.origin[2] + bounds[(i >> 0) & 1][2];
-		if( SNAP_Raycast( cms, &trace, vieworg, to ) ) {
-			return false;
-		}
+		VectorCopy( vieworg, rayFrom[numRays] );
+		rayTo[numRays][0] = ent->s.origin[0] + bounds[(i >> 2) & 1][0];
+		rayTo[numRays][1] = ent->s.origin[1] + bounds[(i >> 1) & 1][1];
+		rayTo[numRays][2] = ent->s.origin[2] + bounds[(i >> 0) & 1][2];
+		numRays++;
+	}
+
+	if( SNAP_RaycastBatch( cms, rayFrom, rayTo, numRays ) ) {
+		return false;
 	}
 
 	// There is no need to extrapolate
@@ -718,22 +755,29 @@ static bool SNAP_TryCullClientByRaycasting( cmodel_state_t *cms, edict_t *clent,
 		timestep = 24.0f / sqrtf( squareClientVelocity );
 	}
 
+	numRays = 0;
 	float secondsAhead = 0.0f;
 	while( secondsAhead < xerpTimeSeconds ) {
 		secondsAhead += timestep;
 
-		vec3_t from;
 		vec3_t entOrigin;
 
-		VectorMA( vieworg, secondsAhead, clientVelocity, from );
+		VectorMA( vieworg, secondsAhead, clientVelocity, rayFrom[numRays] );
 		VectorMA( ent->s.origin, secondsAhead, vec3_origin, entOrigin );
 
-		SNAP_GetRandomPointInBox( entOrigin, ent->r.mins, ent->r.size, to );
-		if( SNAP_Raycast( cms, &trace, from, to ) ) {
-			return false;
+		SNAP_GetRandomPointInBox( entOrigin, ent->r.mins, ent->r.size, rayTo[numRays] );
+		if( ++numRays == MAX_SNAP_RAYCAST_BATCH ) {
+			if( SNAP_RaycastBatch( cms, rayFrom, rayTo, numRays ) ) {
+				return false;
+			}
+			numRays = 0;
 		}
 	}
 
+	if( numRays && SNAP_RaycastBatch( cms, rayFrom, rayTo, numRays ) ) {
+		return false;
+	}
+
 	return true;
 }
 
@@ -129,6 +129,16 @@ void QThread_Yield( void ) {
 	Sys_Thread_Yield();
 }
 
+/*
+* QThread_GetNumCPUs
+*
+* Returns the number of logical processors, at least 1.
+*/
+int QThread_GetNumCPUs( void ) {
+	int numCPUs = Sys_Thread_GetNumCPUs();
+	return numCPUs > 0 ? numCPUs : 1;
+}
+
 /*
 * QThreads_Init
 */
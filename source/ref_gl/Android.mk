@@ -13,6 +13,7 @@ LOCAL_SRC_FILES := \
   ../gameshared/q_shared.c \
   ../qalgo/glob.c \
   ../qalgo/hash.c \
+  ../qalgo/md5.c \
   ../qalgo/half_float.c \
   ../qalgo/q_trie.c \
   ../qcommon/bsp.c \
@@ -60,6 +60,10 @@ static int gl_anisotropic_filter = 0;
 static void R_InitImageLoader( int id );
 static void R_ShutdownImageLoader( int id );
 static bool R_LoadAsyncImageFromDisk( image_t *image );
+static void R_InitImageDecoders( void );
+static void R_ShutdownImageDecoders( void );
+static bool R_QueueImageDecode( int pic );
+static void R_FinishDecodingImages( void );
 
 typedef struct {
 	char *name;
@@ -317,8 +321,12 @@ enum {
 static uint8_t *r_screenShotBuffer;
 static size_t r_screenShotBufferSize;
 
-static uint8_t *r_imageBuffers[NUM_QGL_CONTEXTS][NUM_IMAGE_BUFFERS];
-static size_t r_imageBufSize[NUM_QGL_CONTEXTS][NUM_IMAGE_BUFFERS];
+// GL contexts and image decoders each have their own set of scratch buffers
+#define IMAGE_BUFFERS_DECODER   NUM_QGL_CONTEXTS
+#define NUM_IMAGE_BUFFER_SETS   ( IMAGE_BUFFERS_DECODER + MAX_IMAGE_DECODERS )
+
+static uint8_t *r_imageBuffers[NUM_IMAGE_BUFFER_SETS][NUM_IMAGE_BUFFERS];
+static size_t r_imageBufSize[NUM_IMAGE_BUFFER_SETS][NUM_IMAGE_BUFFERS];
 
 #define R_PrepareImageBuffer( ctx,buffer,size ) _R_PrepareImageBuffer( ctx,buffer,size,__FILE__,__LINE__ )
 
@@ -346,7 +354,7 @@ static uint8_t *_R_PrepareImageBuffer( int ctx, int buffer, size_t size,
 void R_FreeImageBuffers( void ) {
 	int i, j;
 
-	for( i = 0; i < NUM_QGL_CONTEXTS; i++ )
+	for( i = 0; i < NUM_IMAGE_BUFFER_SETS; i++ )
 		for( j = 0; j < NUM_IMAGE_BUFFERS; j++ ) {
 			if( r_imageBuffers[i][j] ) {
 				R_Free( r_imageBuffers[i][j] );
@@ -1315,6 +1323,164 @@ static void R_UploadMipmapped( int ctx, uint8_t **data,
 	}
 }
 
+#define MAX_DECODED_MIPLEVELS   16
+
+/*
+* Image data that has been decoded, resampled and mipmapped on a decoder thread,
+* only waiting for the GL upload on a thread that has a context.
+*/
+typedef struct {
+	int width, height;                          // source image
+	int upload_width, upload_height;
+	int samples;
+	int flags;
+	int faces;
+	int mips;
+	char extension[8];
+	uint8_t *data[6 * MAX_DECODED_MIPLEVELS];   // data[face * mips + mip]
+} decodedImage_t;
+
+/*
+* R_PrepareDecodedImage
+*
+* Does all CPU-side work of R_Upload32 for a new 2D texture or cubemap,
+* storing all mip levels in a single allocation that is released after the upload.
+*/
+static decodedImage_t *R_PrepareDecodedImage( int ctx, uint8_t **data, int width, int height,
+											  int flags, int minmipsize, int samples ) {
+	int i, j;
+	int faces, mips;
+	int scaledWidth, scaledHeight;
+	int w, h;
+	size_t faceSize, totalSize;
+	uint8_t *buf, *scratch;
+	decodedImage_t *decoded;
+
+	R_ScaledImageSize( width, height, &scaledWidth, &scaledHeight, flags, 1, minmipsize, false );
+
+	if( flags & IT_CUBEMAP ) {
+		faces = 6;
+	} else {
+		if( flags & ( IT_LEFTHALF | IT_RIGHTHALF ) ) {
+			// assume width represents half of the original image width
+			uint8_t *temp = R_PrepareImageBuffer( ctx, TEXTURE_CUT_BUF, width * height * samples );
+			if( flags & IT_LEFTHALF ) {
+				R_CutImage( *data, width * 2, height, temp, 0, 0, width, height, samples );
+			} else {
+				R_CutImage( *data, width * 2, height, temp, width, 0, width, height, samples );
+			}
+			data = &r_imageBuffers[ctx][TEXTURE_CUT_BUF];
+		}
+
+		if( flags & ( IT_FLIPX | IT_FLIPY | IT_FLIPDIAGONAL ) ) {
+			uint8_t *temp = R_PrepareImageBuffer( ctx, TEXTURE_FLIPPING_BUF0, width * height * samples );
+			R_FlipTexture( data[0], temp, width, height, samples,
+						   ( flags & IT_FLIPX ) ? true : false,
+						   ( flags & IT_FLIPY ) ? true : false,
+						   ( flags & IT_FLIPDIAGONAL ) ? true : false );
+			data = &r_imageBuffers[ctx][TEXTURE_FLIPPING_BUF0];
+		}
+
+		faces = 1;
+	}
+
+	mips = ( flags & IT_NOMIPMAP ) ? 1 : R_MipCount( scaledWidth, scaledHeight, minmipsize );
+	if( mips > MAX_DECODED_MIPLEVELS ) {
+		return NULL;
+	}
+
+	faceSize = 0;
+	for( i = 0, w = scaledWidth, h = scaledHeight; i < mips; i++ ) {
+		faceSize += w * h * samples;
+		w = max( w >> 1, 1 );
+		h = max( h >> 1, 1 );
+	}
+	totalSize = sizeof( decodedImage_t ) + faceSize * faces;
+
+	decoded = R_MallocExt( r_imagesPool, totalSize, 16, 0 );
+	memset( decoded, 0, sizeof( *decoded ) );
+	decoded->width = width;
+	decoded->height = height;
+	decoded->upload_width = scaledWidth;
+	decoded->upload_height = scaledHeight;
+	decoded->samples = samples;
+	decoded->flags = flags;
+	decoded->faces = faces;
+	decoded->mips = mips;
+
+	buf = ( uint8_t * )( decoded + 1 );
+	for( i = 0; i < faces; i++ ) {
+		uint8_t *level = buf;
+
+		R_ResampleTexture( ctx, data[i], width, height, level, scaledWidth, scaledHeight, samples, 1 );
+		decoded->data[i * mips] = level;
+		level += scaledWidth * scaledHeight * samples;
+
+		if( mips > 1 ) {
+			// R_MipMap operates in place, so reduce a copy and store each level
+			scratch = R_PrepareImageBuffer( ctx, TEXTURE_RESAMPLING_BUF0, scaledWidth * scaledHeight * samples );
+			memcpy( scratch, decoded->data[i * mips], scaledWidth * scaledHeight * samples );
+
+			for( j = 1, w = scaledWidth, h = scaledHeight; j < mips; j++ ) {
+				R_MipMap( scratch, w, h, samples, 1 );
+				w = max( w >> 1, 1 );
+				h = max( h >> 1, 1 );
+
+				memcpy( level, scratch, w * h * samples );
+				decoded->data[i * mips + j] = level;
+				level += w * h * samples;
+			}
+		}
+
+		buf += faceSize;
+	}
+
+	return decoded;
+}
+
+/*
+* R_UploadDecodedImage
+*
+* The GL part of loading an image prepared by R_PrepareDecodedImage.
+*/
+static void R_UploadDecodedImage( int ctx, image_t *image, const decodedImage_t *decoded ) {
+	int i, j;
+	int comp, format, type;
+	int target;
+	int w, h;
+
+	image->width = decoded->width;
+	image->height = decoded->height;
+	image->upload_width = decoded->upload_width;
+	image->upload_height = decoded->upload_height;
+	image->samples = decoded->samples;
+	Q_strncpyz( image->extension, decoded->extension, sizeof( image->extension ) );
+
+	R_BindImage( image );
+
+	R_TextureTarget( decoded->flags, &target );
+
+	R_TextureFormat( decoded->flags, decoded->samples, &comp, &format, &type );
+
+	R_SetupTexParameters( decoded->flags, decoded->upload_width, decoded->upload_height, image->minmipsize );
+
+	R_UnpackAlignment( ctx, 1 );
+
+	for( i = 0; i < decoded->faces; i++ ) {
+		w = decoded->upload_width;
+		h = decoded->upload_height;
+		for( j = 0; j < decoded->mips; j++ ) {
+			qglTexImage2D( target + i, j, comp, w, h, 0, format, type, decoded->data[i * decoded->mips + j] );
+			w = max( w >> 1, 1 );
+			h = max( h >> 1, 1 );
+		}
+	}
+
+	// Update IT_LOADFLAGS that may be set by R_ReadImageFromDisk.
+	image->flags = decoded->flags;
+	R_DeferDataSync();
+}
+
 /*
 * R_IsKTXFormatValid
 */
@@ -1610,15 +1776,17 @@ error: // must not be reached after actually starting uploading the texture
 }
 
 /*
-* R_LoadImageFromDisk
+* R_ReadImageFacesFromDisk
+*
+* Reads and decodes the image or all six cubemap faces, without touching GL.
+* The pixel data is stored in the scratch buffers of the given buffer set.
 */
-static bool R_LoadImageFromDisk( int ctx, image_t *image ) {
-	int flags = image->flags;
+static bool R_ReadImageFacesFromDisk( int ctx, image_t *image, uint8_t **pic,
+									  int *width, int *height, int *samples, int *flags,
+									  char *extension, size_t extension_size ) {
 	size_t len = strlen( image->name );
 	char pathname[1024];
 	size_t pathsize = sizeof( pathname );
-	int width = 1, height = 1, samples = 1;
-	bool loaded = false;
 
 	if( len >= pathsize - 7 ) {
 		return false;
@@ -1626,15 +1794,8 @@ static bool R_LoadImageFromDisk( int ctx, image_t *image ) {
 
 	memcpy( pathname, image->name, len + 1 );
 
-	Q_strncatz( pathname, ".ktx", pathsize );
-	if( R_LoadKTX( ctx, image, pathname ) ) {
-		return true;
-	}
-	pathname[len] = 0;
-
-	if( flags & IT_CUBEMAP ) {
+	if( *flags & IT_CUBEMAP ) {
 		int i, j;
-		uint8_t *pic[6];
 		struct cubemapSufAndFlip {
 			char *suf; int flags;
 		} cubemapSides[2][6] = {
@@ -1659,23 +1820,23 @@ static bool R_LoadImageFromDisk( int ctx, image_t *image ) {
 				pathname[len + 3] = 0;
 
 				Q_strncatz( pathname, ".tga", pathsize );
-				samples = R_ReadImageFromDisk( ctx, pathname, pathsize,
-											   &( pic[j] ), &width, &height, &flags, j );
+				*samples = R_ReadImageFromDisk( ctx, pathname, pathsize,
+												&( pic[j] ), width, height, flags, j );
 				if( pic[j] ) {
-					if( width != height ) {
+					if( *width != *height ) {
 						ri.Com_DPrintf( S_COLOR_YELLOW "Not square cubemap image %s\n", pathname );
 						break;
 					}
 					if( !j ) {
-						lastSize = width;
-					} else if( lastSize != width ) {
+						lastSize = *width;
+					} else if( lastSize != *width ) {
 						ri.Com_DPrintf( S_COLOR_YELLOW "Different cubemap image size: %s\n", pathname );
 						break;
 					}
 					if( cbflags & ( IT_FLIPX | IT_FLIPY | IT_FLIPDIAGONAL ) ) {
 						uint8_t *temp = R_PrepareImageBuffer( ctx,
-															  TEXTURE_FLIPPING_BUF0 + j, width * height * samples );
-						R_FlipTexture( pic[j], temp, width, height, 4,
+															  TEXTURE_FLIPPING_BUF0 + j, *width * *height * *samples );
+						R_FlipTexture( pic[j], temp, *width, *height, 4,
 									   ( cbflags & IT_FLIPX ) ? true : false,
 									   ( cbflags & IT_FLIPY ) ? true : false,
 									   ( cbflags & IT_FLIPDIAGONAL ) ? true : false );
@@ -1691,50 +1852,66 @@ static bool R_LoadImageFromDisk( int ctx, image_t *image ) {
 		}
 
 		if( i != 2 ) {
-			image->width = width;
-			image->height = height;
-			image->samples = samples;
-
-			R_BindImage( image );
-
-			R_Upload32( ctx, pic, 0, 0, 0, width, height, flags, image->minmipsize, &image->upload_width,
-						&image->upload_height, samples, false, false );
-
-			Q_strncpyz( image->extension, &pathname[len + 3], sizeof( image->extension ) );
-			loaded = true;
-		} else {
-			ri.Com_DPrintf( S_COLOR_YELLOW "Missing image: %s\n", image->name );
+			Q_strncpyz( extension, &pathname[len + 3], extension_size );
+			return true;
 		}
 	} else {
-		uint8_t *pic = NULL;
+		pic[0] = NULL;
 
 		Q_strncatz( pathname, ".tga", pathsize );
-		samples = R_ReadImageFromDisk( ctx, pathname, pathsize, &pic, &width, &height, &flags, 0 );
+		*samples = R_ReadImageFromDisk( ctx, pathname, pathsize, &pic[0], width, height, flags, 0 );
 
-		if( pic ) {
-			image->width = width;
-			image->height = height;
-			image->samples = samples;
+		if( pic[0] ) {
+			Q_strncpyz( extension, &pathname[len], extension_size );
+			return true;
+		}
+	}
 
-			R_BindImage( image );
+	ri.Com_DPrintf( S_COLOR_YELLOW "Missing image: %s\n", image->name );
+	return false;
+}
+
+/*
+* R_LoadImageFromDisk
+*/
+static bool R_LoadImageFromDisk( int ctx, image_t *image ) {
+	int flags = image->flags;
+	size_t len = strlen( image->name );
+	char pathname[1024];
+	int width = 1, height = 1, samples = 1;
+	uint8_t *pic[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+	char extension[sizeof( image->extension )];
 
-			R_Upload32( ctx, &pic, 0, 0, 0, width, height, flags, image->minmipsize, &image->upload_width,
-						&image->upload_height, samples, false, false );
+	if( len >= sizeof( pathname ) - 7 ) {
+		return false;
+	}
 
-			Q_strncpyz( image->extension, &pathname[len], sizeof( image->extension ) );
-			loaded = true;
-		} else {
-			ri.Com_DPrintf( S_COLOR_YELLOW "Missing image: %s\n", image->name );
-		}
+	Q_snprintfz( pathname, sizeof( pathname ), "%s.ktx", image->name );
+	if( R_LoadKTX( ctx, image, pathname ) ) {
+		return true;
 	}
 
-	if( loaded ) {
-		// Update IT_LOADFLAGS that may be set by R_ReadImageFromDisk.
-		image->flags = flags;
-		R_DeferDataSync();
+	if( !R_ReadImageFacesFromDisk( ctx, image, pic, &width, &height, &samples, &flags,
+								   extension, sizeof( extension ) ) ) {
+		return false;
 	}
 
-	return loaded;
+	image->width = width;
+	image->height = height;
+	image->samples = samples;
+
+	R_BindImage( image );
+
+	R_Upload32( ctx, pic, 0, 0, 0, width, height, flags, image->minmipsize, &image->upload_width,
+				&image->upload_height, samples, false, false );
+
+	Q_strncpyz( image->extension, extension, sizeof( image->extension ) );
+
+	// Update IT_LOADFLAGS that may be set by R_ReadImageFromDisk.
+	image->flags = flags;
+	R_DeferDataSync();
+
+	return true;
 }
 
 /*
@@ -2796,6 +2973,8 @@ void R_InitImages( void ) {
 		R_InitImageLoader( i );
 	}
 
+	R_InitImageDecoders();
+
 	R_InitStretchRawImages();
 	R_InitBuiltinImages();
 }
@@ -2871,6 +3050,8 @@ void R_ShutdownImages( void ) {
 		return;
 	}
 
+	R_ShutdownImageDecoders();
+
 	for( i = 0; i < NUM_LOADER_THREADS; i++ ) {
 		R_ShutdownImageLoader( i );
 	}
@@ -2924,6 +3105,7 @@ enum {
 	CMD_LOADER_INIT,
 	CMD_LOADER_SHUTDOWN,
 	CMD_LOADER_LOAD_PIC,
+	CMD_LOADER_UPLOAD_PIC,
 	CMD_LOADER_DATA_SYNC,
 
 	NUM_LOADER_CMDS
@@ -2940,6 +3122,13 @@ typedef struct {
 	int pic;
 } loaderPicCmd_t;
 
+typedef struct {
+	int id;
+	int self;
+	int pic;
+	decodedImage_t *decoded;
+} loaderUploadCmd_t;
+
 typedef unsigned (*queueCmdHandler_t)( const void * );
 
 static qbufPipe_t *loader_queue[NUM_LOADER_THREADS] = { NULL };
@@ -2948,8 +3137,20 @@ static qthread_t *loader_thread[NUM_LOADER_THREADS] = { NULL };
 static void *loader_gl_context[NUM_LOADER_THREADS] = { NULL };
 static void *loader_gl_surface[NUM_LOADER_THREADS] = { NULL };
 
+// the loader queues are written by the main thread and the decoders
+static qmutex_t *loader_queue_lock;
+
 static void *R_ImageLoaderThreadProc( void *param );
 
+/*
+* R_WriteLoaderCmd
+*/
+static void R_WriteLoaderCmd( int id, const void *cmd, unsigned cmd_size ) {
+	ri.Mutex_Lock( loader_queue_lock );
+	ri.BufPipe_WriteCmd( loader_queue[id], cmd, cmd_size );
+	ri.Mutex_Unlock( loader_queue_lock );
+}
+
 /*
 * R_IssueInitLoaderCmd
 */
@@ -2957,7 +3158,7 @@ static void R_IssueInitLoaderCmd( int id ) {
 	loaderInitCmd_t cmd;
 	cmd.id = CMD_LOADER_INIT;
 	cmd.self = id;
-	ri.BufPipe_WriteCmd( loader_queue[id], &cmd, sizeof( cmd ) );
+	R_WriteLoaderCmd( id, &cmd, sizeof( cmd ) );
 }
 
 /*
@@ -2966,7 +3167,7 @@ static void R_IssueInitLoaderCmd( int id ) {
 static void R_IssueShutdownLoaderCmd( int id ) {
 	int cmd;
 	cmd = CMD_LOADER_SHUTDOWN;
-	ri.BufPipe_WriteCmd( loader_queue[id], &cmd, sizeof( cmd ) );
+	R_WriteLoaderCmd( id, &cmd, sizeof( cmd ) );
 }
 
 /*
@@ -2977,7 +3178,19 @@ static void R_IssueLoadPicLoaderCmd( int id, int pic ) {
 	cmd.id = CMD_LOADER_LOAD_PIC;
 	cmd.self = id;
 	cmd.pic = pic;
-	ri.BufPipe_WriteCmd( loader_queue[id], &cmd, sizeof( cmd ) );
+	R_WriteLoaderCmd( id, &cmd, sizeof( cmd ) );
+}
+
+/*
+* R_IssueUploadPicLoaderCmd
+*/
+static void R_IssueUploadPicLoaderCmd( int id, int pic, decodedImage_t *decoded ) {
+	loaderUploadCmd_t cmd;
+	cmd.id = CMD_LOADER_UPLOAD_PIC;
+	cmd.self = id;
+	cmd.pic = pic;
+	cmd.decoded = decoded;
+	R_WriteLoaderCmd( id, &cmd, sizeof( cmd ) );
 }
 
 /*
@@ -2986,7 +3199,7 @@ static void R_IssueLoadPicLoaderCmd( int id, int pic ) {
 static void R_IssueDataSyncLoaderCmd( int id ) {
 	int cmd;
 	cmd = CMD_LOADER_DATA_SYNC;
-	ri.BufPipe_WriteCmd( loader_queue[id], &cmd, sizeof( cmd ) );
+	R_WriteLoaderCmd( id, &cmd, sizeof( cmd ) );
 }
 
 /*
@@ -3003,6 +3216,10 @@ static void R_InitImageLoader( int id ) {
 		return;
 	}
 
+	if( !loader_queue_lock ) {
+		loader_queue_lock = ri.Mutex_Create();
+	}
+
 	loader_queue[id] = ri.BufPipe_Create( 0x40000, 1 );
 	loader_thread[id] = ri.Thread_Create( R_ImageLoaderThreadProc, loader_queue[id] );
 
@@ -3018,6 +3235,9 @@ static void R_InitImageLoader( int id ) {
 void R_FinishLoadingImages( void ) {
 	int i;
 
+	// all decoded images must be queued for upload before syncing the loaders
+	R_FinishDecodingImages();
+
 	for( i = 0; i < NUM_LOADER_THREADS; i++ ) {
 		if( loader_gl_context[i] ) {
 			R_IssueDataSyncLoaderCmd( i );
@@ -3031,22 +3251,28 @@ void R_FinishLoadingImages( void ) {
 	}
 }
 
+/*
+* R_LoaderForPic
+*/
+static int R_LoaderForPic( int pic ) {
+	int id = pic % NUM_LOADER_THREADS;
+	if( loader_gl_context[id] == NULL ) {
+		id = 0;
+	}
+	return id;
+}
+
 /*
 * R_LoadAsyncImageFromDisk
 */
 static bool R_LoadAsyncImageFromDisk( image_t *image ) {
 	int pic;
-	int id;
 
 	if( loader_gl_context[0] == NULL ) {
 		return false;
 	}
 
 	pic = image - r_images;
-	id = pic % NUM_LOADER_THREADS;
-	if( loader_gl_context[id] == NULL ) {
-		id = 0;
-	}
 
 	image->loaded = false;
 	image->missing = false;
@@ -3058,7 +3284,9 @@ static bool R_LoadAsyncImageFromDisk( image_t *image ) {
 	R_UnbindImage( image );
 	qglFinish();
 
-	R_IssueLoadPicLoaderCmd( id, pic );
+	if( !R_QueueImageDecode( pic ) ) {
+		R_IssueLoadPicLoaderCmd( R_LoaderForPic( pic ), pic );
+	}
 	return true;
 }
 
@@ -3085,6 +3313,13 @@ static void R_ShutdownImageLoader( int id ) {
 	ri.BufPipe_Destroy( &loader_queue[id] );
 
 	GLimp_SharedContext_Destroy( context, surface );
+
+	for( id = 0; id < NUM_LOADER_THREADS; id++ ) {
+		if( loader_gl_context[id] ) {
+			return;
+		}
+	}
+	ri.Mutex_Destroy( &loader_queue_lock );
 }
 
 //
@@ -3137,6 +3372,27 @@ static unsigned R_HandleLoadPicLoaderCmd( void *pcmd ) {
 	return sizeof( *cmd );
 }
 
+/*
+* R_HandleUploadPicLoaderCmd
+*/
+static unsigned R_HandleUploadPicLoaderCmd( void *pcmd ) {
+	loaderUploadCmd_t *cmd = pcmd;
+	image_t *image = r_images + cmd->pic;
+
+	R_UploadDecodedImage( QGL_CONTEXT_LOADER + cmd->self, image, cmd->decoded );
+	R_UnbindImage( image );
+
+	R_Free( cmd->decoded );
+
+	// see R_HandleLoadPicLoaderCmd
+	if( !rsh.registrationOpen ) {
+		qglFinish();
+	}
+	image->loaded = true;
+
+	return sizeof( *cmd );
+}
+
 /*
 * R_HandleDataSyncLoaderCmd
 */
@@ -3165,6 +3421,7 @@ static void *R_ImageLoaderThreadProc( void *param ) {
 		(queueCmdHandler_t)R_HandleInitLoaderCmd,
 		(queueCmdHandler_t)R_HandleShutdownLoaderCmd,
 		(queueCmdHandler_t)R_HandleLoadPicLoaderCmd,
+		(queueCmdHandler_t)R_HandleUploadPicLoaderCmd,
 		(queueCmdHandler_t)R_HandleDataSyncLoaderCmd,
 	};
 
@@ -3172,3 +3429,335 @@ static void *R_ImageLoaderThreadProc( void *param ) {
 
 	return NULL;
 }
+
+// ============================================================================
+
+/*
+* Image decoder pool
+*
+* Decoding, resampling and mipmapping are done by a pool of threads sized to the
+* number of CPU cores, the loader threads owning GL contexts only do the uploads.
+* Each decoder has its own deque of pending images, new images are distributed
+* round-robin and decoders that run out of work steal from the others.
+*/
+
+typedef struct {
+	int self;
+	qthread_t *thread;
+	qmutex_t *lock;
+	int *pics;                  // ring buffer of MAX_GLIMAGES entries
+	unsigned head, tail;        // the owner pops from the tail, thieves take from the head
+} imageDecoder_t;
+
+static imageDecoder_t r_decoders[MAX_IMAGE_DECODERS];
+static int r_numDecoders;
+static unsigned r_nextDecoder;
+
+static qmutex_t *r_decodeLock;
+static qcondvar_t *r_decodeCond;        // signalled when new work is queued or on shutdown
+static qcondvar_t *r_decodeIdleCond;    // signalled when all queued images have been decoded
+static int r_decodeQueued;              // images waiting in the deques
+static int r_decodeInFlight;            // images queued or being decoded
+static bool r_decodeShutdown;
+
+static struct {
+	int64_t registrationTime;
+	uint64_t decodeTime;
+	uint64_t maxDecodeTime;
+	int numDecoded;
+	int numStolen;
+	int maxQueueDepth;
+} r_imageLoadStats;
+
+static void *R_ImageDecoderThreadProc( void *param );
+
+/*
+* R_InitImageDecoders
+*/
+static void R_InitImageDecoders( void ) {
+	int i;
+	imageDecoder_t *decoder;
+
+	r_numDecoders = 0;
+	if( !loader_gl_context[0] ) {
+		return;
+	}
+
+	// leave a core for the main thread
+	r_numDecoders = bound( 1, ri.Thread_GetNumCPUs() - 1, MAX_IMAGE_DECODERS );
+	r_nextDecoder = 0;
+
+	r_decodeLock = ri.Mutex_Create();
+	r_decodeCond = ri.CondVar_Create();
+	r_decodeIdleCond = ri.CondVar_Create();
+	r_decodeQueued = r_decodeInFlight = 0;
+	r_decodeShutdown = false;
+
+	for( i = 0, decoder = r_decoders; i < r_numDecoders; i++, decoder++ ) {
+		decoder->self = i;
+		decoder->lock = ri.Mutex_Create();
+		decoder->pics = R_MallocExt( r_imagesPool, MAX_GLIMAGES * sizeof( *decoder->pics ), 0, 0 );
+		decoder->head = decoder->tail = 0;
+		decoder->thread = ri.Thread_Create( R_ImageDecoderThreadProc, decoder );
+	}
+}
+
+/*
+* R_ShutdownImageDecoders
+*/
+static void R_ShutdownImageDecoders( void ) {
+	int i;
+	imageDecoder_t *decoder;
+
+	if( !r_numDecoders ) {
+		return;
+	}
+
+	R_FinishDecodingImages();
+
+	ri.Mutex_Lock( r_decodeLock );
+	r_decodeShutdown = true;
+	for( i = 0; i < r_numDecoders; i++ ) {
+		ri.CondVar_Wake( r_decodeCond );
+	}
+	ri.Mutex_Unlock( r_decodeLock );
+
+	for( i = 0, decoder = r_decoders; i < r_numDecoders; i++, decoder++ ) {
+		ri.Thread_Join( decoder->thread );
+		decoder->thread = NULL;
+		ri.Mutex_Destroy( &decoder->lock );
+		R_Free( decoder->pics );
+		decoder->pics = NULL;
+	}
+
+	ri.CondVar_Destroy( &r_decodeIdleCond );
+	ri.CondVar_Destroy( &r_decodeCond );
+	ri.Mutex_Destroy( &r_decodeLock );
+
+	r_numDecoders = 0;
+}
+
+/*
+* R_QueueImageDecode
+*
+* Returns false if the image can't be handled by the decoders.
+*/
+static bool R_QueueImageDecode( int pic ) {
+	imageDecoder_t *decoder;
+
+	if( !r_numDecoders ) {
+		return false;
+	}
+
+	decoder = &r_decoders[r_nextDecoder++ % r_numDecoders];
+
+	ri.Mutex_Lock( r_decodeLock );
+	r_decodeInFlight++;
+	ri.Mutex_Unlock( r_decodeLock );
+
+	ri.Mutex_Lock( decoder->lock );
+	decoder->pics[decoder->tail++ % MAX_GLIMAGES] = pic;
+	ri.Mutex_Unlock( decoder->lock );
+
+	ri.Mutex_Lock( r_decodeLock );
+	r_decodeQueued++;
+	if( r_decodeQueued > r_imageLoadStats.maxQueueDepth ) {
+		r_imageLoadStats.maxQueueDepth = r_decodeQueued;
+	}
+	ri.CondVar_Wake( r_decodeCond );
+	ri.Mutex_Unlock( r_decodeLock );
+
+	return true;
+}
+
+/*
+* R_TakeImageDecode
+*
+* Pops an image from the decoder's own deque or steals one from another decoder.
+*/
+static bool R_TakeImageDecode( imageDecoder_t *decoder, int *pic, bool *stolen ) {
+	int i;
+	imageDecoder_t *victim;
+	bool taken = false;
+
+	*stolen = false;
+
+	ri.Mutex_Lock( decoder->lock );
+	if( decoder->head != decoder->tail ) {
+		*pic = decoder->pics[--decoder->tail % MAX_GLIMAGES];
+		taken = true;
+	}
+	ri.Mutex_Unlock( decoder->lock );
+
+	for( i = 1; i < r_numDecoders && !taken; i++ ) {
+		victim = &r_decoders[( decoder->self + i ) % r_numDecoders];
+
+		ri.Mutex_Lock( victim->lock );
+		if( victim->head != victim->tail ) {
+			*pic = victim->pics[victim->head++ % MAX_GLIMAGES];
+			taken = true;
+			*stolen = true;
+		}
+		ri.Mutex_Unlock( victim->lock );
+	}
+
+	if( taken ) {
+		ri.Mutex_Lock( r_decodeLock );
+		r_decodeQueued--;
+		ri.Mutex_Unlock( r_decodeLock );
+	}
+
+	return taken;
+}
+
+/*
+* R_DecodeImage
+*
+* Returns false if the image has to be loaded on a GL context thread instead.
+*/
+static bool R_DecodeImage( int ctx, image_t *image, decodedImage_t **pdecoded ) {
+	int flags = image->flags;
+	int width = 1, height = 1, samples = 1;
+	uint8_t *pic[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+	char pathname[1024];
+	char extension[sizeof( image->extension )];
+	decodedImage_t *decoded;
+
+	*pdecoded = NULL;
+
+	// compressed KTX images are uploaded as they are, see R_LoadKTX
+	if( !( flags & ( IT_FLIPX | IT_FLIPY | IT_FLIPDIAGONAL ) ) ) {
+		Q_snprintfz( pathname, sizeof( pathname ), "%s.ktx", image->name );
+		if( ri.FS_FOpenFile( pathname, NULL, FS_READ ) != -1 ) {
+			return false;
+		}
+	}
+
+	if( !R_ReadImageFacesFromDisk( ctx, image, pic, &width, &height, &samples, &flags,
+								   extension, sizeof( extension ) ) ) {
+		return true;
+	}
+
+	decoded = R_PrepareDecodedImage( ctx, pic, width, height, flags, image->minmipsize, samples );
+	if( !decoded ) {
+		return false;
+	}
+
+	Q_strncpyz( decoded->extension, extension, sizeof( decoded->extension ) );
+	*pdecoded = decoded;
+	return true;
+}
+
+/*
+* R_RunImageDecode
+*/
+static void R_RunImageDecode( imageDecoder_t *decoder, int pic, bool stolen ) {
+	image_t *image = r_images + pic;
+	decodedImage_t *decoded;
+	uint64_t start, time;
+
+	start = ri.Sys_Microseconds();
+
+	if( !R_DecodeImage( IMAGE_BUFFERS_DECODER + decoder->self, image, &decoded ) ) {
+		R_IssueLoadPicLoaderCmd( R_LoaderForPic( pic ), pic );
+	} else if( decoded ) {
+		R_IssueUploadPicLoaderCmd( R_LoaderForPic( pic ), pic, decoded );
+	} else {
+		image->missing = true;
+	}
+
+	time = ri.Sys_Microseconds() - start;
+
+	if( r_showImageLoads->integer > 1 ) {
+		ri.Com_Printf( "Decoded %s in %.2f ms on decoder %i%s\n", image->name,
+					   time * 0.001, decoder->self, stolen ? " (stolen)" : "" );
+	}
+
+	ri.Mutex_Lock( r_decodeLock );
+	r_imageLoadStats.decodeTime += time;
+	if( time > r_imageLoadStats.maxDecodeTime ) {
+		r_imageLoadStats.maxDecodeTime = time;
+	}
+	r_imageLoadStats.numDecoded++;
+	if( stolen ) {
+		r_imageLoadStats.numStolen++;
+	}
+	if( !--r_decodeInFlight ) {
+		ri.CondVar_Wake( r_decodeIdleCond );
+	}
+	ri.Mutex_Unlock( r_decodeLock );
+}
+
+/*
+* R_FinishDecodingImages
+*
+* Blocks until all queued images are decoded and submitted to the loaders.
+*/
+static void R_FinishDecodingImages( void ) {
+	if( !r_numDecoders ) {
+		return;
+	}
+
+	ri.Mutex_Lock( r_decodeLock );
+	while( r_decodeInFlight > 0 ) {
+		ri.CondVar_Wait( r_decodeIdleCond, r_decodeLock, Q_THREADS_WAIT_INFINITE );
+	}
+	ri.Mutex_Unlock( r_decodeLock );
+}
+
+/*
+* R_ImageDecoderThreadProc
+*/
+static void *R_ImageDecoderThreadProc( void *param ) {
+	imageDecoder_t *decoder = param;
+	int pic;
+	bool stolen;
+
+	while( true ) {
+		if( R_TakeImageDecode( decoder, &pic, &stolen ) ) {
+			R_RunImageDecode( decoder, pic, stolen );
+			continue;
+		}
+
+		ri.Mutex_Lock( r_decodeLock );
+		while( !r_decodeQueued && !r_decodeShutdown ) {
+			ri.CondVar_Wait( r_decodeCond, r_decodeLock, Q_THREADS_WAIT_INFINITE );
+		}
+		if( r_decodeShutdown ) {
+			ri.Mutex_Unlock( r_decodeLock );
+			break;
+		}
+		ri.Mutex_Unlock( r_decodeLock );
+	}
+
+	return NULL;
+}
+
+/*
+* R_ResetImageLoadStats
+*/
+void R_ResetImageLoadStats( void ) {
+	memset( &r_imageLoadStats, 0, sizeof( r_imageLoadStats ) );
+	r_imageLoadStats.registrationTime = ri.Sys_Milliseconds();
+}
+
+/*
+* R_PrintImageLoadStats
+*/
+void R_PrintImageLoadStats( void ) {
+	if( !r_showImageLoads->integer ) {
+		return;
+	}
+
+	ri.Com_Printf( "Registration took %" PRIi64 " ms\n", ri.Sys_Milliseconds() - r_imageLoadStats.registrationTime );
+	if( !r_imageLoadStats.numDecoded ) {
+		return;
+	}
+
+	ri.Com_Printf( "%i images decoded by %i decoders, %i stolen, max queue depth %i\n",
+				   r_imageLoadStats.numDecoded, r_numDecoders, r_imageLoadStats.numStolen, r_imageLoadStats.maxQueueDepth );
+	ri.Com_Printf( "Decode time: %.2f ms total, %.2f ms average, %.2f ms max\n",
+				   r_imageLoadStats.decodeTime * 0.001,
+				   r_imageLoadStats.decodeTime * 0.001 / r_imageLoadStats.numDecoded,
+				   r_imageLoadStats.maxDecodeTime * 0.001 );
+}
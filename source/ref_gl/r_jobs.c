@@ -20,158 +20,79 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "r_local.h"
 
-typedef void (*queueCmdHandler_t)( const void * );
-
-enum {
-	CMD_JOB_TAKE,
-	CMD_JOB_QUIT,
+/*
+* Renderer jobs are executed by the engine job system. Job arguments are passed
+* by pointer, so they are copied to a per-frame array which is recycled once
+* all jobs have been finished.
+*/
 
-	NUM_JOB_CMDS
-};
+#define MAX_RENDER_JOBS     1024
 
 typedef struct {
-	int id;
-	unsigned first;
-	unsigned items;
 	jobfunc_t job;
 	jobarg_t job_arg;
-} jobTakeCmd_t;
+} renderJob_t;
 
-static qbufPipe_t *job_queue[NUM_JOB_THREADS] = { NULL };
-static qthread_t *job_thread[NUM_JOB_THREADS] = { NULL };
+static renderJob_t job_list[MAX_RENDER_JOBS];
 static unsigned job_count;
-
-static void RJ_IssueJobTakeCmd( unsigned thread, jobfunc_t job, jobarg_t *arg, unsigned first, unsigned stride );
-static void RJ_IssueJobQuitCmd( unsigned thread );
-static void *R_JobThreadProc( void *param );
+static qjobcounter_t *job_counter;
 
 /*
 * RJ_Init
 */
 void RJ_Init( void ) {
-	int i;
-
 	job_count = 0;
-
-	for( i = 0; i < NUM_JOB_THREADS; i++ ) {
-		job_queue[i] = ri.BufPipe_Create( 0x4000, 1 );
-		job_thread[i] = ri.Thread_Create( R_JobThreadProc, job_queue[i] );
-	}
-}
-
-/*
-* RJ_ScheduleJob
-*/
-void RJ_ScheduleJob( jobfunc_t job, jobarg_t *arg, unsigned items ) {
-	unsigned first;
-	const unsigned block = ( items + NUM_JOB_THREADS - 1 ) / NUM_JOB_THREADS;
-
-	for( first = 0; first < items; ) {
-		unsigned last = first + block;
-		if( last > items ) {
-			last = items;
-		}
-
-		RJ_IssueJobTakeCmd( job_count % NUM_JOB_THREADS, job, arg, first, last - first );
-		job_count++;
-
-		first += last - first;
-	}
+	job_counter = ri.JobCounter_Create();
 }
 
 /*
-* RJ_FinishJobs
+* RJ_RunJob
 */
-void RJ_FinishJobs( void ) {
-	int i;
+static void RJ_RunJob( unsigned first, unsigned items, void *arg ) {
+	renderJob_t *job = arg;
 
-	for( i = 0; i < NUM_JOB_THREADS; i++ )
-		ri.BufPipe_Finish( job_queue[i] );
+	job->job( first, items, &job->job_arg );
 }
 
 /*
-* RJ_Shutdown
+* RJ_ScheduleJob
 */
-void RJ_Shutdown( void ) {
-	int i;
-
-	for( i = 0; i < NUM_JOB_THREADS; i++ ) {
-		RJ_IssueJobQuitCmd( i );
-	}
-
-	RJ_FinishJobs();
+void RJ_ScheduleJob( jobfunc_t job, jobarg_t *arg, unsigned items ) {
+	renderJob_t *rjob;
 
-	for( i = 0; i < NUM_JOB_THREADS; i++ ) {
-		ri.Thread_Join( job_thread[i] );
-		job_thread[i] = NULL;
+	if( !items ) {
+		return;
 	}
 
-	for( i = 0; i < NUM_JOB_THREADS; i++ ) {
-		ri.BufPipe_Destroy( &job_queue[i] );
+	if( job_count == MAX_RENDER_JOBS ) {
+		job( 0, items, arg );
+		return;
 	}
 
-	job_count = 0;
-}
-
-/*
-* RJ_IssueJobTakeCmd
-*/
-static void RJ_IssueJobTakeCmd( unsigned thread, jobfunc_t job, jobarg_t *arg, unsigned first, unsigned items ) {
-	jobTakeCmd_t cmd;
-	cmd.id = CMD_JOB_TAKE;
-	cmd.job = job;
-	cmd.job_arg = *arg;
-	cmd.first = first;
-	cmd.items = items;
-	ri.BufPipe_WriteCmd( job_queue[thread], &cmd, sizeof( cmd ) );
-}
-
-/*
- * RJ_IssueJobQuitCmd
- */
-static void RJ_IssueJobQuitCmd( unsigned thread ) {
-	int cmd = CMD_JOB_QUIT;
-	ri.BufPipe_WriteCmd( job_queue[thread], &cmd, sizeof( cmd ) );
-}
-
-/*
-* R_HandleJobTakeCmd
-*/
-static unsigned R_HandleJobTakeCmd( void *pcmd ) {
-	jobTakeCmd_t *cmd = pcmd;
-
-	cmd->job( cmd->first, cmd->items, &cmd->job_arg );
+	rjob = &job_list[job_count++];
+	rjob->job = job;
+	rjob->job_arg = *arg;
 
-	return sizeof( *cmd );
+	ri.Jobs_ParallelFor( RJ_RunJob, rjob, items, 0, job_counter, NULL );
 }
 
 /*
-* R_HandleJobQuitCmd
+* RJ_FinishJobs
 */
-static unsigned R_HandleJobQuitCmd( void *pcmd ) {
-	return 0;
-}
+void RJ_FinishJobs( void ) {
+	if( !job_counter ) {
+		return;
+	}
 
-/*
-* R_JobCmdsWaiter
-*/
-static int R_JobCmdsWaiter( qbufPipe_t *queue, queueCmdHandler_t *cmdHandlers, bool timeout ) {
-	return ri.BufPipe_ReadCmds( queue, (void *)cmdHandlers );
+	ri.Jobs_Wait( job_counter );
+	job_count = 0;
 }
 
 /*
-* R_JobThreadProc
+* RJ_Shutdown
 */
-static void *R_JobThreadProc( void *param ) {
-	qbufPipe_t *cmdQueue = param;
-	queueCmdHandler_t cmdHandlers[NUM_JOB_CMDS] =
-	{
-		(queueCmdHandler_t)R_HandleJobTakeCmd,
-		(queueCmdHandler_t)R_HandleJobQuitCmd,
-
-	};
-
-	ri.BufPipe_Wait( cmdQueue, (void*)&R_JobCmdsWaiter, (void*)cmdHandlers, Q_THREADS_WAIT_INFINITE );
+void RJ_Shutdown( void ) {
+	RJ_FinishJobs();
 
-	return NULL;
+	ri.JobCounter_Destroy( &job_counter );
 }
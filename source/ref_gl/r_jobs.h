@@ -21,8 +21,6 @@
 #ifndef R_JOBS_H
 #define R_JOBS_H
 
-#define NUM_JOB_THREADS 2
-
 typedef struct {
 	int iarg;
 	unsigned uarg;
@@ -368,6 +368,20 @@ LIGHTMAP ALLOCATION
 
 #define MAX_LIGHTMAP_IMAGES     1024
 
+// number of array layers built in parallel before they're uploaded
+#define LIGHTMAP_BATCH_LAYERS   16
+
+typedef struct {
+	int w, h, samples;
+	bool layers;                // every block is an array layer, deluxemap data follows the lightmap
+	int numColumns;             // blocks per row of the destination image
+	int destWidth;              // size of a row of the destination image in bytes
+	size_t dataStep;            // source data bytes between consecutive blocks
+	size_t destRowStep, destColumnStep;
+	const uint8_t *data;
+	uint8_t *dest;
+} lightmapBuildJob_t;
+
 static uint8_t *r_lightmapBuffer;
 static int r_lightmapBufferSize;
 static image_t *r_lightmapTextures[MAX_LIGHTMAP_IMAGES];
@@ -418,6 +432,31 @@ static void R_BuildLightmap( int w, int h, bool deluxe, const uint8_t *data, uin
 	}
 }
 
+/*
+* R_BuildLightmapsJob
+*/
+static void R_BuildLightmapsJob( unsigned first, unsigned items, jobarg_t *ja ) {
+	unsigned num;
+	const lightmapBuildJob_t *job = ja->parg;
+
+	for( num = first; num < first + items; num++ ) {
+		const uint8_t *data = job->data + num * job->dataStep;
+		uint8_t *dest = job->dest + ( num / job->numColumns ) * job->destRowStep + ( num % job->numColumns ) * job->destColumnStep;
+
+		if( job->layers ) {
+			R_BuildLightmap( job->w, job->h, false, data, dest, job->destWidth, job->samples );
+			if( mapConfig.deluxeMappingEnabled ) {
+				R_BuildLightmap( job->w, job->h, true, data + job->w * job->h * LIGHTMAP_BYTES,
+								 dest + job->w * job->samples, job->destWidth, job->samples );
+			}
+			continue;
+		}
+
+		R_BuildLightmap( job->w, job->h, mapConfig.deluxeMappingEnabled && ( num & 1 ) ? true : false,
+						 data, dest, job->destWidth, job->samples );
+	}
+}
+
 /*
 * R_UploadLightmap
 */
@@ -448,12 +487,13 @@ static int R_UploadLightmap( const char *name, uint8_t *data, int w, int h, int
 static int R_PackLightmaps( int num, int w, int h, int dataSize, int stride, int samples, bool deluxe,
 							const char *name, const uint8_t *data, mlightmapRect_t *rects ) {
 	int i, x, y, root;
-	uint8_t *block;
 	int lightmapNum;
 	int rectX, rectY, rectW, rectH, rectSize;
 	int maxX, maxY, max, xStride;
 	double tw, th, tx, ty;
 	mlightmapRect_t *rect;
+	lightmapBuildJob_t job;
+	jobarg_t ja;
 
 	maxX = r_maxLightmapBlockSize / w;
 	maxY = r_maxLightmapBlockSize / h;
@@ -542,13 +582,24 @@ static int R_PackLightmaps( int num, int w, int h, int dataSize, int stride, int
 
 	ri.Com_DPrintf( "%ix%i : %ix%i\n", rectX, rectY, rectW, rectH );
 
-	block = r_lightmapBuffer;
-	for( y = 0, ty = 0.0, num = 0, rect = rects; y < rectY; y++, ty += th, block += rectX * xStride * h ) {
-		for( x = 0, tx = 0.0; x < rectX; x++, tx += tw, num++, data += dataSize * stride ) {
-			R_BuildLightmap( w, h,
-							 mapConfig.deluxeMappingEnabled && ( num & 1 ) ? true : false,
-							 data, block + x * xStride, rectX * xStride, samples );
-
+	// blocks don't overlap in the destination image so they are built in parallel
+	job.w = w;
+	job.h = h;
+	job.samples = samples;
+	job.layers = false;
+	job.numColumns = rectX;
+	job.destWidth = rectX * xStride;
+	job.dataStep = dataSize * stride;
+	job.destRowStep = rectX * xStride * h;
+	job.destColumnStep = xStride;
+	job.data = data;
+	job.dest = r_lightmapBuffer;
+
+	ja.parg = &job;
+	RJ_ScheduleJob( &R_BuildLightmapsJob, &ja, rectX * rectY );
+
+	for( y = 0, ty = 0.0, num = 0, rect = rects; y < rectY; y++, ty += th ) {
+		for( x = 0, tx = 0.0; x < rectX; x++, tx += tw, num++ ) {
 			// this is not a real texture matrix, but who cares?
 			if( rects ) {
 				rect->texMatrix[0][0] = tw; rect->texMatrix[0][1] = tx;
@@ -558,6 +609,8 @@ static int R_PackLightmaps( int num, int w, int h, int dataSize, int stride, int
 		}
 	}
 
+	RJ_FinishJobs();
+
 	lightmapNum = R_UploadLightmap( name, r_lightmapBuffer, rectW, rectH, samples, deluxe );
 	if( rects ) {
 		for( i = 0, rect = rects; i < num; i++, rect += stride ) {
@@ -604,7 +657,7 @@ void R_BuildLightmaps( model_t *mod, int numLightmaps, int w, int h, const uint8
 	if( mapConfig.lightmapArrays ) {
 		mapConfig.maxLightmapSize = layerWidth;
 
-		size = layerWidth * h;
+		size = layerWidth * h * min( numLightmaps, LIGHTMAP_BATCH_LAYERS );
 	} else {
 		if( !mapConfig.lightmapsPacking ) {
 			size = max( w, h );
@@ -632,11 +685,16 @@ void R_BuildLightmaps( model_t *mod, int numLightmaps, int w, int h, const uint8
 		int numLayers = min( glConfig.maxTextureLayers, 256 ); // layer index is a uint8_t
 		int layer = 0;
 		int lightmapNum = 0;
+		int k, numBatchLayers;
+		int layerSize = layerWidth * h * samples;
 		image_t *image = NULL;
 		mlightmapRect_t *rect = rects;
 		int blockSize = w * h * LIGHTMAP_BYTES;
 		float texScale = 1.0f;
 		char tempbuf[16];
+		lightmapBuildJob_t job;
+		jobarg_t ja;
+		uint8_t *layerData;
 
 		if( mapConfig.deluxeMaps ) {
 			numLightmaps /= 2;
@@ -646,44 +704,61 @@ void R_BuildLightmaps( model_t *mod, int numLightmaps, int w, int h, const uint8
 			texScale = 0.5f;
 		}
 
-		for( i = 0; i < numLightmaps; i++ ) {
-			if( !layer ) {
-				if( r_numUploadedLightmaps == MAX_LIGHTMAP_IMAGES ) {
-					// not sure what I'm supposed to do here.. an unrealistic scenario
-					Com_Printf( S_COLOR_YELLOW "Warning: r_numUploadedLightmaps == MAX_LIGHTMAP_IMAGES\n" );
-					break;
+		job.w = w;
+		job.h = h;
+		job.samples = samples;
+		job.layers = true;
+		job.numColumns = 1;
+		job.destWidth = layerWidth * samples;
+		job.dataStep = blockSize * ( mapConfig.deluxeMaps ? 2 : 1 );
+		job.destRowStep = layerSize;
+		job.destColumnStep = 0;
+		job.dest = r_lightmapBuffer;
+		ja.parg = &job;
+
+		for( i = 0; i < numLightmaps; i += numBatchLayers ) {
+			// build a batch of layers in parallel, uploads have to be done from this thread
+			numBatchLayers = min( numLightmaps - i, LIGHTMAP_BATCH_LAYERS );
+
+			job.data = data;
+			RJ_ScheduleJob( &R_BuildLightmapsJob, &ja, numBatchLayers );
+			RJ_FinishJobs();
+
+			data += numBatchLayers * job.dataStep;
+
+			for( k = 0; k < numBatchLayers; k++ ) {
+				if( !layer ) {
+					if( r_numUploadedLightmaps == MAX_LIGHTMAP_IMAGES ) {
+						// not sure what I'm supposed to do here.. an unrealistic scenario
+						Com_Printf( S_COLOR_YELLOW "Warning: r_numUploadedLightmaps == MAX_LIGHTMAP_IMAGES\n" );
+						numLightmaps = i + k;
+						break;
+					}
+					lightmapNum = r_numUploadedLightmaps++;
+					image = R_Create3DImage( va_r( tempbuf, sizeof( tempbuf ), "*lm%i", lightmapNum ), layerWidth, h,
+											 ( ( i + k + numLayers ) <= numLightmaps ) ? numLayers : numLightmaps % numLayers,
+											 IT_SPECIAL, IMAGE_TAG_GENERIC, samples, true );
+					r_lightmapTextures[lightmapNum] = image;
 				}
-				lightmapNum = r_numUploadedLightmaps++;
-				image = R_Create3DImage( va_r( tempbuf, sizeof( tempbuf ), "*lm%i", lightmapNum ), layerWidth, h,
-										 ( ( i + numLayers ) <= numLightmaps ) ? numLayers : numLightmaps % numLayers,
-										 IT_SPECIAL, IMAGE_TAG_GENERIC, samples, true );
-				r_lightmapTextures[lightmapNum] = image;
-			}
-
-			R_BuildLightmap( w, h, false, data, r_lightmapBuffer, layerWidth * samples, samples );
-			data += blockSize;
-
-			rect->texNum = lightmapNum;
-			rect->texLayer = layer;
-			// this is not a real texture matrix, but who cares?
-			rect->texMatrix[0][0] = texScale; rect->texMatrix[0][1] = 0.0f;
-			rect->texMatrix[1][0] = 1.0f; rect->texMatrix[1][1] = 0.0f;
-			++rect;
 
-			if( mapConfig.deluxeMappingEnabled ) {
-				R_BuildLightmap( w, h, true, data, r_lightmapBuffer + w * samples, layerWidth * samples, samples );
-			}
-
-			if( mapConfig.deluxeMaps ) {
-				data += blockSize;
+				rect->texNum = lightmapNum;
+				rect->texLayer = layer;
+				// this is not a real texture matrix, but who cares?
+				rect->texMatrix[0][0] = texScale; rect->texMatrix[0][1] = 0.0f;
+				rect->texMatrix[1][0] = 1.0f; rect->texMatrix[1][1] = 0.0f;
 				++rect;
-			}
 
-			R_ReplaceImageLayer( image, layer, &r_lightmapBuffer );
+				if( mapConfig.deluxeMaps ) {
+					++rect;
+				}
+
+				layerData = r_lightmapBuffer + k * layerSize;
+				R_ReplaceImageLayer( image, layer, &layerData );
 
-			++layer;
-			if( layer == numLayers ) {
-				layer = 0;
+				++layer;
+				if( layer == numLayers ) {
+					layer = 0;
+				}
 			}
 		}
 	} else {
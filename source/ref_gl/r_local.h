@@ -35,7 +35,9 @@ typedef struct mempool_s mempool_t;
 typedef struct cinematics_s cinematics_t;
 typedef struct qthread_s qthread_t;
 typedef struct qmutex_s qmutex_t;
+typedef struct qcondvar_s qcondvar_t;
 typedef struct qbufPipe_s qbufPipe_t;
+typedef struct qjobcounter_s qjobcounter_t;
 
 typedef unsigned short elem_t;
 
@@ -43,7 +45,8 @@ typedef vec_t instancePoint_t[8]; // quaternion for rotation + xyz pos + uniform
 
 #define NUM_CUSTOMCOLORS        16
 
-#define NUM_LOADER_THREADS      4 // optimal value found by testing, when there are too many, CPU usage may be 100%
+#define NUM_LOADER_THREADS      1 // threads owning a shared GL context, images are decoded by the decoder pool
+#define MAX_IMAGE_DECODERS      16 // the actual number of decoders depends on the number of CPU cores
 
 enum {
 	QGL_CONTEXT_MAIN,
@@ -458,6 +461,9 @@ extern cvar_t *r_maxglslbones;
 extern cvar_t *r_multithreading;
 
 extern cvar_t *r_showShaderCache;
+extern cvar_t *r_shaderIndex;
+
+extern cvar_t *r_showImageLoads;
 
 extern cvar_t *gl_cull;
 
@@ -498,6 +504,8 @@ void        R_RunAllCinematics( void );
 void        R_TouchCinematic( unsigned int id );
 void        R_FreeUnusedCinematics( void );
 void        R_FinishLoadingImages( void );
+void        R_ResetImageLoadStats( void );
+void        R_PrintImageLoadStats( void );
 void        R_UploadCinematic( unsigned int id );
 image_t     *R_GetCinematicImage( unsigned int id );
 struct cinematics_s *R_GetCinematicById( unsigned int id );
@@ -786,6 +794,7 @@ bool        R_SkeletalModelLerpTag( orientation_t *orient, const mskmodel_t *skm
 void        R_InitSkeletalCache( void );
 void        R_ClearSkeletalCache( void );
 void        R_ShutdownSkeletalCache( void );
+void        R_SkeletalBench_f( void );
 
 //
 // r_vbo.c
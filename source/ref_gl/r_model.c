@@ -888,6 +888,8 @@ static void Mod_CreateSkydome( model_t *mod ) {
 * Mod_FinalizeBrushModel
 */
 static void Mod_FinalizeBrushModel( model_t *model ) {
+	uint64_t time = ri.Sys_Microseconds();
+
 	Mod_FinishFaces( model );
 
 	Mod_CreateVisLeafs( model );
@@ -897,6 +899,8 @@ static void Mod_FinalizeBrushModel( model_t *model ) {
 	Mod_SetupSubmodels( model );
 
 	Mod_CreateSkydome( model );
+
+	ri.Com_DPrintf( "%s: finalized in %.2f ms\n", model->name, ( ri.Sys_Microseconds() - time ) * 0.001 );
 }
 
 /*
@@ -976,6 +980,9 @@ void R_InitModels( void ) {
 * Mod_Free
 */
 static void Mod_Free( model_t *model ) {
+	// a map load aborted with an error may have left lump conversion jobs running
+	RJ_FinishJobs();
+
 	R_FreePool( &model->mempool );
 	memset( model, 0, sizeof( *model ) );
 	model->type = mod_free;
@@ -22,7 +22,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "../cgame/ref.h"
 
-#define REF_API_VERSION 24
+#define REF_API_VERSION 27
 
 //
 // these are the functions exported by the refresh module
@@ -82,6 +82,8 @@ typedef struct {
 	bool ( *FS_MoveFile )( const char *src, const char *dst );
 	bool ( *FS_IsUrl )( const char *url );
 	time_t ( *FS_FileMTime )( const char *filename );
+	const char *( *FS_PakNameForFile )( const char *filename );
+	unsigned ( *FS_ChecksumBaseFile )( const char *filename, bool ignorePakChecksum );
 	bool ( *FS_RemoveDirectory )( const char *dirname );
 	const char * ( *FS_GameDirectory )( void );
 	const char * ( *FS_WriteDirectory )( void );
@@ -109,10 +111,15 @@ typedef struct {
 	struct qthread_s *( *Thread_Create )( void *( *routine )( void* ), void *param );
 	void ( *Thread_Join )( struct qthread_s *thread );
 	void ( *Thread_Yield )( void );
+	int ( *Thread_GetNumCPUs )( void );
 	struct qmutex_s *( *Mutex_Create )( void );
 	void ( *Mutex_Destroy )( struct qmutex_s **mutex );
 	void ( *Mutex_Lock )( struct qmutex_s *mutex );
 	void ( *Mutex_Unlock )( struct qmutex_s *mutex );
+	struct qcondvar_s *( *CondVar_Create )( void );
+	void ( *CondVar_Destroy )( struct qcondvar_s **cond );
+	bool ( *CondVar_Wait )( struct qcondvar_s *cond, struct qmutex_s *mutex, unsigned int timeout_msec );
+	void ( *CondVar_Wake )( struct qcondvar_s *cond );
 
 	struct qbufPipe_s *( *BufPipe_Create )( size_t bufSize, int flags );
 	void ( *BufPipe_Destroy )( struct qbufPipe_s **pqueue );
@@ -121,6 +128,16 @@ typedef struct {
 	int ( *BufPipe_ReadCmds )( struct qbufPipe_s *queue, unsigned( **cmdHandlers )( const void * ) );
 	void ( *BufPipe_Wait )( struct qbufPipe_s *queue, int ( *read )( struct qbufPipe_s *, unsigned( ** )( const void * ), bool ),
 							unsigned( **cmdHandlers )( const void * ), unsigned timeout_msec );
+
+	int ( *Jobs_NumWorkers )( void );
+	struct qjobcounter_s *( *JobCounter_Create )( void );
+	void ( *JobCounter_Destroy )( struct qjobcounter_s **pcounter );
+	bool ( *JobCounter_IsDone )( struct qjobcounter_s *counter );
+	void ( *Jobs_Schedule )( void ( *func )( unsigned, unsigned, void * ), void *arg,
+							 struct qjobcounter_s *counter, struct qjobcounter_s *dependency );
+	void ( *Jobs_ParallelFor )( void ( *func )( unsigned, unsigned, void * ), void *arg, unsigned items, unsigned grain,
+								struct qjobcounter_s *counter, struct qjobcounter_s *dependency );
+	void ( *Jobs_Wait )( struct qjobcounter_s *counter );
 } ref_import_t;
 
 typedef struct {
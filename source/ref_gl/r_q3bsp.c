@@ -67,6 +67,22 @@ BRUSHMODEL LOADING
 static uint8_t *mod_base;
 static mbrushmodel_t *loadbmodel;
 
+static uint64_t mod_stageStartTime;
+
+/*
+* Mod_FinishStage
+*
+* Reports time spent in a loading stage to the developer console and starts the next stage.
+*/
+static void Mod_FinishStage( const char *stage ) {
+	uint64_t now = ri.Sys_Microseconds();
+
+	if( stage ) {
+		ri.Com_DPrintf( "%s: %s in %.2f ms\n", loadmodel->name, stage, ( now - mod_stageStartTime ) * 0.001 );
+	}
+	mod_stageStartTime = now;
+}
+
 /*
 * Mod_CheckDeluxemaps
 */
@@ -351,43 +367,18 @@ static void Mod_LoadFaces( const lump_t *l ) {
 }
 
 /*
-* Mod_LoadVertexes
+* Mod_LoadVertexesJob
 */
-static void Mod_LoadVertexes( const lump_t *l ) {
-	int i, count, j;
-	dvertex_t *in;
-	float *out_xyz, *out_normals, *out_st, *out_lmst;
-	uint8_t *buffer, *out_colors;
-	size_t bufSize;
-
-	in = ( void * )( mod_base + l->fileofs );
-	if( l->filelen % sizeof( *in ) ) {
-		ri.Com_Error( ERR_DROP, "Mod_LoadVertexes: funny lump size in %s", loadmodel->name );
-	}
-	count = l->filelen / sizeof( *in );
-
-	bufSize = 0;
-	bufSize += count * ( sizeof( vec3_t ) + sizeof( vec3_t ) + sizeof( vec2_t ) * 2 + sizeof( byte_vec4_t ) );
-	buffer = Mod_Malloc( loadmodel, bufSize );
-
-	loadmodel_numverts = count;
-	loadmodel_xyz_array = ( vec3_t * )buffer; buffer += count * sizeof( vec3_t );
-	loadmodel_normals_array = ( vec3_t * )buffer; buffer += count * sizeof( vec3_t );
-	loadmodel_st_array = ( vec2_t * )buffer; buffer += count * sizeof( vec2_t );
-	loadmodel_lmst_array[0] = ( vec2_t * )buffer; buffer += count * sizeof( vec2_t );
-	loadmodel_colors_array[0] = ( byte_vec4_t * )buffer; buffer += count * sizeof( byte_vec4_t );
-	for( i = 1; i < MAX_LIGHTMAPS; i++ ) {
-		loadmodel_lmst_array[i] = loadmodel_lmst_array[0];
-		loadmodel_colors_array[i] = loadmodel_colors_array[0];
-	}
-
-	out_xyz = loadmodel_xyz_array[0];
-	out_normals = loadmodel_normals_array[0];
-	out_st = loadmodel_st_array[0];
-	out_lmst = loadmodel_lmst_array[0][0];
-	out_colors = loadmodel_colors_array[0][0];
-
-	for( i = 0; i < count; i++, in++, out_xyz += 3, out_normals += 3, out_st += 2, out_lmst += 2, out_colors += 4 ) {
+static void Mod_LoadVertexesJob( unsigned first, unsigned items, jobarg_t *ja ) {
+	unsigned i, j;
+	const dvertex_t *in = ( const dvertex_t * )ja->parg + first;
+	float *out_xyz = loadmodel_xyz_array[first];
+	float *out_normals = loadmodel_normals_array[first];
+	float *out_st = loadmodel_st_array[first];
+	float *out_lmst = loadmodel_lmst_array[0][first];
+	uint8_t *out_colors = loadmodel_colors_array[0][first];
+
+	for( i = 0; i < items; i++, in++, out_xyz += 3, out_normals += 3, out_st += 2, out_lmst += 2, out_colors += 4 ) {
 		for( j = 0; j < 3; j++ ) {
 			out_xyz[j] = LittleFloat( in->point[j] );
 			out_normals[j] = LittleFloat( in->normal[j] );
@@ -417,14 +408,14 @@ static void Mod_LoadVertexes( const lump_t *l ) {
 }
 
 /*
-* Mod_LoadVertexes_RBSP
+* Mod_LoadVertexes
 */
-static void Mod_LoadVertexes_RBSP( const lump_t *l ) {
-	int i, count, j;
-	rdvertex_t *in;
-	float *out_xyz, *out_normals, *out_st, *out_lmst[MAX_LIGHTMAPS];
-	uint8_t *buffer, *out_colors[MAX_LIGHTMAPS];
+static void Mod_LoadVertexes( const lump_t *l ) {
+	int i, count;
+	dvertex_t *in;
+	uint8_t *buffer;
 	size_t bufSize;
+	jobarg_t ja;
 
 	in = ( void * )( mod_base + l->fileofs );
 	if( l->filelen % sizeof( *in ) ) {
@@ -433,27 +424,43 @@ static void Mod_LoadVertexes_RBSP( const lump_t *l ) {
 	count = l->filelen / sizeof( *in );
 
 	bufSize = 0;
-	bufSize += count * ( sizeof( vec3_t ) + sizeof( vec3_t ) + sizeof( vec2_t ) + ( sizeof( vec2_t ) + sizeof( byte_vec4_t ) ) * MAX_LIGHTMAPS );
+	bufSize += count * ( sizeof( vec3_t ) + sizeof( vec3_t ) + sizeof( vec2_t ) * 2 + sizeof( byte_vec4_t ) );
 	buffer = Mod_Malloc( loadmodel, bufSize );
 
 	loadmodel_numverts = count;
 	loadmodel_xyz_array = ( vec3_t * )buffer; buffer += count * sizeof( vec3_t );
 	loadmodel_normals_array = ( vec3_t * )buffer; buffer += count * sizeof( vec3_t );
 	loadmodel_st_array = ( vec2_t * )buffer; buffer += count * sizeof( vec2_t );
-	for( i = 0; i < MAX_LIGHTMAPS; i++ ) {
-		loadmodel_lmst_array[i] = ( vec2_t * )buffer; buffer += count * sizeof( vec2_t );
-		loadmodel_colors_array[i] = ( byte_vec4_t * )buffer; buffer += count * sizeof( byte_vec4_t );
+	loadmodel_lmst_array[0] = ( vec2_t * )buffer; buffer += count * sizeof( vec2_t );
+	loadmodel_colors_array[0] = ( byte_vec4_t * )buffer; buffer += count * sizeof( byte_vec4_t );
+	for( i = 1; i < MAX_LIGHTMAPS; i++ ) {
+		loadmodel_lmst_array[i] = loadmodel_lmst_array[0];
+		loadmodel_colors_array[i] = loadmodel_colors_array[0];
 	}
 
-	out_xyz = loadmodel_xyz_array[0];
-	out_normals = loadmodel_normals_array[0];
-	out_st = loadmodel_st_array[0];
+	// converted in the background, see Mod_LoadQ3BrushModel
+	ja.parg = in;
+	RJ_ScheduleJob( &Mod_LoadVertexesJob, &ja, count );
+}
+
+/*
+* Mod_LoadVertexesJob_RBSP
+*/
+static void Mod_LoadVertexesJob_RBSP( unsigned first, unsigned items, jobarg_t *ja ) {
+	unsigned i, j;
+	const rdvertex_t *in = ( const rdvertex_t * )ja->parg + first;
+	float *out_xyz = loadmodel_xyz_array[first];
+	float *out_normals = loadmodel_normals_array[first];
+	float *out_st = loadmodel_st_array[first];
+	float *out_lmst[MAX_LIGHTMAPS];
+	uint8_t *out_colors[MAX_LIGHTMAPS];
+
 	for( i = 0; i < MAX_LIGHTMAPS; i++ ) {
-		out_lmst[i] = loadmodel_lmst_array[i][0];
-		out_colors[i] = loadmodel_colors_array[i][0];
+		out_lmst[i] = loadmodel_lmst_array[i][first];
+		out_colors[i] = loadmodel_colors_array[i][first];
 	}
 
-	for( i = 0; i < count; i++, in++, out_xyz += 3, out_normals += 3, out_st += 2 ) {
+	for( i = 0; i < items; i++, in++, out_xyz += 3, out_normals += 3, out_st += 2 ) {
 		for( j = 0; j < 3; j++ ) {
 			out_xyz[j] = LittleFloat( in->point[j] );
 			out_normals[j] = LittleFloat( in->normal[j] );
@@ -485,6 +492,40 @@ static void Mod_LoadVertexes_RBSP( const lump_t *l ) {
 	}
 }
 
+/*
+* Mod_LoadVertexes_RBSP
+*/
+static void Mod_LoadVertexes_RBSP( const lump_t *l ) {
+	int i, count;
+	rdvertex_t *in;
+	uint8_t *buffer;
+	size_t bufSize;
+	jobarg_t ja;
+
+	in = ( void * )( mod_base + l->fileofs );
+	if( l->filelen % sizeof( *in ) ) {
+		ri.Com_Error( ERR_DROP, "Mod_LoadVertexes: funny lump size in %s", loadmodel->name );
+	}
+	count = l->filelen / sizeof( *in );
+
+	bufSize = 0;
+	bufSize += count * ( sizeof( vec3_t ) + sizeof( vec3_t ) + sizeof( vec2_t ) + ( sizeof( vec2_t ) + sizeof( byte_vec4_t ) ) * MAX_LIGHTMAPS );
+	buffer = Mod_Malloc( loadmodel, bufSize );
+
+	loadmodel_numverts = count;
+	loadmodel_xyz_array = ( vec3_t * )buffer; buffer += count * sizeof( vec3_t );
+	loadmodel_normals_array = ( vec3_t * )buffer; buffer += count * sizeof( vec3_t );
+	loadmodel_st_array = ( vec2_t * )buffer; buffer += count * sizeof( vec2_t );
+	for( i = 0; i < MAX_LIGHTMAPS; i++ ) {
+		loadmodel_lmst_array[i] = ( vec2_t * )buffer; buffer += count * sizeof( vec2_t );
+		loadmodel_colors_array[i] = ( byte_vec4_t * )buffer; buffer += count * sizeof( byte_vec4_t );
+	}
+
+	// converted in the background, see Mod_LoadQ3BrushModel
+	ja.parg = in;
+	RJ_ScheduleJob( &Mod_LoadVertexesJob_RBSP, &ja, count );
+}
+
 /*
 * Mod_LoadSubmodels
 */
@@ -1243,13 +1284,26 @@ static void Mod_LoadLeafs( const lump_t *l, const lump_t *msLump ) {
 	}
 }
 
+/*
+* Mod_LoadElemsJob
+*/
+static void Mod_LoadElemsJob( unsigned first, unsigned items, jobarg_t *ja ) {
+	unsigned i;
+	const int *in = ( const int * )ja->parg + first;
+	elem_t *out = loadmodel_surfelems + first;
+
+	for( i = 0; i < items; i++ )
+		out[i] = LittleLong( in[i] );
+}
+
 /*
 * Mod_LoadElems
 */
 static void Mod_LoadElems( const lump_t *l ) {
-	int i, count;
+	int count;
 	int *in;
 	elem_t  *out;
+	jobarg_t ja;
 
 	in = ( void * )( mod_base + l->fileofs );
 	if( l->filelen % sizeof( *in ) ) {
@@ -1261,18 +1315,43 @@ static void Mod_LoadElems( const lump_t *l ) {
 	loadmodel_surfelems = out;
 	loadmodel_numsurfelems = count;
 
-	for( i = 0; i < count; i++ )
-		out[i] = LittleLong( in[i] );
+	ja.parg = in;
+	RJ_ScheduleJob( &Mod_LoadElemsJob, &ja, count );
+}
+
+/*
+* Mod_LoadPlanesJob
+*/
+static void Mod_LoadPlanesJob( unsigned first, unsigned items, jobarg_t *ja ) {
+	unsigned i, j;
+	const dplane_t *in = ( const dplane_t * )ja->parg + first;
+	cplane_t *out = loadbmodel->planes + first;
+
+	for( i = 0; i < items; i++, in++, out++ ) {
+		out->type = PLANE_NONAXIAL;
+		out->signbits = 0;
+
+		for( j = 0; j < 3; j++ ) {
+			out->normal[j] = LittleFloat( in->normal[j] );
+			if( out->normal[j] < 0 ) {
+				out->signbits |= 1 << j;
+			}
+			if( out->normal[j] == 1.0f ) {
+				out->type = j;
+			}
+		}
+		out->dist = LittleFloat( in->dist );
+	}
 }
 
 /*
 * Mod_LoadPlanes
 */
 static void Mod_LoadPlanes( const lump_t *l ) {
-	int i, j;
 	cplane_t *out;
 	dplane_t *in;
 	int count;
+	jobarg_t ja;
 
 	in = ( void * )( mod_base + l->fileofs );
 	if( l->filelen % sizeof( *in ) ) {
@@ -1284,20 +1363,29 @@ static void Mod_LoadPlanes( const lump_t *l ) {
 	loadbmodel->planes = out;
 	loadbmodel->numplanes = count;
 
-	for( i = 0; i < count; i++, in++, out++ ) {
-		out->type = PLANE_NONAXIAL;
-		out->signbits = 0;
+	ja.parg = in;
+	RJ_ScheduleJob( &Mod_LoadPlanesJob, &ja, count );
+}
 
+/*
+* Mod_LoadLightgridJob
+*/
+static void Mod_LoadLightgridJob( unsigned first, unsigned items, jobarg_t *ja ) {
+	unsigned i, j;
+	const dgridlight_t *in = ( const dgridlight_t * )ja->parg + first;
+	mgridlight_t *out = loadbmodel->lightgrid + first;
+
+	// lightgrid is all 8 bit
+	for( i = 0; i < items; i++, in++, out++ ) {
+		out->styles[0] = 0;
+		for( j = 1; j < MAX_LIGHTMAPS; j++ )
+			out->styles[j] = 255;
+		out->direction[0] = in->direction[0];
+		out->direction[1] = in->direction[1];
 		for( j = 0; j < 3; j++ ) {
-			out->normal[j] = LittleFloat( in->normal[j] );
-			if( out->normal[j] < 0 ) {
-				out->signbits |= 1 << j;
-			}
-			if( out->normal[j] == 1.0f ) {
-				out->type = j;
-			}
+			out->diffuse[0][j] = in->diffuse[j];
+			out->ambient[0][j] = in->diffuse[j];
 		}
-		out->dist = LittleFloat( in->dist );
 	}
 }
 
@@ -1305,9 +1393,10 @@ static void Mod_LoadPlanes( const lump_t *l ) {
 * Mod_LoadLightgrid
 */
 static void Mod_LoadLightgrid( const lump_t *l ) {
-	int i, j, count;
+	int count;
 	dgridlight_t *in;
 	mgridlight_t *out;
+	jobarg_t ja;
 
 	in = ( void * )( mod_base + l->fileofs );
 	if( l->filelen % sizeof( *in ) ) {
@@ -1319,18 +1408,8 @@ static void Mod_LoadLightgrid( const lump_t *l ) {
 	loadbmodel->lightgrid = out;
 	loadbmodel->numlightgridelems = count;
 
-	// lightgrid is all 8 bit
-	for( i = 0; i < count; i++, in++, out++ ) {
-		out->styles[0] = 0;
-		for( j = 1; j < MAX_LIGHTMAPS; j++ )
-			out->styles[j] = 255;
-		out->direction[0] = in->direction[0];
-		out->direction[1] = in->direction[1];
-		for( j = 0; j < 3; j++ ) {
-			out->diffuse[0][j] = in->diffuse[j];
-			out->ambient[0][j] = in->diffuse[j];
-		}
-	}
+	ja.parg = in;
+	RJ_ScheduleJob( &Mod_LoadLightgridJob, &ja, count );
 }
 
 /*
@@ -1564,6 +1643,17 @@ static void Mod_ApplySuperStylesToFace( const rdface_t *in, msurface_t *out ) {
 	out->superLightStyle = R_AddSuperLightStyle( loadmodel, lightmaps, lightmapStyles, vertexStyles, lmRects );
 }
 
+/*
+* Mod_CreateMeshesJob
+*/
+static void Mod_CreateMeshesJob( unsigned first, unsigned items, jobarg_t *ja ) {
+	unsigned i;
+
+	for( i = first; i < first + items; i++ ) {
+		Mod_CreateMeshForSurface( loadmodel_dsurfaces + i, loadbmodel->surfaces + i, loadmodel_patchgrouprefs[i] );
+	}
+}
+
 /*
 * Mod_Finish
 */
@@ -1573,6 +1663,7 @@ static void Mod_Finish( const lump_t *faces, const lump_t *light, vec3_t gridSiz
 	mfog_t *testFog;
 	bool globalFog;
 	rdface_t *in;
+	jobarg_t ja;
 
 	// remembe the BSP format just in case
 	loadbmodel->format = mod_bspFormat;
@@ -1642,13 +1733,17 @@ static void Mod_Finish( const lump_t *faces, const lump_t *light, vec3_t gridSiz
 
 	R_SortSuperLightStyles( loadmodel );
 
+	// tessellate patches and copy geometry of other surfaces in parallel,
+	// meshes must all be ready before vertex buffer objects are created
+	memset( &ja, 0, sizeof( ja ) );
+	RJ_ScheduleJob( &Mod_CreateMeshesJob, &ja, loadbmodel->numsurfaces );
+	RJ_FinishJobs();
+
 	in = loadmodel_dsurfaces;
 	surf = loadbmodel->surfaces;
 	for( i = 0; i < loadbmodel->numsurfaces; i++, in++, surf++ ) {
 		shader_t *shader;
 
-		Mod_CreateMeshForSurface( in, surf, loadmodel_patchgrouprefs[i] );
-
 		Mod_ApplySuperStylesToFace( in, surf );
 
 		shader = surf->shader;
@@ -1726,16 +1821,14 @@ void Mod_LoadQ3BrushModel( model_t *mod, model_t *parent, void *buffer, bspForma
 	for( i = 0; i < sizeof( dheader_t ) / 4; i++ )
 		( (int *)header )[i] = LittleLong( ( (int *)header )[i] );
 
+	Mod_FinishStage( NULL );
+
 	// load into heap
 	Mod_LoadSubmodels( &header->lumps[LUMP_MODELS] );
-	Mod_LoadVisibility( &header->lumps[LUMP_VISIBILITY] );
-	Mod_LoadEntities( &header->lumps[LUMP_ENTITIES], gridSize, ambient, outline );
-	Mod_LoadLighting( &header->lumps[LUMP_LIGHTING], &header->lumps[LUMP_FACES] );
-	Mod_LoadShaderrefs( &header->lumps[LUMP_SHADERREFS] );
-	Mod_PreloadFaces( &header->lumps[LUMP_FACES] );
+
+	// these only convert lump data, the loaders validate the lumps and allocate
+	// memory right away and leave the conversion to background jobs
 	Mod_LoadPlanes( &header->lumps[LUMP_PLANES] );
-	Mod_LoadFogs( &header->lumps[LUMP_FOGS], &header->lumps[LUMP_BRUSHES], &header->lumps[LUMP_BRUSHSIDES] );
-	Mod_LoadFaces( &header->lumps[LUMP_FACES] );
 	if( mod_bspFormat->flags & BSP_RAVEN ) {
 		Mod_LoadVertexes_RBSP( &header->lumps[LUMP_VERTEXES] );
 	} else {
@@ -1747,6 +1840,24 @@ void Mod_LoadQ3BrushModel( model_t *mod, model_t *parent, void *buffer, bspForma
 	} else {
 		Mod_LoadLightgrid( &header->lumps[LUMP_LIGHTGRID] );
 	}
+
+	Mod_LoadVisibility( &header->lumps[LUMP_VISIBILITY] );
+	Mod_LoadEntities( &header->lumps[LUMP_ENTITIES], gridSize, ambient, outline );
+	Mod_FinishStage( "loaded entities" );
+
+	Mod_LoadLighting( &header->lumps[LUMP_LIGHTING], &header->lumps[LUMP_FACES] );
+	Mod_FinishStage( "built lightmaps" );
+
+	Mod_LoadShaderrefs( &header->lumps[LUMP_SHADERREFS] );
+	Mod_PreloadFaces( &header->lumps[LUMP_FACES] );
+	Mod_FinishStage( "registered shaders" );
+
+	// everything below may access planes, vertices or the lightgrid
+	RJ_FinishJobs();
+	Mod_FinishStage( "waited for lumps" );
+
+	Mod_LoadFogs( &header->lumps[LUMP_FOGS], &header->lumps[LUMP_BRUSHES], &header->lumps[LUMP_BRUSHSIDES] );
+	Mod_LoadFaces( &header->lumps[LUMP_FACES] );
 	Mod_LoadPatchGroups( &header->lumps[LUMP_FACES] );
 	Mod_LoadLeafs( &header->lumps[LUMP_LEAFS], &header->lumps[LUMP_LEAFFACES] );
 	Mod_LoadNodes( &header->lumps[LUMP_NODES] );
@@ -1755,6 +1866,8 @@ void Mod_LoadQ3BrushModel( model_t *mod, model_t *parent, void *buffer, bspForma
 	} else {
 		Mod_LoadLightArray();
 	}
+	Mod_FinishStage( "loaded faces and tree" );
 
 	Mod_Finish( &header->lumps[LUMP_FACES], &header->lumps[LUMP_LIGHTING], gridSize, ambient, outline );
+	Mod_FinishStage( "created meshes" );
 }
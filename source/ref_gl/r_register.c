@@ -132,6 +132,9 @@ cvar_t *gl_cull;
 cvar_t *r_multithreading;
 
 cvar_t *r_showShaderCache;
+cvar_t *r_shaderIndex;
+
+cvar_t *r_showImageLoads;
 
 static bool r_verbose;
 static bool r_postinit;
@@ -1176,6 +1179,10 @@ static void R_Register( const char *screenshotsPrefix ) {
 	r_multithreading = ri.Cvar_Get( "r_multithreading", "1", CVAR_ARCHIVE | CVAR_LATCH_VIDEO );
 
 	r_showShaderCache = ri.Cvar_Get( "r_showShaderCache", "1", CVAR_ARCHIVE );
+	r_shaderIndex = ri.Cvar_Get( "r_shaderIndex", "1", CVAR_ARCHIVE );
+
+	// 1 - print image loading totals at the end of registration, 2 - also print per-image decode times
+	r_showImageLoads = ri.Cvar_Get( "r_showImageLoads", "0", 0 );
 
 	gl_cull = ri.Cvar_Get( "gl_cull", "1", 0 );
 	gl_drawbuffer = ri.Cvar_Get( "gl_drawbuffer", "GL_BACK", 0 );
@@ -1196,6 +1203,7 @@ static void R_Register( const char *screenshotsPrefix ) {
 	ri.Cmd_AddCommand( "gfxinfo", R_GfxInfo_f );
 	ri.Cmd_AddCommand( "glslprogramlist", RP_ProgramList_f );
 	ri.Cmd_AddCommand( "cinlist", R_CinList_f );
+	ri.Cmd_AddCommand( "skinningbench", R_SkeletalBench_f );
 }
 
 /*
@@ -1520,6 +1528,8 @@ static void R_DestroyVolatileAssets( void ) {
 void R_BeginRegistration( void ) {
 	R_FinishLoadingImages();
 
+	R_ResetImageLoadStats();
+
 	R_DestroyVolatileAssets();
 
 	rsh.registrationSequence++;
@@ -1554,6 +1564,8 @@ void R_EndRegistration( void ) {
 	R_FreeUnusedCinematics();
 	R_FreeUnusedImages();
 
+	R_PrintImageLoadStats();
+
 	R_RestartCinematics();
 
 	R_DeferDataSync();
@@ -1574,6 +1586,7 @@ void R_Shutdown( bool verbose ) {
 	ri.Cmd_RemoveCommand( "shaderlist" );
 	ri.Cmd_RemoveCommand( "glslprogramlist" );
 	ri.Cmd_RemoveCommand( "cinlist" );
+	ri.Cmd_RemoveCommand( "skinningbench" );
 
 	// free shaders, models, etc.
 
@@ -23,27 +23,59 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "r_local.h"
 #include "../qalgo/hash.h"
+#include "../qalgo/md5.h"
 
 #define SHADERS_HASH_SIZE   128
 #define SHADERCACHE_HASH_SIZE   128
 
+#define SHADERCACHE_INDEX_FILE_NAME     "cache/shaders.idx"
+#define SHADERCACHE_INDEX_MAGIC         "QSHI"
+#define SHADERCACHE_INDEX_VERSION       1
+
 typedef struct {
 	const char *keyword;
 	void ( *func )( shader_t *shader, shaderpass_t *pass, const char **ptr );
 } shaderkey_t;
 
-typedef struct shadercache_s {
+// a shader script file, its compressed text is only loaded when one of its shaders is requested
+typedef struct shadercachefile_s {
 	char *name;
 	char *buffer;
-	char *filename;
+	size_t size;
+	bool loaded;
+} shadercachefile_t;
+
+typedef struct shadercache_s {
+	char *name;
+	shadercachefile_t *file;
 	size_t offset;
+	size_t length;
 	struct shadercache_s *hash_next;
 } shadercache_t;
 
+// the persisted index, all integers are little endian
+typedef struct {
+	char magic[4];
+	int version;
+	uint8_t digest[16];
+	int numFiles;
+	int numEntries;
+	int stringsSize;
+} shadercacheindexheader_t;
+
+typedef struct {
+	int name;
+	int file;
+	int offset;
+	int length;
+} shadercacheindexentry_t;
+
 static shader_t r_shaders[MAX_SHADERS];
 
 static shader_t r_shaders_hash_headnode[SHADERS_HASH_SIZE], *r_free_shaders;
 static shadercache_t *shadercache_hash[SHADERCACHE_HASH_SIZE];
+static shadercachefile_t *shadercache_files;
+static int shadercache_numfiles;
 
 static deformv_t r_currentDeforms[MAX_SHADER_DEFORMVS];
 static shaderpass_t r_currentPasses[MAX_SHADER_PASSES];
@@ -69,8 +101,9 @@ static char *r_shortShaderName;
 static size_t r_shortShaderNameSize;
 
 static bool Shader_Parsetok( shader_t *shader, shaderpass_t *pass, const shaderkey_t *keys, const char *token, const char **ptr );
-static void Shader_MakeCache( const char *filename );
+static void Shader_MakeCache( shadercachefile_t *file );
 static unsigned int Shader_GetCache( const char *name, shadercache_t **cache );
+static char *Shader_GetCacheText( shadercache_t *cache );
 #define R_FreePassCinematics( pass ) if( ( pass )->cin ) { R_FreeCinematic( ( pass )->cin ); ( pass )->cin = 0; }
 
 //===========================================================================
@@ -859,16 +892,21 @@ static void Shader_Template( shader_t *shader, shaderpass_t *pass, const char **
 	}
 
 	// aha, found it
+	buf = Shader_GetCacheText( cache );
+	if( !buf ) {
+		Com_Printf( S_COLOR_YELLOW "WARNING: shader template %s could not be loaded\n", tmpl );
+		Shader_SkipLine( ptr );
+		return;
+	}
 
 	// find total length
-	buf = cache->buffer + cache->offset;
 	ptr2 = buf;
 	Shader_SkipBlock( (const char **)&ptr2 );
 	length = ptr2 - buf;
 
 	// replace the following char with a EOF
-	backup = cache->buffer[ptr2 - cache->buffer];
-	cache->buffer[ptr2 - cache->buffer] = '\0';
+	backup = *ptr2;
+	*ptr2 = '\0';
 
 	// now count occurences of each argument in a template
 	ptr_backup = *ptr;
@@ -944,7 +982,7 @@ static void Shader_Template( shader_t *shader, shaderpass_t *pass, const char **
 	COM_ParseExt( ptr, true );
 
 	// restore backup char
-	cache->buffer[ptr2 - cache->buffer] = backup;
+	*ptr2 = backup;
 }
 
 static void Shader_Skip( shader_t *shader, shaderpass_t *pass, const char **ptr ) {
@@ -1677,7 +1715,7 @@ void R_PrintShaderList( const char *pattern, bool ( *filter )( const char *filte
 * R_PrintShaderCache
 */
 void R_PrintShaderCache( const char *name ) {
-	char backup, *start;
+	char backup, *start, *end;
 	const char *ptr;
 	shadercache_t *cache;
 
@@ -1687,30 +1725,37 @@ void R_PrintShaderCache( const char *name ) {
 		return;
 	}
 
-	start = cache->buffer + cache->offset;
+	start = Shader_GetCacheText( cache );
+	if( !start ) {
+		Com_Printf( "Could not load shader %s from %s.\n", name, cache->file->name );
+		return;
+	}
 
 	// temporarily hack in the zero-char
 	ptr = start;
 	Shader_SkipBlock( &ptr );
-	backup = cache->buffer[ptr - cache->buffer];
-	cache->buffer[ptr - cache->buffer] = '\0';
+	end = ( char * )ptr;
+	backup = *end;
+	*end = '\0';
 
-	Com_Printf( "Found in %s:\n\n", cache->filename );
+	Com_Printf( "Found in %s:\n\n", cache->file->name );
 	Com_Printf( S_COLOR_YELLOW "%s%s\n", name, start );
 
-	cache->buffer[ptr - cache->buffer] = backup;
+	*end = backup;
 }
 
-static void Shader_MakeCache( const char *filename ) {
+/*
+* Shader_LoadCacheFile
+*
+* Loads and compresses the shader script, offsets of cache entries point into the compressed text.
+*/
+static char *Shader_LoadCacheFile( const char *filename, size_t *psize ) {
 	int size;
-	unsigned int key;
 	char *pathName = NULL;
 	size_t pathNameSize;
-	char *token, *buf, *temp = NULL;
-	const char *ptr;
-	shadercache_t *cache;
-	uint8_t *cacheMemBuf;
-	size_t cacheMemSize;
+	char *buf = NULL, *temp = NULL;
+
+	*psize = 0;
 
 	pathNameSize = strlen( "scripts/" ) + strlen( filename ) + 1;
 	pathName = R_Malloc( pathNameSize );
@@ -1732,8 +1777,30 @@ static void Shader_MakeCache( const char *filename ) {
 
 	buf = R_Malloc( size + 1 );
 	strcpy( buf, temp );
-	R_FreeFile( temp );
-	temp = NULL;
+	*psize = size;
+
+done:
+	if( temp ) {
+		R_FreeFile( temp );
+	}
+	R_Free( pathName );
+	return buf;
+}
+
+static void Shader_MakeCache( shadercachefile_t *file ) {
+	unsigned int key;
+	char *token, *buf;
+	const char *ptr;
+	shadercache_t *cache;
+	uint8_t *cacheMemBuf;
+	size_t cacheMemSize;
+
+	buf = Shader_LoadCacheFile( file->name, &file->size );
+	file->buffer = buf;
+	file->loaded = true;
+	if( !buf ) {
+		return;
+	}
 
 	// calculate buffer size to allocate our cache objects all at once (we may leak
 	// insignificantly here because of duplicate entries)
@@ -1748,8 +1815,7 @@ static void Shader_MakeCache( const char *filename ) {
 	}
 
 	if( !cacheMemSize ) {
-		R_Free( buf );
-		goto done;
+		return;
 	}
 
 	cacheMemBuf = R_Malloc( cacheMemSize );
@@ -1769,26 +1835,37 @@ static void Shader_MakeCache( const char *filename ) {
 		cache = ( shadercache_t * )cacheMemBuf; cacheMemBuf += sizeof( shadercache_t ) + strlen( token ) + 1;
 		cache->hash_next = shadercache_hash[key];
 		cache->name = ( char * )( (uint8_t *)cache + sizeof( shadercache_t ) );
-		cache->filename = NULL;
 		strcpy( cache->name, token );
 		shadercache_hash[key] = cache;
 
 set_path_and_offset:
-		if( cache->filename ) {
-			R_Free( cache->filename );
-		}
-		cache->filename = R_CopyString( filename );
-		cache->buffer = buf;
+		cache->file = file;
 		cache->offset = ptr - buf;
 
 		Shader_SkipBlock( &ptr );
+		cache->length = ptr ? ptr - buf - cache->offset : file->size - cache->offset;
 	}
+}
 
-done:
-	if( temp ) {
-		R_FreeFile( temp );
+/*
+* Shader_GetCacheText
+*
+* Returns the text of the cached shader, loading its script file if needed.
+*/
+static char *Shader_GetCacheText( shadercache_t *cache ) {
+	shadercachefile_t *file = cache->file;
+
+	if( !file->loaded ) {
+		file->buffer = Shader_LoadCacheFile( file->name, &file->size );
+		file->loaded = true;
 	}
-	R_Free( pathName );
+
+	// the script may have changed on disk without the index noticing
+	if( !file->buffer || cache->offset + cache->length > file->size ) {
+		return NULL;
+	}
+
+	return file->buffer + cache->offset;
 }
 
 /*
@@ -1813,6 +1890,170 @@ static unsigned int Shader_GetCache( const char *name, shadercache_t **cache ) {
 	return key;
 }
 
+/*
+* Shader_CacheDigest
+*
+* Hashes names, sizes and modification times of all shader scripts, along with
+* checksums of the pak files they come from.
+*/
+static void Shader_CacheDigest( char **filenames, int numFiles, uint8_t *digest ) {
+	int i, size, filenum;
+	unsigned checksum;
+	int64_t mtime;
+	const char *pakname;
+	char path[MAX_QPATH];
+	md5_state_t md5;
+
+	md5_init( &md5 );
+
+	for( i = 0; i < numFiles; i++ ) {
+		Q_snprintfz( path, sizeof( path ), "scripts/%s", filenames[i] );
+		md5_append( &md5, ( const md5_byte_t * )path, strlen( path ) + 1 );
+
+		size = ri.FS_FOpenFile( path, &filenum, FS_READ );
+		if( size != -1 ) {
+			ri.FS_FCloseFile( filenum );
+		}
+		mtime = ri.FS_FileMTime( path );
+
+		checksum = 0;
+		pakname = ri.FS_PakNameForFile( path );
+		if( pakname ) {
+			checksum = ri.FS_ChecksumBaseFile( pakname, false );
+			md5_append( &md5, ( const md5_byte_t * )pakname, strlen( pakname ) + 1 );
+		}
+
+		md5_append( &md5, ( const md5_byte_t * )&size, sizeof( size ) );
+		md5_append( &md5, ( const md5_byte_t * )&mtime, sizeof( mtime ) );
+		md5_append( &md5, ( const md5_byte_t * )&checksum, sizeof( checksum ) );
+	}
+
+	md5_finish( &md5, digest );
+}
+
+/*
+* Shader_LoadCacheIndex
+*/
+static bool Shader_LoadCacheIndex( const uint8_t *digest ) {
+	int i, size, numEntries, stringsSize;
+	uint8_t *data;
+	char *strings;
+	const shadercacheindexheader_t *header;
+	const shadercacheindexentry_t *in;
+	shadercache_t *entries, *cache;
+	unsigned int key;
+	bool valid = false;
+
+	size = R_LoadCacheFile( SHADERCACHE_INDEX_FILE_NAME, ( void ** )&data );
+	if( !data ) {
+		return false;
+	}
+
+	header = ( const shadercacheindexheader_t * )data;
+	if( size < (int)sizeof( *header ) || memcmp( header->magic, SHADERCACHE_INDEX_MAGIC, sizeof( header->magic ) )
+		|| LittleLong( header->version ) != SHADERCACHE_INDEX_VERSION || memcmp( header->digest, digest, sizeof( header->digest ) )
+		|| LittleLong( header->numFiles ) != shadercache_numfiles ) {
+		goto done;
+	}
+
+	numEntries = LittleLong( header->numEntries );
+	stringsSize = LittleLong( header->stringsSize );
+	if( numEntries <= 0 || stringsSize <= 0
+		|| size != (int)( sizeof( *header ) + numEntries * sizeof( *in ) ) + stringsSize ) {
+		goto done;
+	}
+
+	in = ( const shadercacheindexentry_t * )( header + 1 );
+
+	// entries and their names are allocated all at once, just like when parsing the scripts
+	entries = cache = R_Malloc( numEntries * sizeof( shadercache_t ) + stringsSize );
+	strings = ( char * )( entries + numEntries );
+	memcpy( strings, in + numEntries, stringsSize );
+	strings[stringsSize - 1] = '\0';
+
+	for( i = 0; i < numEntries; i++, in++, cache++ ) {
+		int name = LittleLong( in->name ), file = LittleLong( in->file );
+		int offset = LittleLong( in->offset ), length = LittleLong( in->length );
+
+		if( name < 0 || name >= stringsSize || file < 0 || file >= shadercache_numfiles || offset < 0 || length < 0 ) {
+			memset( shadercache_hash, 0, sizeof( shadercache_hash ) );
+			R_Free( entries );
+			goto done;
+		}
+
+		cache->name = strings + name;
+		cache->file = &shadercache_files[file];
+		cache->offset = offset;
+		cache->length = length;
+
+		key = COM_SuperFastHash( ( const uint8_t * )cache->name, strlen( cache->name ), strlen( cache->name ) ) % SHADERCACHE_HASH_SIZE;
+		cache->hash_next = shadercache_hash[key];
+		shadercache_hash[key] = cache;
+	}
+
+	valid = true;
+
+done:
+	R_FreeFile( data );
+	return valid;
+}
+
+/*
+* Shader_WriteCacheIndex
+*/
+static void Shader_WriteCacheIndex( const uint8_t *digest ) {
+	int i, filenum, numEntries, stringsSize;
+	shadercache_t *cache;
+	shadercacheindexheader_t header;
+	shadercacheindexentry_t entry;
+
+	numEntries = stringsSize = 0;
+	for( i = 0; i < SHADERCACHE_HASH_SIZE; i++ ) {
+		for( cache = shadercache_hash[i]; cache; cache = cache->hash_next ) {
+			numEntries++;
+			stringsSize += strlen( cache->name ) + 1;
+		}
+	}
+
+	if( !numEntries ) {
+		return;
+	}
+
+	if( ri.FS_FOpenFile( SHADERCACHE_INDEX_FILE_NAME, &filenum, FS_WRITE | FS_CACHE ) == -1 ) {
+		Com_Printf( S_COLOR_YELLOW "Could not open %s for writing.\n", SHADERCACHE_INDEX_FILE_NAME );
+		return;
+	}
+
+	memcpy( header.magic, SHADERCACHE_INDEX_MAGIC, sizeof( header.magic ) );
+	header.version = LittleLong( SHADERCACHE_INDEX_VERSION );
+	memcpy( header.digest, digest, sizeof( header.digest ) );
+	header.numFiles = LittleLong( shadercache_numfiles );
+	header.numEntries = LittleLong( numEntries );
+	header.stringsSize = LittleLong( stringsSize );
+	ri.FS_Write( &header, sizeof( header ), filenum );
+
+	stringsSize = 0;
+	for( i = 0; i < SHADERCACHE_HASH_SIZE; i++ ) {
+		for( cache = shadercache_hash[i]; cache; cache = cache->hash_next ) {
+			entry.name = LittleLong( stringsSize );
+			entry.file = LittleLong( (int)( cache->file - shadercache_files ) );
+			entry.offset = LittleLong( (int)cache->offset );
+			entry.length = LittleLong( (int)cache->length );
+			ri.FS_Write( &entry, sizeof( entry ), filenum );
+
+			stringsSize += strlen( cache->name ) + 1;
+		}
+	}
+
+	for( i = 0; i < SHADERCACHE_HASH_SIZE; i++ ) {
+		for( cache = shadercache_hash[i]; cache; cache = cache->hash_next ) {
+			ri.FS_Write( cache->name, strlen( cache->name ) + 1, filenum );
+		}
+	}
+
+	ri.FS_FCloseFile( filenum );
+}
+
 /*
 * R_PrecacheShaders
 */
@@ -1823,6 +2064,11 @@ static void R_InitShadersCache( void ) {
 	const char *fileptr;
 	char shaderPaths[1024];
 	const char *dirs[3] = { "<scripts", ">scripts", "scripts" };
+	char **filenames;
+	int numfilenames;
+	uint8_t digest[16];
+	bool indexed;
+	uint64_t start;
 
 	r_shaderTemplateBuf = NULL;
 
@@ -1831,6 +2077,11 @@ static void R_InitShadersCache( void ) {
 	if ( r_showShaderCache && r_showShaderCache->integer )
 		Com_Printf( "Initializing Shaders:\n" );
 
+	start = ri.Sys_Microseconds();
+
+	// gather the list of scripts first, so it can be checked against the index
+	filenames = NULL;
+	numfilenames = 0;
 	numfiles_total = 0;
 	for( d = 0; d < 3; d++ ) {
 		if( d == 2 ) {
@@ -1844,8 +2095,12 @@ static void R_InitShadersCache( void ) {
 		// enumerate shaders
 		numfiles = ri.FS_GetFileList( dirs[d], ".shader", NULL, 0, 0, 0 );
 		numfiles_total += numfiles;
+		if( !numfiles ) {
+			continue;
+		}
+
+		filenames = R_Realloc( filenames, ( numfilenames + numfiles ) * sizeof( *filenames ) );
 
-		// now load them all
 		for( i = 0; i < numfiles; i += k ) {
 			if( ( k = ri.FS_GetFileList( dirs[d], ".shader", shaderPaths, sizeof( shaderPaths ), i, numfiles ) ) == 0 ) {
 				k = 1; // advance by one file
@@ -1854,7 +2109,7 @@ static void R_InitShadersCache( void ) {
 
 			fileptr = shaderPaths;
 			for( j = 0; j < k; j++ ) {
-				Shader_MakeCache( fileptr );
+				filenames[numfilenames++] = R_CopyString( fileptr );
 
 				fileptr += strlen( fileptr ) + 1;
 				if( !*fileptr ) {
@@ -1868,10 +2123,38 @@ static void R_InitShadersCache( void ) {
 		ri.Com_Error( ERR_DROP, "Could not find any shaders!" );
 	}
 
+	shadercache_numfiles = numfilenames;
+	shadercache_files = R_Malloc( numfilenames * sizeof( shadercachefile_t ) );
+	for( i = 0; i < numfilenames; i++ ) {
+		shadercache_files[i].name = filenames[i];
+		shadercache_files[i].buffer = NULL;
+		shadercache_files[i].size = 0;
+		shadercache_files[i].loaded = false;
+	}
+
+	indexed = false;
+	if( r_shaderIndex->integer ) {
+		Shader_CacheDigest( filenames, numfilenames, digest );
+		indexed = Shader_LoadCacheIndex( digest );
+	}
+
+	if( !indexed ) {
+		// later scripts override shaders of the same name from earlier ones
+		for( i = 0; i < numfilenames; i++ ) {
+			Shader_MakeCache( &shadercache_files[i] );
+		}
+
+		if( r_shaderIndex->integer ) {
+			Shader_WriteCacheIndex( digest );
+		}
+	}
+
+	R_Free( filenames );
+
 	if ( r_showShaderCache && r_showShaderCache->integer )
 		Com_Printf( "--------------------------------------\n" );
-	else
-		Com_Printf( "Shaders Initialized.\n" );
+	Com_Printf( "Shaders Initialized %s in %.1f ms.\n", indexed ? "from index" : "from scripts",
+		( ri.Sys_Microseconds() - start ) * 0.001 );
 }
 
 /*
@@ -2045,6 +2328,8 @@ void R_ShutdownShaders( void ) {
 	r_shortShaderNameSize = 0;
 
 	memset( shadercache_hash, 0, sizeof( shadercache_hash ) );
+	shadercache_files = NULL;
+	shadercache_numfiles = 0;
 }
 
 static void Shader_Readpass( shader_t *shader, const char **ptr ) {
@@ -2866,7 +3151,7 @@ shader_t *R_LoadShader( const char *name, shaderType_e type, bool forceDefault,
 
 		// shader is in the shader scripts
 		if( cache ) {
-			text = cache->buffer + cache->offset;
+			text = Shader_GetCacheText( cache );
 			ri.Com_DPrintf( "Loading shader %s from cache...\n", shortname );
 		}
 	}
@@ -23,6 +23,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "r_local.h"
 #include "iqm.h"
 
+#if defined( QF_SSE2 )
+#define SKM_SIMD_SSE2
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#define SKM_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
 // typedefs
 typedef struct iqmheader iqmheader_t;
 typedef struct iqmvertexarray iqmvertexarray_t;
@@ -1096,9 +1103,9 @@ void R_ShutdownSkeletalCache( void ) {
 #endif
 
 /*
-* R_SkeletalBlendPoses
+* R_SkeletalBlendPoses_Generic
 */
-static void R_SkeletalBlendPoses( unsigned int numblends, mskblend_t *blends, unsigned int numbones, mat4_t *relbonepose ) {
+static void R_SkeletalBlendPoses_Generic( unsigned int numblends, mskblend_t *blends, unsigned int numbones, mat4_t *relbonepose ) {
 	unsigned int i, j, k;
 	float *pose;
 	mskblend_t *blend;
@@ -1129,9 +1136,9 @@ static void R_SkeletalBlendPoses( unsigned int numblends, mskblend_t *blends, un
 }
 
 /*
-* R_SkeletalTransformVerts
+* R_SkeletalTransformVerts_Generic
 */
-static void R_SkeletalTransformVerts( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov ) {
+static void R_SkeletalTransformVerts_Generic( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov ) {
 	const float *pose;
 
 	for( ; numverts; numverts--, v += 4, ov += 4, blends++ ) {
@@ -1145,9 +1152,9 @@ static void R_SkeletalTransformVerts( int numverts, const unsigned int *blends,
 }
 
 /*
-* R_SkeletalTransformNormals
+* R_SkeletalTransformNormals_Generic
 */
-static void R_SkeletalTransformNormals( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov ) {
+static void R_SkeletalTransformNormals_Generic( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov ) {
 	const float *pose;
 
 	for( ; numverts; numverts--, v += 4, ov += 4, blends++ ) {
@@ -1161,9 +1168,9 @@ static void R_SkeletalTransformNormals( int numverts, const unsigned int *blends
 }
 
 /*
-* R_SkeletalTransformNormalsAndSVecs
+* R_SkeletalTransformNormalsAndSVecs_Generic
 */
-static void R_SkeletalTransformNormalsAndSVecs( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov, const vec_t *sv, vec_t *osv ) {
+static void R_SkeletalTransformNormalsAndSVecs_Generic( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov, const vec_t *sv, vec_t *osv ) {
 	const float *pose;
 
 	for( ; numverts; numverts--, v += 4, ov += 4, sv += 4, osv += 4, blends++ ) {
@@ -1181,6 +1188,208 @@ static void R_SkeletalTransformNormalsAndSVecs( int numverts, const unsigned int
 	}
 }
 
+#if defined( SKM_SIMD_SSE2 )
+
+// each vertex references its own matrix, so the kernels below broadcast
+// the vertex components and accumulate the matrix columns instead
+
+/*
+* R_SkeletalBlendPoses_SIMD
+*/
+static void R_SkeletalBlendPoses_SIMD( unsigned int numblends, mskblend_t *blends, unsigned int numbones, mat4_t *relbonepose ) {
+	unsigned int i, j, k;
+	const float *b;
+	float *pose;
+	__m128 f, c0, c1, c2, c3;
+	mskblend_t *blend;
+
+	for( i = 0, j = numbones, blend = blends; i < numblends; i++, j++, blend++ ) {
+		pose = relbonepose[j];
+
+		b = relbonepose[blend->indices[0]];
+		f = _mm_set1_ps( blend->weights[0] * ( 1.0 / 255.0 ) );
+
+		c0 = _mm_mul_ps( f, _mm_loadu_ps( b +  0 ) );
+		c1 = _mm_mul_ps( f, _mm_loadu_ps( b +  4 ) );
+		c2 = _mm_mul_ps( f, _mm_loadu_ps( b +  8 ) );
+		c3 = _mm_mul_ps( f, _mm_loadu_ps( b + 12 ) );
+
+		for( k = 1; k < SKM_MAX_WEIGHTS && blend->weights[k]; k++ ) {
+			b = relbonepose[blend->indices[k]];
+			f = _mm_set1_ps( blend->weights[k] * ( 1.0 / 255.0 ) );
+
+			c0 = _mm_add_ps( c0, _mm_mul_ps( f, _mm_loadu_ps( b +  0 ) ) );
+			c1 = _mm_add_ps( c1, _mm_mul_ps( f, _mm_loadu_ps( b +  4 ) ) );
+			c2 = _mm_add_ps( c2, _mm_mul_ps( f, _mm_loadu_ps( b +  8 ) ) );
+			c3 = _mm_add_ps( c3, _mm_mul_ps( f, _mm_loadu_ps( b + 12 ) ) );
+		}
+
+		_mm_storeu_ps( pose +  0, c0 );
+		_mm_storeu_ps( pose +  4, c1 );
+		_mm_storeu_ps( pose +  8, c2 );
+		_mm_storeu_ps( pose + 12, c3 );
+	}
+}
+
+/*
+* R_SkeletalRotate_SSE2
+*/
+static inline __m128 R_SkeletalRotate_SSE2( __m128 v, const float *pose ) {
+	__m128 r;
+
+	r = _mm_add_ps( _mm_mul_ps( _mm_shuffle_ps( v, v, _MM_SHUFFLE( 0, 0, 0, 0 ) ), _mm_loadu_ps( pose + 0 ) ),
+					_mm_mul_ps( _mm_shuffle_ps( v, v, _MM_SHUFFLE( 1, 1, 1, 1 ) ), _mm_loadu_ps( pose + 4 ) ) );
+	return _mm_add_ps( r, _mm_mul_ps( _mm_shuffle_ps( v, v, _MM_SHUFFLE( 2, 2, 2, 2 ) ), _mm_loadu_ps( pose + 8 ) ) );
+}
+
+/*
+* R_SkeletalTransformVerts_SIMD
+*/
+static void R_SkeletalTransformVerts_SIMD( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov ) {
+	const __m128 xyzmask = _mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) );
+	const __m128 w1 = _mm_set_ps( 1, 0, 0, 0 );
+	const float *pose;
+	__m128 r;
+
+	for( ; numverts; numverts--, v += 4, ov += 4, blends++ ) {
+		pose = relbonepose[*blends];
+
+		r = _mm_add_ps( R_SkeletalRotate_SSE2( _mm_loadu_ps( v ), pose ), _mm_loadu_ps( pose + 12 ) );
+		_mm_storeu_ps( ov, _mm_or_ps( _mm_and_ps( r, xyzmask ), w1 ) );
+	}
+}
+
+/*
+* R_SkeletalTransformNormals_SIMD
+*/
+static void R_SkeletalTransformNormals_SIMD( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov ) {
+	const __m128 xyzmask = _mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) );
+
+	for( ; numverts; numverts--, v += 4, ov += 4, blends++ ) {
+		_mm_storeu_ps( ov, _mm_and_ps( R_SkeletalRotate_SSE2( _mm_loadu_ps( v ), relbonepose[*blends] ), xyzmask ) );
+	}
+}
+
+/*
+* R_SkeletalTransformNormalsAndSVecs_SIMD
+*/
+static void R_SkeletalTransformNormalsAndSVecs_SIMD( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov, const vec_t *sv, vec_t *osv ) {
+	const __m128 xyzmask = _mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) );
+	const float *pose;
+	__m128 s;
+
+	for( ; numverts; numverts--, v += 4, ov += 4, sv += 4, osv += 4, blends++ ) {
+		pose = relbonepose[*blends];
+
+		_mm_storeu_ps( ov, _mm_and_ps( R_SkeletalRotate_SSE2( _mm_loadu_ps( v ), pose ), xyzmask ) );
+
+		// keep the sign of the bitangent in w
+		s = _mm_loadu_ps( sv );
+		_mm_storeu_ps( osv, _mm_or_ps( _mm_and_ps( R_SkeletalRotate_SSE2( s, pose ), xyzmask ), _mm_andnot_ps( xyzmask, s ) ) );
+	}
+}
+
+#elif defined( SKM_SIMD_NEON )
+
+/*
+* R_SkeletalBlendPoses_SIMD
+*/
+static void R_SkeletalBlendPoses_SIMD( unsigned int numblends, mskblend_t *blends, unsigned int numbones, mat4_t *relbonepose ) {
+	unsigned int i, j, k;
+	const float *b;
+	float *pose, f;
+	float32x4_t c0, c1, c2, c3;
+	mskblend_t *blend;
+
+	for( i = 0, j = numbones, blend = blends; i < numblends; i++, j++, blend++ ) {
+		pose = relbonepose[j];
+
+		b = relbonepose[blend->indices[0]];
+		f = blend->weights[0] * ( 1.0 / 255.0 );
+
+		c0 = vmulq_n_f32( vld1q_f32( b +  0 ), f );
+		c1 = vmulq_n_f32( vld1q_f32( b +  4 ), f );
+		c2 = vmulq_n_f32( vld1q_f32( b +  8 ), f );
+		c3 = vmulq_n_f32( vld1q_f32( b + 12 ), f );
+
+		for( k = 1; k < SKM_MAX_WEIGHTS && blend->weights[k]; k++ ) {
+			b = relbonepose[blend->indices[k]];
+			f = blend->weights[k] * ( 1.0 / 255.0 );
+
+			c0 = vmlaq_n_f32( c0, vld1q_f32( b +  0 ), f );
+			c1 = vmlaq_n_f32( c1, vld1q_f32( b +  4 ), f );
+			c2 = vmlaq_n_f32( c2, vld1q_f32( b +  8 ), f );
+			c3 = vmlaq_n_f32( c3, vld1q_f32( b + 12 ), f );
+		}
+
+		vst1q_f32( pose +  0, c0 );
+		vst1q_f32( pose +  4, c1 );
+		vst1q_f32( pose +  8, c2 );
+		vst1q_f32( pose + 12, c3 );
+	}
+}
+
+/*
+* R_SkeletalRotate_NEON
+*/
+static inline float32x4_t R_SkeletalRotate_NEON( const float *v, const float *pose ) {
+	float32x4_t r;
+
+	r = vmulq_n_f32( vld1q_f32( pose + 0 ), v[0] );
+	r = vmlaq_n_f32( r, vld1q_f32( pose + 4 ), v[1] );
+	return vmlaq_n_f32( r, vld1q_f32( pose + 8 ), v[2] );
+}
+
+/*
+* R_SkeletalTransformVerts_SIMD
+*/
+static void R_SkeletalTransformVerts_SIMD( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov ) {
+	const float *pose;
+
+	for( ; numverts; numverts--, v += 4, ov += 4, blends++ ) {
+		pose = relbonepose[*blends];
+
+		vst1q_f32( ov, vsetq_lane_f32( 1.0f, vaddq_f32( R_SkeletalRotate_NEON( v, pose ), vld1q_f32( pose + 12 ) ), 3 ) );
+	}
+}
+
+/*
+* R_SkeletalTransformNormals_SIMD
+*/
+static void R_SkeletalTransformNormals_SIMD( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov ) {
+	for( ; numverts; numverts--, v += 4, ov += 4, blends++ ) {
+		vst1q_f32( ov, vsetq_lane_f32( 0.0f, R_SkeletalRotate_NEON( v, relbonepose[*blends] ), 3 ) );
+	}
+}
+
+/*
+* R_SkeletalTransformNormalsAndSVecs_SIMD
+*/
+static void R_SkeletalTransformNormalsAndSVecs_SIMD( int numverts, const unsigned int *blends, mat4_t *relbonepose, const vec_t *v, vec_t *ov, const vec_t *sv, vec_t *osv ) {
+	const float *pose;
+
+	for( ; numverts; numverts--, v += 4, ov += 4, sv += 4, osv += 4, blends++ ) {
+		pose = relbonepose[*blends];
+
+		vst1q_f32( ov, vsetq_lane_f32( 0.0f, R_SkeletalRotate_NEON( v, pose ), 3 ) );
+		vst1q_f32( osv, vsetq_lane_f32( sv[3], R_SkeletalRotate_NEON( sv, pose ), 3 ) );
+	}
+}
+
+#endif
+
+#if defined( SKM_SIMD_SSE2 ) || defined( SKM_SIMD_NEON )
+#define R_SkeletalBlendPoses                R_SkeletalBlendPoses_SIMD
+#define R_SkeletalTransformVerts            R_SkeletalTransformVerts_SIMD
+#define R_SkeletalTransformNormals          R_SkeletalTransformNormals_SIMD
+#define R_SkeletalTransformNormalsAndSVecs  R_SkeletalTransformNormalsAndSVecs_SIMD
+#else
+#define R_SkeletalBlendPoses                R_SkeletalBlendPoses_Generic
+#define R_SkeletalTransformVerts            R_SkeletalTransformVerts_Generic
+#define R_SkeletalTransformNormals          R_SkeletalTransformNormals_Generic
+#define R_SkeletalTransformNormalsAndSVecs  R_SkeletalTransformNormalsAndSVecs_Generic
+#endif
+
 // set the FP precision back to whatever value it was
 #if defined ( _WIN32 ) && ( _MSC_VER >= 1400 ) && defined( NDEBUG )
 # pragma float_control(pop)
@@ -1612,3 +1821,196 @@ bool R_AddSkeletalModelToDrawList( const entity_t *e ) {
 
 	return true;
 }
+
+//=======================================================================
+
+#if defined( SKM_SIMD_SSE2 ) || defined( SKM_SIMD_NEON )
+
+#define SKM_BENCH_EPSILON   1e-4f
+
+static const char *r_skmBenchModels[] = {
+	"bigvic", "bobot", "monada", "padpork", "silverclaw"
+};
+
+/*
+* R_SkeletalBenchCompare
+*
+* Returns the largest difference between two arrays, relative to the magnitude of the values.
+*/
+static float R_SkeletalBenchCompare( const float *a, const float *b, unsigned count, unsigned stride, unsigned numcomps ) {
+	unsigned i, j;
+	float d, maxerr = 0;
+
+	for( i = 0; i < count; i++, a += stride, b += stride ) {
+		for( j = 0; j < numcomps; j++ ) {
+			d = fabs( a[j] - b[j] ) / max( 1.0f, fabs( a[j] ) );
+			if( d > maxerr || d != d ) {
+				maxerr = d;
+			}
+		}
+	}
+
+	return maxerr;
+}
+
+/*
+* R_SkeletalBenchModel
+*/
+static bool R_SkeletalBenchModel( const char *name, int iterations ) {
+	int it;
+	unsigned i, frame, maxverts, numposes;
+	model_t *mod;
+	mskmodel_t *skmodel;
+	mskmesh_t *mesh;
+	bonepose_t *abspose;
+	mat4_t *poses[2];
+	vec4_t *xyz[2], *normals[2], *svecs[2];
+	uint64_t t, blendTime[2], skinTime[2];
+	float err, blendErr, skinErr;
+	uint8_t *buffer;
+
+	mod = R_RegisterModel( name );
+	if( !mod || mod->type != mod_skeletal ) {
+		ri.Com_Printf( "%s: not a skeletal model\n", name );
+		return true;
+	}
+
+	skmodel = ( mskmodel_t * )mod->extradata;
+	if( !skmodel->numbones || !skmodel->numframes ) {
+		ri.Com_Printf( "%s: no animation data\n", name );
+		return true;
+	}
+
+	maxverts = 0;
+	for( i = 0, mesh = skmodel->meshes; i < skmodel->nummeshes; i++, mesh++ ) {
+		maxverts = max( maxverts, mesh->numverts );
+	}
+
+	numposes = skmodel->numbones + skmodel->numblends;
+	buffer = R_Malloc( sizeof( bonepose_t ) * skmodel->numbones + sizeof( mat4_t ) * numposes * 2 + sizeof( vec4_t ) * maxverts * 6 );
+	poses[0] = ( mat4_t * )buffer;
+	poses[1] = poses[0] + numposes;
+	xyz[0] = ( vec4_t * )( poses[1] + numposes );
+	xyz[1] = xyz[0] + maxverts;
+	normals[0] = xyz[1] + maxverts;
+	normals[1] = normals[0] + maxverts;
+	svecs[0] = normals[1] + maxverts;
+	svecs[1] = svecs[0] + maxverts;
+	abspose = ( bonepose_t * )( svecs[1] + maxverts );
+
+	// pose the model in the middle of its animation, the same way R_CacheBoneTransformsJob does
+	frame = skmodel->numframes / 2;
+	for( i = 0; i < skmodel->numbones; i++ ) {
+		const bonepose_t *bp = skmodel->frames[frame].boneposes + i;
+
+		if( skmodel->bones[i].parent >= 0 ) {
+			DualQuat_Multiply( abspose[skmodel->bones[i].parent].dualquat, bp->dualquat, abspose[i].dualquat );
+		} else {
+			DualQuat_Copy( bp->dualquat, abspose[i].dualquat );
+		}
+	}
+
+	for( i = 0; i < skmodel->numbones; i++ ) {
+		dualquat_t dq;
+
+		DualQuat_Multiply( abspose[i].dualquat, skmodel->invbaseposes[i].dualquat, dq );
+		DualQuat_Normalize( dq );
+		Matrix4_FromDualQuaternion( dq, poses[0][i] );
+		Matrix4_Copy( poses[0][i], poses[1][i] );
+	}
+
+	t = ri.Sys_Microseconds();
+	for( it = 0; it < iterations; it++ ) {
+		R_SkeletalBlendPoses_Generic( skmodel->numblends, skmodel->blends, skmodel->numbones, poses[0] );
+	}
+	blendTime[0] = ri.Sys_Microseconds() - t;
+
+	t = ri.Sys_Microseconds();
+	for( it = 0; it < iterations; it++ ) {
+		R_SkeletalBlendPoses_SIMD( skmodel->numblends, skmodel->blends, skmodel->numbones, poses[1] );
+	}
+	blendTime[1] = ri.Sys_Microseconds() - t;
+
+	// the generic code leaves the last row of blended matrices untouched
+	blendErr = 0;
+	for( i = 0; i < 4; i++ ) {
+		err = R_SkeletalBenchCompare( poses[0][0] + i * 4, poses[1][0] + i * 4, numposes, 16, 3 );
+		blendErr = max( blendErr, err );
+	}
+
+	// skin with the same matrices so that only the kernels are compared
+	skinErr = 0;
+	skinTime[0] = skinTime[1] = 0;
+	for( i = 0, mesh = skmodel->meshes; i < skmodel->nummeshes; i++, mesh++ ) {
+		t = ri.Sys_Microseconds();
+		for( it = 0; it < iterations; it++ ) {
+			R_SkeletalTransformVerts_Generic( mesh->numverts, mesh->vertexBlends, poses[0],
+				( vec_t * )mesh->xyzArray[0], ( vec_t * )xyz[0] );
+			R_SkeletalTransformNormalsAndSVecs_Generic( mesh->numverts, mesh->vertexBlends, poses[0],
+				( vec_t * )mesh->normalsArray[0], ( vec_t * )normals[0], ( vec_t * )mesh->sVectorsArray[0], ( vec_t * )svecs[0] );
+		}
+		skinTime[0] += ri.Sys_Microseconds() - t;
+
+		t = ri.Sys_Microseconds();
+		for( it = 0; it < iterations; it++ ) {
+			R_SkeletalTransformVerts_SIMD( mesh->numverts, mesh->vertexBlends, poses[0],
+				( vec_t * )mesh->xyzArray[0], ( vec_t * )xyz[1] );
+			R_SkeletalTransformNormalsAndSVecs_SIMD( mesh->numverts, mesh->vertexBlends, poses[0],
+				( vec_t * )mesh->normalsArray[0], ( vec_t * )normals[1], ( vec_t * )mesh->sVectorsArray[0], ( vec_t * )svecs[1] );
+		}
+		skinTime[1] += ri.Sys_Microseconds() - t;
+
+		err = R_SkeletalBenchCompare( xyz[0][0], xyz[1][0], mesh->numverts, 4, 4 );
+		skinErr = max( skinErr, err );
+		err = R_SkeletalBenchCompare( normals[0][0], normals[1][0], mesh->numverts, 4, 4 );
+		skinErr = max( skinErr, err );
+		err = R_SkeletalBenchCompare( svecs[0][0], svecs[1][0], mesh->numverts, 4, 4 );
+		skinErr = max( skinErr, err );
+	}
+
+	R_Free( buffer );
+
+	ri.Com_Printf( "%s: %i bones, %i blends, %i meshes\n", name, skmodel->numbones, skmodel->numblends, skmodel->nummeshes );
+	ri.Com_Printf( "  blend: %.2f us generic, %.2f us simd, max error %g\n",
+		(double)blendTime[0] / iterations, (double)blendTime[1] / iterations, blendErr );
+	ri.Com_Printf( "  skin:  %.2f us generic, %.2f us simd, max error %g\n",
+		(double)skinTime[0] / iterations, (double)skinTime[1] / iterations, skinErr );
+
+	return blendErr <= SKM_BENCH_EPSILON && skinErr <= SKM_BENCH_EPSILON;
+}
+
+#endif
+
+/*
+* R_SkeletalBench_f
+*
+* Skins player models on the CPU with the generic and the SIMD kernels,
+* reporting the timings and checking that the results match.
+*/
+void R_SkeletalBench_f( void ) {
+#if defined( SKM_SIMD_SSE2 ) || defined( SKM_SIMD_NEON )
+	int i, iterations;
+	bool passed = true;
+	char name[MAX_QPATH];
+
+	iterations = ri.Cmd_Argc() > 1 ? atoi( ri.Cmd_Argv( 1 ) ) : 0;
+	if( iterations <= 0 ) {
+		iterations = 100;
+	}
+
+	if( ri.Cmd_Argc() > 2 ) {
+		for( i = 2; i < ri.Cmd_Argc(); i++ ) {
+			passed = R_SkeletalBenchModel( ri.Cmd_Argv( i ), iterations ) && passed;
+		}
+	} else {
+		for( i = 0; i < (int)( sizeof( r_skmBenchModels ) / sizeof( r_skmBenchModels[0] ) ); i++ ) {
+			Q_snprintfz( name, sizeof( name ), "models/players/%s/tris.iqm", r_skmBenchModels[i] );
+			passed = R_SkeletalBenchModel( name, iterations ) && passed;
+		}
+	}
+
+	ri.Com_Printf( "%s\n", passed ? "Results match" : S_COLOR_RED "Results differ" );
+#else
+	ri.Com_Printf( "No SIMD skinning kernels for this platform\n" );
+#endif
+}
@@ -426,6 +426,7 @@ bool SV_SendClientsFragments( void );
 void SV_InitClientMessage( client_t *client, msg_t *msg, uint8_t *data, size_t size );
 bool SV_SendMessageToClient( client_t *client, msg_t *msg );
 void SV_ResetClientFrameCounters( void );
+int SV_ClientSnapHintFlags( client_t *client );
 
 typedef enum { RD_NONE, RD_PACKET } redirect_t;
 
@@ -514,6 +515,27 @@ void SV_DemoGet_f( client_t *client );
 
 bool SV_IsDemoDownloadRequest( const char *request );
 
+//
+// sv_benchmark.c
+//
+typedef enum {
+	SV_BENCH_FRAME,
+	SV_BENCH_GAME,
+	SV_BENCH_AI,
+	SV_BENCH_SNAPSHOTS,
+	SV_BENCH_SEND,
+
+	SV_BENCH_NUM_PHASES
+} sv_benchphase_t;
+
+void SV_Benchmark_f( void );
+void SV_Benchmark_Cancel( void );
+bool SV_Benchmark_Running( void );
+unsigned SV_Benchmark_Seed( void );
+int64_t SV_Benchmark_Milliseconds( void );
+void SV_Benchmark_AddPhaseTime( sv_benchphase_t phase, uint64_t micros );
+void SV_Benchmark_SnapFrame( void );
+
 //
 // sv_motd.c
 //
@@ -0,0 +1,423 @@
+/*
+Copyright (C) 2017 Warsow development team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "server.h"
+
+/*
+* Server benchmark
+*
+* Loads a map, fills it with bots and runs a fixed number of server frames
+* back to back. The game runs on a virtual clock that advances by exactly one
+* game frame per server frame and the random generators are seeded with a fixed
+* value, so every run of the same map, bots count and seed does the same work.
+*
+* Bots do not need snapshots, but the benchmark builds, writes and transmits
+* them to a sink address anyway, as if every bot was a connected player.
+* The netchans use the requested packet codec and every message is acknowledged
+* right away, the resulting per-client bandwidth is printed with the timings.
+*/
+
+#define SV_BENCHMARK_DEFAULT_BOTS       8
+#define SV_BENCHMARK_DEFAULT_FRAMES     5000
+#define SV_BENCHMARK_DEFAULT_SEED       1
+
+#define SV_BENCHMARK_MAX_WARMUP_TIME    30000   // game msecs to wait for the bots to enter the game
+#define SV_BENCHMARK_SETTLE_TIME        3000    // game msecs to let the bots join teams
+
+static const char *sv_benchPhaseNames[SV_BENCH_NUM_PHASES] = {
+	"frame", "game", "ai", "snapshots", "send"
+};
+
+typedef struct {
+	bool running;
+	bool measuring;
+	unsigned seed;
+	int64_t millis;                                 // the clock the game module sees
+
+	int numFrames;
+	int numSamples[SV_BENCH_NUM_PHASES];
+	uint64_t *samples[SV_BENCH_NUM_PHASES];         // numFrames samples for each phase
+
+	uint64_t frameTimes[SV_BENCH_NUM_PHASES];       // of the current frame
+	bool framePhases[SV_BENCH_NUM_PHASES];          // phases that ran in the current frame
+
+	socket_t socket;                                // open, but never sends anything
+	int numNetchans;
+	netchan_t *netchans;                            // [sv_maxclients->integer]
+	netchan_codec_t codec;
+} sv_benchmark_t;
+
+static sv_benchmark_t sv_bench;
+
+/*
+* SV_Benchmark_Running
+*/
+bool SV_Benchmark_Running( void ) {
+	return sv_bench.running;
+}
+
+/*
+* SV_Benchmark_Seed
+*/
+unsigned SV_Benchmark_Seed( void ) {
+	return sv_bench.seed;
+}
+
+/*
+* SV_Benchmark_Milliseconds
+*/
+int64_t SV_Benchmark_Milliseconds( void ) {
+	return sv_bench.millis;
+}
+
+/*
+* SV_Benchmark_AddPhaseTime
+*/
+void SV_Benchmark_AddPhaseTime( sv_benchphase_t phase, uint64_t micros ) {
+	if( !sv_bench.measuring ) {
+		return;
+	}
+
+	sv_bench.frameTimes[phase] += micros;
+	sv_bench.framePhases[phase] = true;
+}
+
+/*
+* SV_Benchmark_SnapFrame
+*
+* Builds, writes and transmits snapshots for the bots
+*/
+void SV_Benchmark_SnapFrame( void ) {
+	int i;
+	client_t *client;
+	netchan_t *netchan;
+	uint64_t startedAt, builtAt;
+	static msg_t msg;
+	static uint8_t msgData[MAX_MSGLEN];
+
+	if( !sv_bench.running ) {
+		return;
+	}
+
+	for( i = 0, client = svs.clients; i < sv_maxclients->integer; i++, client++ ) {
+		if( client->state != CS_SPAWNED || !client->edict || !( client->edict->r.svflags & SVF_FAKECLIENT ) ) {
+			continue;
+		}
+
+		netchan = &sv_bench.netchans[i];
+
+		startedAt = Sys_Microseconds();
+
+		SV_BuildClientFrameSnap( client, SV_ClientSnapHintFlags( client ) );
+
+		builtAt = Sys_Microseconds();
+
+		MSG_Init( &msg, msgData, sizeof( msgData ) );
+		MSG_Clear( &msg );
+		SV_WriteFrameSnapToClient( client, &msg );
+		SV_Netchan_Transmit( netchan, &msg );
+
+		// acknowledge the frame right away, so next snapshots are delta compressed
+		client->lastframe = sv.framenum;
+		netchan->incoming_acknowledged = netchan->outgoingSequence - 1;
+		netchan->incoming_stream_acknowledged = netchan->incoming_acknowledged;
+
+		SV_Benchmark_AddPhaseTime( SV_BENCH_SNAPSHOTS, builtAt - startedAt );
+		SV_Benchmark_AddPhaseTime( SV_BENCH_SEND, Sys_Microseconds() - builtAt );
+	}
+}
+
+/*
+* SV_Benchmark_NumBotsInGame
+*/
+static int SV_Benchmark_NumBotsInGame( void ) {
+	int i, numBots = 0;
+	client_t *client;
+
+	for( i = 0, client = svs.clients; i < sv_maxclients->integer; i++, client++ ) {
+		if( client->state == CS_SPAWNED && client->edict && ( client->edict->r.svflags & SVF_FAKECLIENT ) ) {
+			numBots++;
+		}
+	}
+
+	return numBots;
+}
+
+/*
+* SV_Benchmark_RunFrame
+*/
+static void SV_Benchmark_RunFrame( void ) {
+	int i;
+	uint64_t startedAt;
+
+	memset( sv_bench.frameTimes, 0, sizeof( sv_bench.frameTimes ) );
+	memset( sv_bench.framePhases, 0, sizeof( sv_bench.framePhases ) );
+
+	sv_bench.millis += svc.gameFrameTime;
+
+	startedAt = Sys_Microseconds();
+	SV_Frame( svc.gameFrameTime, svc.gameFrameTime );
+	SV_Benchmark_AddPhaseTime( SV_BENCH_FRAME, Sys_Microseconds() - startedAt );
+
+	if( !sv_bench.measuring ) {
+		return;
+	}
+
+	for( i = 0; i < SV_BENCH_NUM_PHASES; i++ ) {
+		if( sv_bench.framePhases[i] ) {
+			sv_bench.samples[i][sv_bench.numSamples[i]++] = sv_bench.frameTimes[i];
+		}
+	}
+}
+
+/*
+* SV_Benchmark_CompareSamples
+*/
+static int SV_Benchmark_CompareSamples( const void *p1, const void *p2 ) {
+	uint64_t s1 = *( (const uint64_t *)p1 ), s2 = *( (const uint64_t *)p2 );
+	return s1 < s2 ? -1 : ( s1 > s2 ? 1 : 0 );
+}
+
+/*
+* SV_Benchmark_Percentile
+*/
+static uint64_t SV_Benchmark_Percentile( const uint64_t *sorted, int numSamples, int percentile ) {
+	return sorted[( ( numSamples - 1 ) * percentile + 50 ) / 100];
+}
+
+/*
+* SV_Benchmark_PrintResults
+*
+* Prints one line per phase in key=value form, the times are in microseconds
+*/
+static void SV_Benchmark_PrintResults( const char *mapname, int numBots, uint64_t wallTime ) {
+	int i, j, numSamples;
+	uint64_t *samples, total;
+
+	Com_Printf( "benchmark: map=%s bots=%i frames=%i seed=%u gameframe=%u snapframe=%u wall=%" PRIu64 "\n",
+				mapname, numBots, sv_bench.numFrames, sv_bench.seed, svc.gameFrameTime, svc.snapFrameTime, wallTime );
+
+	for( i = 0; i < SV_BENCH_NUM_PHASES; i++ ) {
+		samples = sv_bench.samples[i];
+		numSamples = sv_bench.numSamples[i];
+		if( !numSamples ) {
+			Com_Printf( "benchmark: phase=%s samples=0\n", sv_benchPhaseNames[i] );
+			continue;
+		}
+
+		qsort( samples, numSamples, sizeof( *samples ), SV_Benchmark_CompareSamples );
+
+		total = 0;
+		for( j = 0; j < numSamples; j++ ) {
+			total += samples[j];
+		}
+
+		Com_Printf( "benchmark: phase=%s samples=%i mean=%" PRIu64 " p50=%" PRIu64 " p90=%" PRIu64
+					" p99=%" PRIu64 " max=%" PRIu64 "\n",
+					sv_benchPhaseNames[i], numSamples, total / numSamples,
+					SV_Benchmark_Percentile( samples, numSamples, 50 ),
+					SV_Benchmark_Percentile( samples, numSamples, 90 ),
+					SV_Benchmark_Percentile( samples, numSamples, 99 ),
+					samples[numSamples - 1] );
+	}
+}
+
+/*
+* SV_Benchmark_PrintBandwidth
+*
+* Prints the outgoing traffic of an average client, before and after compression
+*/
+static void SV_Benchmark_PrintBandwidth( int numBots ) {
+	int i;
+	unsigned packets = 0;
+	uint64_t in = 0, out = 0, time = 0;
+	double seconds = (double)sv_bench.numFrames * svc.gameFrameTime / 1000.0;
+	const netchan_t *netchan;
+
+	for( i = 0, netchan = sv_bench.netchans; i < sv_bench.numNetchans; i++, netchan++ ) {
+		packets += netchan->compressedPackets;
+		in += netchan->compressInBytes;
+		out += netchan->compressOutBytes;
+		time += netchan->compressTime;
+	}
+
+	if( !numBots || !packets ) {
+		Com_Printf( "benchmark: codec=%s packets=0 compress=%i\n", Netchan_CodecName( sv_bench.codec ),
+					sv_compresspackets->integer );
+		return;
+	}
+
+	Com_Printf( "benchmark: codec=%s packets=%u in=%.0f out=%.0f ratio=%.2f us/packet=%.1f\n",
+				Netchan_CodecName( sv_bench.codec ), packets,
+				in / seconds / numBots, out / seconds / numBots,
+				out ? (double)in / out : 0.0, (double)time / packets );
+}
+
+/*
+* SV_Benchmark_ResetBandwidth
+*/
+static void SV_Benchmark_ResetBandwidth( void ) {
+	int i;
+	netchan_t *netchan;
+
+	for( i = 0, netchan = sv_bench.netchans; i < sv_bench.numNetchans; i++, netchan++ ) {
+		netchan->compressedPackets = 0;
+		netchan->compressInBytes = netchan->compressOutBytes = 0;
+		netchan->compressTime = 0;
+	}
+}
+
+/*
+* SV_Benchmark_Cancel
+*
+* Frees the benchmark state, also called when the game is shut down in the middle of a run
+*/
+void SV_Benchmark_Cancel( void ) {
+	int i;
+
+	for( i = 0; i < SV_BENCH_NUM_PHASES; i++ ) {
+		if( sv_bench.samples[i] ) {
+			Mem_Free( sv_bench.samples[i] );
+		}
+	}
+
+	if( sv_bench.netchans ) {
+		for( i = 0; i < sv_bench.numNetchans; i++ ) {
+			Netchan_Release( &sv_bench.netchans[i] );
+		}
+		Mem_Free( sv_bench.netchans );
+	}
+
+	memset( &sv_bench, 0, sizeof( sv_bench ) );
+}
+
+/*
+* SV_Benchmark_f
+*
+* serverbenchmark <map> [bots] [frames] [seed] [codec]
+*/
+void SV_Benchmark_f( void ) {
+	int i, numBots, numFrames, botsInGame;
+	int codec;
+	int64_t warmupEndTime;
+	uint64_t startedAt;
+	char mapname[MAX_CONFIGSTRING_CHARS];
+	netadr_t address;
+
+	if( Cmd_Argc() < 2 ) {
+		Com_Printf( "Usage: %s <map> [bots] [frames] [seed] [codec]\n", Cmd_Argv( 0 ) );
+		return;
+	}
+
+	if( sv_bench.running ) {
+		Com_Printf( "A server benchmark is already running\n" );
+		return;
+	}
+
+	Q_strncpyz( mapname, Cmd_Argv( 1 ), sizeof( mapname ) );
+	COM_StripExtension( mapname );
+	if( !ML_ValidateFilename( mapname ) || ( !ML_FilenameExists( mapname ) && ( !ML_Update() || !ML_FilenameExists( mapname ) ) ) ) {
+		Com_Printf( "Couldn't find map: %s\n", mapname );
+		return;
+	}
+
+	numBots = Cmd_Argc() > 2 ? atoi( Cmd_Argv( 2 ) ) : SV_BENCHMARK_DEFAULT_BOTS;
+	numFrames = Cmd_Argc() > 3 ? atoi( Cmd_Argv( 3 ) ) : SV_BENCHMARK_DEFAULT_FRAMES;
+	if( numFrames <= 0 ) {
+		numFrames = SV_BENCHMARK_DEFAULT_FRAMES;
+	}
+
+	codec = NETCHAN_CODEC_ZLIB;
+	if( Cmd_Argc() > 5 ) {
+		for( codec = 0; codec < NETCHAN_CODEC_TOTAL; codec++ ) {
+			if( !Q_stricmp( Cmd_Argv( 5 ), Netchan_CodecName( codec ) ) ) {
+				break;
+			}
+		}
+		if( codec == NETCHAN_CODEC_TOTAL ) {
+			Com_Printf( "Unknown codec: %s\n", Cmd_Argv( 5 ) );
+			return;
+		}
+	}
+
+	// restart the game so it's initialized with the fixed seed and the virtual clock
+	SV_ShutdownGame( "Server benchmark", false );
+
+	Cvar_GetLatchedVars( CVAR_LATCH );
+	clamp( numBots, 0, sv_maxclients->integer );
+	Cvar_ForceSet( "g_numbots", va( "%i", numBots ) );
+
+	sv_bench.running = true;
+	sv_bench.seed = Cmd_Argc() > 4 ? (unsigned)atoi( Cmd_Argv( 4 ) ) : SV_BENCHMARK_DEFAULT_SEED;
+	sv_bench.millis = Sys_Milliseconds();
+	srand( sv_bench.seed );
+
+	SV_Map( mapname, false );
+
+	sv_bench.numFrames = numFrames;
+	for( i = 0; i < SV_BENCH_NUM_PHASES; i++ ) {
+		sv_bench.samples[i] = Mem_Alloc( sv_mempool, sizeof( *sv_bench.samples[i] ) * numFrames );
+	}
+
+	NET_InitAddress( &address, NA_NOTRANSMIT );
+	sv_bench.socket.type = SOCKET_UDP;
+	sv_bench.socket.address = address;
+	sv_bench.socket.open = true;
+	sv_bench.socket.server = true;
+	sv_bench.codec = codec;
+	sv_bench.numNetchans = sv_maxclients->integer;
+	sv_bench.netchans = Mem_Alloc( sv_mempool, sizeof( *sv_bench.netchans ) * sv_bench.numNetchans );
+	for( i = 0; i < sv_bench.numNetchans; i++ ) {
+		Netchan_Setup( &sv_bench.netchans[i], &sv_bench.socket, &address, 0 );
+		Netchan_SetCodec( &sv_bench.netchans[i], codec );
+	}
+
+	Com_Printf( "Benchmarking %s with %i bots for %i frames\n", mapname, numBots, numFrames );
+
+	// bots can only be spawned a few seconds after the map has been loaded,
+	// and they take some time to join the game after that
+	warmupEndTime = svs.gametime + SV_BENCHMARK_MAX_WARMUP_TIME;
+	while( svs.gametime < warmupEndTime ) {
+		if( SV_Benchmark_NumBotsInGame() >= numBots ) {
+			warmupEndTime = min( warmupEndTime, svs.gametime + SV_BENCHMARK_SETTLE_TIME );
+		}
+		SV_Benchmark_RunFrame();
+	}
+
+	botsInGame = SV_Benchmark_NumBotsInGame();
+	if( botsInGame < numBots ) {
+		Com_Printf( S_COLOR_YELLOW "Only %i of %i bots have entered the game\n", botsInGame, numBots );
+	}
+
+	SV_Benchmark_ResetBandwidth();
+
+	sv_bench.measuring = true;
+	startedAt = Sys_Microseconds();
+	for( i = 0; i < numFrames; i++ ) {
+		SV_Benchmark_RunFrame();
+	}
+
+	SV_Benchmark_PrintResults( mapname, botsInGame, Sys_Microseconds() - startedAt );
+	SV_Benchmark_PrintBandwidth( botsInGame );
+
+	// the game clock is way ahead of the real one now, don't let the game carry on
+	SV_Benchmark_Cancel();
+	SV_ShutdownGame( "Server benchmark finished", false );
+}
@@ -284,6 +284,39 @@ void SV_Status_f( void ) {
 	Com_Printf( "\n" );
 }
 
+/*
+* SV_CompressionStats_f
+*/
+static void SV_CompressionStats_f( void ) {
+	int i;
+	client_t *cl;
+	const netchan_t *chan;
+
+	if( !svs.clients ) {
+		Com_Printf( "No server running.\n" );
+		return;
+	}
+
+	Com_Printf( "num codec        packets    in KB   out KB ratio us/pkt name\n" );
+	Com_Printf( "--- ------------ -------- -------- -------- ----- ------ ---------------\n" );
+	for( i = 0, cl = svs.clients; i < sv_maxclients->integer; i++, cl++ ) {
+		if( cl->state < CS_CONNECTED ) {
+			continue;
+		}
+		if( cl->edict && ( cl->edict->r.svflags & SVF_FAKECLIENT ) ) {
+			continue;
+		}
+
+		chan = &cl->netchan;
+		Com_Printf( "%3i %-12s %8u %8u %8u %5.2f %6.1f %s\n", i, Netchan_CodecName( chan->codec ),
+					chan->compressedPackets, (unsigned)( chan->compressInBytes / 1024 ), (unsigned)( chan->compressOutBytes / 1024 ),
+					chan->compressOutBytes ? (double)chan->compressInBytes / chan->compressOutBytes : 0.0,
+					chan->compressedPackets ? (double)chan->compressTime / chan->compressedPackets : 0.0,
+					COM_RemoveColorTokens( cl->name ) );
+	}
+	Com_Printf( "\n" );
+}
+
 /*
 * SV_Heartbeat_f
 */
@@ -379,6 +412,7 @@ static void SV_CvarCheck_f( void ) {
 void SV_InitOperatorCommands( void ) {
 	Cmd_AddCommand( "heartbeat", SV_Heartbeat_f );
 	Cmd_AddCommand( "status", SV_Status_f );
+	Cmd_AddCommand( "compressionstats", SV_CompressionStats_f );
 	Cmd_AddCommand( "serverinfo", SV_Serverinfo_f );
 	Cmd_AddCommand( "dumpuser", SV_DumpUser_f );
 
@@ -386,6 +420,7 @@ void SV_InitOperatorCommands( void ) {
 	Cmd_AddCommand( "devmap", SV_Map_f );
 	Cmd_AddCommand( "gamemap", SV_Map_f );
 	Cmd_AddCommand( "killserver", SV_KillServer_f );
+	Cmd_AddCommand( "serverbenchmark", SV_Benchmark_f );
 
 	Cmd_AddCommand( "serverrecord", SV_Demo_Start_f );
 	Cmd_AddCommand( "serverrecordstop", SV_Demo_Stop_f );
@@ -412,6 +447,7 @@ void SV_InitOperatorCommands( void ) {
 void SV_ShutdownOperatorCommands( void ) {
 	Cmd_RemoveCommand( "heartbeat" );
 	Cmd_RemoveCommand( "status" );
+	Cmd_RemoveCommand( "compressionstats" );
 	Cmd_RemoveCommand( "serverinfo" );
 	Cmd_RemoveCommand( "dumpuser" );
 
@@ -419,6 +455,7 @@ void SV_ShutdownOperatorCommands( void ) {
 	Cmd_RemoveCommand( "devmap" );
 	Cmd_RemoveCommand( "gamemap" );
 	Cmd_RemoveCommand( "killserver" );
+	Cmd_RemoveCommand( "serverbenchmark" );
 
 	Cmd_RemoveCommand( "serverrecord" );
 	Cmd_RemoveCommand( "serverrecordstop" );
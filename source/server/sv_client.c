@@ -225,6 +225,8 @@ void SV_DropClient( client_t *drop, int type, const char *format, ... ) {
 
 	SNAP_FreeClientFrames( drop );
 
+	Netchan_Release( &drop->netchan );
+
 	SV_Web_RemoveGameClient( drop->session );
 
 	if( drop->download.name ) {
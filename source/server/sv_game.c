@@ -44,6 +44,11 @@ static inline void PF_CM_TransformedBoxTrace( trace_t *tr, vec3_t start, vec3_t
 	CM_TransformedBoxTrace( svs.cms, tr, start, end, mins, maxs, cmodel, brushmask, origin, angles );
 }
 
+static inline void PF_CM_TraceBatch( trace_t *traces, vec3_t *starts, vec3_t *ends, int numtraces,
+									 vec3_t mins, vec3_t maxs, int brushmask ) {
+	CM_TraceBatch( svs.cms, traces, starts, ends, numtraces, mins, maxs, brushmask );
+}
+
 static inline int PF_CM_NumInlineModels( void ) {
 	return CM_NumInlineModels( svs.cms );
 }
@@ -444,6 +449,18 @@ static void SV_LocateEntities( struct edict_s *edicts, int edict_size, int num_e
 	sv.gi.max_clients = min( num_edicts, sv_maxclients->integer );
 }
 
+/*
+* PF_Milliseconds
+*
+* The server benchmark runs the game on its own clock
+*/
+static int64_t PF_Milliseconds( void ) {
+	if( SV_Benchmark_Running() ) {
+		return SV_Benchmark_Milliseconds();
+	}
+	return Sys_Milliseconds();
+}
+
 /*
 * SV_InitGameProgs
 *
@@ -475,6 +492,7 @@ void SV_InitGameProgs( void ) {
 
 	import.CM_TransformedPointContents = PF_CM_TransformedPointContents;
 	import.CM_TransformedBoxTrace = PF_CM_TransformedBoxTrace;
+	import.CM_TraceBatch = PF_CM_TraceBatch;
 	import.CM_NumInlineModels = PF_CM_NumInlineModels;
 	import.CM_InlineModel = PF_CM_InlineModel;
 	import.CM_InlineModelBounds = PF_CM_InlineModelBounds;
@@ -487,7 +505,8 @@ void SV_InitGameProgs( void ) {
 	import.CM_LeafArea = PF_CM_LeafArea;
 	import.CM_LeafsInPVS = PF_CM_LeafsInPVS;
 
-	import.Milliseconds = Sys_Milliseconds;
+	import.Milliseconds = PF_Milliseconds;
+	import.Microseconds = Sys_Microseconds;
 
 	import.ModelIndex = SV_ModelIndex;
 	import.SoundIndex = SV_SoundIndex;
@@ -553,6 +572,19 @@ void SV_InitGameProgs( void ) {
 	import.MM_SendQuery = SV_MM_SendQuery;
 	import.MM_GameState = SV_MM_GameState;
 
+	import.Mutex_Create = QMutex_Create;
+	import.Mutex_Destroy = QMutex_Destroy;
+	import.Mutex_Lock = QMutex_Lock;
+	import.Mutex_Unlock = QMutex_Unlock;
+
+	import.Jobs_NumWorkers = QJobs_NumWorkers;
+	import.JobCounter_Create = QJobCounter_Create;
+	import.JobCounter_Destroy = QJobCounter_Destroy;
+	import.JobCounter_IsDone = QJobCounter_IsDone;
+	import.Jobs_Schedule = QJobs_Schedule;
+	import.Jobs_ParallelFor = QJobs_ParallelFor;
+	import.Jobs_Wait = QJobs_Wait;
+
 	// clear module manifest string
 	assert( sizeof( manifest ) >= MAX_INFO_STRING );
 	memset( manifest, 0, sizeof( manifest ) );
@@ -578,5 +610,5 @@ void SV_InitGameProgs( void ) {
 
 	SV_SetServerConfigStrings();
 
-	ge->Init( time( NULL ), svc.snapFrameTime, APP_PROTOCOL_VERSION, APP_DEMO_EXTENSION_STR );
+	ge->Init( SV_Benchmark_Running() ? SV_Benchmark_Seed() : (unsigned)time( NULL ), svc.snapFrameTime, APP_PROTOCOL_VERSION, APP_DEMO_EXTENSION_STR );
 }
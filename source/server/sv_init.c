@@ -474,16 +474,24 @@ static void SV_FinalMessage( const char *message, bool reconnect ) {
 * Called when each game quits
 */
 void SV_ShutdownGame( const char *finalmsg, bool reconnect ) {
+	int i;
+
 	if( !svs.initialized ) {
 		return;
 	}
 
+	SV_Benchmark_Cancel();
+
 	if( svs.demo.file ) {
 		SV_Demo_Stop_f();
 	}
 
 	if( svs.clients ) {
 		SV_FinalMessage( finalmsg, reconnect );
+
+		for( i = 0; i < sv_maxclients->integer; i++ ) {
+			Netchan_Release( &svs.clients[i].netchan );
+		}
 	}
 
 	SV_ShutdownGameProgs();
@@ -162,18 +162,13 @@ static bool SV_ProcessPacket( netchan_t *netchan, msg_t *msg ) {
 		return false; // wasn't accepted for some reason
 
 	}
-	// now if compressed, expand it
-	MSG_BeginReading( msg );
-	MSG_ReadInt32( msg ); // sequence
-	MSG_ReadInt32( msg ); // sequence_ack
-	MSG_ReadInt16( msg ); // game_port
-	if( msg->compressed ) {
-		zerror = Netchan_DecompressMessage( msg );
-		if( zerror < 0 ) {
-			// compression error. Drop the packet
-			Com_DPrintf( "SV_ProcessPacket: Compression error %i. Dropping packet\n", zerror );
-			return false;
-		}
+	// now if compressed, expand it, the header has already been read by Netchan_Process.
+	// Uncompressed messages go through it too, the stream codecs keep them for reference
+	zerror = Netchan_DecompressMessage( netchan, msg );
+	if( zerror < 0 ) {
+		// compression error. Drop the packet
+		Com_DPrintf( "SV_ProcessPacket: Compression error %i. Dropping packet\n", zerror );
+		return false;
 	}
 
 	return true;
@@ -482,7 +477,7 @@ static bool SV_RunGameFrame( int msec ) {
 	}
 
 	// if there aren't pending packets to be sent, we can sleep
-	if( dedicated->integer && !sentFragments && !refreshSnapshot ) {
+	if( dedicated->integer && !sentFragments && !refreshSnapshot && !SV_Benchmark_Running() ) {
 		int sleeptime = min( WORLDFRAMETIME - ( accTime + 1 ), sv.nextSnapTime - ( svs.gametime + 1 ) );
 
 		if( sleeptime > 0 ) {
@@ -526,7 +521,14 @@ static bool SV_RunGameFrame( int msec ) {
 			time_before_game = Sys_Milliseconds();
 		}
 
-		ge->RunFrame( moduleTime, svs.gametime );
+		if( SV_Benchmark_Running() ) {
+			uint64_t startedAt = Sys_Microseconds();
+			ge->RunFrame( moduleTime, svs.gametime );
+			SV_Benchmark_AddPhaseTime( SV_BENCH_GAME, Sys_Microseconds() - startedAt );
+			SV_Benchmark_AddPhaseTime( SV_BENCH_AI, ge->GetAIFrameTime() );
+		} else {
+			ge->RunFrame( moduleTime, svs.gametime );
+		}
 
 		if( host_speeds->integer ) {
 			time_after_game = Sys_Milliseconds();
@@ -539,7 +541,13 @@ static bool SV_RunGameFrame( int msec ) {
 
 		// set up for sending a snapshot
 		sv.framenum++;
-		ge->SnapFrame();
+		if( SV_Benchmark_Running() ) {
+			uint64_t startedAt = Sys_Microseconds();
+			ge->SnapFrame();
+			SV_Benchmark_AddPhaseTime( SV_BENCH_SNAPSHOTS, Sys_Microseconds() - startedAt );
+		} else {
+			ge->SnapFrame();
+		}
 
 		// set time for next snapshot
 		extraSnapTime = (int)( svs.gametime - sv.nextSnapTime );
@@ -744,6 +752,9 @@ void SV_Frame( unsigned realmsec, unsigned gamemsec ) {
 		// send messages back to the clients that had packets read this frame
 		SV_SendClientMessages();
 
+		// the benchmark handles bots like connected players
+		SV_Benchmark_SnapFrame();
+
 		// write snap to server demo file
 		SV_Demo_WriteSnap();
 
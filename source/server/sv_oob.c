@@ -615,6 +615,7 @@ static void SVC_DirectConnect( const socket_t *socket, const netadr_t *address )
 	mm_uuid_t session_id, ticket_id;
 	char *session_id_str;
 	int64_t time;
+	netchan_codec_t codec;
 
 	Com_DPrintf( "SVC_DirectConnect (%s)\n", Cmd_Args() );
 
@@ -671,6 +672,12 @@ static void SVC_DirectConnect( const socket_t *socket, const netadr_t *address )
 		ticket_id = session_id = Uuid_ZeroUuid();
 	}
 
+	// clients that don't advertise their codecs only know the legacy one
+	codec = NETCHAN_CODEC_ZLIB;
+	if( Cmd_Argc() >= 9 ) {
+		codec = Netchan_NegotiateCodec( strtoul( Cmd_Argv( 7 ), NULL, 10 ), strtoul( Cmd_Argv( 8 ), NULL, 10 ) );
+	}
+
 #ifdef TCP_ALLOW_CONNECT
 	if( socket->type == SOCKET_TCP ) {
 		// find the connection
@@ -806,8 +813,14 @@ static void SVC_DirectConnect( const socket_t *socket, const netadr_t *address )
 		return;
 	}
 
+	Netchan_SetCodec( &newcl->netchan, codec );
+
 	// send the connect packet to the client
-	Netchan_OutOfBandPrint( socket, address, "client_connect\n%s", newcl->session );
+	if( codec != NETCHAN_CODEC_ZLIB ) {
+		Netchan_OutOfBandPrint( socket, address, "client_connect\n%s\n%i", newcl->session, (int)codec );
+	} else {
+		Netchan_OutOfBandPrint( socket, address, "client_connect\n%s", newcl->session );
+	}
 
 	// free the incoming entry
 #ifdef TCP_ALLOW_CONNECT
@@ -294,7 +294,7 @@ bool SV_Netchan_Transmit( netchan_t *netchan, msg_t *msg ) {
 	}
 
 	if( sv_compresspackets->integer ) {
-		zerror = Netchan_CompressMessage( msg );
+		zerror = Netchan_CompressMessage( netchan, msg );
 		if( zerror < 0 ) { // it's compression error, just send uncompressed
 			Com_DPrintf( "SV_Netchan_Transmit (ignoring compression): Compression error %i\n", zerror );
 		}
@@ -392,17 +392,9 @@ void SV_BuildClientFrameSnap( client_t *client, int snapHintFlags ) {
 }
 
 /*
-* SV_SendClientDatagram
+* SV_ClientSnapHintFlags
 */
-static bool SV_SendClientDatagram( client_t *client ) {
-	if( client->edict && ( client->edict->r.svflags & SVF_FAKECLIENT ) ) {
-		return true;
-	}
-
-	SV_InitClientMessage( client, &tmpMessage, NULL, 0 );
-
-	SV_AddReliableCommandsToMessage( client, &tmpMessage );
-
+int SV_ClientSnapHintFlags( client_t *client ) {
 	// Set snap hint flags to client-specific flags set by the game module
 	int snapHintFlags = client->edict->r.client->r.snapHintFlags;
 	// Add server global snap hint flags
@@ -418,10 +410,24 @@ static bool SV_SendClientDatagram( client_t *client ) {
 	if( sv_snap_shadow_events_data->integer ) {
 		snapHintFlags |= SNAP_HINT_SHADOW_EVENTS_DATA;
 	}
+	return snapHintFlags;
+}
+
+/*
+* SV_SendClientDatagram
+*/
+static bool SV_SendClientDatagram( client_t *client ) {
+	if( client->edict && ( client->edict->r.svflags & SVF_FAKECLIENT ) ) {
+		return true;
+	}
+
+	SV_InitClientMessage( client, &tmpMessage, NULL, 0 );
+
+	SV_AddReliableCommandsToMessage( client, &tmpMessage );
 
 	// send over all the relevant entity_state_t
 	// and the player_state_t
-	SV_BuildClientFrameSnap( client, snapHintFlags );
+	SV_BuildClientFrameSnap( client, SV_ClientSnapHintFlags( client ) );
 
 	SV_WriteFrameSnapToClient( client, &tmpMessage );
 
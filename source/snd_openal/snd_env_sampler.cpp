@@ -246,6 +246,71 @@ struct LeafPropsBuilder {
 
 static void ENV_SetupSamplingRayDirs( vec3_t *rayDirs, unsigned numRays );
 
+// Spreading fewer rays over the job threads costs more than tracing them right away
+#define RAYCAST_BATCH_GRAIN ( 4 )
+
+static qjobcounter_t *raycastJobCounter = nullptr;
+
+struct BatchedRay {
+	vec3_t start;
+	vec3_t end;
+	int contentMask;
+	trace_t trace;
+};
+
+// Collects rays and traces them at once on the engine job threads.
+// World traces are reentrant, so rays of a batch are traced in an arbitrary order.
+class RaycastBatch {
+	BatchedRay *const rays;
+	const unsigned maxRays;
+	unsigned numRays;
+
+	static void TraceRays( unsigned first, unsigned items, void *arg );
+public:
+	RaycastBatch( BatchedRay *rays_, unsigned maxRays_ )
+		: rays( rays_ ), maxRays( maxRays_ ), numRays( 0 ) {}
+
+	void Clear() { numRays = 0; }
+
+	unsigned Size() const { return numRays; }
+
+	void AddRay( const vec3_t start, const vec3_t end, int contentMask ) {
+		assert( numRays < maxRays );
+		BatchedRay *ray = &rays[numRays++];
+		VectorCopy( start, ray->start );
+		VectorCopy( end, ray->end );
+		ray->contentMask = contentMask;
+	}
+
+	// Blocks until all added rays are traced
+	void Trace();
+
+	const BatchedRay &RayAt( unsigned index ) const {
+		assert( index < numRays );
+		return rays[index];
+	}
+};
+
+void RaycastBatch::TraceRays( unsigned first, unsigned items, void *arg ) {
+	BatchedRay *ray = (BatchedRay *)arg + first;
+	BatchedRay *const end = ray + items;
+
+	for(; ray != end; ++ray ) {
+		trap_Trace( &ray->trace, ray->start, ray->end, vec3_origin, vec3_origin, ray->contentMask );
+	}
+}
+
+void RaycastBatch::Trace() {
+	if( numRays <= RAYCAST_BATCH_GRAIN || !raycastJobCounter ) {
+		TraceRays( 0, numRays, rays );
+		return;
+	}
+
+	// The sound thread is not idle while waiting, it helps tracing the batch
+	trap_Jobs_ParallelFor( TraceRays, rays, numRays, RAYCAST_BATCH_GRAIN, raycastJobCounter, nullptr );
+	trap_Jobs_Wait( raycastJobCounter );
+}
+
 class GenericRaycastSampler {
 	vec3_t *primaryRayDirs;
 	vec3_t *primaryHitPoints;
@@ -261,6 +326,11 @@ protected:
 
 	vec3_t emissionOrigin;
 
+	RaycastBatch raycastBatch;
+
+	GenericRaycastSampler( BatchedRay *batchedRays, unsigned maxBatchedRays )
+		: raycastBatch( batchedRays, maxBatchedRays ) {}
+
 	virtual float GetEmissionRadius() const {
 		return 999999.9f;
 	}
@@ -338,10 +408,11 @@ class LeafPropsSampler: public GenericRaycastSampler {
 	// Note that instances of this class should be allocated dynamically, so do not bother about arrays size.
 	vec3_t dirs[MAX_RAYS];
 	float distances[MAX_RAYS];
+	BatchedRay batchedRays[MAX_RAYS];
 	const unsigned maxRays;
 public:
 	LeafPropsSampler( bool fastAndCoarse = false )
-		: maxRays( fastAndCoarse ? MAX_RAYS / 3 : MAX_RAYS ) {
+		: GenericRaycastSampler( batchedRays, MAX_RAYS ), maxRays( fastAndCoarse ? MAX_RAYS / 3 : MAX_RAYS ) {
 		ENV_SetupSamplingRayDirs( dirs, maxRays );
 	}
 
@@ -742,6 +813,8 @@ void ENV_Init() {
 
 	isEaxReverbAvailable = qalGetEnumValue( "AL_EFFECT_EAXREVERB" ) != 0;
 
+	raycastJobCounter = trap_JobCounter_Create();
+
 	::leafPropsCache = new( leafPropsCacheStorage )LeafPropsCache;
 	::leafPropsCache->EnsureValid();
 }
@@ -754,6 +827,8 @@ void ENV_Shutdown() {
 	::leafPropsCache->~LeafPropsCache();
 	::leafPropsCache = nullptr;
 
+	trap_JobCounter_Destroy( &raycastJobCounter );
+
 	listenerProps.InvalidateCachedUpdateState();
 
 	isEaxReverbAvailable = false;
@@ -1207,6 +1282,7 @@ private:
 	vec3_t primaryRayDirs[MAX_REVERB_PRIMARY_RAY_SAMPLES];
 	vec3_t reflectionPoints[MAX_REVERB_PRIMARY_RAY_SAMPLES];
 	float primaryHitDistances[MAX_REVERB_PRIMARY_RAY_SAMPLES];
+	BatchedRay batchedRays[MAX_REVERB_PRIMARY_RAY_SAMPLES];
 	vec3_t testedListenerOrigin;
 
 	const ListenerProps *listenerProps;
@@ -1233,6 +1309,8 @@ private:
 	void SetMinimalReverbProps();
 
 public:
+	ReverbEffectSampler(): GenericRaycastSampler( batchedRays, MAX_REVERB_PRIMARY_RAY_SAMPLES ) {}
+
 	Effect *TryApply( const ListenerProps &listenerProps, src_t *src, const src_t *tryReusePropsSrc ) override;
 };
 
@@ -1360,6 +1438,8 @@ float ObstructedEffectSampler::ComputeDirectObstruction( const ListenerProps &li
 	float squareDistance;
 	unsigned numTestedRays, numPassedRays;
 	unsigned i, valueIndex;
+	BatchedRay batchedRays[MAX_DIRECT_OBSTRUCTION_SAMPLES];
+	RaycastBatch raycastBatch( batchedRays, MAX_DIRECT_OBSTRUCTION_SAMPLES );
 
 	updateState = &src->envUpdateState;
 
@@ -1393,8 +1473,14 @@ float ObstructedEffectSampler::ComputeDirectObstruction( const ListenerProps &li
 		originOffset = randomDirectObstructionOffsets[ valueIndex ];
 
 		VectorAdd( src->origin, originOffset, testedSourceOrigin );
-		trap_Trace( &trace, testedListenerOrigin, testedSourceOrigin, vec3_origin, vec3_origin, MASK_SOLID );
-		if( trace.fraction == 1.0f && !trace.startsolid ) {
+		raycastBatch.AddRay( testedListenerOrigin, testedSourceOrigin, MASK_SOLID );
+	}
+
+	raycastBatch.Trace();
+
+	for( i = 0; i < numTestedRays; i++ ) {
+		const trace_t &rayTrace = raycastBatch.RayAt( i ).trace;
+		if( rayTrace.fraction == 1.0f && !rayTrace.startsolid ) {
 			numPassedRays++;
 		}
 	}
@@ -1476,16 +1562,21 @@ void GenericRaycastSampler::EmitPrimaryRays() {
 	assert( primaryRayDirs );
 	assert( primaryHitDistances );
 
-	trace_t trace;
+	raycastBatch.Clear();
 	for( unsigned i = 0; i < numPrimaryRays; ++i ) {
-		float *sampleDir, *hitPoint;
-		sampleDir = primaryRayDirs[i];
-
 		vec3_t testedRayPoint;
-		VectorScale( sampleDir, primaryEmissionRadius, testedRayPoint );
+		VectorScale( primaryRayDirs[i], primaryEmissionRadius, testedRayPoint );
 		VectorAdd( testedRayPoint, emissionOrigin, testedRayPoint );
-		trap_Trace( &trace, emissionOrigin, testedRayPoint, vec3_origin, vec3_origin, MASK_SOLID | MASK_WATER );
+		raycastBatch.AddRay( emissionOrigin, testedRayPoint, MASK_SOLID | MASK_WATER );
+	}
+
+	raycastBatch.Trace();
 
+	for( unsigned i = 0; i < numPrimaryRays; ++i ) {
+		float *sampleDir, *hitPoint;
+		sampleDir = primaryRayDirs[i];
+
+		const trace_t &trace = raycastBatch.RayAt( i ).trace;
 		if( trace.startsolid || trace.allsolid ) {
 			continue;
 		}
@@ -1695,34 +1786,31 @@ void ReverbEffectSampler::EmitSecondaryRays() {
 	auto *const eaxEffect = Effect::Cast<EaxReverbEffect *>( effect );
 	auto *const panningUpdateState = &src->panningUpdateState;
 
-	trace_t trace;
+	// Cut off by PVS system early, we are not interested in actual ray hit points contrary to the primary emission.
+	raycastBatch.Clear();
+	for( unsigned i = 0; i < numPrimaryHits; i++ ) {
+		if( trap_LeafsInPVS( listenerLeafNum, trap_PointLeafNum( reflectionPoints[i] ) ) ) {
+			raycastBatch.AddRay( reflectionPoints[i], testedListenerOrigin, MASK_SOLID );
+		}
+	}
+
+	raycastBatch.Trace();
 
 	unsigned numPassedSecondaryRays = 0;
 	if( eaxEffect ) {
 		panningUpdateState->numReflectionPoints = 0;
-		for( unsigned i = 0; i < numPrimaryHits; i++ ) {
-			// Cut off by PVS system early, we are not interested in actual ray hit points contrary to the primary emission.
-			if( !trap_LeafsInPVS( listenerLeafNum, trap_PointLeafNum( reflectionPoints[i] ) ) ) {
-				continue;
-			}
+	}
 
-			trap_Trace( &trace, reflectionPoints[i], testedListenerOrigin, vec3_origin, vec3_origin, MASK_SOLID );
-			if( trace.fraction == 1.0f && !trace.startsolid ) {
-				numPassedSecondaryRays++;
-				float *savedPoint = panningUpdateState->reflectionPoints[panningUpdateState->numReflectionPoints++];
-				VectorCopy( reflectionPoints[i], savedPoint );
-			}
+	for( unsigned i = 0; i < raycastBatch.Size(); i++ ) {
+		const BatchedRay &ray = raycastBatch.RayAt( i );
+		if( ray.trace.fraction != 1.0f || ray.trace.startsolid ) {
+			continue;
 		}
-	} else {
-		for( unsigned i = 0; i < numPrimaryHits; i++ ) {
-			if( !trap_LeafsInPVS( listenerLeafNum, trap_PointLeafNum( reflectionPoints[i] ) ) ) {
-				continue;
-			}
 
-			trap_Trace( &trace, reflectionPoints[i], testedListenerOrigin, vec3_origin, vec3_origin, MASK_SOLID );
-			if( trace.fraction == 1.0f && !trace.startsolid ) {
-				numPassedSecondaryRays++;
-			}
+		numPassedSecondaryRays++;
+		if( eaxEffect ) {
+			float *savedPoint = panningUpdateState->reflectionPoints[panningUpdateState->numReflectionPoints++];
+			VectorCopy( ray.start, savedPoint );
 		}
 	}
 
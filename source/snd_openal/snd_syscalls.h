@@ -31,6 +31,8 @@ extern sound_import_t SOUND_IMPORT;
 typedef struct qthread_s qthread_t;
 typedef struct qmutex_s qmutex_t;
 typedef struct qbufPipe_s qbufPipe_t;
+typedef struct qjobcounter_s qjobcounter_t;
+typedef void ( *qjobfunc_t )( unsigned first, unsigned items, void *arg );
 
 static inline void trap_Print( const char *msg ) {
 	SOUND_IMPORT.Print( msg );
@@ -275,6 +277,35 @@ static inline void trap_BufPipe_Wait( qbufPipe_t *queue, int ( *read )( qbufPipe
 	SOUND_IMPORT.BufPipe_Wait( queue, read, cmdHandlers, timeout_msec );
 }
 
+static inline int trap_Jobs_NumWorkers( void ) {
+	return SOUND_IMPORT.Jobs_NumWorkers();
+}
+
+static inline qjobcounter_t *trap_JobCounter_Create( void ) {
+	return SOUND_IMPORT.JobCounter_Create();
+}
+
+static inline void trap_JobCounter_Destroy( qjobcounter_t **pcounter ) {
+	SOUND_IMPORT.JobCounter_Destroy( pcounter );
+}
+
+static inline bool trap_JobCounter_IsDone( qjobcounter_t *counter ) {
+	return SOUND_IMPORT.JobCounter_IsDone( counter );
+}
+
+static inline void trap_Jobs_Schedule( qjobfunc_t func, void *arg, qjobcounter_t *counter, qjobcounter_t *dependency ) {
+	SOUND_IMPORT.Jobs_Schedule( func, arg, counter, dependency );
+}
+
+static inline void trap_Jobs_ParallelFor( qjobfunc_t func, void *arg, unsigned items, unsigned grain,
+										  qjobcounter_t *counter, qjobcounter_t *dependency ) {
+	SOUND_IMPORT.Jobs_ParallelFor( func, arg, items, grain, counter, dependency );
+}
+
+static inline void trap_Jobs_Wait( qjobcounter_t *counter ) {
+	SOUND_IMPORT.Jobs_Wait( counter );
+}
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -1559,6 +1559,8 @@ static unsigned S_HandlePositionedRawSamplesCmd( const sndPositionedRawSamplesCm
 static unsigned S_HandleStuffCmd( const sndStuffCmd_t *cmd ) {
 	if( !Q_stricmp( cmd->text, "soundlist" ) ) {
 		S_SoundList_f();
+	} else if( !Q_strnicmp( cmd->text, "mixbench", 8 ) ) {
+		S_BenchmarkMixer( atoi( cmd->text + 8 ) );
 	}
 	return sizeof( *cmd );
 }
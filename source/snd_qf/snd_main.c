@@ -82,6 +82,17 @@ static void SF_SoundList_f( void ) {
 	S_IssueStuffCmd( s_cmdPipe, "soundlist" );
 }
 
+/*
+* SF_MixBench_f
+*/
+static void SF_MixBench_f( void ) {
+	char text[80];
+
+	// mix on the backend thread, which owns the channels and the paint buffer
+	Q_snprintfz( text, sizeof( text ), "mixbench %i", atoi( trap_Cmd_Argv( 1 ) ) );
+	S_IssueStuffCmd( s_cmdPipe, text );
+}
+
 /*
 * S_Music
 */
@@ -279,6 +290,7 @@ bool SF_Init( void *hwnd, int maxEntities, bool verbose ) {
 	trap_Cmd_AddCommand( "pausemusic", SF_PauseBackgroundTrack );
 	trap_Cmd_AddCommand( "soundlist", SF_SoundList_f );
 	trap_Cmd_AddCommand( "soundinfo", SF_SoundInfo_f );
+	trap_Cmd_AddCommand( "mixbench", SF_MixBench_f );
 
 	num_sfx = 0;
 
@@ -348,6 +360,7 @@ void SF_Shutdown( bool verbose ) {
 	trap_Cmd_RemoveCommand( "pausemusic" );
 	trap_Cmd_RemoveCommand( "soundlist" );
 	trap_Cmd_RemoveCommand( "soundinfo" );
+	trap_Cmd_RemoveCommand( "mixbench" );
 
 	S_MemFreePool( &soundpool );
 
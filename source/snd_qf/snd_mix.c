@@ -21,13 +21,103 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include "snd_local.h"
 
+#if defined( QF_SSE2 )
+#define SND_SIMD_SSE2
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#define SND_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined( SND_SIMD_SSE2 ) || defined( SND_SIMD_NEON )
+#define SND_SIMD
+#endif
+
 #define PAINTBUFFER_SIZE    2048
 static portable_samplepair_t paintbuffer[PAINTBUFFER_SIZE];
 static int snd_scaletable[32][256];
 static int *snd_p, snd_linear_count, snd_vol, music_vol;
 static short *snd_out;
 
-#if defined ( __arm__ ) && defined ( __GNUC__ )
+#if defined( SND_SIMD ) || !( ( defined ( __arm__ ) && defined ( __GNUC__ ) ) || ( defined ( _MSC_VER ) && defined( id386 ) ) )
+#ifdef _MSC_VER
+#pragma warning( push )
+#pragma warning( disable : 4310 )       // cast truncates constant value
+#endif
+/*
+* S_WriteLinearBlastStereo16_Generic
+*/
+static void S_WriteLinearBlastStereo16_Generic( const int *p, short *out, int count, bool swap ) {
+	int i;
+	int val;
+
+	if( swap ) {
+		for( i = 0; i < count; i += 2 ) {
+			val = p[i + 1] >> 8;
+			out[i] = bound( (short)0x8000, val, 0x7fff );
+
+			val = p[i] >> 8;
+			out[i + 1] = bound( (short)0x8000, val, 0x7fff );
+		}
+	} else {
+		for( i = 0; i < count; i += 2 ) {
+			val = p[i] >> 8;
+			out[i] = bound( (short)0x8000, val, 0x7fff );
+
+			val = p[i + 1] >> 8;
+			out[i + 1] = bound( (short)0x8000, val, 0x7fff );
+		}
+	}
+}
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+#endif
+
+#if defined( SND_SIMD_SSE2 )
+/*
+* S_WriteLinearBlastStereo16_SIMD
+*
+* Eight samples per iteration, packs_epi32 does the clamping.
+*/
+static void S_WriteLinearBlastStereo16_SIMD( const int *p, short *out, int count, bool swap ) {
+	int i;
+	__m128i a, b;
+
+	for( i = 0; i + 8 <= count; i += 8 ) {
+		a = _mm_srai_epi32( _mm_loadu_si128( ( const __m128i * )( p + i ) ), 8 );
+		b = _mm_srai_epi32( _mm_loadu_si128( ( const __m128i * )( p + i + 4 ) ), 8 );
+		if( swap ) {
+			a = _mm_shuffle_epi32( a, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+			b = _mm_shuffle_epi32( b, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+		}
+		_mm_storeu_si128( ( __m128i * )( out + i ), _mm_packs_epi32( a, b ) );
+	}
+
+	S_WriteLinearBlastStereo16_Generic( p + i, out + i, count - i, swap );
+}
+#elif defined( SND_SIMD_NEON )
+/*
+* S_WriteLinearBlastStereo16_SIMD
+*
+* Eight samples per iteration, the saturating narrow does the clamping.
+*/
+static void S_WriteLinearBlastStereo16_SIMD( const int *p, short *out, int count, bool swap ) {
+	int i;
+	int32x4_t a, b;
+
+	for( i = 0; i + 8 <= count; i += 8 ) {
+		a = vshrq_n_s32( vld1q_s32( p + i ), 8 );
+		b = vshrq_n_s32( vld1q_s32( p + i + 4 ), 8 );
+		if( swap ) {
+			a = vrev64q_s32( a );
+			b = vrev64q_s32( b );
+		}
+		vst1q_s16( out + i, vcombine_s16( vqmovn_s32( a ), vqmovn_s32( b ) ) );
+	}
+
+	S_WriteLinearBlastStereo16_Generic( p + i, out + i, count - i, swap );
+}
+#elif defined ( __arm__ ) && defined ( __GNUC__ )
 // 40-50% faster than the C version.
 // Uses signed saturation instruction (available since ARMv6 or Thumb2) instead of comparisons,
 // with the right shift being a part of the saturation instruction.
@@ -156,37 +246,12 @@ LClampDone2:
 	}
 }
 #else
-#ifdef _MSC_VER
-#pragma warning( push )
-#pragma warning( disable : 4310 )       // cast truncates constant value
-#endif
 static void S_WriteLinearBlastStereo16( void ) {
-	int i;
-	int val;
-
-	for( i = 0; i < snd_linear_count; i += 2 ) {
-		val = snd_p[i] >> 8;
-		snd_out[i] = bound( (short)0x8000, val, 0x7fff );
-
-		val = snd_p[i + 1] >> 8;
-		snd_out[i + 1] = bound( (short)0x8000, val, 0x7fff );
-	}
+	S_WriteLinearBlastStereo16_Generic( snd_p, snd_out, snd_linear_count, false );
 }
 
 static void S_WriteSwappedLinearBlastStereo16( void ) {
-	int i;
-	int val;
-
-	for( i = 0; i < snd_linear_count; i += 2 ) {
-		val = snd_p[i + 1] >> 8;
-		snd_out[i] = bound( (short)0x8000, val, 0x7fff );
-
-		val = snd_p[i] >> 8;
-		snd_out[i + 1] = bound( (short)0x8000, val, 0x7fff );
-	}
-#ifdef _MSC_VER
-#pragma warning( pop )
-#endif
+	S_WriteLinearBlastStereo16_Generic( snd_p, snd_out, snd_linear_count, true );
 }
 #endif
 
@@ -211,11 +276,15 @@ static void S_TransferStereo16( unsigned int *pbuf, int endtime ) {
 		snd_linear_count <<= 1;
 
 		// write a linear blast of samples
+#ifdef SND_SIMD
+		S_WriteLinearBlastStereo16_SIMD( snd_p, snd_out, snd_linear_count, s_swapstereo->integer != 0 );
+#else
 		if( s_swapstereo->integer ) {
 			S_WriteSwappedLinearBlastStereo16();
 		} else {
 			S_WriteLinearBlastStereo16();
 		}
+#endif
 
 		snd_p += snd_linear_count;
 		lpaintedtime += ( snd_linear_count >> 1 );
@@ -494,9 +563,286 @@ void S_InitScaletable( void ) {
 	}
 }
 
-static void S_PaintChannelFrom8( channel_t *ch, sfxcache_t *sc, unsigned int count, int offset ) {
+/*
+* S_PaintStereo8_Generic
+*/
+static void S_PaintStereo8_Generic( portable_samplepair_t *samp, const unsigned char *sfx, unsigned int count, const int *lscale, const int *rscale ) {
+	unsigned int i;
+
+	for( i = 0; i < count; i++, samp++ ) {
+		samp->left += lscale[*sfx++];
+		samp->right += rscale[*sfx++];
+	}
+}
+
+/*
+* S_PaintMono8_Generic
+*/
+static void S_PaintMono8_Generic( portable_samplepair_t *samp, const unsigned char *sfx, unsigned int count, const int *lscale, const int *rscale ) {
+	unsigned int i;
+	int j;
+
+	for( i = 0; i < count; i++, samp++ ) {
+		j = *sfx++;
+		samp->left += lscale[j];
+		samp->right += rscale[j];
+	}
+}
+
+/*
+* S_PaintStereo16_Generic
+*/
+static void S_PaintStereo16_Generic( portable_samplepair_t *samp, const signed short *sfx, unsigned int count, int leftvol, int rightvol ) {
+	unsigned int i;
+
+	for( i = 0; i < count; i++, samp++ ) {
+		samp->left += ( *sfx++ *leftvol ) >> 8;
+		samp->right += ( *sfx++ *rightvol ) >> 8;
+	}
+}
+
+/*
+* S_PaintMono16_Generic
+*/
+static void S_PaintMono16_Generic( portable_samplepair_t *samp, const signed short *sfx, unsigned int count, int leftvol, int rightvol ) {
 	unsigned int i;
 	int j;
+
+	for( i = 0; i < count; i++, samp++ ) {
+		j = *sfx++;
+		samp->left += ( j * leftvol ) >> 8;
+		samp->right += ( j * rightvol ) >> 8;
+	}
+}
+
+// The SIMD kernels below mix eight sample pairs per iteration and produce exactly
+// the same sums as the generic ones. The 8-bit scale tables are linear in the sample
+// value, so the kernels multiply by the scale of sample 1 instead of looking them up.
+
+#if defined( SND_SIMD_SSE2 )
+
+/*
+* S_MixSamples_SSE2
+*
+* Adds ( s * vol ) >> shift to four sample pairs for interleaved left and right
+* 16-bit samples. SSE2 has no 32-bit multiply, so the volume is split into two
+* 15-bit halves which are multiplied separately.
+*/
+static inline void S_MixSamples_SSE2( int *out, __m128i s, __m128i vollo, __m128i volhi, __m128i shift ) {
+	__m128i lo, hi, lo2, hi2, p0, p1;
+
+	lo = _mm_mullo_epi16( s, vollo );
+	hi = _mm_mulhi_epi16( s, vollo );
+	lo2 = _mm_mullo_epi16( s, volhi );
+	hi2 = _mm_mulhi_epi16( s, volhi );
+
+	p0 = _mm_add_epi32( _mm_unpacklo_epi16( lo, hi ), _mm_slli_epi32( _mm_unpacklo_epi16( lo2, hi2 ), 15 ) );
+	p1 = _mm_add_epi32( _mm_unpackhi_epi16( lo, hi ), _mm_slli_epi32( _mm_unpackhi_epi16( lo2, hi2 ), 15 ) );
+
+	_mm_storeu_si128( ( __m128i * )( out + 0 ), _mm_add_epi32( _mm_loadu_si128( ( __m128i * )( out + 0 ) ), _mm_sra_epi32( p0, shift ) ) );
+	_mm_storeu_si128( ( __m128i * )( out + 4 ), _mm_add_epi32( _mm_loadu_si128( ( __m128i * )( out + 4 ) ), _mm_sra_epi32( p1, shift ) ) );
+}
+
+#define S_VOLUME_LO_SSE2( l, r ) _mm_set_epi16( ( r ) & 0x7fff, ( l ) & 0x7fff, ( r ) & 0x7fff, ( l ) & 0x7fff, ( r ) & 0x7fff, ( l ) & 0x7fff, ( r ) & 0x7fff, ( l ) & 0x7fff )
+#define S_VOLUME_HI_SSE2( l, r ) _mm_set_epi16( ( r ) >> 15, ( l ) >> 15, ( r ) >> 15, ( l ) >> 15, ( r ) >> 15, ( l ) >> 15, ( r ) >> 15, ( l ) >> 15 )
+
+/*
+* S_PaintStereo8_SIMD
+*/
+static void S_PaintStereo8_SIMD( portable_samplepair_t *samp, const unsigned char *sfx, unsigned int count, const int *lscale, const int *rscale ) {
+	unsigned int i;
+	int *out = ( int * )samp;
+	const __m128i vollo = S_VOLUME_LO_SSE2( lscale[1], rscale[1] );
+	const __m128i volhi = S_VOLUME_HI_SSE2( lscale[1], rscale[1] );
+	const __m128i shift = _mm_cvtsi32_si128( 0 );
+	__m128i x;
+
+	for( i = 0; i + 8 <= count; i += 8, sfx += 16, out += 16 ) {
+		x = _mm_loadu_si128( ( const __m128i * )sfx );
+		S_MixSamples_SSE2( out + 0, _mm_srai_epi16( _mm_unpacklo_epi8( x, x ), 8 ), vollo, volhi, shift );
+		S_MixSamples_SSE2( out + 8, _mm_srai_epi16( _mm_unpackhi_epi8( x, x ), 8 ), vollo, volhi, shift );
+	}
+
+	S_PaintStereo8_Generic( ( portable_samplepair_t * )out, sfx, count - i, lscale, rscale );
+}
+
+/*
+* S_PaintMono8_SIMD
+*/
+static void S_PaintMono8_SIMD( portable_samplepair_t *samp, const unsigned char *sfx, unsigned int count, const int *lscale, const int *rscale ) {
+	unsigned int i;
+	int *out = ( int * )samp;
+	const __m128i vollo = S_VOLUME_LO_SSE2( lscale[1], rscale[1] );
+	const __m128i volhi = S_VOLUME_HI_SSE2( lscale[1], rscale[1] );
+	const __m128i shift = _mm_cvtsi32_si128( 0 );
+	__m128i x;
+
+	for( i = 0; i + 8 <= count; i += 8, sfx += 8, out += 16 ) {
+		x = _mm_loadl_epi64( ( const __m128i * )sfx );
+		x = _mm_srai_epi16( _mm_unpacklo_epi8( x, x ), 8 );
+		S_MixSamples_SSE2( out + 0, _mm_unpacklo_epi16( x, x ), vollo, volhi, shift );
+		S_MixSamples_SSE2( out + 8, _mm_unpackhi_epi16( x, x ), vollo, volhi, shift );
+	}
+
+	S_PaintMono8_Generic( ( portable_samplepair_t * )out, sfx, count - i, lscale, rscale );
+}
+
+/*
+* S_PaintStereo16_SIMD
+*/
+static void S_PaintStereo16_SIMD( portable_samplepair_t *samp, const signed short *sfx, unsigned int count, int leftvol, int rightvol ) {
+	unsigned int i;
+	int *out = ( int * )samp;
+	const __m128i vollo = S_VOLUME_LO_SSE2( leftvol, rightvol );
+	const __m128i volhi = S_VOLUME_HI_SSE2( leftvol, rightvol );
+	const __m128i shift = _mm_cvtsi32_si128( 8 );
+
+	for( i = 0; i + 8 <= count; i += 8, sfx += 16, out += 16 ) {
+		S_MixSamples_SSE2( out + 0, _mm_loadu_si128( ( const __m128i * )( sfx + 0 ) ), vollo, volhi, shift );
+		S_MixSamples_SSE2( out + 8, _mm_loadu_si128( ( const __m128i * )( sfx + 8 ) ), vollo, volhi, shift );
+	}
+
+	S_PaintStereo16_Generic( ( portable_samplepair_t * )out, sfx, count - i, leftvol, rightvol );
+}
+
+/*
+* S_PaintMono16_SIMD
+*/
+static void S_PaintMono16_SIMD( portable_samplepair_t *samp, const signed short *sfx, unsigned int count, int leftvol, int rightvol ) {
+	unsigned int i;
+	int *out = ( int * )samp;
+	const __m128i vollo = S_VOLUME_LO_SSE2( leftvol, rightvol );
+	const __m128i volhi = S_VOLUME_HI_SSE2( leftvol, rightvol );
+	const __m128i shift = _mm_cvtsi32_si128( 8 );
+	__m128i x;
+
+	for( i = 0; i + 8 <= count; i += 8, sfx += 8, out += 16 ) {
+		x = _mm_loadu_si128( ( const __m128i * )sfx );
+		S_MixSamples_SSE2( out + 0, _mm_unpacklo_epi16( x, x ), vollo, volhi, shift );
+		S_MixSamples_SSE2( out + 8, _mm_unpackhi_epi16( x, x ), vollo, volhi, shift );
+	}
+
+	S_PaintMono16_Generic( ( portable_samplepair_t * )out, sfx, count - i, leftvol, rightvol );
+}
+
+#elif defined( SND_SIMD_NEON )
+
+/*
+* S_MixSamples_NEON
+*
+* Adds ( s * vol ) >> shift to four sample pairs for interleaved left and right samples.
+*/
+static inline void S_MixSamples_NEON( int *out, int16x8_t s, int32x4_t vol, int32x4_t shift ) {
+	int32x4_t p0, p1;
+
+	p0 = vshlq_s32( vmulq_s32( vmovl_s16( vget_low_s16( s ) ), vol ), shift );
+	p1 = vshlq_s32( vmulq_s32( vmovl_s16( vget_high_s16( s ) ), vol ), shift );
+
+	vst1q_s32( out + 0, vaddq_s32( vld1q_s32( out + 0 ), p0 ) );
+	vst1q_s32( out + 4, vaddq_s32( vld1q_s32( out + 4 ), p1 ) );
+}
+
+/*
+* S_Volume_NEON
+*/
+static inline int32x4_t S_Volume_NEON( int left, int right ) {
+	const int vol[4] = { left, right, left, right };
+	return vld1q_s32( vol );
+}
+
+/*
+* S_PaintStereo8_SIMD
+*/
+static void S_PaintStereo8_SIMD( portable_samplepair_t *samp, const unsigned char *sfx, unsigned int count, const int *lscale, const int *rscale ) {
+	unsigned int i;
+	int *out = ( int * )samp;
+	const int32x4_t vol = S_Volume_NEON( lscale[1], rscale[1] );
+	const int32x4_t shift = vdupq_n_s32( 0 );
+	int8x16_t x;
+
+	for( i = 0; i + 8 <= count; i += 8, sfx += 16, out += 16 ) {
+		x = vld1q_s8( ( const int8_t * )sfx );
+		S_MixSamples_NEON( out + 0, vmovl_s8( vget_low_s8( x ) ), vol, shift );
+		S_MixSamples_NEON( out + 8, vmovl_s8( vget_high_s8( x ) ), vol, shift );
+	}
+
+	S_PaintStereo8_Generic( ( portable_samplepair_t * )out, sfx, count - i, lscale, rscale );
+}
+
+/*
+* S_PaintMono8_SIMD
+*/
+static void S_PaintMono8_SIMD( portable_samplepair_t *samp, const unsigned char *sfx, unsigned int count, const int *lscale, const int *rscale ) {
+	unsigned int i;
+	int *out = ( int * )samp;
+	const int32x4_t vol = S_Volume_NEON( lscale[1], rscale[1] );
+	const int32x4_t shift = vdupq_n_s32( 0 );
+	int16x8_t x;
+	int16x8x2_t z;
+
+	for( i = 0; i + 8 <= count; i += 8, sfx += 8, out += 16 ) {
+		x = vmovl_s8( vld1_s8( ( const int8_t * )sfx ) );
+		z = vzipq_s16( x, x );
+		S_MixSamples_NEON( out + 0, z.val[0], vol, shift );
+		S_MixSamples_NEON( out + 8, z.val[1], vol, shift );
+	}
+
+	S_PaintMono8_Generic( ( portable_samplepair_t * )out, sfx, count - i, lscale, rscale );
+}
+
+/*
+* S_PaintStereo16_SIMD
+*/
+static void S_PaintStereo16_SIMD( portable_samplepair_t *samp, const signed short *sfx, unsigned int count, int leftvol, int rightvol ) {
+	unsigned int i;
+	int *out = ( int * )samp;
+	const int32x4_t vol = S_Volume_NEON( leftvol, rightvol );
+	const int32x4_t shift = vdupq_n_s32( -8 );
+
+	for( i = 0; i + 8 <= count; i += 8, sfx += 16, out += 16 ) {
+		S_MixSamples_NEON( out + 0, vld1q_s16( sfx + 0 ), vol, shift );
+		S_MixSamples_NEON( out + 8, vld1q_s16( sfx + 8 ), vol, shift );
+	}
+
+	S_PaintStereo16_Generic( ( portable_samplepair_t * )out, sfx, count - i, leftvol, rightvol );
+}
+
+/*
+* S_PaintMono16_SIMD
+*/
+static void S_PaintMono16_SIMD( portable_samplepair_t *samp, const signed short *sfx, unsigned int count, int leftvol, int rightvol ) {
+	unsigned int i;
+	int *out = ( int * )samp;
+	const int32x4_t vol = S_Volume_NEON( leftvol, rightvol );
+	const int32x4_t shift = vdupq_n_s32( -8 );
+	int16x8_t x;
+	int16x8x2_t z;
+
+	for( i = 0; i + 8 <= count; i += 8, sfx += 8, out += 16 ) {
+		x = vld1q_s16( sfx );
+		z = vzipq_s16( x, x );
+		S_MixSamples_NEON( out + 0, z.val[0], vol, shift );
+		S_MixSamples_NEON( out + 8, z.val[1], vol, shift );
+	}
+
+	S_PaintMono16_Generic( ( portable_samplepair_t * )out, sfx, count - i, leftvol, rightvol );
+}
+
+#endif
+
+#ifdef SND_SIMD
+#define S_PaintStereo8  S_PaintStereo8_SIMD
+#define S_PaintMono8    S_PaintMono8_SIMD
+#define S_PaintStereo16 S_PaintStereo16_SIMD
+#define S_PaintMono16   S_PaintMono16_SIMD
+#else
+#define S_PaintStereo8  S_PaintStereo8_Generic
+#define S_PaintMono8    S_PaintMono8_Generic
+#define S_PaintStereo16 S_PaintStereo16_Generic
+#define S_PaintMono16   S_PaintMono16_Generic
+#endif
+
+static void S_PaintChannelFrom8( channel_t *ch, sfxcache_t *sc, unsigned int count, int offset ) {
 	int *lscale, *rscale;
 	unsigned char *sfx;
 	portable_samplepair_t *samp;
@@ -520,27 +866,16 @@ static void S_PaintChannelFrom8( channel_t *ch, sfxcache_t *sc, unsigned int cou
 
 	if( sc->channels == 2 ) {
 		sfx = (unsigned char *)sc->data + ch->pos * 2;
-
-		for( i = 0; i < count; i++, samp++ ) {
-			samp->left += lscale[*sfx++];
-			samp->right += rscale[*sfx++];
-		}
+		S_PaintStereo8( samp, sfx, count, lscale, rscale );
 	} else {
 		sfx = (unsigned char *)sc->data + ch->pos;
-
-		for( i = 0; i < count; i++, samp++ ) {
-			j = *sfx++;
-			samp->left += lscale[j];
-			samp->right += rscale[j];
-		}
+		S_PaintMono8( samp, sfx, count, lscale, rscale );
 	}
 
 	ch->pos += count;
 }
 
 static void S_PaintChannelFrom16( channel_t *ch, sfxcache_t *sc, unsigned int count, int offset ) {
-	unsigned int i;
-	int j;
 	int leftvol, rightvol;
 	signed short *sfx;
 	portable_samplepair_t *samp;
@@ -557,19 +892,10 @@ static void S_PaintChannelFrom16( channel_t *ch, sfxcache_t *sc, unsigned int co
 
 	if( sc->channels == 2 ) {
 		sfx = (signed short *)sc->data + ch->pos * 2;
-
-		for( i = 0; i < count; i++, samp++ ) {
-			samp->left += ( *sfx++ *leftvol ) >> 8;
-			samp->right += ( *sfx++ *rightvol ) >> 8;
-		}
+		S_PaintStereo16( samp, sfx, count, leftvol, rightvol );
 	} else {
 		sfx = (signed short *)sc->data + ch->pos;
-
-		for( i = 0; i < count; i++, samp++ ) {
-			j = *sfx++;
-			samp->left += ( j * leftvol ) >> 8;
-			samp->right += ( j * rightvol ) >> 8;
-		}
+		S_PaintMono16( samp, sfx, count, leftvol, rightvol );
 	}
 
 	ch->pos += count;
@@ -601,11 +927,7 @@ static void S_PaintChannelFrom8HQ( channel_t *ch, sfxcache_t *sc, unsigned int c
 
 	if( sc->channels == 2 ) {
 		sfx = (unsigned char *)sc->data + ch->pos * 2;
-
-		for( i = 0; i < count; i++, samp++ ) {
-			samp->left += lscale[*sfx++];
-			samp->right += rscale[*sfx++];
-		}
+		S_PaintStereo8( samp, sfx, count, lscale, rscale );
 	} else {
 		sfx = (unsigned char *)sc->data + ch->pos;
 
@@ -665,11 +987,7 @@ static void S_PaintChannelFrom16HQ( channel_t *ch, sfxcache_t *sc, unsigned int
 
 	if( sc->channels == 2 ) {
 		sfx = (signed short *)sc->data + ch->pos * 2;
-
-		for( i = 0; i < count; i++, samp++ ) {
-			samp->left += ( *sfx++ *leftvol ) >> 8;
-			samp->right += ( *sfx++ *rightvol ) >> 8;
-		}
+		S_PaintStereo16( samp, sfx, count, leftvol, rightvol );
 	} else {
 		sfx = (signed short *)sc->data + ch->pos;
 
@@ -705,3 +1023,134 @@ static void S_PaintChannelFrom16HQ( channel_t *ch, sfxcache_t *sc, unsigned int
 
 	ch->pos += count;
 }
+
+#ifdef SND_SIMD
+/*
+* S_BenchmarkMixChannel
+*/
+static void S_BenchmarkMixChannel( const channel_t *ch, portable_samplepair_t *samp, bool simd ) {
+	unsigned int pos, count;
+	int leftvol, rightvol;
+	const sfxcache_t *sc = ch->sfx->cache;
+
+	pos = ch->pos < sc->length ? ch->pos : 0;
+	count = min( sc->length - pos, PAINTBUFFER_SIZE );
+	leftvol = min( ch->leftvol, 255 );
+	rightvol = min( ch->rightvol, 255 );
+
+	if( sc->width == 1 ) {
+		const int *lscale = snd_scaletable[leftvol >> 3];
+		const int *rscale = snd_scaletable[rightvol >> 3];
+		const unsigned char *sfx = (const unsigned char *)sc->data + pos * sc->channels;
+
+		if( sc->channels == 2 ) {
+			( simd ? S_PaintStereo8_SIMD : S_PaintStereo8_Generic )( samp, sfx, count, lscale, rscale );
+		} else {
+			( simd ? S_PaintMono8_SIMD : S_PaintMono8_Generic )( samp, sfx, count, lscale, rscale );
+		}
+	} else {
+		const int vol = s_volume->value * 256;
+		const signed short *sfx = (const signed short *)sc->data + pos * sc->channels;
+
+		if( sc->channels == 2 ) {
+			( simd ? S_PaintStereo16_SIMD : S_PaintStereo16_Generic )( samp, sfx, count, leftvol * vol, rightvol * vol );
+		} else {
+			( simd ? S_PaintMono16_SIMD : S_PaintMono16_Generic )( samp, sfx, count, leftvol * vol, rightvol * vol );
+		}
+	}
+}
+#endif
+
+/*
+* S_BenchmarkMixer
+*
+* Mixes the currently playing channels, or all loaded sounds if nothing is playing,
+* into scratch buffers with the generic and the SIMD kernels, then reports the
+* timings and whether the results are bit-exact.
+*/
+void S_BenchmarkMixer( int iterations ) {
+#ifdef SND_SIMD
+	int i, k, it;
+	int numchannels;
+	bool recorded, swap;
+	channel_t *ch;
+	uint64_t t, time[2];
+	static channel_t set[MAX_CHANNELS];
+	static portable_samplepair_t mixed[2][PAINTBUFFER_SIZE];
+	static short out[2][PAINTBUFFER_SIZE * 2];
+
+	if( iterations <= 0 ) {
+		iterations = 1000;
+	}
+
+	numchannels = 0;
+	for( i = 0, ch = channels; i < MAX_CHANNELS; i++, ch++ ) {
+		if( ch->sfx && ch->sfx->cache && ( ch->leftvol || ch->rightvol ) ) {
+			set[numchannels++] = *ch;
+		}
+	}
+
+	recorded = numchannels > 0;
+	if( !recorded ) {
+		for( i = 0; i < num_sfx && numchannels < MAX_CHANNELS; i++ ) {
+			if( !known_sfx[i].cache ) {
+				continue;
+			}
+
+			ch = &set[numchannels];
+			memset( ch, 0, sizeof( *ch ) );
+			ch->sfx = &known_sfx[i];
+			ch->leftvol = 64 + ( numchannels * 37 ) % 192;
+			ch->rightvol = 64 + ( numchannels * 91 ) % 192;
+			numchannels++;
+		}
+	}
+
+	if( !numchannels ) {
+		Com_Printf( "No sounds to mix\n" );
+		return;
+	}
+
+	swap = s_swapstereo->integer != 0;
+	for( k = 0; k < 2; k++ ) {
+		t = trap_Microseconds();
+		for( it = 0; it < iterations; it++ ) {
+			memset( mixed[k], 0, sizeof( mixed[k] ) );
+
+			for( i = 0; i < numchannels; i++ ) {
+				S_BenchmarkMixChannel( &set[i], mixed[k], k != 0 );
+			}
+
+			if( k ) {
+				S_WriteLinearBlastStereo16_SIMD( &mixed[k][0].left, out[k], PAINTBUFFER_SIZE * 2, swap );
+			} else {
+				S_WriteLinearBlastStereo16_Generic( &mixed[k][0].left, out[k], PAINTBUFFER_SIZE * 2, swap );
+			}
+		}
+		time[k] = trap_Microseconds() - t;
+	}
+
+	Com_Printf( "Mixed %i %s channels, %i samples:\n", numchannels, recorded ? "playing" : "loaded", PAINTBUFFER_SIZE );
+	Com_Printf( "  generic: %.1f us\n", (double)time[0] / iterations );
+	Com_Printf( "  simd:    %.1f us\n", (double)time[1] / iterations );
+
+	for( i = 0; i < PAINTBUFFER_SIZE; i++ ) {
+		if( mixed[0][i].left != mixed[1][i].left || mixed[0][i].right != mixed[1][i].right ) {
+			break;
+		}
+	}
+	if( i < PAINTBUFFER_SIZE ) {
+		Com_Printf( S_COLOR_RED "Mixed samples differ at %i\n", i );
+		return;
+	}
+
+	if( memcmp( out[0], out[1], sizeof( out[0] ) ) ) {
+		Com_Printf( S_COLOR_RED "Transferred samples differ\n" );
+		return;
+	}
+
+	Com_Printf( "Results are bit-exact\n" );
+#else
+	Com_Printf( "No SIMD mixing kernels for this platform\n" );
+#endif
+}
@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <pthread.h>
 #include <sched.h>
 #include <sys/time.h>
+#include <unistd.h>
 
 struct qthread_s {
 	pthread_t t;
@@ -120,6 +121,13 @@ void Sys_Thread_Yield( void ) {
 	sched_yield();
 }
 
+/*
+* Sys_Thread_GetNumCPUs
+*/
+int Sys_Thread_GetNumCPUs( void ) {
+	return (int)sysconf( _SC_NPROCESSORS_ONLN );
+}
+
 /*
 * Sys_Atomic_Add
 */
@@ -173,6 +173,16 @@ void Sys_Thread_Yield( void ) {
 	Sys_Sleep( 0 );
 }
 
+/*
+* Sys_Thread_GetNumCPUs
+*/
+int Sys_Thread_GetNumCPUs( void ) {
+	SYSTEM_INFO si;
+
+	GetSystemInfo( &si );
+	return (int)si.dwNumberOfProcessors;
+}
+
 /*
 * Sys_Atomic_Add
 */